@@ -0,0 +1,181 @@
+/*
+ *
+ *  1bpp Bitmap/Animation Player
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#include <string.h>
+#include "Animation.h"
+
+// Makes at least one byte available and returns how many are contiguous, up to <wanted>.
+// 0 on a read error or truncated input
+static uint32_t Animation_Fill(Animation *anim, uint32_t wanted) {
+    if (anim->position == anim->length) {
+        if (anim->stream == NULL) {
+            return 0;
+        }
+        int32_t result = anim->stream->read(anim->stream->context, anim->buffer, ANIMATION_STREAM_BUFFER);
+        if (result <= 0) {
+            return 0;
+        }
+        anim->data = anim->buffer;
+        anim->length = result;
+        anim->position = 0;
+    }
+    uint32_t available = anim->length - anim->position;
+    return available < wanted ? available : wanted;
+}
+
+static bool Animation_ReadBytes(Animation *anim, uint8_t *data, uint32_t length) {
+    while (length) {
+        uint32_t count = Animation_Fill(anim, length);
+        if (count == 0) {
+            return false;
+        }
+        memcpy(data, anim->data + anim->position, count);
+        anim->position += count;
+        data += count;
+        length -= count;
+    }
+    return true;
+}
+
+static int Animation_ParseHeader(Animation *anim) {
+    uint8_t header[ANIMATION_HEADER_SIZE];
+    if (!Animation_ReadBytes(anim, header, ANIMATION_HEADER_SIZE)) {
+        return ANIMATION_ERROR_IO;
+    }
+    if (memcmp(header, ANIMATION_MAGIC, 4) != 0) {
+        return ANIMATION_ERROR_FORMAT;
+    }
+    anim->width = header[4];
+    anim->pages = header[5];
+    anim->frame_count = header[6] | (header[7] << 8);
+    anim->frame_period_ms = header[8] | (header[9] << 8);
+    anim->frame = 0;
+    if (anim->width == 0 || anim->pages == 0 || anim->pages > ANIMATION_MAX_PAGES || anim->frame_count == 0) {
+        return ANIMATION_ERROR_FORMAT;
+    }
+    return ANIMATION_OK;
+}
+
+int Animation_OpenMemory(Animation *anim, const uint8_t *data, uint32_t length) {
+    memset(anim, 0, sizeof(Animation));
+    anim->data = data;
+    anim->length = length;
+    return Animation_ParseHeader(anim);
+}
+
+int Animation_OpenStream(Animation *anim, const Animation_Stream *stream) {
+    memset(anim, 0, sizeof(Animation));
+    anim->stream = stream;
+    return Animation_ParseHeader(anim);
+}
+
+int Animation_Rewind(Animation *anim) {
+    anim->frame = 0;
+    if (anim->stream == NULL) {
+        anim->position = ANIMATION_HEADER_SIZE;
+        return ANIMATION_OK;
+    }
+    if (anim->stream->seek(anim->stream->context, ANIMATION_HEADER_SIZE) < 0) {
+        return ANIMATION_ERROR_IO;
+    }
+    // Drop the buffered window
+    anim->position = anim->length;
+    return ANIMATION_OK;
+}
+
+// Decodes one page of packets into <out>, <width> bytes exactly
+static int Animation_DecodePage(Animation *anim, uint8_t *out, bool delta, uint32_t *consumed) {
+    uint8_t produced = 0;
+    while (produced < anim->width) {
+        uint8_t packet;
+        if (!Animation_ReadBytes(anim, &packet, 1)) {
+            return ANIMATION_ERROR_IO;
+        }
+        uint8_t count = (packet & 0x7F) + 1;
+        if (count > anim->width - produced) {
+            return ANIMATION_ERROR_FORMAT;
+        }
+        (*consumed)++;
+
+        if (packet & 0x80) {
+            uint8_t value;
+            if (!Animation_ReadBytes(anim, &value, 1)) {
+                return ANIMATION_ERROR_IO;
+            }
+            (*consumed)++;
+            if (!delta) {
+                memset(out + produced, value, count);
+            }
+            else if (value) {
+                for (uint8_t i = 0; i < count; i++) {
+                    out[produced + i] ^= value;
+                }
+            }
+            produced += count;
+            continue;
+        }
+
+        // Literals are used in place, from flash or the stream buffer
+        *consumed += count;
+        while (count) {
+            uint32_t available = Animation_Fill(anim, count);
+            if (available == 0) {
+                return ANIMATION_ERROR_IO;
+            }
+            const uint8_t *in = anim->data + anim->position;
+            if (!delta) {
+                memcpy(out + produced, in, available);
+            }
+            else {
+                for (uint32_t i = 0; i < available; i++) {
+                    out[produced + i] ^= in[i];
+                }
+            }
+            anim->position += available;
+            produced += available;
+            count -= available;
+        }
+    }
+    return ANIMATION_OK;
+}
+
+int Animation_DecodeFrame(Animation *anim, uint8_t *framebuffer, uint16_t stride, uint8_t pages, uint8_t x, uint8_t page) {
+    if (x + anim->width > stride || page + anim->pages > pages) {
+        return ANIMATION_ERROR_FORMAT;
+    }
+    if (anim->frame >= anim->frame_count) {
+        return ANIMATION_ERROR_END;
+    }
+
+    uint8_t frame_header[2];
+    if (!Animation_ReadBytes(anim, frame_header, 2)) {
+        return ANIMATION_ERROR_IO;
+    }
+    uint8_t type = frame_header[0];
+    uint8_t mask = frame_header[1];
+    if (type > ANIMATION_FRAME_DELTA || (anim->frame == 0 && type != ANIMATION_FRAME_KEY)) {
+        return ANIMATION_ERROR_FORMAT;
+    }
+
+    uint32_t consumed = 2;
+    for (uint8_t p = 0; p < anim->pages; p++) {
+        if (!(mask & (1 << p))) {
+            continue;
+        }
+        int result = Animation_DecodePage(anim, framebuffer + (page + p) * stride + x, type == ANIMATION_FRAME_DELTA, &consumed);
+        if (result < 0) {
+            return result;
+        }
+    }
+    anim->frame++;
+    anim->last_frame_bytes = consumed;
+    return ANIMATION_OK;
+}
@@ -0,0 +1,80 @@
+/*
+ *
+ *  1bpp Bitmap/Animation Player
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _ANIMATION_H
+#define _ANIMATION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Frames are decoded a page at a time straight into a page major framebuffer (the SSD1306
+// back buffer), so no frame is ever held in RAM. Input is either a const array, read in
+// place from XIP flash, or a stream (a file on the SD card) read through a small buffer.
+// Files are produced by tools/anim_convert.py
+//
+// Header, little endian:
+//   "MPA1", width u8, pages u8, frame count u16, frame period ms u16, reserved u16
+// Frame:
+//   type u8, page mask u8 (bit per page present), then for each page in the mask packets
+//   until <width> bytes have been produced:
+//     0x00-0x7F: n + 1 literal bytes follow
+//     0x80-0xFF: (n & 0x7F) + 1 copies of the following byte
+// KEY pages replace the framebuffer bytes. DELTA pages are XORed in, pages left out of
+// the mask are unchanged. The first frame is always a KEY frame
+
+#define ANIMATION_MAGIC             "MPA1"
+#define ANIMATION_HEADER_SIZE       12
+#define ANIMATION_MAX_PAGES         8
+#define ANIMATION_STREAM_BUFFER     64
+
+#define ANIMATION_FRAME_KEY         0
+#define ANIMATION_FRAME_DELTA       1
+
+#define ANIMATION_OK                0
+#define ANIMATION_ERROR_FORMAT      -1
+#define ANIMATION_ERROR_IO          -2
+#define ANIMATION_ERROR_END         -3 // All frames played, rewind to loop
+
+// Stream source. read returns bytes read, 0 at the end, or an error. seek is absolute
+typedef struct {
+    void *context;
+    int32_t (*read)(void *context, uint8_t *data, uint32_t length);
+    int (*seek)(void *context, uint32_t position);
+} Animation_Stream;
+
+typedef struct {
+    uint8_t width;
+    uint8_t pages;
+    uint16_t frame_count;
+    uint16_t frame_period_ms;
+    uint16_t frame; // Next to decode
+
+    // Input window, the whole array for memory or the stream buffer
+    const uint8_t *data;
+    uint32_t length;
+    uint32_t position;
+    const Animation_Stream *stream;
+    uint8_t buffer[ANIMATION_STREAM_BUFFER];
+
+    uint32_t last_frame_bytes; // Encoded size of the last decoded frame
+} Animation;
+
+// <data> must stay valid while playing, typically a const array in flash
+int Animation_OpenMemory(Animation *anim, const uint8_t *data, uint32_t length);
+int Animation_OpenStream(Animation *anim, const Animation_Stream *stream);
+
+// Decodes the next frame into <framebuffer> (<stride> bytes per page, <pages> pages) with its
+// top left corner at column <x> of page <page>. Returns ANIMATION_ERROR_END after the last frame
+int Animation_DecodeFrame(Animation *anim, uint8_t *framebuffer, uint16_t stride, uint8_t pages, uint8_t x, uint8_t page);
+
+// Back to the first frame
+int Animation_Rewind(Animation *anim);
+#endif
@@ -0,0 +1,32 @@
+/*
+ *
+ *  Block Device Interface
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _BLOCKDEVICE_H
+#define _BLOCKDEVICE_H
+
+#include <stdint.h>
+
+// What the sector cache and filesystem see of a storage device. The SD card driver
+// provides one on target, a disk image file can provide one on a host
+
+#define BLOCKDEVICE_SECTOR_SIZE 512
+
+// Return 0 or a negative error, <count> whole sectors starting at <lba>
+typedef int (*BlockDevice_ReadFunction)(void *context, uint32_t lba, uint8_t *data, uint32_t count);
+typedef int (*BlockDevice_WriteFunction)(void *context, uint32_t lba, const uint8_t *data, uint32_t count);
+
+typedef struct {
+    void *context;
+    BlockDevice_ReadFunction read;
+    BlockDevice_WriteFunction write; // NULL if read only
+    uint32_t sector_count;
+} BlockDevice;
+#endif
@@ -0,0 +1,95 @@
+/*
+ *
+ *  Boot Sequencer
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "Boot.h"
+#include "HotPath.h"
+
+void Boot_Initialise(Boot *boot, Boot_ClockFunction clock) {
+    memset(boot, 0, sizeof(Boot));
+    boot->clock = clock;
+}
+
+static Boot_Phase *Boot_StartPhase(Boot *boot, const char *name, bool deferred) {
+    if (boot->phase_count >= BOOT_MAX_PHASES) {
+        return NULL;
+    }
+    Boot_Phase *phase = &boot->phases[boot->phase_count++];
+    phase->name = name;
+    phase->deferred = deferred;
+    phase->duration_us = 0;
+    phase->start_us = (uint32_t)boot->clock();
+    return phase;
+}
+
+void Boot_Begin(Boot *boot, const char *name) {
+    Boot_StartPhase(boot, name, false);
+}
+
+void Boot_End(Boot *boot) {
+    if (boot->phase_count) {
+        Boot_Phase *phase = &boot->phases[boot->phase_count - 1];
+        phase->duration_us = (uint32_t)boot->clock() - phase->start_us;
+    }
+}
+
+bool Boot_Defer(Boot *boot, const char *name, Boot_StepFunction function, void *context) {
+    if (boot->deferred_count >= BOOT_MAX_DEFERRED || function == NULL) {
+        return false;
+    }
+    Boot_Step *step = &boot->deferred[boot->deferred_count++];
+    step->name = name;
+    step->function = function;
+    step->context = context;
+    return true;
+}
+
+bool Boot_RunDeferred(Boot *boot) {
+    if (boot->deferred_next >= boot->deferred_count) {
+        return false;
+    }
+    Boot_Step *step = &boot->deferred[boot->deferred_next];
+    if (!boot->deferred_running) {
+        boot->deferred_phase = Boot_StartPhase(boot, step->name, true);
+        boot->deferred_running = true;
+    }
+    if (!step->function(step->context)) {
+        return true;
+    }
+    boot->deferred_running = false;
+    boot->deferred_next++;
+    if (boot->deferred_phase) {
+        boot->deferred_phase->duration_us = (uint32_t)boot->clock() - boot->deferred_phase->start_us;
+    }
+    if (boot->deferred_next < boot->deferred_count) {
+        return true;
+    }
+    boot->complete_us = (uint32_t)boot->clock();
+    return false;
+}
+
+void HOT_PATH(Boot_MarkFirstScan)(Boot *boot) {
+    if (boot->first_scan_us == 0) {
+        boot->first_scan_us = (uint32_t)boot->clock();
+    }
+}
+
+void Boot_PrintReport(Boot *boot) {
+    printf("Phase           Start(us)  Time(us)\n");
+    for (uint8_t i = 0; i < boot->phase_count; i++) {
+        Boot_Phase *phase = &boot->phases[i];
+        printf("%-14s %c %8lu  %8lu\n", phase->name, phase->deferred ? '*' : ' ',
+               (unsigned long)phase->start_us, (unsigned long)phase->duration_us);
+    }
+    printf("First scan: %luus, boot complete: %luus (* deferred)\n",
+           (unsigned long)boot->first_scan_us, (unsigned long)boot->complete_us);
+}
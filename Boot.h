@@ -0,0 +1,73 @@
+/*
+ *
+ *  Boot Sequencer
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _BOOT_H
+#define _BOOT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Only what is needed to scan keys runs before the scheduler starts. Everything else
+// (display, storage, diagnostics) is queued as deferred steps, run one per release of a
+// low priority task so scans carry on in between. A step that would block for long (SD card
+// power up) returns false and is run again on the next release until it is done.
+// Every phase is timed from reset
+
+#define BOOT_MAX_PHASES     16
+#define BOOT_MAX_DEFERRED   8
+
+// Microseconds since reset
+typedef uint64_t (*Boot_ClockFunction)(void);
+// Returns true when done, false to be run again on the next release
+typedef bool (*Boot_StepFunction)(void *context);
+
+typedef struct {
+    const char *name;
+    uint32_t start_us;
+    uint32_t duration_us;
+    bool deferred;
+} Boot_Phase;
+
+typedef struct {
+    const char *name;
+    Boot_StepFunction function;
+    void *context;
+} Boot_Step;
+
+typedef struct {
+    Boot_ClockFunction clock;
+    Boot_Phase phases[BOOT_MAX_PHASES];
+    uint8_t phase_count;
+    Boot_Step deferred[BOOT_MAX_DEFERRED];
+    uint8_t deferred_count;
+    uint8_t deferred_next;
+    Boot_Phase *deferred_phase; // Phase of a step that isn't done yet, timed start to finish
+    bool deferred_running;
+    uint32_t first_scan_us; // 0 until the first key scan
+    uint32_t complete_us;   // 0 until the last deferred step
+} Boot;
+
+void Boot_Initialise(Boot *boot, Boot_ClockFunction clock);
+
+// Times the code between Begin and End as a phase
+void Boot_Begin(Boot *boot, const char *name);
+void Boot_End(Boot *boot);
+
+// Queues a step for the background. Returns false if the queue is full
+bool Boot_Defer(Boot *boot, const char *name, Boot_StepFunction function, void *context);
+// Runs the next deferred step. Returns true while steps remain
+bool Boot_RunDeferred(Boot *boot);
+
+// Called by the scan task, only the first call is recorded
+void Boot_MarkFirstScan(Boot *boot);
+
+void Boot_PrintReport(Boot *boot);
+#endif
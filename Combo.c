@@ -0,0 +1,213 @@
+/*
+ *
+ *  Combo/Chord Engine
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+// A press of a key that belongs to any combo is held while the engine looks ahead at the
+// presses that follow it. The chord resolves as soon as it exactly matches a combo that
+// no longer combo could extend, or when the window expires / a release or unrelated key
+// interrupts it, in which case the longest matching prefix wins. Member presses after the
+// first are flagged consumed in place, the first becomes the synthetic combo press
+#include <string.h>
+#include "Combo.h"
+#include "HotPath.h"
+
+static inline uint32_t Combo_Hash(uint32_t keys) {
+    return (keys * 0x9E3779B1u) >> (32 - COMBO_TABLE_BITS);
+}
+
+uint8_t Combo_Initialise(Combo *engine, const Combo_Definition *combos, uint16_t combo_count, uint32_t window_us) {
+    memset(engine, 0, sizeof(Combo));
+    memset(engine->table, 0xFF, sizeof(engine->table));
+    engine->combos = combos;
+    engine->window_us = window_us;
+    if (combo_count > COMBO_MAX) {
+        return 1;
+    }
+
+    for (uint16_t i = 0; i < combo_count; i++) {
+        uint32_t keys = combos[i].keys;
+        if (__builtin_popcount(keys) < 2 || Combo_Lookup(engine, keys) >= 0) {
+            return 1;
+        }
+        uint32_t slot = Combo_Hash(keys);
+        while (engine->table[slot] >= 0) {
+            slot = (slot + 1) & (COMBO_TABLE_SIZE - 1);
+        }
+        engine->table[slot] = i;
+        engine->combo_keys |= keys;
+        while (keys) {
+            uint8_t key = __builtin_ctz(keys);
+            keys &= keys - 1;
+            engine->key_combos[key][i / 32] |= 1u << (i % 32);
+        }
+        engine->combo_count++;
+    }
+    return 0;
+}
+
+void Combo_Attach(Combo *engine, KeyPipeline *pipe, uint8_t stage) {
+    engine->pipe = pipe;
+    engine->stage = stage;
+}
+
+void HOT_PATH(Combo_SetTime)(Combo *engine, uint32_t now_us) {
+    engine->now_us = now_us;
+}
+
+int16_t HOT_PATH(Combo_Lookup)(Combo *engine, uint32_t keys) {
+    uint32_t slot = Combo_Hash(keys);
+    while (engine->table[slot] >= 0) {
+        if (engine->combos[engine->table[slot]].keys == keys) {
+            return engine->table[slot];
+        }
+        slot = (slot + 1) & (COMBO_TABLE_SIZE - 1);
+    }
+    return -1;
+}
+
+// True if any candidate other than <exact> is left, i.e. a longer combo is still possible
+static bool HOT_PATH(Combo_HasLarger)(const uint32_t *candidates, int16_t exact) {
+    for (uint8_t i = 0; i < COMBO_SET_WORDS; i++) {
+        uint32_t word = candidates[i];
+        if (exact >= 0 && exact / 32 == i) {
+            word &= ~(1u << (exact % 32));
+        }
+        if (word) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool HOT_PATH(Combo_Release)(Combo *engine, KeyEvent *event, uint32_t bit) {
+    for (uint8_t i = 0; i < COMBO_MAX_ACTIVE; i++) {
+        Combo_Active *active = &engine->active[i];
+        if (!(active->held & bit)) {
+            continue;
+        }
+        const Combo_Definition *combo = &engine->combos[active->combo];
+        active->held &= ~bit;
+        engine->active_keys &= ~bit;
+
+        bool send = combo->release_rule == COMBO_RELEASE_ANY ? !active->released : active->held == 0;
+        if (send) {
+            event->keycode = combo->keycode;
+            event->flags |= KEYEVENT_FLAG_SYNTHETIC;
+            active->released = true;
+        }
+        else {
+            event->flags |= KEYEVENT_FLAG_CONSUMED;
+        }
+        break;
+    }
+    return true;
+}
+
+static bool HOT_PATH(Combo_Fire)(Combo *engine, KeyEvent *event, int16_t index, const uint8_t *member_offsets, uint8_t members) {
+    const Combo_Definition *combo = &engine->combos[index];
+    Combo_Active *slot = NULL;
+    for (uint8_t i = 0; i < COMBO_MAX_ACTIVE; i++) {
+        if (engine->active[i].held == 0) {
+            slot = &engine->active[i];
+            break;
+        }
+    }
+    if (slot == NULL) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < members; i++) {
+        KeyPipeline_Lookahead(engine->pipe, engine->stage, member_offsets[i])->flags |= KEYEVENT_FLAG_CONSUMED;
+    }
+    event->keycode = combo->keycode;
+    event->flags |= KEYEVENT_FLAG_SYNTHETIC;
+    slot->combo = index;
+    slot->held = combo->keys;
+    slot->released = false;
+    engine->active_keys |= combo->keys;
+    engine->fired++;
+    return true;
+}
+
+bool HOT_PATH(Combo_Stage)(void *context, KeyEvent *event) {
+    Combo *engine = (Combo *)context;
+    if ((event->flags & KEYEVENT_FLAG_CONSUMED) || event->key >= COMBO_MAX_KEYS) {
+        return true;
+    }
+    uint32_t bit = 1u << event->key;
+    if (event->edge == KEYEVENT_RELEASE) {
+        return (engine->active_keys & bit) ? Combo_Release(engine, event, bit) : true;
+    }
+    if (!(engine->combo_keys & bit) || (engine->active_keys & bit)) {
+        return true; // Fast path, key isn't in any combo
+    }
+
+    uint32_t candidates[COMBO_SET_WORDS];
+    memcpy(candidates, engine->key_combos[event->key], sizeof(candidates));
+    uint32_t pending = bit;
+    uint8_t offsets[COMBO_MAX_KEYS];
+    uint8_t count = 0;
+    int16_t best = -1;
+    uint8_t best_count = 0;
+    bool decided = false;
+
+    for (uint32_t offset = 1; ; offset++) {
+        KeyEvent *next = KeyPipeline_Lookahead(engine->pipe, engine->stage, offset);
+        if (next == NULL) {
+            break;
+        }
+        if (next->flags & KEYEVENT_FLAG_CONSUMED) {
+            continue; // Member of an earlier combo
+        }
+        if ((uint32_t)(next->timestamp_us - event->timestamp_us) > engine->window_us) {
+            decided = true;
+            break;
+        }
+        uint32_t next_bit = next->key < COMBO_MAX_KEYS ? 1u << next->key : 0;
+        if (next->edge != KEYEVENT_PRESS || (pending & next_bit) || !(engine->combo_keys & next_bit) || (engine->active_keys & next_bit)) {
+            decided = true; // Release or unrelated key ends the chord
+            break;
+        }
+
+        uint32_t any = 0;
+        for (uint8_t i = 0; i < COMBO_SET_WORDS; i++) {
+            candidates[i] &= engine->key_combos[next->key][i];
+            any |= candidates[i];
+        }
+        if (!any) {
+            decided = true;
+            break;
+        }
+        pending |= next_bit;
+        offsets[count++] = offset;
+        int16_t exact = Combo_Lookup(engine, pending);
+        if (exact >= 0) {
+            best = exact;
+            best_count = count;
+        }
+    }
+
+    if (!decided && (uint32_t)(engine->now_us - event->timestamp_us) > engine->window_us) {
+        decided = true;
+        engine->timeouts++;
+    }
+    if (!decided) {
+        // Fire early when nothing longer can match, otherwise wait for more keys
+        if (best >= 0 && best_count == count && !Combo_HasLarger(candidates, best)) {
+            Combo_Fire(engine, event, best, offsets, best_count);
+            return true;
+        }
+        return false;
+    }
+    if (best >= 0) {
+        Combo_Fire(engine, event, best, offsets, best_count);
+    }
+    return true;
+}
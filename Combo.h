@@ -0,0 +1,83 @@
+/*
+ *
+ *  Combo/Chord Engine
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _COMBO_H
+#define _COMBO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "KeyPipeline.h"
+
+// Pipeline stage that runs before the keymap. Keys pressed within the window that form a
+// combo are replaced by a single synthetic press carrying the combo keycode. Combos are
+// found by hashing the pressed key bitmask, and a per key bitset of the combos containing
+// each key prunes candidates, so cost doesn't grow with the number of combos
+
+#define COMBO_MAX               256
+#define COMBO_TABLE_BITS        9
+#define COMBO_TABLE_SIZE        (1 << COMBO_TABLE_BITS) // At least twice COMBO_MAX
+#define COMBO_MAX_KEYS          32
+#define COMBO_MAX_ACTIVE        8
+#define COMBO_SET_WORDS         (COMBO_MAX / 32)
+#define COMBO_DEFAULT_WINDOW_US 50000
+
+typedef enum {
+    COMBO_RELEASE_ANY = 0, // Combo released with the first member key
+    COMBO_RELEASE_ALL,     // Combo held until every member key is up
+} Combo_ReleaseRule;
+
+typedef struct {
+    uint32_t keys; // Bitmask of physical keys, at least two
+    uint16_t keycode;
+    uint8_t release_rule;
+} Combo_Definition;
+
+typedef struct {
+    uint16_t combo;
+    uint32_t held; // Member keys still down
+    bool released; // Combo release already sent
+} Combo_Active;
+
+typedef struct {
+    KeyPipeline *pipe;
+    uint8_t stage;
+    uint32_t window_us;
+    uint32_t now_us;
+
+    const Combo_Definition *combos;
+    uint16_t combo_count;
+    int16_t table[COMBO_TABLE_SIZE]; // Key bitmask hash -> combo index, -1 empty
+    uint32_t key_combos[COMBO_MAX_KEYS][COMBO_SET_WORDS];
+    uint32_t combo_keys; // Keys in at least one combo
+
+    Combo_Active active[COMBO_MAX_ACTIVE];
+    uint32_t active_keys;
+
+    // Statistics
+    uint32_t fired;
+    uint32_t timeouts;
+} Combo;
+
+// <combos> must stay valid, typically a const table in flash. Returns 1 if a definition is
+// invalid or duplicated, or there are more than COMBO_MAX
+uint8_t Combo_Initialise(Combo *engine, const Combo_Definition *combos, uint16_t combo_count, uint32_t window_us);
+
+// Must be called with the id returned by KeyPipeline_AddStage, the engine looks ahead in the ring
+void Combo_Attach(Combo *engine, KeyPipeline *pipe, uint8_t stage);
+
+// Time used to expire a pending chord when no further events arrive
+void Combo_SetTime(Combo *engine, uint32_t now_us);
+
+// Index of the combo with exactly <keys>, or -1
+int16_t Combo_Lookup(Combo *engine, uint32_t keys);
+
+bool Combo_Stage(void *context, KeyEvent *event);
+#endif
@@ -0,0 +1,113 @@
+/*
+ *
+ *  Display Compositor
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "Compositor.h"
+
+void Compositor_Initialise(Compositor *comp, SSD1306 *dev, uint32_t frame_period_us) {
+    memset(comp, 0, sizeof(Compositor));
+    comp->dev = dev;
+    comp->frame_period_us = frame_period_us;
+}
+
+static bool Compositor_Overlaps(const Compositor_Rect *a, const Compositor_Rect *b) {
+    return a->x < b->x + b->width && b->x < a->x + a->width &&
+           a->page < b->page + b->pages && b->page < a->page + a->pages;
+}
+
+int Compositor_AddWidget(Compositor *comp, const Compositor_Rect *rect, Compositor_RenderFunction render, void *context) {
+    if (comp->widget_count >= COMPOSITOR_MAX_WIDGETS || rect->width == 0 || rect->pages == 0 ||
+        rect->x + rect->width > comp->dev->width || rect->page + rect->pages > comp->dev->pages) {
+        return -1;
+    }
+    for (uint8_t i = 0; i < comp->widget_count; i++) {
+        if (Compositor_Overlaps(rect, &comp->widgets[i].rect)) {
+            return -1;
+        }
+    }
+    Compositor_Widget *widget = &comp->widgets[comp->widget_count];
+    widget->rect = *rect;
+    widget->render = render;
+    widget->context = context;
+    widget->invalid = true;
+    return comp->widget_count++;
+}
+
+void Compositor_Invalidate(Compositor *comp, int id) {
+    if (id >= 0 && id < comp->widget_count) {
+        comp->widgets[id].invalid = true;
+    }
+}
+
+void Compositor_InvalidateAll(Compositor *comp) {
+    for (uint8_t i = 0; i < comp->widget_count; i++) {
+        comp->widgets[i].invalid = true;
+    }
+}
+
+void Compositor_SetEnabled(Compositor *comp, bool enabled) {
+    if (enabled) {
+        Compositor_InvalidateAll(comp);
+    }
+    comp->enabled = enabled;
+}
+
+bool Compositor_Pending(const Compositor *comp) {
+    if (!comp->enabled) {
+        return false;
+    }
+    for (uint8_t i = 0; i < comp->widget_count; i++) {
+        if (comp->widgets[i].invalid) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t Compositor_WaitUs(const Compositor *comp, uint32_t now_us) {
+    uint32_t elapsed = now_us - comp->last_frame_us;
+    if (comp->frames == 0 || elapsed >= comp->frame_period_us) {
+        return 0;
+    }
+    return comp->frame_period_us - elapsed;
+}
+
+uint32_t Compositor_Update(Compositor *comp, uint32_t now_us) {
+    if (!Compositor_Pending(comp) || Compositor_WaitUs(comp, now_us) > 0) {
+        return 0;
+    }
+    SSD1306 *dev = comp->dev;
+    uint32_t bytes = 0;
+    for (uint8_t i = 0; i < comp->widget_count; i++) {
+        Compositor_Widget *widget = &comp->widgets[i];
+        if (!widget->invalid) {
+            continue;
+        }
+        widget->invalid = false;
+        const Compositor_Rect *rect = &widget->rect;
+        for (uint8_t page = rect->page; page < rect->page + rect->pages; page++) {
+            memset(&dev->buffer[page * dev->width + rect->x], 0, rect->width);
+        }
+        widget->render(widget->context, dev, rect);
+        bytes += SSD1306_FlushRegion(dev, rect->x, rect->width, rect->page, rect->pages);
+        comp->regions++;
+    }
+    comp->last_frame_us = now_us;
+    comp->frames++;
+    comp->bytes += bytes;
+    return bytes;
+}
+
+void Compositor_PrintStats(const Compositor *comp) {
+    printf("Compositor %s, %u widgets, %lu frames, %lu regions, %lu bytes flushed\n", comp->enabled ? "on" : "off",
+           comp->widget_count, (unsigned long)comp->frames, (unsigned long)comp->regions, (unsigned long)comp->bytes);
+}
@@ -0,0 +1,81 @@
+/*
+ *
+ *  Display Compositor
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _COMPOSITOR_H
+#define _COMPOSITOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "SSD1306.h"
+
+// Widgets each own a page aligned rectangle of the SSD1306 back buffer. Marking one invalid
+// is a flag write, safe from the other core. An update clears and redraws only the invalid
+// rectangles and flushes each one on its own (SSD1306_FlushRegion), so the cost of a frame
+// follows the area that changed. Updates are capped at one per frame period.
+// The flag is cleared before the widget draws, so a change made while it draws is picked
+// up by the next frame
+
+#define COMPOSITOR_MAX_WIDGETS          8
+#define COMPOSITOR_DEFAULT_FRAME_US     50000 // 20 frames per second
+
+typedef struct {
+    uint8_t x;
+    uint8_t width;
+    uint8_t page;
+    uint8_t pages;
+} Compositor_Rect;
+
+// Draws into <rect> of the back buffer, which has been cleared. Must stay inside it
+typedef void (*Compositor_RenderFunction)(void *context, SSD1306 *dev, const Compositor_Rect *rect);
+
+typedef struct {
+    Compositor_Rect rect;
+    Compositor_RenderFunction render;
+    void *context;
+    volatile bool invalid;
+} Compositor_Widget;
+
+typedef struct {
+    SSD1306 *dev;
+    Compositor_Widget widgets[COMPOSITOR_MAX_WIDGETS];
+    uint8_t widget_count;
+    volatile bool enabled;
+    uint32_t frame_period_us;
+    uint32_t last_frame_us;
+    // Statistics
+    uint32_t frames;
+    uint32_t regions;
+    uint32_t bytes;
+} Compositor;
+
+void Compositor_Initialise(Compositor *comp, SSD1306 *dev, uint32_t frame_period_us);
+
+// Returns the widget id, or -1 if the rectangle is off the panel, overlaps another widget
+// or there is no slot left. Widgets start invalid
+int Compositor_AddWidget(Compositor *comp, const Compositor_Rect *rect, Compositor_RenderFunction render, void *context);
+
+// Any core
+void Compositor_Invalidate(Compositor *comp, int id);
+void Compositor_InvalidateAll(Compositor *comp);
+
+// Nothing is drawn while disabled, enabling redraws every widget (the display had another owner)
+void Compositor_SetEnabled(Compositor *comp, bool enabled);
+
+// True if an enabled compositor has an invalid widget
+bool Compositor_Pending(const Compositor *comp);
+// Microseconds until the next frame may go, 0 if now
+uint32_t Compositor_WaitUs(const Compositor *comp, uint32_t now_us);
+
+// Redraws and flushes the invalid widgets if a frame is due. Returns bus bytes used
+uint32_t Compositor_Update(Compositor *comp, uint32_t now_us);
+
+void Compositor_PrintStats(const Compositor *comp);
+#endif
@@ -0,0 +1,88 @@
+/*
+ *
+ *  Serial Command Console
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "Console.h"
+
+void Console_Initialise(Console *console) {
+    memset(console, 0, sizeof(Console));
+}
+
+bool Console_AddCommand(Console *console, const char *name, const char *help, Console_CommandFunction function, void *context) {
+    if (console->command_count >= CONSOLE_MAX_COMMANDS || function == NULL) {
+        return false;
+    }
+    Console_Command *command = &console->commands[console->command_count++];
+    command->name = name;
+    command->help = help;
+    command->function = function;
+    command->context = context;
+    return true;
+}
+
+static void Console_Execute(Console *console) {
+    char *name = console->line;
+    while (*name == ' ') {
+        name++;
+    }
+    if (*name == '\0') {
+        return;
+    }
+    char *arguments = name;
+    while (*arguments && *arguments != ' ') {
+        arguments++;
+    }
+    if (*arguments) {
+        *arguments++ = '\0';
+        while (*arguments == ' ') {
+            arguments++;
+        }
+    }
+
+    if (strcmp(name, "help") == 0) {
+        for (uint8_t i = 0; i < console->command_count; i++) {
+            printf("%-10s %s\n", console->commands[i].name, console->commands[i].help ? console->commands[i].help : "");
+        }
+        return;
+    }
+    for (uint8_t i = 0; i < console->command_count; i++) {
+        if (strcmp(name, console->commands[i].name) == 0) {
+            console->commands[i].function(console->commands[i].context, arguments);
+            return;
+        }
+    }
+    printf("Unknown command '%s', try help\n", name);
+}
+
+void Console_Feed(Console *console, char c) {
+    if (c == '\r' || c == '\n') {
+        if (console->length == 0) {
+            return; // Second half of \r\n
+        }
+        putchar('\n');
+        console->line[console->length] = '\0';
+        console->length = 0;
+        Console_Execute(console);
+        return;
+    }
+    if (c == '\b' || c == 0x7F) {
+        if (console->length) {
+            console->length--;
+            printf("\b \b");
+        }
+        return;
+    }
+    if (c >= ' ' && console->length < CONSOLE_LINE_LENGTH - 1) {
+        console->line[console->length++] = c;
+        putchar(c);
+    }
+}
@@ -0,0 +1,49 @@
+/*
+ *
+ *  Serial Command Console
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _CONSOLE_H
+#define _CONSOLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Line based commands for diagnostics that are too slow or noisy to run at boot.
+// Characters are fed in as they arrive, the command runs when the line ends.
+// "help" lists the registered commands
+
+#define CONSOLE_MAX_COMMANDS    16
+#define CONSOLE_LINE_LENGTH     48
+
+// <arguments> is the rest of the line after the command name, never NULL
+typedef void (*Console_CommandFunction)(void *context, const char *arguments);
+
+typedef struct {
+    const char *name;
+    const char *help;
+    Console_CommandFunction function;
+    void *context;
+} Console_Command;
+
+typedef struct {
+    Console_Command commands[CONSOLE_MAX_COMMANDS];
+    uint8_t command_count;
+    char line[CONSOLE_LINE_LENGTH];
+    uint8_t length;
+} Console;
+
+void Console_Initialise(Console *console);
+
+// Returns false if the table is full
+bool Console_AddCommand(Console *console, const char *name, const char *help, Console_CommandFunction function, void *context);
+
+// Feeds one received character, echoing it back
+void Console_Feed(Console *console, char c);
+#endif
@@ -0,0 +1,63 @@
+/*
+ *
+ *  Key Debounce
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#include <string.h>
+#include "Debounce.h"
+#include "HotPath.h"
+
+void Debounce_Initialise(Debounce *db, uint32_t window_us) {
+    memset(db, 0, sizeof(Debounce));
+    db->window_us = window_us;
+}
+
+uint8_t HOT_PATH(Debounce_Update)(Debounce *db, KeyPipeline *pipe, uint8_t source, uint16_t raw, uint32_t now_us) {
+    uint8_t pushed = 0;
+    if (source >= DEBOUNCE_MAX_SOURCES) {
+        return 0;
+    }
+
+    // Expire windows
+    uint16_t locked = db->locked[source];
+    while (locked) {
+        uint8_t bit = __builtin_ctz(locked);
+        locked &= locked - 1;
+        if ((int32_t)(now_us - db->unlock_at_us[source][bit]) >= 0) {
+            db->locked[source] &= ~(1 << bit);
+        }
+    }
+
+    // Raw transitions on locked keys are bounce
+    uint16_t bounced = (raw ^ db->raw[source]) & db->locked[source];
+    db->raw[source] = raw;
+    while (bounced) {
+        uint8_t bit = __builtin_ctz(bounced);
+        bounced &= bounced - 1;
+        if (db->chatter[source][bit] != UINT16_MAX) {
+            db->chatter[source][bit]++;
+        }
+    }
+
+    // Report edges on unlocked keys, lowest pin first
+    uint16_t accept = (raw ^ db->state[source]) & ~db->locked[source];
+    while (accept) {
+        uint8_t bit = __builtin_ctz(accept);
+        accept &= accept - 1;
+        uint8_t edge = (raw >> bit) & 1 ? KEYEVENT_PRESS : KEYEVENT_RELEASE;
+        if (!KeyPipeline_Push(pipe, source * DEBOUNCE_KEYS_PER_SOURCE + bit, edge, source, now_us)) {
+            break; // State left as is so the edge is picked up next sample
+        }
+        db->state[source] ^= 1 << bit;
+        db->locked[source] |= 1 << bit;
+        db->unlock_at_us[source][bit] = now_us + db->window_us;
+        pushed++;
+    }
+    return pushed;
+}
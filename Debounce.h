@@ -0,0 +1,42 @@
+/*
+ *
+ *  Key Debounce
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _DEBOUNCE_H
+#define _DEBOUNCE_H
+
+#include <stdint.h>
+#include "KeyPipeline.h"
+
+// Eager debounce, first stage of the key pipeline. An edge is reported as soon as it is
+// seen, then the key is locked out for the window. Bounces inside the window are counted
+// as chatter, and if the key ends the window in a different state that edge follows
+
+#ifndef DEBOUNCE_MAX_SOURCES
+#define DEBOUNCE_MAX_SOURCES        2 // Set per profile by the build
+#endif
+#define DEBOUNCE_KEYS_PER_SOURCE    16
+#define DEBOUNCE_DEFAULT_WINDOW_US  5000
+
+typedef struct {
+    uint32_t window_us;
+    uint16_t state[DEBOUNCE_MAX_SOURCES];   // Debounced, 1 = pressed
+    uint16_t raw[DEBOUNCE_MAX_SOURCES];     // Last sample
+    uint16_t locked[DEBOUNCE_MAX_SOURCES];  // Keys inside their window
+    uint32_t unlock_at_us[DEBOUNCE_MAX_SOURCES][DEBOUNCE_KEYS_PER_SOURCE];
+    uint16_t chatter[DEBOUNCE_MAX_SOURCES][DEBOUNCE_KEYS_PER_SOURCE];
+} Debounce;
+
+void Debounce_Initialise(Debounce *db, uint32_t window_us);
+
+// Feeds one sample of <source> (bit set = pressed) taken at <now_us>, pushing any edges into <pipe>.
+// Edges that don't fit in the ring are retried on the next sample. Returns the number pushed
+uint8_t Debounce_Update(Debounce *db, KeyPipeline *pipe, uint8_t source, uint16_t raw, uint32_t now_us);
+#endif
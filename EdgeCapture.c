@@ -0,0 +1,36 @@
+/*
+ *
+ *  Expander Edge Capture
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#include <string.h>
+#include "EdgeCapture.h"
+#include "HotPath.h"
+
+void EdgeCapture_Initialise(EdgeCapture *cap) {
+    memset(cap, 0, sizeof(EdgeCapture));
+}
+
+uint8_t HOT_PATH(EdgeCapture_Decode)(EdgeCapture *cap, uint8_t source, uint16_t flags, uint16_t capture, uint16_t io, uint16_t samples[2]) {
+    uint8_t count = 0;
+    uint16_t last = cap->last[source];
+    // Each port latches on its own, INTCAP is stale for a port with nothing in INTF
+    uint16_t latched = ((flags & 0xFF00) ? 0xFF00 : 0x0000) | ((flags & 0x00FF) ? 0x00FF : 0x0000);
+    capture = (capture & latched) | (last & ~latched);
+    if (capture != last) {
+        samples[count++] = capture;
+        cap->captures++;
+        for (uint16_t gone = (capture ^ last) & (capture ^ io); gone != 0; gone &= gone - 1) {
+            cap->recovered++;
+        }
+    }
+    samples[count++] = io;
+    cap->last[source] = io;
+    return count;
+}
@@ -0,0 +1,39 @@
+/*
+ *
+ *  Expander Edge Capture
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _EDGECAPTURE_H
+#define _EDGECAPTURE_H
+
+#include <stdint.h>
+
+// Turns one INTF/INTCAP/GPIO burst (MCP23017_ReadCapture) into ordered samples for the
+// debouncer. The expander latches INTCAP on the first change after the last read, so a
+// tap that starts and ends between two reads still shows up there even though GPIO is
+// back to where it was. Feeding INTCAP (timed at the interrupt) before GPIO (timed at the
+// read) gives the press and the release in order. Changes after the first one are only
+// seen through GPIO, which is why the reads are also triggered from the INT line.
+// Portable, no SDK dependencies
+
+#define EDGECAPTURE_MAX_SOURCES     2
+
+typedef struct {
+    uint16_t last[EDGECAPTURE_MAX_SOURCES]; // Last sample handed on
+    // Statistics
+    uint32_t captures;  // Reads where INTCAP added a sample
+    uint32_t recovered; // Key changes only seen in INTCAP, GPIO had already gone back
+} EdgeCapture;
+
+void EdgeCapture_Initialise(EdgeCapture *cap);
+
+// <flags>, <capture> and <io> must already be masked to the keys. Writes the samples to
+// feed in order into <samples>, INTCAP first if it holds a change, and returns 1 or 2
+uint8_t EdgeCapture_Decode(EdgeCapture *cap, uint8_t source, uint16_t flags, uint16_t capture, uint16_t io, uint16_t samples[2]);
+#endif
@@ -0,0 +1,131 @@
+/*
+ *
+ *  Rotary Encoder Quadrature Decoder
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#include <string.h>
+#include "Encoder.h"
+#include "HotPath.h"
+
+// Indexed by previous state << 2 | current state, states are A | B << 1.
+// Clockwise (A leads B) is 0 -> 1 -> 3 -> 2 -> 0
+static const int8_t encoder_transition[16] = {
+     0, +1, -1,  0,
+    -1,  0,  0, +1,
+    +1,  0,  0, -1,
+     0, -1, +1,  0,
+};
+// Both pins changed between samples (0<->3, 1<->2), direction unknown
+#define ENCODER_INVALID_TRANSITIONS 0x1248
+
+const Encoder_AccelerationStep Encoder_DefaultCurve[] = {
+    {10000, 8},
+    {25000, 4},
+    {50000, 2},
+};
+const uint8_t Encoder_DefaultCurveLength = sizeof(Encoder_DefaultCurve) / sizeof(Encoder_DefaultCurve[0]);
+
+void Encoder_Initialise(Encoder *enc, uint8_t ab, uint8_t key_cw, uint8_t key_ccw, uint8_t steps_per_detent) {
+    memset(enc, 0, sizeof(Encoder));
+    enc->state = ab & 0x03;
+    enc->key_cw = key_cw;
+    enc->key_ccw = key_ccw;
+    enc->steps_per_detent = steps_per_detent ? steps_per_detent : ENCODER_DEFAULT_STEPS_PER_DETENT;
+    enc->curve = Encoder_DefaultCurve;
+    enc->curve_length = Encoder_DefaultCurveLength;
+}
+
+void Encoder_SetAcceleration(Encoder *enc, const Encoder_AccelerationStep *curve, uint8_t curve_length) {
+    enc->curve = curve;
+    enc->curve_length = curve ? curve_length : 0;
+}
+
+void HOT_PATH(Encoder_Decode)(Encoder *enc, uint8_t ab) {
+    uint8_t index = (enc->state << 2) | (ab & 0x03);
+    enc->state = ab & 0x03;
+    if ((ENCODER_INVALID_TRANSITIONS >> index) & 1) {
+        enc->errors++;
+        return;
+    }
+    // A detent only counts once a full cycle has been made in one direction, so jitter
+    // around the rest position never produces a step
+    enc->sub_steps += encoder_transition[index];
+    if (enc->sub_steps >= enc->steps_per_detent) {
+        enc->sub_steps -= enc->steps_per_detent;
+        enc->detents++;
+    }
+    else if (enc->sub_steps <= -enc->steps_per_detent) {
+        enc->sub_steps += enc->steps_per_detent;
+        enc->detents--;
+    }
+}
+
+int32_t HOT_PATH(Encoder_TakeDetents)(Encoder *enc) {
+    // Only the decoder writes detents and a 32 bit read is atomic, so no lock is needed
+    int32_t detents = enc->detents;
+    int32_t delta = detents - enc->detents_taken;
+    enc->detents_taken = detents;
+    return delta;
+}
+
+static uint8_t HOT_PATH(Encoder_Multiplier)(Encoder *enc, uint32_t interval_us) {
+    for (uint8_t i = 0; i < enc->curve_length; i++) {
+        if (interval_us < enc->curve[i].interval_us) {
+            return enc->curve[i].multiplier;
+        }
+    }
+    return 1;
+}
+
+bool HOT_PATH(Encoder_Update)(Encoder *enc, KeyPipeline *pipe, uint32_t now_us) {
+    int32_t delta = Encoder_TakeDetents(enc);
+    if (delta != 0) {
+        uint32_t steps = delta > 0 ? delta : -delta;
+        int8_t direction = delta > 0 ? 1 : -1;
+        uint8_t multiplier = 1;
+        if (direction != enc->direction) {
+            // Turned back, acceleration starts over and whatever was still queued the other way is stale
+            enc->pending_taps = 0;
+            enc->direction = direction;
+        }
+        else {
+            multiplier = Encoder_Multiplier(enc, (now_us - enc->last_move_us) / steps);
+        }
+        enc->last_move_us = now_us;
+
+        int32_t pending = enc->pending_taps + delta * multiplier;
+        if (pending > ENCODER_MAX_PENDING_TAPS) {
+            pending = ENCODER_MAX_PENDING_TAPS;
+        }
+        else if (pending < -ENCODER_MAX_PENDING_TAPS) {
+            pending = -ENCODER_MAX_PENDING_TAPS;
+        }
+        enc->pending_taps = pending;
+    }
+
+    while (enc->tap_pressed || enc->pending_taps != 0) {
+        if (enc->tap_pressed) {
+            uint8_t key = enc->tap_key;
+            if (!KeyPipeline_Push(pipe, key, KEYEVENT_RELEASE, ENCODER_EVENT_SOURCE, now_us)) {
+                break;
+            }
+            enc->tap_pressed = false;
+            continue;
+        }
+        // Only start a tap if its release fits too
+        if (KeyPipeline_Free(pipe) < 2) {
+            break;
+        }
+        enc->tap_key = enc->pending_taps > 0 ? enc->key_cw : enc->key_ccw;
+        KeyPipeline_Push(pipe, enc->tap_key, KEYEVENT_PRESS, ENCODER_EVENT_SOURCE, now_us);
+        enc->tap_pressed = true;
+        enc->pending_taps += enc->pending_taps > 0 ? -1 : 1;
+    }
+    return delta != 0;
+}
@@ -0,0 +1,72 @@
+/*
+ *
+ *  Rotary Encoder Quadrature Decoder
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _ENCODER_H
+#define _ENCODER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "KeyPipeline.h"
+
+// Samples are the A/B pin pair packed as A | B << 1, from native pins (PIO or GPIO IRQ) or
+// spare expander pins. Each transition is looked up in a table indexed by previous and
+// current state, so contact bounce cancels itself out (+1 then -1) and a skipped state
+// (both pins changed) is counted as an error rather than guessed at.
+// Detents are turned into taps of a virtual key, pushed into the key pipeline so the keymap
+// decides what they do (volume, scroll, ...) per layer
+
+#define ENCODER_DEFAULT_STEPS_PER_DETENT    4
+#define ENCODER_MAX_PENDING_TAPS            32 // Taps beyond this are dropped rather than queued
+#define ENCODER_EVENT_SOURCE                0x10 // KeyEvent source, expanders are 0 and up
+
+typedef struct {
+    uint32_t interval_us; // Detents closer together than this...
+    uint8_t multiplier;   // ...count this many times
+} Encoder_AccelerationStep;
+
+typedef struct {
+    // Decoder, written from the sample side (possibly an IRQ)
+    uint8_t state;
+    int8_t sub_steps;
+    volatile int32_t detents;
+    volatile uint32_t errors; // Invalid transitions
+
+    // Output side
+    uint8_t steps_per_detent;
+    uint8_t key_cw;
+    uint8_t key_ccw;
+    int32_t detents_taken;
+    int32_t pending_taps; // Positive clockwise
+    uint8_t tap_key;
+    bool tap_pressed;     // Press of the current tap is in the pipeline, release not yet
+    int8_t direction;     // Of the last move, 0 before the first
+    uint32_t last_move_us;
+    const Encoder_AccelerationStep *curve; // Fastest step first, may be NULL
+    uint8_t curve_length;
+} Encoder;
+
+extern const Encoder_AccelerationStep Encoder_DefaultCurve[];
+extern const uint8_t Encoder_DefaultCurveLength;
+
+// <ab> is the current pin state. <key_cw>/<key_ccw> are the virtual keys tapped per detent
+void Encoder_Initialise(Encoder *enc, uint8_t ab, uint8_t key_cw, uint8_t key_ccw, uint8_t steps_per_detent);
+void Encoder_SetAcceleration(Encoder *enc, const Encoder_AccelerationStep *curve, uint8_t curve_length);
+
+// Feeds one A/B sample. Safe to call from an interrupt with Encoder_Update on the main loop
+void Encoder_Decode(Encoder *enc, uint8_t ab);
+
+// Net detents since the last call, positive clockwise, before acceleration
+int32_t Encoder_TakeDetents(Encoder *enc);
+
+// Applies acceleration to new detents and pushes as many queued taps as fit into <pipe>.
+// Returns true if the encoder moved
+bool Encoder_Update(Encoder *enc, KeyPipeline *pipe, uint32_t now_us);
+#endif
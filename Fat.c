@@ -0,0 +1,439 @@
+/*
+ *
+ *  FAT16/FAT32 Filesystem (read only)
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#include <string.h>
+#include <ctype.h>
+#include "Fat.h"
+
+#define FAT_ENTRY_SIZE          32
+#define FAT_ENTRIES_PER_SECTOR  (BLOCKDEVICE_SECTOR_SIZE / FAT_ENTRY_SIZE)
+#define FAT_LFN_CHARS           13
+#define FAT_ENTRY_END           0x00
+#define FAT_ENTRY_DELETED       0xE5
+
+// Character offsets within a long name entry, UCS-2
+static const uint8_t fat_lfn_offsets[FAT_LFN_CHARS] = {1, 3, 5, 7, 9, 14, 16, 18, 20, 22, 24, 28, 30};
+
+static uint16_t Fat_Read16(const uint8_t *data) {
+    return data[0] | (data[1] << 8);
+}
+
+static uint32_t Fat_Read32(const uint8_t *data) {
+    return data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static bool Fat_IsBootSector(const uint8_t *sector) {
+    uint8_t sectors_per_cluster = sector[13];
+    return (sector[0] == 0xEB || sector[0] == 0xE9)
+        && Fat_Read16(sector + 11) == BLOCKDEVICE_SECTOR_SIZE
+        && sectors_per_cluster != 0 && (sectors_per_cluster & (sectors_per_cluster - 1)) == 0
+        && sector[16] != 0
+        && sector[510] == 0x55 && sector[511] == 0xAA;
+}
+
+int Fat_Mount(Fat_Volume *volume, SectorCache *cache) {
+    uint8_t *sector;
+    uint32_t start = 0;
+    memset(volume, 0, sizeof(Fat_Volume));
+    volume->cache = cache;
+
+    if (SectorCache_Get(cache, 0, false, &sector) < 0) {
+        return FAT_ERROR_IO;
+    }
+    if (!Fat_IsBootSector(sector)) {
+        if (sector[510] != 0x55 || sector[511] != 0xAA) {
+            return FAT_ERROR_NO_FILESYSTEM;
+        }
+        // MBR, first partition only
+        const uint8_t *partition = sector + 0x1BE;
+        uint8_t type = partition[4];
+        if (type != 0x04 && type != 0x06 && type != 0x0E && type != 0x0B && type != 0x0C) {
+            return FAT_ERROR_NO_FILESYSTEM;
+        }
+        start = Fat_Read32(partition + 8);
+        if (SectorCache_Get(cache, start, false, &sector) < 0) {
+            return FAT_ERROR_IO;
+        }
+        if (!Fat_IsBootSector(sector)) {
+            return FAT_ERROR_NO_FILESYSTEM;
+        }
+    }
+
+    uint16_t reserved = Fat_Read16(sector + 14);
+    uint8_t fat_count = sector[16];
+    uint16_t root_entries = Fat_Read16(sector + 17);
+    uint32_t total = Fat_Read16(sector + 19) ? Fat_Read16(sector + 19) : Fat_Read32(sector + 32);
+    uint32_t fat_size = Fat_Read16(sector + 22) ? Fat_Read16(sector + 22) : Fat_Read32(sector + 36);
+    uint32_t root_sectors = (root_entries * FAT_ENTRY_SIZE + BLOCKDEVICE_SECTOR_SIZE - 1) / BLOCKDEVICE_SECTOR_SIZE;
+    uint32_t metadata = reserved + fat_count * fat_size + root_sectors;
+    if (fat_size == 0 || total <= metadata) {
+        return FAT_ERROR_NO_FILESYSTEM;
+    }
+
+    volume->sectors_per_cluster = sector[13];
+    volume->fat_lba = start + reserved;
+    volume->root_lba = volume->fat_lba + fat_count * fat_size;
+    volume->data_lba = volume->root_lba + root_sectors;
+    volume->cluster_count = (total - metadata) / volume->sectors_per_cluster;
+
+    // The type is decided by cluster count alone, whatever the label says
+    if (volume->cluster_count < 4085) {
+        return FAT_ERROR_NO_FILESYSTEM; // FAT12
+    }
+    else if (volume->cluster_count < 65525) {
+        volume->type = FAT_TYPE_16;
+        volume->root_entries = root_entries;
+    }
+    else {
+        volume->type = FAT_TYPE_32;
+        volume->root_cluster = Fat_Read32(sector + 44);
+    }
+    return FAT_OK;
+}
+
+static uint32_t Fat_ClusterLba(Fat_Volume *volume, uint32_t cluster) {
+    return volume->data_lba + (cluster - 2) * volume->sectors_per_cluster;
+}
+
+// <next> is 0 at the end of the chain
+static int Fat_NextCluster(Fat_Volume *volume, uint32_t cluster, uint32_t *next) {
+    uint8_t *sector;
+    if (cluster < 2 || cluster >= volume->cluster_count + 2) {
+        return FAT_ERROR_CORRUPT;
+    }
+    uint32_t offset = cluster * (volume->type == FAT_TYPE_16 ? 2 : 4);
+    if (SectorCache_Get(volume->cache, volume->fat_lba + offset / BLOCKDEVICE_SECTOR_SIZE, false, &sector) < 0) {
+        return FAT_ERROR_IO;
+    }
+    uint32_t value;
+    if (volume->type == FAT_TYPE_16) {
+        value = Fat_Read16(sector + offset % BLOCKDEVICE_SECTOR_SIZE);
+        if (value >= 0xFFF8) {
+            value = 0;
+        }
+    }
+    else {
+        value = Fat_Read32(sector + offset % BLOCKDEVICE_SECTOR_SIZE) & 0x0FFFFFFF;
+        if (value >= 0x0FFFFFF8) {
+            value = 0;
+        }
+    }
+    // Free or bad clusters inside a chain
+    if (value != 0 && (value < 2 || value >= volume->cluster_count + 2)) {
+        return FAT_ERROR_CORRUPT;
+    }
+    *next = value;
+    return FAT_OK;
+}
+
+static void Fat_DirFromCluster(Fat_Volume *volume, Fat_Dir *dir, uint32_t cluster) {
+    dir->volume = volume;
+    dir->first_cluster = cluster;
+    dir->cluster = cluster;
+    dir->index = 0;
+}
+
+static uint8_t Fat_ShortNameChecksum(const uint8_t *name) {
+    uint8_t sum = 0;
+    for (uint8_t i = 0; i < 11; i++) {
+        sum = ((sum & 1) << 7) + (sum >> 1) + name[i];
+    }
+    return sum;
+}
+
+static void Fat_ShortName(const uint8_t *raw, char *name) {
+    uint8_t length = 0;
+    for (uint8_t i = 0; i < 8 && raw[i] != ' '; i++) {
+        name[length++] = (i == 0 && raw[i] == 0x05) ? (char)0xE5 : raw[i];
+    }
+    if (raw[8] != ' ') {
+        name[length++] = '.';
+        for (uint8_t i = 8; i < 11 && raw[i] != ' '; i++) {
+            name[length++] = raw[i];
+        }
+    }
+    name[length] = '\0';
+}
+
+int Fat_ReadDir(Fat_Dir *dir, Fat_DirEntry *entry) {
+    Fat_Volume *volume = dir->volume;
+    uint32_t per_cluster = volume->sectors_per_cluster * FAT_ENTRIES_PER_SECTOR;
+    // Long name parts come last part first, each numbered, ahead of their short entry
+    uint8_t lfn_next = 0;
+    uint8_t lfn_checksum = 0;
+    bool lfn_complete = false;
+    memset(entry->name, 0, FAT_MAX_NAME);
+
+    while (true) {
+        uint32_t lba;
+        if (dir->first_cluster == 0) {
+            if (dir->index >= volume->root_entries) {
+                return 0;
+            }
+            lba = volume->root_lba + dir->index / FAT_ENTRIES_PER_SECTOR;
+        }
+        else {
+            if (dir->cluster == 0) {
+                return 0;
+            }
+            lba = Fat_ClusterLba(volume, dir->cluster) + (dir->index % per_cluster) / FAT_ENTRIES_PER_SECTOR;
+        }
+
+        uint8_t *sector;
+        if (SectorCache_Get(volume->cache, lba, false, &sector) < 0) {
+            return FAT_ERROR_IO;
+        }
+        const uint8_t *raw = sector + (dir->index % FAT_ENTRIES_PER_SECTOR) * FAT_ENTRY_SIZE;
+        if (raw[0] == FAT_ENTRY_END) {
+            return 0;
+        }
+
+        // Step past this entry now, following the chain at a cluster boundary
+        dir->index++;
+        if (dir->first_cluster != 0 && dir->index % per_cluster == 0) {
+            uint32_t next;
+            int result = Fat_NextCluster(volume, dir->cluster, &next);
+            if (result < 0) {
+                return result;
+            }
+            dir->cluster = next;
+        }
+
+        uint8_t attributes = raw[11];
+        if (raw[0] == FAT_ENTRY_DELETED) {
+            lfn_complete = false;
+            continue;
+        }
+        if (attributes == FAT_ATTRIBUTE_LONG_NAME) {
+            uint8_t sequence = raw[0] & 0x1F;
+            if (raw[0] & 0x40) {
+                memset(entry->name, 0, FAT_MAX_NAME);
+                lfn_checksum = raw[13];
+            }
+            else if (sequence != lfn_next || raw[13] != lfn_checksum) {
+                lfn_complete = false;
+                lfn_next = 0;
+                continue;
+            }
+            if (sequence == 0) {
+                lfn_complete = false;
+                lfn_next = 0;
+                continue;
+            }
+            uint16_t position = (sequence - 1) * FAT_LFN_CHARS;
+            for (uint8_t i = 0; i < FAT_LFN_CHARS; i++) {
+                uint16_t c = Fat_Read16(raw + fat_lfn_offsets[i]);
+                if (c == 0x0000 || c == 0xFFFF) {
+                    break;
+                }
+                if (position + i < FAT_MAX_NAME - 1) {
+                    entry->name[position + i] = c < 0x80 ? (char)c : '?';
+                }
+            }
+            lfn_next = sequence - 1;
+            lfn_complete = lfn_next == 0;
+            continue;
+        }
+        if (attributes & FAT_ATTRIBUTE_VOLUME_ID) {
+            lfn_complete = false;
+            continue;
+        }
+
+        Fat_ShortName(raw, entry->short_name);
+        if (entry->short_name[0] == '.') {
+            lfn_complete = false;
+            continue; // . and ..
+        }
+        // The long name only belongs to this entry if every part was seen and the checksum agrees
+        if (!lfn_complete || lfn_checksum != Fat_ShortNameChecksum(raw)) {
+            strcpy(entry->name, entry->short_name);
+        }
+        entry->attributes = attributes;
+        entry->first_cluster = Fat_Read16(raw + 26);
+        if (volume->type == FAT_TYPE_32) {
+            entry->first_cluster |= (uint32_t)Fat_Read16(raw + 20) << 16;
+        }
+        entry->size = Fat_Read32(raw + 28);
+        return 1;
+    }
+}
+
+static bool Fat_NameMatches(const char *name, const char *component, uint32_t length) {
+    for (uint32_t i = 0; i < length; i++) {
+        if (name[i] == '\0' || toupper((unsigned char)name[i]) != toupper((unsigned char)component[i])) {
+            return false;
+        }
+    }
+    return name[length] == '\0';
+}
+
+static int Fat_Lookup(Fat_Volume *volume, const char *path, Fat_DirEntry *entry) {
+    memset(entry, 0, sizeof(Fat_DirEntry));
+    entry->attributes = FAT_ATTRIBUTE_DIRECTORY;
+    entry->first_cluster = volume->root_cluster;
+
+    while (*path) {
+        if (*path == '/') {
+            path++;
+            continue;
+        }
+        uint32_t length = 0;
+        while (path[length] && path[length] != '/') {
+            length++;
+        }
+        if (!(entry->attributes & FAT_ATTRIBUTE_DIRECTORY)) {
+            return FAT_ERROR_NOT_A_DIRECTORY;
+        }
+
+        Fat_Dir dir;
+        Fat_DirFromCluster(volume, &dir, entry->first_cluster);
+        int result;
+        while ((result = Fat_ReadDir(&dir, entry)) > 0) {
+            if (Fat_NameMatches(entry->name, path, length) || Fat_NameMatches(entry->short_name, path, length)) {
+                break;
+            }
+        }
+        if (result < 0) {
+            return result;
+        }
+        if (result == 0) {
+            return FAT_ERROR_NOT_FOUND;
+        }
+        path += length;
+    }
+    return FAT_OK;
+}
+
+int Fat_OpenDir(Fat_Volume *volume, Fat_Dir *dir, const char *path) {
+    Fat_DirEntry entry;
+    int result = Fat_Lookup(volume, path, &entry);
+    if (result < 0) {
+        return result;
+    }
+    if (!(entry.attributes & FAT_ATTRIBUTE_DIRECTORY)) {
+        return FAT_ERROR_NOT_A_DIRECTORY;
+    }
+    Fat_DirFromCluster(volume, dir, entry.first_cluster);
+    return FAT_OK;
+}
+
+int Fat_Open(Fat_Volume *volume, Fat_File *file, const char *path) {
+    Fat_DirEntry entry;
+    int result = Fat_Lookup(volume, path, &entry);
+    if (result < 0) {
+        return result;
+    }
+    if (entry.attributes & (FAT_ATTRIBUTE_DIRECTORY | FAT_ATTRIBUTE_VOLUME_ID)) {
+        return FAT_ERROR_NOT_A_FILE;
+    }
+    file->volume = volume;
+    file->first_cluster = entry.first_cluster;
+    file->size = entry.size;
+    file->position = 0;
+    file->cluster = entry.first_cluster;
+    file->cluster_index = 0;
+    return FAT_OK;
+}
+
+int Fat_Seek(Fat_File *file, uint32_t position) {
+    if (position > file->size) {
+        return FAT_ERROR_INVALID_ARG;
+    }
+    file->position = position;
+    return FAT_OK;
+}
+
+// Moves the cached cluster to the <index>th of the file, forward from where it is if possible
+static int Fat_FileCluster(Fat_File *file, uint32_t index) {
+    if (index < file->cluster_index) {
+        file->cluster = file->first_cluster;
+        file->cluster_index = 0;
+    }
+    while (file->cluster_index < index) {
+        uint32_t next;
+        int result = Fat_NextCluster(file->volume, file->cluster, &next);
+        if (result < 0) {
+            return result;
+        }
+        if (next == 0) {
+            return FAT_ERROR_CORRUPT; // Chain shorter than the file size
+        }
+        file->cluster = next;
+        file->cluster_index++;
+    }
+    return FAT_OK;
+}
+
+int32_t Fat_Read(Fat_File *file, void *data, uint32_t length) {
+    Fat_Volume *volume = file->volume;
+    uint32_t cluster_bytes = volume->sectors_per_cluster * BLOCKDEVICE_SECTOR_SIZE;
+    uint8_t *out = (uint8_t *)data;
+    uint32_t done = 0;
+
+    if (file->position >= file->size) {
+        return 0;
+    }
+    if (length > file->size - file->position) {
+        length = file->size - file->position;
+    }
+
+    while (done < length) {
+        int result = Fat_FileCluster(file, file->position / cluster_bytes);
+        if (result < 0) {
+            return result;
+        }
+        uint32_t sector_in_cluster = (file->position % cluster_bytes) / BLOCKDEVICE_SECTOR_SIZE;
+        uint32_t offset = file->position % BLOCKDEVICE_SECTOR_SIZE;
+        uint32_t lba = Fat_ClusterLba(volume, file->cluster) + sector_in_cluster;
+        uint32_t remaining = length - done;
+        uint32_t step;
+
+        if (offset == 0 && remaining >= BLOCKDEVICE_SECTOR_SIZE) {
+            // Whole sectors go straight to the caller, carrying on into following clusters while they are contiguous
+            uint32_t sectors = remaining / BLOCKDEVICE_SECTOR_SIZE;
+            uint32_t run = volume->sectors_per_cluster - sector_in_cluster;
+            while (run < sectors) {
+                uint32_t next;
+                result = Fat_NextCluster(volume, file->cluster, &next);
+                if (result < 0) {
+                    return result;
+                }
+                if (next != file->cluster + 1) {
+                    break;
+                }
+                file->cluster = next;
+                file->cluster_index++;
+                run += volume->sectors_per_cluster;
+            }
+            if (run > sectors) {
+                run = sectors;
+            }
+            if (SectorCache_ReadDirect(volume->cache, lba, out + done, run) < 0) {
+                return FAT_ERROR_IO;
+            }
+            step = run * BLOCKDEVICE_SECTOR_SIZE;
+        }
+        else {
+            uint8_t *sector;
+            if (SectorCache_Get(volume->cache, lba, false, &sector) < 0) {
+                return FAT_ERROR_IO;
+            }
+            step = BLOCKDEVICE_SECTOR_SIZE - offset;
+            if (step > remaining) {
+                step = remaining;
+            }
+            memcpy(out + done, sector + offset, step);
+        }
+        file->position += step;
+        done += step;
+    }
+    return done;
+}
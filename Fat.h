@@ -0,0 +1,95 @@
+/*
+ *
+ *  FAT16/FAT32 Filesystem (read only)
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _FAT_H
+#define _FAT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "SectorCache.h"
+
+// Files are streamed, a read only ever touches the sectors it needs. Metadata goes through
+// the sector cache, whole sectors of file data go straight to the caller's buffer and
+// contiguous clusters are merged into one multi-block read.
+// Long file names are matched and listed (ASCII only), paths use '/' and are case insensitive
+
+#define FAT_OK                      0
+#define FAT_ERROR_IO                -1
+#define FAT_ERROR_NO_FILESYSTEM     -2
+#define FAT_ERROR_NOT_FOUND         -3
+#define FAT_ERROR_NOT_A_FILE        -4
+#define FAT_ERROR_NOT_A_DIRECTORY   -5
+#define FAT_ERROR_CORRUPT           -6
+#define FAT_ERROR_INVALID_ARG       -7
+
+#define FAT_MAX_NAME                64 // Including terminator, longer names are truncated
+
+#define FAT_ATTRIBUTE_READ_ONLY     0x01
+#define FAT_ATTRIBUTE_HIDDEN        0x02
+#define FAT_ATTRIBUTE_SYSTEM        0x04
+#define FAT_ATTRIBUTE_VOLUME_ID     0x08
+#define FAT_ATTRIBUTE_DIRECTORY     0x10
+#define FAT_ATTRIBUTE_ARCHIVE       0x20
+#define FAT_ATTRIBUTE_LONG_NAME     0x0F
+
+typedef enum {
+    FAT_TYPE_16 = 16,
+    FAT_TYPE_32 = 32,
+} Fat_Type;
+
+typedef struct {
+    SectorCache *cache;
+    Fat_Type type;
+    uint8_t sectors_per_cluster;
+    uint32_t fat_lba;
+    uint32_t data_lba;      // Cluster 2
+    uint32_t root_lba;      // FAT16 fixed root directory
+    uint16_t root_entries;
+    uint32_t root_cluster;  // FAT32, 0 on FAT16
+    uint32_t cluster_count;
+} Fat_Volume;
+
+typedef struct {
+    char name[FAT_MAX_NAME];
+    char short_name[13];
+    uint8_t attributes;
+    uint32_t first_cluster;
+    uint32_t size;
+} Fat_DirEntry;
+
+typedef struct {
+    Fat_Volume *volume;
+    uint32_t first_cluster; // 0 for the FAT16 root
+    uint32_t cluster;
+    uint32_t index;         // Entry within the directory
+} Fat_Dir;
+
+typedef struct {
+    Fat_Volume *volume;
+    uint32_t first_cluster;
+    uint32_t size;
+    uint32_t position;
+    uint32_t cluster;       // Cluster holding position, cached so sequential reads don't walk the chain
+    uint32_t cluster_index;
+} Fat_File;
+
+// Finds the filesystem in the first partition, or a partitionless (superfloppy) volume
+int Fat_Mount(Fat_Volume *volume, SectorCache *cache);
+
+int Fat_OpenDir(Fat_Volume *volume, Fat_Dir *dir, const char *path);
+// Returns 1 with <entry> filled in, 0 at the end of the directory, or an error
+int Fat_ReadDir(Fat_Dir *dir, Fat_DirEntry *entry);
+
+int Fat_Open(Fat_Volume *volume, Fat_File *file, const char *path);
+// Returns the number of bytes read, 0 at the end of the file, or an error
+int32_t Fat_Read(Fat_File *file, void *data, uint32_t length);
+int Fat_Seek(Fat_File *file, uint32_t position);
+#endif
@@ -0,0 +1,133 @@
+/*
+ *
+ *  Flash Record Store
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#include <string.h>
+#include "FlashStore.h"
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+
+#define FLASHSTORE_TIMEOUT_MS   100
+
+// End of the program image, the slots must lie beyond it
+extern char __flash_binary_end;
+
+typedef struct {
+    uint32_t offset;     // From the start of flash
+    const uint8_t *data; // Whole record, header first
+    uint32_t length;     // Page multiple
+    bool erase;
+} FlashStore_Operation;
+
+static uint32_t FlashStore_CRC(const uint8_t *data, uint32_t length) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (uint32_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+static uint32_t FlashStore_SlotOffset(uint8_t slot) {
+    return PICO_FLASH_SIZE_BYTES - (slot + 1) * FLASH_SECTOR_SIZE;
+}
+
+static uint32_t FlashStore_RecordSize(uint16_t length) {
+    uint32_t size = sizeof(FlashStore_Header) + length;
+    return (size + FLASH_PAGE_SIZE - 1) & ~(FLASH_PAGE_SIZE - 1);
+}
+
+static bool FlashStore_Erased(const uint8_t *data, uint32_t length) {
+    for (uint32_t i = 0; i < length; i++) {
+        if (data[i] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Newest good record in the sector and where the next one goes, <next> is the sector
+// size when there's no erased space left
+static const FlashStore_Header *FlashStore_Scan(const uint8_t *sector, uint16_t tag, uint16_t length, uint32_t *next) {
+    uint32_t size = FlashStore_RecordSize(length);
+    const FlashStore_Header *newest = NULL;
+    *next = FLASH_SECTOR_SIZE;
+    for (uint32_t position = 0; position + size <= FLASH_SECTOR_SIZE; position += size) {
+        const FlashStore_Header *header = (const FlashStore_Header *)(sector + position);
+        if (FlashStore_Erased(sector + position, size)) {
+            *next = position;
+            break;
+        }
+        if (header->magic != FLASHSTORE_MAGIC || header->tag != tag || header->length != length) {
+            continue;
+        }
+        if (header->crc != FlashStore_CRC((const uint8_t *)(header + 1), length)) {
+            continue;
+        }
+        if (newest == NULL || (int32_t)(header->sequence - newest->sequence) > 0) {
+            newest = header;
+        }
+    }
+    return newest;
+}
+
+int FlashStore_Load(uint8_t slot, uint16_t tag, void *data, uint16_t length) {
+    if (slot >= FLASHSTORE_SLOTS || length > FLASHSTORE_MAX_LENGTH) {
+        return PICO_ERROR_INVALID_ARG;
+    }
+    uint32_t next;
+    const FlashStore_Header *header = FlashStore_Scan((const uint8_t *)(XIP_BASE + FlashStore_SlotOffset(slot)), tag, length, &next);
+    if (header == NULL) {
+        return PICO_ERROR_NOT_FOUND;
+    }
+    memcpy(data, header + 1, length);
+    return 0;
+}
+
+// Called with interrupts off and the other core parked
+static void FlashStore_Program(void *context) {
+    FlashStore_Operation *operation = (FlashStore_Operation *)context;
+    if (operation->erase) {
+        flash_range_erase(operation->offset & ~(FLASH_SECTOR_SIZE - 1), FLASH_SECTOR_SIZE);
+    }
+    flash_range_program(operation->offset, operation->data, operation->length);
+}
+
+int FlashStore_Save(uint8_t slot, uint16_t tag, const void *data, uint16_t length) {
+    static uint8_t record[FLASHSTORE_MAX_LENGTH + FLASH_PAGE_SIZE];
+    uint32_t sector_offset = FlashStore_SlotOffset(slot);
+    if (slot >= FLASHSTORE_SLOTS || length > FLASHSTORE_MAX_LENGTH
+            || XIP_BASE + sector_offset < (uintptr_t)&__flash_binary_end) {
+        return PICO_ERROR_INVALID_ARG;
+    }
+    uint32_t next;
+    const FlashStore_Header *previous = FlashStore_Scan((const uint8_t *)(XIP_BASE + sector_offset), tag, length, &next);
+
+    uint32_t size = FlashStore_RecordSize(length);
+    memset(record, 0xFF, size);
+    FlashStore_Header *header = (FlashStore_Header *)record;
+    header->magic = FLASHSTORE_MAGIC;
+    header->length = length;
+    header->tag = tag;
+    header->sequence = previous != NULL ? previous->sequence + 1 : 0;
+    header->crc = FlashStore_CRC(data, length);
+    memcpy(header + 1, data, length);
+
+    FlashStore_Operation operation = {
+        .offset = sector_offset + (next < FLASH_SECTOR_SIZE ? next : 0),
+        .data = record,
+        .length = size,
+        .erase = next >= FLASH_SECTOR_SIZE,
+    };
+    return flash_safe_execute(FlashStore_Program, &operation, FLASHSTORE_TIMEOUT_MS);
+}
@@ -0,0 +1,44 @@
+/*
+ *
+ *  Flash Record Store
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _FLASHSTORE_H
+#define _FLASHSTORE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Small records kept in the last sectors of program flash, one sector per slot counted
+// back from the end. Saves are appended page aligned behind the previous copy and the
+// sector is only erased once it is full, so a record a few pages long costs one erase
+// every few saves. Load takes the newest copy with a good CRC, so a torn append falls
+// back to the one before it (a power cut between erase and program loses the record).
+// Erase and program stall XIP for tens of milliseconds, so saves want to be rare
+
+#define FLASHSTORE_SLOTS        1
+#define FLASHSTORE_MAGIC        0x5453504Du // "MPST"
+#define FLASHSTORE_MAX_LENGTH   2048
+
+typedef struct {
+    uint32_t magic;
+    uint16_t length;
+    uint16_t tag;        // Caller's record type and version
+    uint32_t sequence;
+    uint32_t crc;        // CRC-32 of the data
+} FlashStore_Header;
+
+// Copies the newest record in <slot> to <data> if its tag and length match.
+// Returns 0 or PICO_ERROR_NOT_FOUND / PICO_ERROR_INVALID_ARG
+int FlashStore_Load(uint8_t slot, uint16_t tag, void *data, uint16_t length);
+// Appends a record to <slot>, erasing the sector first if it is full. Safe with the
+// other core running if it has called flash_safe_execute_core_init.
+// Returns 0 or a negative PICO_ERROR_ code
+int FlashStore_Save(uint8_t slot, uint16_t tag, const void *data, uint16_t length);
+#endif
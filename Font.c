@@ -0,0 +1,73 @@
+/*
+ *
+ *  Font renderer for the SSD1306 framebuffer
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+// Glyph data lives in Font_Data.c, generated at build time by tools/fontgen.py.
+// Each glyph page row is contiguous, so drawing is one memcpy per page into the framebuffer
+#include <string.h>
+#include "Font.h"
+
+// Characters outside the font are drawn as '?'
+static const FontGlyph *Font_GetGlyph(const Font *font, char c) {
+    uint8_t code = (uint8_t)c;
+    if (code < font->first_char || code > font->last_char) {
+        code = '?';
+    }
+    return &font->glyphs[code - font->first_char];
+}
+
+uint8_t Font_MeasureChar(const Font *font, char c) {
+    return Font_GetGlyph(font, c)->width + font->spacing;
+}
+
+uint16_t Font_MeasureString(const Font *font, const char *str) {
+    uint16_t width = 0;
+    while (*str) {
+        width += Font_MeasureChar(font, *str++);
+    }
+    return width;
+}
+
+uint8_t Font_DrawChar(SSD1306 *dev, const Font *font, int16_t x, uint8_t page, char c) {
+    const FontGlyph *glyph = Font_GetGlyph(font, c);
+    uint8_t advance = glyph->width + font->spacing;
+
+    // Clip horizontally, glyph columns [first, last) end up on the panel
+    int16_t first = x < 0 ? -x : 0;
+    int16_t last = advance;
+    if (x + last > dev->width) {
+        last = dev->width - x;
+    }
+    if (first >= last) {
+        return advance;
+    }
+
+    int16_t glyph_end = last < glyph->width ? last : glyph->width;
+    int16_t gap_start = first > glyph->width ? first : glyph->width;
+    for (uint8_t row = 0; row < font->pages && (page + row) < dev->pages; row++) {
+        uint8_t *dst = &dev->buffer[(page + row) * dev->width + x + first];
+        const uint8_t *src = &font->bitmap[glyph->offset + row * glyph->width + first];
+        if (first < glyph_end) {
+            memcpy(dst, src, glyph_end - first);
+        }
+        // Spacing columns are cleared so text overwrites whatever was there
+        if (gap_start < last) {
+            memset(&dst[gap_start - first], 0, last - gap_start);
+        }
+    }
+    return advance;
+}
+
+int16_t Font_DrawString(SSD1306 *dev, const Font *font, int16_t x, uint8_t page, const char *str) {
+    while (*str && x < dev->width) {
+        x += Font_DrawChar(dev, font, x, page, *str++);
+    }
+    return x;
+}
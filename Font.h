@@ -0,0 +1,49 @@
+/*
+ *
+ *  Font renderer for the SSD1306 framebuffer
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _FONT_H
+#define _FONT_H
+
+#include <stdint.h>
+#include "SSD1306.h"
+
+// Glyphs are pre-rasterised by tools/fontgen.py into page aligned column bytes,
+// so text can only be placed on page boundaries (y = 0, 8, 16...)
+typedef struct {
+    uint16_t offset; // Into bitmap, <pages> rows of <width> bytes
+    uint8_t width;   // Proportional width in columns
+} FontGlyph;
+
+typedef struct {
+    const uint8_t *bitmap;
+    const FontGlyph *glyphs;
+    uint8_t first_char;
+    uint8_t last_char;
+    uint8_t pages;   // Glyph height in 8 pixel pages
+    uint8_t spacing; // Blank columns after each glyph
+} Font;
+
+// Generated tables, stored in flash
+extern const Font Font_Small;  // 5x7, 1 page
+extern const Font Font_Medium; // 10x14, 2 pages
+extern const Font Font_Large;  // 15x21, 3 pages
+
+// Draws <c> with its left edge at column <x> and top at <page>, clipped to the panel.
+// Returns the advance in columns including spacing
+uint8_t Font_DrawChar(SSD1306 *dev, const Font *font, int16_t x, uint8_t page, char c);
+
+// Draws <str> and returns the column just after the last glyph
+int16_t Font_DrawString(SSD1306 *dev, const Font *font, int16_t x, uint8_t page, const char *str);
+
+// Width in columns that Font_DrawString would advance, without drawing
+uint16_t Font_MeasureString(const Font *font, const char *str);
+uint8_t Font_MeasureChar(const Font *font, char c);
+#endif
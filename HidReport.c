@@ -0,0 +1,150 @@
+/*
+ *
+ *  HID Keyboard Report Builder
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#include <string.h>
+#include "HidReport.h"
+#include "Keymap.h"
+#include "HotPath.h"
+
+#define HIDREPORT_QUEUE_MASK    (HIDREPORT_QUEUE_SIZE - 1)
+
+void HidReport_Initialise(HidReport *hid) {
+    memset(hid, 0, sizeof(HidReport));
+}
+
+static bool HOT_PATH(HidReport_Press)(HidReport *hid, uint8_t usage) {
+    if (usage >= HIDREPORT_MODIFIER_FIRST && usage <= HIDREPORT_MODIFIER_LAST) {
+        hid->report.modifiers |= 1 << (usage - HIDREPORT_MODIFIER_FIRST);
+        return true;
+    }
+    for (uint8_t i = 0; i < HIDREPORT_MAX_KEYS; i++) {
+        if (hid->report.keys[i] == usage) {
+            return false;
+        }
+    }
+    for (uint8_t i = 0; i < HIDREPORT_MAX_KEYS; i++) {
+        if (hid->report.keys[i] == 0) {
+            hid->report.keys[i] = usage;
+            return true;
+        }
+    }
+    hid->rollover++;
+    return false;
+}
+
+static bool HOT_PATH(HidReport_ReleaseKey)(HidReport *hid, uint8_t usage) {
+    if (usage >= HIDREPORT_MODIFIER_FIRST && usage <= HIDREPORT_MODIFIER_LAST) {
+        hid->report.modifiers &= ~(1 << (usage - HIDREPORT_MODIFIER_FIRST));
+        return true;
+    }
+    for (uint8_t i = 0; i < HIDREPORT_MAX_KEYS; i++) {
+        if (hid->report.keys[i] == usage) {
+            hid->report.keys[i] = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool HOT_PATH(HidReport_StageConsumer)(HidReport *hid, KeyEvent *event) {
+    if ((uint8_t)(hid->consumer_head - hid->consumer_tail) == HIDREPORT_QUEUE_SIZE) {
+        return false;
+    }
+    uint16_t usage = KC_CONSUMER_USAGE(event->keycode);
+    if (event->edge == KEYEVENT_PRESS) {
+        if (hid->consumer == usage) {
+            return true;
+        }
+        hid->consumer = usage;
+    }
+    else if (hid->consumer == usage) {
+        hid->consumer = 0;
+    }
+    else {
+        return true; // Replaced by a later press
+    }
+    hid->consumer_queue[hid->consumer_head++ & HIDREPORT_QUEUE_MASK] = hid->consumer;
+    return true;
+}
+
+bool HOT_PATH(HidReport_Stage)(void *context, KeyEvent *event) {
+    HidReport *hid = (HidReport *)context;
+    if ((event->flags & KEYEVENT_FLAG_CONSUMED) || event->keycode == KEYEVENT_NO_KEYCODE) {
+        return true;
+    }
+    if (KC_IS_CONSUMER(event->keycode)) {
+        return HidReport_StageConsumer(hid, event);
+    }
+    if (event->keycode > 0xFF) {
+        return true;
+    }
+    if ((uint8_t)(hid->queue_head - hid->queue_tail) == HIDREPORT_QUEUE_SIZE) {
+        return false; // Host hasn't caught up, hold
+    }
+    bool changed = event->edge == KEYEVENT_PRESS ? HidReport_Press(hid, event->keycode) : HidReport_ReleaseKey(hid, event->keycode);
+    if (changed) {
+        hid->queue[hid->queue_head & HIDREPORT_QUEUE_MASK] = hid->report;
+        hid->queued_at_us[hid->queue_head & HIDREPORT_QUEUE_MASK] = event->timestamp_us;
+        hid->queue_head++;
+    }
+    return true;
+}
+
+bool HOT_PATH(HidReport_Pending)(const HidReport *hid) {
+    return hid->queue_head != hid->queue_tail || hid->consumer_head != hid->consumer_tail;
+}
+
+bool HidReport_Peek(const HidReport *hid, HidKeyboardReport *report, uint32_t *event_us) {
+    if (hid->queue_head == hid->queue_tail) {
+        return false;
+    }
+    *report = hid->queue[hid->queue_tail & HIDREPORT_QUEUE_MASK];
+    if (event_us != NULL) {
+        *event_us = hid->queued_at_us[hid->queue_tail & HIDREPORT_QUEUE_MASK];
+    }
+    return true;
+}
+
+void HidReport_Release(HidReport *hid) {
+    if (hid->queue_head != hid->queue_tail) {
+        hid->queue_tail++;
+    }
+}
+
+bool HidReport_Take(HidReport *hid, HidKeyboardReport *report, uint32_t *event_us) {
+    if (!HidReport_Peek(hid, report, event_us)) {
+        return false;
+    }
+    HidReport_Release(hid);
+    return true;
+}
+
+bool HidReport_PeekConsumer(const HidReport *hid, uint16_t *usage) {
+    if (hid->consumer_head == hid->consumer_tail) {
+        return false;
+    }
+    *usage = hid->consumer_queue[hid->consumer_tail & HIDREPORT_QUEUE_MASK];
+    return true;
+}
+
+void HidReport_ReleaseConsumer(HidReport *hid) {
+    if (hid->consumer_head != hid->consumer_tail) {
+        hid->consumer_tail++;
+    }
+}
+
+bool HidReport_TakeConsumer(HidReport *hid, uint16_t *usage) {
+    if (!HidReport_PeekConsumer(hid, usage)) {
+        return false;
+    }
+    HidReport_ReleaseConsumer(hid);
+    return true;
+}
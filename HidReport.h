@@ -0,0 +1,67 @@
+/*
+ *
+ *  HID Keyboard Report Builder
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _HIDREPORT_H
+#define _HIDREPORT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "KeyPipeline.h"
+
+#define HIDREPORT_MAX_KEYS          6
+#define HIDREPORT_MODIFIER_FIRST    0xE0
+#define HIDREPORT_MODIFIER_LAST     0xE7
+#define HIDREPORT_QUEUE_SIZE        8 // Power of two
+
+// Boot protocol keyboard report
+typedef struct {
+    uint8_t modifiers;
+    uint8_t reserved;
+    uint8_t keys[HIDREPORT_MAX_KEYS];
+} HidKeyboardReport;
+
+// Every change is queued as its own report so a press and release inside one scan are
+// both seen by the host. With the queue full the stage holds, backing up the pipeline.
+// Consumer page keycodes (KC_CONSUMER) go to a second queue of consumer control reports,
+// a single 16 bit usage, 0 once released. The last consumer key pressed wins
+typedef struct {
+    HidKeyboardReport report; // Current state
+    HidKeyboardReport queue[HIDREPORT_QUEUE_SIZE];
+    uint32_t queued_at_us[HIDREPORT_QUEUE_SIZE]; // Timestamp of the event behind each report
+    uint8_t queue_head;
+    uint8_t queue_tail;
+    uint32_t rollover; // Presses dropped with all 6 slots in use
+
+    uint16_t consumer; // Current consumer usage
+    uint16_t consumer_queue[HIDREPORT_QUEUE_SIZE];
+    uint8_t consumer_head;
+    uint8_t consumer_tail;
+} HidReport;
+
+void HidReport_Initialise(HidReport *hid);
+
+// Pipeline stage: applies keycodes from the keymap to the report
+bool HidReport_Stage(void *context, KeyEvent *event);
+
+// True if a keyboard or consumer report is queued
+bool HidReport_Pending(const HidReport *hid);
+
+// Copies the oldest queued report, which stays queued until released. <event_us> (may be
+// NULL) is the timestamp of the key event behind it
+bool HidReport_Peek(const HidReport *hid, HidKeyboardReport *report, uint32_t *event_us);
+void HidReport_Release(HidReport *hid);
+// Peek and release in one, for a sink that can't refuse it
+bool HidReport_Take(HidReport *hid, HidKeyboardReport *report, uint32_t *event_us);
+// Likewise for the oldest consumer control usage
+bool HidReport_PeekConsumer(const HidReport *hid, uint16_t *usage);
+void HidReport_ReleaseConsumer(HidReport *hid);
+bool HidReport_TakeConsumer(HidReport *hid, uint16_t *usage);
+#endif
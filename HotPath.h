@@ -0,0 +1,26 @@
+/*
+ *
+ *  Hot Path Placement
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _HOTPATH_H
+#define _HOTPATH_H
+
+// HOT_PATH(name) around a function name places it in SRAM on target, the same section as
+// the SDK's __not_in_flash_func, so the scan never waits on an XIP cache miss after the
+// display or LED code has evicted its lines. Portable modules use this instead of the SDK
+// macro so they still build on a host, where it leaves the function as it is.
+// HOTPATH_IN_RAM is set by the build unless -DMACROPAD_RAM_HOT_PATH=OFF
+
+#if HOTPATH_IN_RAM
+#define HOT_PATH(name) __attribute__((section(".time_critical." #name))) name
+#else
+#define HOT_PATH(name) name
+#endif
+#endif
@@ -0,0 +1,253 @@
+/*
+ *
+ *  I2C Bus Manager and Device Registry
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "I2CBus.h"
+#include "HotPath.h"
+
+typedef struct {
+    uint8_t first;
+    uint8_t last;
+    I2CBus_DeviceType type;
+} I2CBus_ProbeRange;
+
+// Addresses each supported part can be strapped to
+static const I2CBus_ProbeRange i2cbus_probe_ranges[] = {
+    {0x20, 0x27, I2CBUS_DEVICE_MCP23017}, // A2..A0
+    {0x3C, 0x3D, I2CBUS_DEVICE_SSD1306},  // SA0
+};
+
+static const char *const i2cbus_type_names[I2CBUS_DEVICE_TYPE_COUNT] = {
+    "MCP23017",
+    "SSD1306",
+};
+
+void I2CBus_Initialise(I2CBus *bus, i2c_inst_t *i2c_instance) {
+    memset(bus, 0, sizeof(I2CBus));
+    bus->i2c_instance = i2c_instance;
+    bus->lock = spin_lock_instance(spin_lock_claim_unused(true));
+}
+
+void I2CBus_SetTransferHook(I2CBus *bus, I2CBus_TransferHook hook, void *context) {
+    bus->transfer_hook = hook;
+    bus->transfer_context = context;
+}
+
+// Lines are only ever released (input, pulled up) or driven low, like open drain.
+// Half periods of 5us, 100KHz
+void I2CBus_RecoverPins(uint sda_pin, uint scl_pin) {
+    gpio_init(sda_pin);
+    gpio_init(scl_pin);
+    gpio_pull_up(sda_pin);
+    gpio_pull_up(scl_pin);
+    gpio_put(sda_pin, 0);
+    gpio_put(scl_pin, 0);
+    busy_wait_us_32(5);
+    for (uint8_t i = 0; i < 9 && !gpio_get(sda_pin); i++) {
+        gpio_set_dir(scl_pin, GPIO_OUT);
+        busy_wait_us_32(5);
+        gpio_set_dir(scl_pin, GPIO_IN);
+        busy_wait_us_32(5);
+    }
+    // STOP: SDA low to high while SCL is high
+    gpio_set_dir(scl_pin, GPIO_OUT);
+    gpio_set_dir(sda_pin, GPIO_OUT);
+    busy_wait_us_32(5);
+    gpio_set_dir(scl_pin, GPIO_IN);
+    busy_wait_us_32(5);
+    gpio_set_dir(sda_pin, GPIO_IN);
+    busy_wait_us_32(5);
+}
+
+static inline void I2CBus_Mark(I2CBus *bus, const I2CBus_Device *device) {
+    if (bus->transfer_hook) {
+        bus->transfer_hook(bus->transfer_context, device);
+    }
+}
+
+const char *I2CBus_TypeName(I2CBus_DeviceType type) {
+    return type < I2CBUS_DEVICE_TYPE_COUNT ? i2cbus_type_names[type] : "?";
+}
+
+// <waited_us> is how long the caller has been waiting, if <waiting>. Both cores can be
+// waiting at once, so the statistics are only updated with the spinlock held
+static bool HOT_PATH(I2CBus_Claim)(I2CBus *bus, uint32_t token, bool waiting, uint32_t waited_us) {
+    uint32_t status = spin_lock_blocking(bus->lock);
+    bool claimed = bus->owner == 0 || bus->owner == token;
+    if (claimed) {
+        bus->owner = token;
+        bus->depth++;
+    }
+    if (waiting && (claimed || waited_us >= I2CBUS_ACQUIRE_TIMEOUT_US)) {
+        bus->contended++;
+        bus->wait_us += waited_us;
+        if (!claimed) {
+            bus->timeouts++;
+        }
+    }
+    spin_unlock(bus->lock, status);
+    return claimed;
+}
+
+bool I2CBus_TryAcquire(I2CBus *bus) {
+    return I2CBus_Claim(bus, get_core_num() + 1, false, 0);
+}
+
+int HOT_PATH(I2CBus_Acquire)(I2CBus *bus) {
+    uint32_t token = get_core_num() + 1;
+    if (I2CBus_Claim(bus, token, false, 0)) {
+        return 0;
+    }
+    uint32_t start = time_us_32();
+    for (;;) {
+        tight_loop_contents();
+        uint32_t waited_us = time_us_32() - start;
+        if (I2CBus_Claim(bus, token, true, waited_us)) {
+            return 0;
+        }
+        if (waited_us >= I2CBUS_ACQUIRE_TIMEOUT_US) {
+            return PICO_ERROR_TIMEOUT;
+        }
+    }
+}
+
+void HOT_PATH(I2CBus_Release)(I2CBus *bus) {
+    uint32_t status = spin_lock_blocking(bus->lock);
+    if (bus->owner == get_core_num() + 1 && --bus->depth == 0) {
+        bus->owner = 0;
+    }
+    spin_unlock(bus->lock, status);
+}
+
+static void HOT_PATH(I2CBus_Account)(I2CBus_Device *device, int result, size_t length, uint32_t start) {
+    device->bus_time_us += time_us_32() - start;
+    device->transfers++;
+    if (result < 0) {
+        device->errors++;
+    }
+    else {
+        device->bytes += length;
+    }
+}
+
+int HOT_PATH(I2CBus_Write)(I2CBus_Device *device, const uint8_t *data, size_t length) {
+    I2CBus *bus = device->bus;
+    if (I2CBus_Acquire(bus) < 0) {
+        return PICO_ERROR_TIMEOUT;
+    }
+    uint32_t start = time_us_32();
+    I2CBus_Mark(bus, device);
+    int ret = i2c_write_blocking(bus->i2c_instance, device->address, data, length, false);
+    I2CBus_Mark(bus, NULL);
+    I2CBus_Account(device, ret, length, start);
+    I2CBus_Release(bus);
+    return ret < 0 ? ret : 0;
+}
+
+int I2CBus_Read(I2CBus_Device *device, uint8_t *data, size_t length) {
+    I2CBus *bus = device->bus;
+    if (I2CBus_Acquire(bus) < 0) {
+        return PICO_ERROR_TIMEOUT;
+    }
+    uint32_t start = time_us_32();
+    I2CBus_Mark(bus, device);
+    int ret = i2c_read_blocking(bus->i2c_instance, device->address, data, length, false);
+    I2CBus_Mark(bus, NULL);
+    I2CBus_Account(device, ret, length, start);
+    I2CBus_Release(bus);
+    return ret < 0 ? ret : 0;
+}
+
+int HOT_PATH(I2CBus_WriteRead)(I2CBus_Device *device, const uint8_t *tx, size_t tx_length, uint8_t *rx, size_t rx_length) {
+    I2CBus *bus = device->bus;
+    if (I2CBus_Acquire(bus) < 0) {
+        return PICO_ERROR_TIMEOUT;
+    }
+    uint32_t start = time_us_32();
+    I2CBus_Mark(bus, device);
+    int ret = i2c_write_blocking(bus->i2c_instance, device->address, tx, tx_length, true);
+    if (ret >= 0) {
+        ret = i2c_read_blocking(bus->i2c_instance, device->address, rx, rx_length, false);
+    }
+    I2CBus_Mark(bus, NULL);
+    I2CBus_Account(device, ret, tx_length + rx_length, start);
+    I2CBus_Release(bus);
+    return ret < 0 ? ret : 0;
+}
+
+I2CBus_Device *I2CBus_Register(I2CBus *bus, uint8_t address, I2CBus_DeviceType type) {
+    if (bus->device_count >= I2CBUS_MAX_DEVICES) {
+        return NULL;
+    }
+    uint8_t index = 0;
+    for (uint8_t i = 0; i < bus->device_count; i++) {
+        if (bus->devices[i].address == address) {
+            return &bus->devices[i];
+        }
+        if (bus->devices[i].type == type) {
+            index++;
+        }
+    }
+    I2CBus_Device *device = &bus->devices[bus->device_count++];
+    memset(device, 0, sizeof(I2CBus_Device));
+    device->bus = bus;
+    device->address = address;
+    device->type = type;
+    device->index = index;
+    return device;
+}
+
+uint8_t I2CBus_Discover(I2CBus *bus) {
+    uint8_t found = 0;
+    if (I2CBus_Acquire(bus) < 0) {
+        return 0;
+    }
+    for (uint8_t r = 0; r < sizeof(i2cbus_probe_ranges) / sizeof(i2cbus_probe_ranges[0]); r++) {
+        const I2CBus_ProbeRange *range = &i2cbus_probe_ranges[r];
+        for (uint8_t address = range->first; address <= range->last; address++) {
+            // A one byte read is harmless on every supported part, an absent address NAKs in ~25us
+            uint8_t data;
+            if (i2c_read_timeout_us(bus->i2c_instance, address, &data, 1, false, I2CBUS_PROBE_TIMEOUT_US) < 0) {
+                continue;
+            }
+            if (I2CBus_Register(bus, address, range->type)) {
+                found++;
+            }
+        }
+    }
+    I2CBus_Release(bus);
+    return found;
+}
+
+I2CBus_Device *I2CBus_Find(I2CBus *bus, I2CBus_DeviceType type, uint8_t index) {
+    for (uint8_t i = 0; i < bus->device_count; i++) {
+        if (bus->devices[i].type == type && bus->devices[i].index == index) {
+            return &bus->devices[i];
+        }
+    }
+    return NULL;
+}
+
+void I2CBus_PrintDevices(I2CBus *bus, uint64_t elapsed_us) {
+    printf("Addr  Type      Transfers     Bytes  Errors  Bus(us)  Share\n");
+    for (uint8_t i = 0; i < bus->device_count; i++) {
+        I2CBus_Device *device = &bus->devices[i];
+        uint32_t share = elapsed_us ? (uint32_t)(device->bus_time_us * 1000 / elapsed_us) : 0;
+        printf("0x%02x  %-8s%u %9lu %9lu  %6lu %8llu  %lu.%lu%%\n", device->address, I2CBus_TypeName(device->type), device->index,
+               (unsigned long)device->transfers, (unsigned long)device->bytes, (unsigned long)device->errors,
+               (unsigned long long)device->bus_time_us, (unsigned long)(share / 10), (unsigned long)(share % 10));
+    }
+    printf("Contended acquisitions: %lu, waited %lluus, timed out %lu\n", (unsigned long)bus->contended,
+           (unsigned long long)bus->wait_us, (unsigned long)bus->timeouts);
+}
@@ -0,0 +1,110 @@
+/*
+ *
+ *  I2C Bus Manager and Device Registry
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _I2CBUS_H
+#define _I2CBUS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "hardware/i2c.h"
+#include "hardware/sync.h"
+
+// Devices are found once by probing only the addresses the supported parts can strap to,
+// and handed out as typed handles, so drivers never hard code an address.
+// Every transfer goes through the bus, which arbitrates between cores with an ownership
+// token (the core number + 1). The hardware spinlock only guards the token compare and
+// set and the wait statistics, it is never held across a transfer. A lock-free compare
+// and swap isn't possible here: the M0+ (ARMv6-M) has no LDREX/STREX, so the SIO spinlocks
+// are the only atomic primitive shared by both cores. Tasks on one core are cooperative
+// so they can't interleave mid transfer, and a core may nest acquisitions.
+// Bus time, bytes and errors are accounted per device
+
+#define I2CBUS_MAX_DEVICES      12
+#define I2CBUS_PROBE_TIMEOUT_US 1000
+#define I2CBUS_ACQUIRE_TIMEOUT_US 50000 // Twice a full SSD1306 frame at 400kHz
+
+typedef enum {
+    I2CBUS_DEVICE_MCP23017 = 0,
+    I2CBUS_DEVICE_SSD1306,
+    I2CBUS_DEVICE_TYPE_COUNT,
+} I2CBus_DeviceType;
+
+struct I2CBus;
+
+typedef struct I2CBus_Device I2CBus_Device;
+
+struct I2CBus_Device {
+    struct I2CBus *bus;
+    uint8_t address;
+    I2CBus_DeviceType type;
+    uint8_t index; // Nth device of its type, in address order
+
+    // Accounting
+    uint32_t transfers;
+    uint32_t bytes;
+    uint32_t errors;
+    uint64_t bus_time_us;
+};
+
+// Called with the device before each transfer and with NULL once it is over
+typedef void (*I2CBus_TransferHook)(void *context, const I2CBus_Device *device);
+
+typedef struct I2CBus {
+    i2c_inst_t *i2c_instance;
+    I2CBus_Device devices[I2CBUS_MAX_DEVICES];
+    uint8_t device_count;
+
+    // Ownership
+    spin_lock_t *lock;
+    volatile uint32_t owner; // 0 free, otherwise core number + 1
+    uint8_t depth;
+    uint32_t contended;      // Acquisitions that had to wait
+    uint32_t timeouts;       // Gave up after I2CBUS_ACQUIRE_TIMEOUT_US
+    uint64_t wait_us;
+
+    I2CBus_TransferHook transfer_hook; // May be NULL
+    void *transfer_context;
+} I2CBus;
+
+// Frees a bus held by a device reset mid transfer: clocks SCL until the device lets go
+// of SDA, then a STOP. Run on the pins before they are given to the I2C peripheral
+void I2CBus_RecoverPins(uint sda_pin, uint scl_pin);
+
+// The I2C peripheral and pins must already be set up
+void I2CBus_Initialise(I2CBus *bus, i2c_inst_t *i2c_instance);
+void I2CBus_SetTransferHook(I2CBus *bus, I2CBus_TransferHook hook, void *context);
+
+// Probes the strap ranges of every supported type (0x20-0x27 expanders, 0x3C-0x3D displays)
+// and registers what answers. Returns the number of devices found
+uint8_t I2CBus_Discover(I2CBus *bus);
+// Registers a device without probing. Returns NULL if the registry is full
+I2CBus_Device *I2CBus_Register(I2CBus *bus, uint8_t address, I2CBus_DeviceType type);
+// <index>th device of <type>, or NULL
+I2CBus_Device *I2CBus_Find(I2CBus *bus, I2CBus_DeviceType type, uint8_t index);
+const char *I2CBus_TypeName(I2CBus_DeviceType type);
+
+// Ownership for a sequence of transfers. Acquire spins until the other core lets go, for at
+// most I2CBUS_ACQUIRE_TIMEOUT_US. Returns 0 or PICO_ERROR_TIMEOUT, Release only after a 0
+int I2CBus_Acquire(I2CBus *bus);
+bool I2CBus_TryAcquire(I2CBus *bus);
+void I2CBus_Release(I2CBus *bus);
+
+// Transfers, each acquiring the bus for its duration. Return 0 or a negative PICO_ERROR_,
+// PICO_ERROR_TIMEOUT if the other core held the bus for too long
+int I2CBus_Write(I2CBus_Device *device, const uint8_t *data, size_t length);
+int I2CBus_Read(I2CBus_Device *device, uint8_t *data, size_t length);
+// Write then repeated start into a read, as one unit
+int I2CBus_WriteRead(I2CBus_Device *device, const uint8_t *tx, size_t tx_length, uint8_t *rx, size_t rx_length);
+
+// Registry and accounting, share of bus time against <elapsed_us>
+void I2CBus_PrintDevices(I2CBus *bus, uint64_t elapsed_us);
+#endif
@@ -0,0 +1,97 @@
+/*
+ *
+ *  Indicator Outputs
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#include <string.h>
+#include "Indicator.h"
+#include "HotPath.h"
+
+void Indicator_Initialise(Indicator *ind, Indicator_WriteFunction write, void *context) {
+    memset(ind, 0, sizeof(Indicator));
+    ind->write = write;
+    ind->context = context;
+    ind->enabled = true;
+}
+
+int Indicator_Add(Indicator *ind, uint8_t port, uint8_t bit) {
+    if (ind->count >= INDICATOR_MAX || port >= INDICATOR_MAX_PORTS || bit > 15) {
+        return -1;
+    }
+    ind->outputs[ind->count].port = port;
+    ind->outputs[ind->count].bit = 1u << bit;
+    // Latch contents are unknown until the first write
+    ind->stale |= 1u << port;
+    return ind->count++;
+}
+
+uint16_t Indicator_PortMask(const Indicator *ind, uint8_t port) {
+    uint16_t mask = 0;
+    for (uint8_t i = 0; i < ind->count; i++) {
+        if (ind->outputs[i].port == port) {
+            mask |= ind->outputs[i].bit;
+        }
+    }
+    return mask;
+}
+
+void HOT_PATH(Indicator_Set)(Indicator *ind, uint8_t id, bool on) {
+    if (id >= ind->count) {
+        return;
+    }
+    const Indicator_Output *output = &ind->outputs[id];
+    if (on) {
+        ind->latch[output->port] |= output->bit;
+    }
+    else {
+        ind->latch[output->port] &= ~output->bit;
+    }
+}
+
+bool Indicator_Get(const Indicator *ind, uint8_t id) {
+    if (id >= ind->count) {
+        return false;
+    }
+    return (ind->latch[ind->outputs[id].port] & ind->outputs[id].bit) != 0;
+}
+
+void Indicator_SetEnabled(Indicator *ind, bool enabled) {
+    ind->enabled = enabled;
+}
+
+void Indicator_Invalidate(Indicator *ind) {
+    for (uint8_t i = 0; i < ind->count; i++) {
+        ind->stale |= 1u << ind->outputs[i].port;
+    }
+}
+
+int HOT_PATH(Indicator_Flush)(Indicator *ind) {
+    int result = 0;
+    int writes = 0;
+    ind->flushes++;
+    for (uint8_t port = 0; port < INDICATOR_MAX_PORTS; port++) {
+        uint16_t latch = ind->enabled ? ind->latch[port] : 0;
+        if (latch == ind->written[port] && !(ind->stale & (1u << port))) {
+            continue;
+        }
+        int status = ind->write(ind->context, port, latch);
+        if (status < 0) {
+            ind->errors++;
+            if (result == 0) {
+                result = status;
+            }
+            continue;
+        }
+        ind->written[port] = latch;
+        ind->stale &= ~(1u << port);
+        ind->writes++;
+        writes++;
+    }
+    return result < 0 ? result : writes;
+}
@@ -0,0 +1,67 @@
+/*
+ *
+ *  Indicator Outputs
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _INDICATOR_H
+#define _INDICATOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Indicator LEDs on spare expander outputs. Indicator_Set only changes a shadow latch per
+// port, anything may call it any number of times. Indicator_Flush runs once per tick and
+// writes each port whose shadow differs from what was last written, as one 16 bit latch
+// burst (OLATA/OLATB). A tick with no net change costs no bus traffic at all.
+// Portable, the latch write is supplied by the caller
+
+#define INDICATOR_MAX_PORTS     2
+#define INDICATOR_MAX           16
+
+// Writes all 16 outputs of <port>, 0 or a negative error
+typedef int (*Indicator_WriteFunction)(void *context, uint8_t port, uint16_t latch);
+
+typedef struct {
+    uint8_t port;
+    uint16_t bit;
+} Indicator_Output;
+
+typedef struct {
+    Indicator_WriteFunction write;
+    void *context;
+    Indicator_Output outputs[INDICATOR_MAX];
+    uint8_t count;
+    bool enabled;                           // Off while the power manager has the LEDs dark
+    uint16_t latch[INDICATOR_MAX_PORTS];    // Wanted state
+    uint16_t written[INDICATOR_MAX_PORTS];  // Last state the port accepted
+    uint8_t stale;                          // Ports to write whatever the shadow says
+    // Statistics
+    uint32_t flushes;
+    uint32_t writes;
+    uint32_t errors;
+} Indicator;
+
+void Indicator_Initialise(Indicator *ind, Indicator_WriteFunction write, void *context);
+
+// Adds an output on bit <bit> of <port>'s 16 bit latch. Returns its id or -1 if full
+int Indicator_Add(Indicator *ind, uint8_t port, uint8_t bit);
+// Output mask of every indicator on <port>, for setting the pin directions
+uint16_t Indicator_PortMask(const Indicator *ind, uint8_t port);
+
+void Indicator_Set(Indicator *ind, uint8_t id, bool on);
+bool Indicator_Get(const Indicator *ind, uint8_t id);
+// Blanks every output while disabled, the wanted state is kept
+void Indicator_SetEnabled(Indicator *ind, bool enabled);
+// Forces a write of every port on the next flush, e.g. after an expander reset
+void Indicator_Invalidate(Indicator *ind);
+
+// Once per tick. Returns the number of port writes made or the first error.
+// A failed port is retried on the next flush
+int Indicator_Flush(Indicator *ind);
+#endif
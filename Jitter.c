@@ -0,0 +1,68 @@
+/*
+ *
+ *  Cycle Jitter Measurement
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "Jitter.h"
+#include "HotPath.h"
+
+// Sorted copy for the percentiles, printing is never reentrant
+static uint32_t jitter_sorted[JITTER_WINDOW];
+
+void Jitter_Initialise(Jitter *jitter, const char *name) {
+    memset(jitter, 0, sizeof(Jitter));
+    jitter->name = name;
+    jitter->min = UINT32_MAX;
+}
+
+void Jitter_Clear(Jitter *jitter) {
+    Jitter_Initialise(jitter, jitter->name);
+}
+
+void HOT_PATH(Jitter_Record)(Jitter *jitter, uint32_t cycles) {
+    jitter->cycles[jitter->count & (JITTER_WINDOW - 1)] = cycles;
+    jitter->count++;
+    jitter->total += cycles;
+    if (cycles < jitter->min) {
+        jitter->min = cycles;
+    }
+    if (cycles > jitter->max) {
+        jitter->max = cycles;
+    }
+}
+
+void Jitter_Print(const Jitter *jitter, uint32_t cycles_per_us) {
+    if (jitter->count == 0) {
+        printf("%-8s no runs\n", jitter->name);
+        return;
+    }
+    uint32_t n = jitter->count < JITTER_WINDOW ? jitter->count : JITTER_WINDOW;
+    // Insertion sort, a few hundred entries at most
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t value = jitter->cycles[i];
+        uint32_t j = i;
+        while (j > 0 && jitter_sorted[j - 1] > value) {
+            jitter_sorted[j] = jitter_sorted[j - 1];
+            j--;
+        }
+        jitter_sorted[j] = value;
+    }
+    uint32_t p50 = jitter_sorted[n / 2];
+    uint32_t p99 = jitter_sorted[(n * 99) / 100];
+    printf("%-8s %8lu runs  min %7lu  mean %7lu  p50 %7lu  p99 %7lu  max %7lu cycles\n", jitter->name,
+           (unsigned long)jitter->count, (unsigned long)jitter->min, (unsigned long)(jitter->total / jitter->count),
+           (unsigned long)p50, (unsigned long)p99, (unsigned long)jitter->max);
+    if (cycles_per_us) {
+        printf("%-8s jitter p99 %lu.%02luus, max %lu.%02luus\n", "",
+               (unsigned long)((p99 - jitter->min) / cycles_per_us), (unsigned long)(((p99 - jitter->min) % cycles_per_us) * 100 / cycles_per_us),
+               (unsigned long)((jitter->max - jitter->min) / cycles_per_us), (unsigned long)(((jitter->max - jitter->min) % cycles_per_us) * 100 / cycles_per_us));
+    }
+}
@@ -0,0 +1,39 @@
+/*
+ *
+ *  Cycle Jitter Measurement
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _JITTER_H
+#define _JITTER_H
+
+#include <stdint.h>
+
+// Cycle counts of a code path run over and over (one scan iteration), to compare builds.
+// The last JITTER_WINDOW runs are kept for percentiles, min, max and mean cover every run
+// since the last clear. Jitter is reported as p99 and max over the fastest run. The caller
+// supplies the counts (SysTick on target). Portable, no SDK dependencies
+
+#define JITTER_WINDOW   256 // Power of 2
+
+typedef struct {
+    const char *name;
+    uint32_t cycles[JITTER_WINDOW];
+    uint32_t count;     // Runs since the last clear
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+} Jitter;
+
+void Jitter_Initialise(Jitter *jitter, const char *name);
+void Jitter_Clear(Jitter *jitter);
+void Jitter_Record(Jitter *jitter, uint32_t cycles);
+
+// <cycles_per_us> converts the spread to time, 0 to leave it in cycles
+void Jitter_Print(const Jitter *jitter, uint32_t cycles_per_us);
+#endif
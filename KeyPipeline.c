@@ -0,0 +1,123 @@
+/*
+ *
+ *  Key Event Pipeline
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+// Single producer (scan), stages on the same core, consumers may be on the other core.
+// Each cursor has one writer, the barrier orders the record write before the cursor store
+#include <string.h>
+#include "KeyPipeline.h"
+#include "HotPath.h"
+
+#define KEYPIPELINE_MASK    (KEYPIPELINE_RING_SIZE - 1)
+
+void KeyPipeline_Initialise(KeyPipeline *pipe) {
+    memset(pipe, 0, sizeof(KeyPipeline));
+}
+
+int KeyPipeline_AddStage(KeyPipeline *pipe, KeyPipeline_StageFunction function, void *context) {
+    if (pipe->stage_count >= KEYPIPELINE_MAX_STAGES || function == NULL) {
+        return -1;
+    }
+    pipe->stage_function[pipe->stage_count] = function;
+    pipe->stage_context[pipe->stage_count] = context;
+    pipe->stage_cursor[pipe->stage_count] = pipe->head;
+    return pipe->stage_count++;
+}
+
+int KeyPipeline_AddConsumer(KeyPipeline *pipe) {
+    if (pipe->consumer_count >= KEYPIPELINE_MAX_CONSUMERS) {
+        return -1;
+    }
+    pipe->consumer_cursor[pipe->consumer_count] = pipe->head;
+    return pipe->consumer_count++;
+}
+
+// Where the last stage has got to, consumers can't pass it
+static inline uint32_t KeyPipeline_Processed(KeyPipeline *pipe) {
+    return pipe->stage_count ? pipe->stage_cursor[pipe->stage_count - 1] : pipe->head;
+}
+
+// Oldest index still in use by anyone
+static uint32_t HOT_PATH(KeyPipeline_Tail)(KeyPipeline *pipe) {
+    uint32_t head = pipe->head;
+    uint32_t tail = head;
+    for (uint8_t i = 0; i < pipe->stage_count; i++) {
+        if (head - pipe->stage_cursor[i] > head - tail) {
+            tail = pipe->stage_cursor[i];
+        }
+    }
+    for (uint8_t i = 0; i < pipe->consumer_count; i++) {
+        if (head - pipe->consumer_cursor[i] > head - tail) {
+            tail = pipe->consumer_cursor[i];
+        }
+    }
+    return tail;
+}
+
+uint32_t HOT_PATH(KeyPipeline_Free)(KeyPipeline *pipe) {
+    return KEYPIPELINE_RING_SIZE - (pipe->head - KeyPipeline_Tail(pipe));
+}
+
+bool HOT_PATH(KeyPipeline_Push)(KeyPipeline *pipe, uint8_t key, uint8_t edge, uint8_t source, uint32_t timestamp_us) {
+    if (KeyPipeline_Free(pipe) == 0) {
+        pipe->overflows++;
+        return false;
+    }
+    KeyEvent *event = &pipe->events[pipe->head & KEYPIPELINE_MASK];
+    event->timestamp_us = timestamp_us;
+    event->key = key;
+    event->edge = edge;
+    event->source = source;
+    event->flags = 0;
+    event->keycode = KEYEVENT_NO_KEYCODE;
+    event->layer = 0;
+    event->reserved = 0;
+    __sync_synchronize();
+    pipe->head++;
+    return true;
+}
+
+void HOT_PATH(KeyPipeline_Run)(KeyPipeline *pipe) {
+    for (uint8_t stage = 0; stage < pipe->stage_count; stage++) {
+        uint32_t limit = stage ? pipe->stage_cursor[stage - 1] : pipe->head;
+        uint32_t cursor = pipe->stage_cursor[stage];
+        while (cursor != limit) {
+            if (!pipe->stage_function[stage](pipe->stage_context[stage], &pipe->events[cursor & KEYPIPELINE_MASK])) {
+                break; // Held, downstream waits behind it
+            }
+            cursor++;
+            __sync_synchronize();
+            pipe->stage_cursor[stage] = cursor;
+        }
+    }
+}
+
+KeyEvent *HOT_PATH(KeyPipeline_Lookahead)(KeyPipeline *pipe, uint8_t stage, uint32_t offset) {
+    uint32_t limit = stage ? pipe->stage_cursor[stage - 1] : pipe->head;
+    uint32_t index = pipe->stage_cursor[stage] + offset;
+    if (index - pipe->stage_cursor[stage] >= limit - pipe->stage_cursor[stage]) {
+        return NULL;
+    }
+    return &pipe->events[index & KEYPIPELINE_MASK];
+}
+
+KeyEvent *KeyPipeline_Peek(KeyPipeline *pipe, uint8_t consumer) {
+    uint32_t cursor = pipe->consumer_cursor[consumer];
+    if (cursor == KeyPipeline_Processed(pipe)) {
+        return NULL;
+    }
+    __sync_synchronize();
+    return &pipe->events[cursor & KEYPIPELINE_MASK];
+}
+
+void KeyPipeline_Release(KeyPipeline *pipe, uint8_t consumer) {
+    __sync_synchronize();
+    pipe->consumer_cursor[consumer]++;
+}
@@ -0,0 +1,84 @@
+/*
+ *
+ *  Key Event Pipeline
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _KEYPIPELINE_H
+#define _KEYPIPELINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Events live in one statically allocated ring. Stages run in order over the same records
+// and annotate them in place, each stage only ever sees events the previous one has passed.
+// Consumers (display, LEDs) read behind the last stage. A slot is reused once every stage
+// and consumer has moved past it, so nothing is copied and nothing is lost silently
+
+#define KEYPIPELINE_RING_SIZE       64 // Power of two
+#define KEYPIPELINE_MAX_STAGES      4
+#define KEYPIPELINE_MAX_CONSUMERS   4
+
+#define KEYEVENT_RELEASE            0
+#define KEYEVENT_PRESS              1
+
+// Set by stages
+#define KEYEVENT_FLAG_CONSUMED      0x01 // Swallowed, later stages should ignore it
+#define KEYEVENT_FLAG_SYNTHETIC     0x02 // Generated by a stage rather than a key
+
+#define KEYEVENT_NO_KEYCODE         0x0000
+
+typedef struct {
+    uint32_t timestamp_us;
+    uint8_t key;     // Physical key, source * 16 + expander pin
+    uint8_t edge;    // KEYEVENT_PRESS or KEYEVENT_RELEASE
+    uint8_t source;  // Expander index
+    uint8_t flags;
+    uint16_t keycode; // Filled in by the keymap stage
+    uint8_t layer;
+    uint8_t reserved;
+} KeyEvent;
+
+// Returns false to hold the event, the stage is retried from the same event next run
+typedef bool (*KeyPipeline_StageFunction)(void *context, KeyEvent *event);
+
+typedef struct {
+    KeyEvent events[KEYPIPELINE_RING_SIZE];
+    // Free running indices, slot is index & (KEYPIPELINE_RING_SIZE - 1)
+    volatile uint32_t head;
+    volatile uint32_t stage_cursor[KEYPIPELINE_MAX_STAGES];
+    volatile uint32_t consumer_cursor[KEYPIPELINE_MAX_CONSUMERS];
+    KeyPipeline_StageFunction stage_function[KEYPIPELINE_MAX_STAGES];
+    void *stage_context[KEYPIPELINE_MAX_STAGES];
+    uint8_t stage_count;
+    uint8_t consumer_count;
+    uint32_t overflows; // Pushes refused because the ring was full
+} KeyPipeline;
+
+void KeyPipeline_Initialise(KeyPipeline *pipe);
+
+// Stages run in the order they are added. Returns the stage id or -1
+int KeyPipeline_AddStage(KeyPipeline *pipe, KeyPipeline_StageFunction function, void *context);
+// Returns the consumer id or -1
+int KeyPipeline_AddConsumer(KeyPipeline *pipe);
+
+// Producer side. Returns false if the ring is full
+bool KeyPipeline_Push(KeyPipeline *pipe, uint8_t key, uint8_t edge, uint8_t source, uint32_t timestamp_us);
+uint32_t KeyPipeline_Free(KeyPipeline *pipe);
+
+// Runs every stage over whatever it has available
+void KeyPipeline_Run(KeyPipeline *pipe);
+
+// For a stage holding its current event: the event <offset> places after it that the
+// previous stage has already passed, or NULL. Stages may flag these but not reorder them
+KeyEvent *KeyPipeline_Lookahead(KeyPipeline *pipe, uint8_t stage, uint32_t offset);
+
+// Consumer side, returns the next event past all stages or NULL. Release after use
+KeyEvent *KeyPipeline_Peek(KeyPipeline *pipe, uint8_t consumer);
+void KeyPipeline_Release(KeyPipeline *pipe, uint8_t consumer);
+#endif
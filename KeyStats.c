@@ -0,0 +1,117 @@
+/*
+ *
+ *  Key Usage Statistics
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "KeyStats.h"
+#include "Encoder.h"
+
+void KeyStats_Initialise(KeyStats *stats, const KeyStats_Record *saved) {
+    memset(stats, 0, sizeof(KeyStats));
+    if (saved != NULL && saved->version == KEYSTATS_VERSION) {
+        stats->record = *saved;
+    }
+    stats->record.version = KEYSTATS_VERSION;
+}
+
+void KeyStats_Clear(KeyStats *stats) {
+    memset(&stats->record, 0, sizeof(KeyStats_Record));
+    stats->record.version = KEYSTATS_VERSION;
+    stats->dirty = true;
+}
+
+// 0 for < 16ms, doubling up to the open ended last bucket
+static uint8_t KeyStats_Bucket(uint32_t us) {
+    uint32_t units = us / (KEYSTATS_BUCKET_MIN_MS * 1000);
+    uint8_t bucket = units ? 32 - __builtin_clz(units) : 0;
+    return bucket < KEYSTATS_BUCKETS ? bucket : KEYSTATS_BUCKETS - 1;
+}
+
+void KeyStats_Event(KeyStats *stats, const KeyEvent *event) {
+    if ((event->flags & KEYEVENT_FLAG_SYNTHETIC) || event->source >= ENCODER_EVENT_SOURCE || event->key >= KEYSTATS_MAX_KEYS) {
+        return;
+    }
+    uint8_t key = event->key;
+    KeyStats_Key *entry = &stats->record.keys[key];
+    if (event->edge == KEYEVENT_PRESS) {
+        entry->presses++;
+        stats->press_us[key] = event->timestamp_us;
+        stats->held |= 1u << key;
+        if (stats->have_last_press) {
+            uint32_t *count = &stats->record.interval[KeyStats_Bucket(event->timestamp_us - stats->last_press_us)];
+            if (*count != UINT32_MAX) {
+                (*count)++;
+            }
+        }
+        stats->last_press_us = event->timestamp_us;
+        stats->have_last_press = true;
+    }
+    else if (stats->held & (1u << key)) {
+        stats->held &= ~(1u << key);
+        uint16_t *count = &entry->hold[KeyStats_Bucket(event->timestamp_us - stats->press_us[key])];
+        if (*count != UINT16_MAX) {
+            (*count)++;
+        }
+    }
+    stats->dirty = true;
+}
+
+uint32_t KeyStats_Consume(KeyStats *stats, KeyPipeline *pipe, uint8_t consumer) {
+    uint32_t taken = 0;
+    KeyEvent *event;
+    while ((event = KeyPipeline_Peek(pipe, consumer)) != NULL) {
+        KeyStats_Event(stats, event);
+        KeyPipeline_Release(pipe, consumer);
+        taken++;
+    }
+    return taken;
+}
+
+void KeyStats_SyncChatter(KeyStats *stats, const Debounce *db) {
+    for (uint8_t source = 0; source < DEBOUNCE_MAX_SOURCES; source++) {
+        for (uint8_t bit = 0; bit < DEBOUNCE_KEYS_PER_SOURCE; bit++) {
+            uint16_t seen = db->chatter[source][bit];
+            uint16_t delta = seen - stats->chatter_seen[source][bit];
+            uint8_t key = source * DEBOUNCE_KEYS_PER_SOURCE + bit;
+            if (delta == 0 || key >= KEYSTATS_MAX_KEYS) {
+                continue;
+            }
+            stats->chatter_seen[source][bit] = seen;
+            KeyStats_Key *entry = &stats->record.keys[key];
+            entry->chatter = (uint32_t)entry->chatter + delta > UINT16_MAX ? UINT16_MAX : entry->chatter + delta;
+            stats->dirty = true;
+        }
+    }
+}
+
+void KeyStats_MarkSaved(KeyStats *stats) {
+    stats->dirty = false;
+}
+
+void KeyStats_Print(const KeyStats *stats) {
+    printf("key presses chatter hold <16 <32 <64 <128 <256 <512 <1024 >=1024ms\n");
+    for (uint8_t key = 0; key < KEYSTATS_MAX_KEYS; key++) {
+        const KeyStats_Key *entry = &stats->record.keys[key];
+        if (entry->presses == 0 && entry->chatter == 0) {
+            continue;
+        }
+        printf("%3u %7lu %7u     ", key, (unsigned long)entry->presses, entry->chatter);
+        for (uint8_t i = 0; i < KEYSTATS_BUCKETS; i++) {
+            printf(" %u", entry->hold[i]);
+        }
+        printf("\n");
+    }
+    printf("interval <16 <32 <64 <128 <256 <512 <1024 >=1024ms:");
+    for (uint8_t i = 0; i < KEYSTATS_BUCKETS; i++) {
+        printf(" %lu", (unsigned long)stats->record.interval[i]);
+    }
+    printf("\n");
+}
@@ -0,0 +1,67 @@
+/*
+ *
+ *  Key Usage Statistics
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _KEYSTATS_H
+#define _KEYSTATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "KeyPipeline.h"
+#include "Debounce.h"
+
+// Per key press counts, chatter and hold time histograms, plus a histogram of the interval
+// between consecutive presses. Filled from a key pipeline consumer, so nothing is added to
+// the scan itself. Only physical keys are counted, not combos or encoder taps.
+// KeyStats_Record is the fixed size block that gets persisted, it only changes layout
+// with KEYSTATS_VERSION
+
+#define KEYSTATS_MAX_KEYS       32
+#define KEYSTATS_BUCKETS        8  // Log2 buckets, the last is open ended
+#define KEYSTATS_BUCKET_MIN_MS  16 // Upper edge of the first bucket
+#define KEYSTATS_VERSION        1
+
+typedef struct {
+    uint32_t presses;
+    uint16_t chatter;                      // Bounces caught by debounce, saturates
+    uint16_t hold[KEYSTATS_BUCKETS];       // Hold time, <16ms, <32ms, ... >=1024ms. Saturate
+} KeyStats_Key;
+
+typedef struct {
+    uint32_t version;
+    KeyStats_Key keys[KEYSTATS_MAX_KEYS];
+    uint32_t interval[KEYSTATS_BUCKETS];   // Press to next press, any key
+} KeyStats_Record;
+
+typedef struct {
+    KeyStats_Record record;
+    bool dirty;                            // Changed since the last KeyStats_MarkSaved
+    // Not persisted
+    uint32_t press_us[KEYSTATS_MAX_KEYS];
+    uint32_t held;                         // Keys with a press_us
+    uint32_t last_press_us;
+    bool have_last_press;
+    uint16_t chatter_seen[DEBOUNCE_MAX_SOURCES][DEBOUNCE_KEYS_PER_SOURCE];
+} KeyStats;
+
+// Starts from <saved> if it is a valid record (may be NULL), otherwise from zero
+void KeyStats_Initialise(KeyStats *stats, const KeyStats_Record *saved);
+void KeyStats_Clear(KeyStats *stats);
+
+// Consumes everything available to <consumer>. Returns the number of events taken
+uint32_t KeyStats_Consume(KeyStats *stats, KeyPipeline *pipe, uint8_t consumer);
+void KeyStats_Event(KeyStats *stats, const KeyEvent *event);
+// Folds in chatter counted by debounce since the last sync
+void KeyStats_SyncChatter(KeyStats *stats, const Debounce *db);
+
+void KeyStats_MarkSaved(KeyStats *stats);
+// Prints a table, one line per key that has been pressed
+void KeyStats_Print(const KeyStats *stats);
+#endif
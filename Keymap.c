@@ -0,0 +1,86 @@
+/*
+ *
+ *  Keymap and Layers
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#include <string.h>
+#include "Keymap.h"
+#include "HotPath.h"
+
+void Keymap_Initialise(Keymap *km, const uint16_t (*layers)[KEYMAP_MAX_KEYS], uint8_t layer_count) {
+    memset(km, 0, sizeof(Keymap));
+    km->layers = layers;
+    km->layer_count = layer_count > KEYMAP_MAX_LAYERS ? KEYMAP_MAX_LAYERS : layer_count;
+}
+
+uint8_t HOT_PATH(Keymap_GetToggled)(Keymap *km) {
+    return km->toggled_mask;
+}
+
+void Keymap_SetToggled(Keymap *km, uint8_t toggled_mask) {
+    km->toggled_mask = toggled_mask & ((1u << km->layer_count) - 1);
+}
+
+static inline uint8_t Keymap_ActiveMask(Keymap *km) {
+    return km->momentary_mask | km->toggled_mask | 1;
+}
+
+uint8_t HOT_PATH(Keymap_ActiveLayer)(Keymap *km) {
+    return 31 - __builtin_clz(Keymap_ActiveMask(km));
+}
+
+// Highest active layer with a non transparent entry for <key>
+static uint16_t HOT_PATH(Keymap_Resolve)(Keymap *km, uint8_t key, uint8_t *layer) {
+    uint8_t active = Keymap_ActiveMask(km);
+    for (int8_t i = km->layer_count - 1; i >= 0; i--) {
+        if ((active & (1 << i)) && km->layers[i][key] != KC_TRNS) {
+            *layer = i;
+            return km->layers[i][key];
+        }
+    }
+    *layer = 0;
+    return KC_NO;
+}
+
+bool HOT_PATH(Keymap_Stage)(void *context, KeyEvent *event) {
+    Keymap *km = (Keymap *)context;
+    // Synthetic events (combos) already carry their keycode
+    if (event->key >= KEYMAP_MAX_KEYS || (event->flags & (KEYEVENT_FLAG_CONSUMED | KEYEVENT_FLAG_SYNTHETIC))) {
+        return true;
+    }
+
+    uint16_t keycode;
+    if (event->edge == KEYEVENT_PRESS) {
+        keycode = Keymap_Resolve(km, event->key, &event->layer);
+        km->pressed_keycode[event->key] = keycode;
+    }
+    else {
+        keycode = km->pressed_keycode[event->key];
+        km->pressed_keycode[event->key] = KC_NO;
+        event->layer = Keymap_ActiveLayer(km);
+    }
+    event->keycode = keycode;
+
+    if (KC_IS_LAYER(keycode)) {
+        uint8_t layer = keycode & 0x07;
+        if ((keycode & 0xFF00) == 0x0100) {
+            if (event->edge == KEYEVENT_PRESS) {
+                km->momentary_mask |= 1 << layer;
+            }
+            else {
+                km->momentary_mask &= ~(1 << layer);
+            }
+        }
+        else if (event->edge == KEYEVENT_PRESS) {
+            km->toggled_mask ^= 1 << layer;
+        }
+        event->flags |= KEYEVENT_FLAG_CONSUMED;
+    }
+    return true;
+}
@@ -0,0 +1,58 @@
+/*
+ *
+ *  Keymap and Layers
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _KEYMAP_H
+#define _KEYMAP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "KeyPipeline.h"
+
+#define KEYMAP_MAX_LAYERS   4
+#define KEYMAP_MAX_KEYS     32
+
+// Keycodes 0x00-0xFF are HID keyboard usages (0xE0-0xE7 modifiers)
+#define KC_NO               0x0000
+#define KC_TRNS             0xFFFF // Falls through to the next active layer down
+#define KC_MO(layer)        (0x0100 | (layer)) // Layer active while held
+#define KC_TG(layer)        (0x0200 | (layer)) // Layer toggled on press
+#define KC_IS_LAYER(kc)     (((kc) & 0xFF00) == 0x0100 || ((kc) & 0xFF00) == 0x0200)
+// Consumer page usages (0x000-0x3FF) go out on the consumer control report. Hosts ignore
+// the keyboard page volume keys (0x7F-0x81), these are the ones they act on
+#define KC_CONSUMER(usage)      (0x4000 | (usage))
+#define KC_IS_CONSUMER(kc)      (((kc) & 0xFC00) == 0x4000)
+#define KC_CONSUMER_USAGE(kc)   ((kc) & 0x03FF)
+#define KC_MUTE             KC_CONSUMER(0xE2)
+#define KC_VOLU             KC_CONSUMER(0xE9)
+#define KC_VOLD             KC_CONSUMER(0xEA)
+
+typedef struct {
+    const uint16_t (*layers)[KEYMAP_MAX_KEYS];
+    uint8_t layer_count;
+    uint8_t momentary_mask;
+    uint8_t toggled_mask;
+    // Keycode chosen on press, so a layer change while held can't leave a key stuck
+    uint16_t pressed_keycode[KEYMAP_MAX_KEYS];
+} Keymap;
+
+void Keymap_Initialise(Keymap *km, const uint16_t (*layers)[KEYMAP_MAX_KEYS], uint8_t layer_count);
+
+// Layer toggle state, to carry it over a warm restart. Momentary layers aren't restored,
+// their keys are reported pressed again by the first scan if they are still held
+uint8_t Keymap_GetToggled(Keymap *km);
+void Keymap_SetToggled(Keymap *km, uint8_t toggled_mask);
+
+// Highest active layer, layer 0 is always active
+uint8_t Keymap_ActiveLayer(Keymap *km);
+
+// Pipeline stage: fills in keycode and layer, consumes layer keys
+bool Keymap_Stage(void *context, KeyEvent *event);
+#endif
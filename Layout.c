@@ -0,0 +1,37 @@
+/*
+ *
+ *  Default Keymap and Combos
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#include "Layout.h"
+
+// Default keymap, 20 keys. Keys 0-15 are on the first expander, 16-19 on the second.
+// Keys 20 and 21 are the encoder turning clockwise and anticlockwise
+const uint16_t Layout_DefaultLayers[LAYOUT_LAYER_COUNT][KEYMAP_MAX_KEYS] = {
+    { // Base: F13-F24, mute, volume down/up, layer 1. Encoder volume
+        0x68, 0x69, 0x6A, 0x6B, 0x6C, 0x6D, 0x6E, 0x6F,
+        0x70, 0x71, 0x72, 0x73, KC_MUTE, KC_VOLD, KC_VOLU, KC_MO(1),
+        0x1E, 0x1F, 0x20, 0x21,
+        KC_VOLU, KC_VOLD,
+    },
+    { // Layer 1: 1-9, 0, enter, escape, backspace, tab, space. Encoder scrolls (arrow keys until there is a mouse report)
+        0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25,
+        0x26, 0x27, 0x28, 0x29, 0x2A, 0x2B, 0x2C, KC_TRNS,
+        KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS,
+        0x51, 0x52,
+    },
+};
+
+// Default combos, physical key bitmasks
+const Combo_Definition Layout_DefaultCombos[] = {
+    {(1 << 0) | (1 << 1), 0x29, COMBO_RELEASE_ANY}, // Escape
+    {(1 << 2) | (1 << 3), 0x2A, COMBO_RELEASE_ANY}, // Backspace
+    {(1 << 0) | (1 << 1) | (1 << 2), 0x4C, COMBO_RELEASE_ALL}, // Delete
+};
+const uint16_t Layout_DefaultComboCount = sizeof(Layout_DefaultCombos) / sizeof(Layout_DefaultCombos[0]);
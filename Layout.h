@@ -0,0 +1,27 @@
+/*
+ *
+ *  Default Keymap and Combos
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _LAYOUT_H
+#define _LAYOUT_H
+
+#include <stdint.h>
+#include "Keymap.h"
+#include "Combo.h"
+
+// Shared by the firmware and the host replay tool, so a replayed trace goes through the same keymap
+
+#define LAYOUT_LAYER_COUNT  2
+
+extern const uint16_t Layout_DefaultLayers[LAYOUT_LAYER_COUNT][KEYMAP_MAX_KEYS];
+extern const Combo_Definition Layout_DefaultCombos[];
+extern const uint16_t Layout_DefaultComboCount;
+
+#endif
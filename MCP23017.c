@@ -10,30 +10,22 @@
  * 
 */
 
-// Start by adding open and close I2C with error handling
-// Read + write registers
-// bit number for pins
-// Register address for pins
-// Set input/output mode
-// Read GPIO
-// write GPIO
-// Pullup
+// Transport-agnostic core. Bus access goes through MCP23017_TransportRead/Write which are
+// provided by exactly one backend at compile time: MCP23017_I2C.c (MCP23017) or MCP23017_SPI.c (MCP23S17)
 #include <stdio.h>
-#include "hardware/i2c.h"
 #include "MCP23017.h"
+#include "HotPath.h"
 #include "pico/stdlib.h"
-//#include "pico/malloc.h"
-#include <malloc.h>
 
-uint8_t MCP23017_Initialise(MCP23017 *dev, i2c_inst_t *i2c_instance, uint8_t mcp23017_address) {
-    // Checks HW I2C is functional + Valid MCP23017 address range
-    if (i2c_instance == NULL || mcp23017_address < 0b0100000 || mcp23017_address > 0b0100111) { // 0x20 to 0x27
+// Shared by both backends once the bus handle has been stored
+uint8_t MCP23017_InitialiseState(MCP23017 *dev, uint8_t mcp23017_address) {
+    // Valid MCP23017 address range
+    if (mcp23017_address < 0b0100000 || mcp23017_address > 0b0100111) { // 0x20 to 0x27
         return 1;
     }
 
     // Setup struct
-    dev->i2c_instance= i2c_instance;
-    dev->mcp23017_i2c_addr = mcp23017_address;
+    dev->mcp23017_addr = mcp23017_address;
     dev->io_value = 0;
     dev->io_configuration = 0;
     dev->io_direction = 0;
@@ -49,35 +41,33 @@ uint8_t MCP23017_Initialise(MCP23017 *dev, i2c_inst_t *i2c_instance, uint8_t mcp
     return 0;
 }
 
-// Read all 16 GPIOs at once
-uint16_t MCP23017_GetIO(MCP23017 *dev) {
-    uint16_t ioVal = (MCP23017_ReadRegister(dev, MCP23017_REG_GPIOA) << 8) + MCP23017_ReadRegister(dev, MCP23017_REG_GPIOB);
-    dev->io_value = ioVal;
-    return ioVal;
+// Read all 16 GPIOs at once. On a bus error <io> is left alone and io_value keeps the last good read
+int HOT_PATH(MCP23017_GetIO)(MCP23017 *dev, uint16_t *io) {
+    int result = MCP23017_ReadRegisterPair(dev, MCP23017_REG_GPIOA, &dev->io_value);
+    if (result < 0) {
+        return result;
+    }
+    *io = dev->io_value;
+    return 0;
 }
 
 // Writes all 16 IO at once
 void MCP23017_SetIO(MCP23017 *dev, uint16_t *data) {
-    uint8_t *ptrIO = malloc(sizeof(uint8_t));
-    *ptrIO = *data >> 8;
     // Bit ordering: AAAA AAAA BBBB BBBB
-    MCP23017_WriteRegister(dev, MCP23017_REG_GPIOA, ptrIO);
-    *ptrIO = *data;
-    MCP23017_WriteRegister(dev, MCP23017_REG_GPIOB, ptrIO);
-    free(ptrIO);
+    MCP23017_WriteRegisterPair(dev, MCP23017_REG_GPIOA, *data);
 }
 
 uint8_t MCP23017_GetSingleIO(MCP23017 *dev, uint8_t gpio) {
-    uint8_t data;
+    uint8_t data = 0;
     uint8_t bitmask = 1; // 0000 0001
     
     // Read Bank and extract bit
     if (gpio < 7) { // Bank A
-        data = MCP23017_ReadRegister(dev, MCP23017_REG_GPIOA);
+        MCP23017_ReadRegister(dev, MCP23017_REG_GPIOA, &data);
     }
     else { // Bank B
         gpio =-8; // shift to keep within 0-7
-        data = MCP23017_ReadRegister(dev, MCP23017_REG_GPIOB);
+        MCP23017_ReadRegister(dev, MCP23017_REG_GPIOB, &data);
     }
     bitmask = bitmask << gpio;
     if (bitmask == (data & bitmask)) { // Means bit is 1
@@ -97,11 +87,15 @@ void MCP23017_SetSingleIO(MCP23017 *dev, uint8_t io, uint8_t gpio) {
         io = 1;
     }
     if (gpio <= 7) { // Bank A
-        current_io = MCP23017_ReadRegister(dev, MCP23017_REG_IODIRA);
+        if (MCP23017_ReadRegister(dev, MCP23017_REG_IODIRA, &current_io) < 0) {
+            return; // Don't write back a guess
+        }
     }
     else { // Bank B
         gpio =- 8;
-        current_io = MCP23017_ReadRegister(dev, MCP23017_REG_IODIRB);
+        if (MCP23017_ReadRegister(dev, MCP23017_REG_IODIRB, &current_io) < 0) {
+            return; // Don't write back a guess
+        }
     }
     bitmask = bitmask << gpio; // Shift bit to correct IO to change
 
@@ -120,20 +114,15 @@ void MCP23017_SetSingleIO(MCP23017 *dev, uint8_t io, uint8_t gpio) {
 }
 
 uint16_t MCP23017_GetIODirection(MCP23017 *dev) {
-    uint16_t ioDir = (MCP23017_ReadRegister(dev, MCP23017_REG_IODIRA) << 8) + MCP23017_ReadRegister(dev, MCP23017_REG_IODIRB);
-    dev->io_direction = ioDir;
-    return ioDir;
+    // Last known value if the read fails
+    MCP23017_ReadRegisterPair(dev, MCP23017_REG_IODIRA, &dev->io_direction);
+    return dev->io_direction;
 }
 
 // Set all IO direction
 void MCP23017_SetIODirection(MCP23017 *dev, uint16_t *direction) {
-    uint8_t *ptrDir = malloc(sizeof(uint8_t));
-    *ptrDir = *direction >> 8;
     // Bit ordering: AAAA AAAA BBBB BBBB
-    MCP23017_WriteRegister(dev, MCP23017_REG_IODIRA, ptrDir);
-    *ptrDir = *direction;
-    MCP23017_WriteRegister(dev, MCP23017_REG_IODIRB, ptrDir);
-    free(ptrDir);
+    MCP23017_WriteRegisterPair(dev, MCP23017_REG_IODIRA, *direction);
 }
 
 // Get value of IO specified by <gpio>
@@ -142,11 +131,11 @@ uint8_t MCP23017_GetSingleIODirection(MCP23017 *dev, uint8_t gpio) {
     uint8_t bitmask = 1; // 0000 0001
     // Read Bank and extract bit
     if (gpio < 7) { // Bank A
-        data = MCP23017_ReadRegister(dev, MCP23017_REG_IODIRA);
+        MCP23017_ReadRegister(dev, MCP23017_REG_IODIRA, &data);
     }
     else{ // Bank B
         gpio =-8; // shift to keep within 0-7
-        data = MCP23017_ReadRegister(dev, MCP23017_REG_IODIRB);
+        MCP23017_ReadRegister(dev, MCP23017_REG_IODIRB, &data);
     }
     bitmask = bitmask << gpio;
     
@@ -173,11 +162,15 @@ void MCP23017_SetSingleIODirection(MCP23017 *dev, uint8_t direction, uint8_t gpi
     direction = 1;
     }
     if (gpio <= 7) { // Bank A
-        current_direction = MCP23017_ReadRegister(dev, MCP23017_REG_IODIRA);
+        if (MCP23017_ReadRegister(dev, MCP23017_REG_IODIRA, &current_direction) < 0) {
+            return; // Don't write back a guess
+        }
     }
     else { // Bank B
         gpio =- 8;
-        current_direction = MCP23017_ReadRegister(dev, MCP23017_REG_IODIRB);
+        if (MCP23017_ReadRegister(dev, MCP23017_REG_IODIRB, &current_direction) < 0) {
+            return; // Don't write back a guess
+        }
     }
     bitmask = bitmask << gpio; // Shift bit to correct IO to change
 
@@ -197,21 +190,16 @@ void MCP23017_SetSingleIODirection(MCP23017 *dev, uint8_t direction, uint8_t gpi
 
 // Get IO polarity based on Bank - Bank A is IO 0-7, Bank B is IO 8-15
 uint16_t MCP23017_GetIOPolarity(MCP23017 *dev) {
-    uint16_t ioPol = (MCP23017_ReadRegister(dev, MCP23017_REG_IPOLA) << 8) + MCP23017_ReadRegister(dev, MCP23017_REG_IPOLB);
-    dev->io_polarity = ioPol;
-    return ioPol;
+    // Last known value if the read fails
+    MCP23017_ReadRegisterPair(dev, MCP23017_REG_IPOLA, &dev->io_polarity);
+    return dev->io_polarity;
 
 }
 
 // Set all IO polarity
 void MCP23017_SetIOPolarity(MCP23017 *dev, uint16_t *polarity) {
-    uint8_t *ptrPol = malloc(sizeof(uint8_t));
-    *ptrPol = *polarity >> 8;
     // Bit ordering: AAAA AAAA BBBB BBBB
-    MCP23017_WriteRegister(dev, MCP23017_REG_IPOLA, ptrPol);
-    *ptrPol = *polarity;
-    MCP23017_WriteRegister(dev, MCP23017_REG_IPOLB, ptrPol);
-    free(ptrPol);
+    MCP23017_WriteRegisterPair(dev, MCP23017_REG_IPOLA, *polarity);
 }
 
 // Get IO polarity based on GPIO
@@ -220,11 +208,11 @@ uint8_t MCP23017_GetSingleIOPolarity(MCP23017 *dev, uint8_t gpio) {
     uint8_t bitmask = 1; // 0000 0001
     // Read Bank and extract bit
     if (gpio < 7) { // Bank A
-        data = MCP23017_ReadRegister(dev, MCP23017_REG_IPOLA);
+        MCP23017_ReadRegister(dev, MCP23017_REG_IPOLA, &data);
     }
     else{ // Bank B
         gpio =-8; // shift to keep within 0-7
-        data = MCP23017_ReadRegister(dev, MCP23017_REG_IPOLA);
+        MCP23017_ReadRegister(dev, MCP23017_REG_IPOLA, &data);
     }
     bitmask = bitmask << gpio;
     if (bitmask == (data & bitmask)) { // Means bit is 1
@@ -252,11 +240,15 @@ void MCP23017_SetSingleIOPolarity(MCP23017 *dev, uint8_t polarity, uint8_t gpio)
     
     // Set the bitmask and get current polarity
     if (gpio <= 7) { // Bank A
-        current_polarity = MCP23017_ReadRegister(dev, MCP23017_REG_IPOLA);
+        if (MCP23017_ReadRegister(dev, MCP23017_REG_IPOLA, &current_polarity) < 0) {
+            return; // Don't write back a guess
+        }
     }
     else { // Bank B
         gpio =- 8;
-        current_polarity = MCP23017_ReadRegister(dev, MCP23017_REG_IPOLB);
+        if (MCP23017_ReadRegister(dev, MCP23017_REG_IPOLB, &current_polarity) < 0) {
+            return; // Don't write back a guess
+        }
     }
     bitmask = bitmask << gpio; // Shift bit to correct IO to change
 
@@ -275,20 +267,15 @@ void MCP23017_SetSingleIOPolarity(MCP23017 *dev, uint8_t polarity, uint8_t gpio)
 }
 
 uint16_t MCP23017_GetPullups(MCP23017 *dev) {
-    uint16_t ioPull = (MCP23017_ReadRegister(dev, MCP23017_REG_GPPUA) << 8) + MCP23017_ReadRegister(dev, MCP23017_REG_GPPUB);
-    dev->io_value = ioPull;
-    return ioPull;
+    // Last known value if the read fails
+    MCP23017_ReadRegisterPair(dev, MCP23017_REG_GPPUA, &dev->io_value);
+    return dev->io_value;
 }
 
 // Set all IO pullups
 void MCP23017_SetPullups(MCP23017* dev, uint16_t* pullup) {
-    uint8_t *ptrPullup = malloc(sizeof(uint8_t));
-    *ptrPullup = *pullup >> 8;
     // Bit ordering: AAAA AAAA BBBB BBBB
-    MCP23017_WriteRegister(dev, MCP23017_REG_GPPUA, ptrPullup);
-    *ptrPullup = *pullup;
-    MCP23017_WriteRegister(dev, MCP23017_REG_GPPUB, ptrPullup);
-    free(ptrPullup);
+    MCP23017_WriteRegisterPair(dev, MCP23017_REG_GPPUA, *pullup);
 }
 
 // Get single IO determined by <gpio>
@@ -297,11 +284,11 @@ uint8_t MCP23017_GetSinglePullup(MCP23017 *dev, uint8_t gpio) {
     uint8_t bitmask = 1; // 0000 0001
     // Read Bank and extract bit
     if (gpio < 7) { // Bank A
-        data = MCP23017_ReadRegister(dev, MCP23017_REG_GPPUA);
+        MCP23017_ReadRegister(dev, MCP23017_REG_GPPUA, &data);
     }
     else{ // Bank B
         gpio =-8; // shift to keep within 0-7
-        data = MCP23017_ReadRegister(dev, MCP23017_REG_GPPUB);
+        MCP23017_ReadRegister(dev, MCP23017_REG_GPPUB, &data);
     }
     bitmask = bitmask << gpio; // Bit shift
     if (bitmask == (data & bitmask)) { // Means bit is 1
@@ -323,11 +310,15 @@ void MCP23017_SetSinglePullup(MCP23017 *dev, uint8_t pullup, uint8_t gpio) {
     
     // Set the bitmask and get current polarity
     if (gpio <= 7) { // Bank A
-        current_pullup = MCP23017_ReadRegister(dev, MCP23017_REG_GPPUA);
+        if (MCP23017_ReadRegister(dev, MCP23017_REG_GPPUA, &current_pullup) < 0) {
+            return; // Don't write back a guess
+        }
     }
     else { // Bank B
         gpio =- 8;
-        current_pullup = MCP23017_ReadRegister(dev, MCP23017_REG_GPPUB);
+        if (MCP23017_ReadRegister(dev, MCP23017_REG_GPPUB, &current_pullup) < 0) {
+            return; // Don't write back a guess
+        }
     }
     bitmask = bitmask << gpio; // Shift bit to correct IO to change
 
@@ -346,19 +337,14 @@ void MCP23017_SetSinglePullup(MCP23017 *dev, uint8_t pullup, uint8_t gpio) {
 }
 
 uint16_t MCP23017_GetInterruptChange(MCP23017 *dev) {
-    uint16_t intChg = (MCP23017_ReadRegister(dev, MCP23017_REG_INTCONA) << 8) + MCP23017_ReadRegister(dev, MCP23017_REG_INTCONB);
-    dev->io_interrupt_chg = intChg;
-    return intChg;
+    // Last known value if the read fails
+    MCP23017_ReadRegisterPair(dev, MCP23017_REG_INTCONA, &dev->io_interrupt_chg);
+    return dev->io_interrupt_chg;
 }
 
 void MCP23017_SetInterruptChange(MCP23017 *dev, uint16_t *interrupt) {
-    uint8_t *ptrIntChg = malloc(sizeof(uint8_t));
-    *ptrIntChg = *interrupt >> 8;
     // Bit ordering: AAAA AAAA BBBB BBBB
-    MCP23017_WriteRegister(dev, MCP23017_REG_INTCONA, ptrIntChg);
-    *ptrIntChg = *interrupt;
-    MCP23017_WriteRegister(dev, MCP23017_REG_INTCONB, ptrIntChg);
-    free(ptrIntChg);
+    MCP23017_WriteRegisterPair(dev, MCP23017_REG_INTCONA, *interrupt);
 }
 
 uint8_t MCP23017_GetSingleInterruptChange(MCP23017 *dev, uint8_t gpio) {
@@ -366,11 +352,11 @@ uint8_t MCP23017_GetSingleInterruptChange(MCP23017 *dev, uint8_t gpio) {
     uint8_t bitmask = 1; // 0000 0001
     // Read Bank and extract bit
     if (gpio < 7) { // Bank A
-        data = MCP23017_ReadRegister(dev, MCP23017_REG_INTCONA);
+        MCP23017_ReadRegister(dev, MCP23017_REG_INTCONA, &data);
     }
     else{ // Bank B
         gpio =-8; // shift to keep within 0-7
-        data = MCP23017_ReadRegister(dev, MCP23017_REG_INTCONB);
+        MCP23017_ReadRegister(dev, MCP23017_REG_INTCONB, &data);
     }
     bitmask = bitmask << gpio; // Bit shift
     if (bitmask == (data & bitmask)) { // Means bit is 1
@@ -392,11 +378,15 @@ void MCP23017_SetSingleInterruptChange(MCP23017 *dev, uint8_t interrupt, uint8_t
     
     // Set the bitmask and get current polarity
     if (gpio <= 7) { // Bank A
-        current_interrupt = MCP23017_ReadRegister(dev, MCP23017_REG_INTCONA);
+        if (MCP23017_ReadRegister(dev, MCP23017_REG_INTCONA, &current_interrupt) < 0) {
+            return; // Don't write back a guess
+        }
     }
     else { // Bank B
         gpio =- 8;
-        current_interrupt = MCP23017_ReadRegister(dev, MCP23017_REG_INTCONB);
+        if (MCP23017_ReadRegister(dev, MCP23017_REG_INTCONB, &current_interrupt) < 0) {
+            return; // Don't write back a guess
+        }
     }
     bitmask = bitmask << gpio; // Shift bit to correct IO to change
 
@@ -415,19 +405,14 @@ void MCP23017_SetSingleInterruptChange(MCP23017 *dev, uint8_t interrupt, uint8_t
 }
 
 uint16_t MCP23017_GetDefaults(MCP23017 *dev) {
-    uint16_t defVal = (MCP23017_ReadRegister(dev, MCP23017_REG_DEFVALA) << 8) + MCP23017_ReadRegister(dev, MCP23017_REG_DEFVALB);
-    dev->io_interrupt_chg = defVal;
-    return defVal;
+    // Last known value if the read fails
+    MCP23017_ReadRegisterPair(dev, MCP23017_REG_DEFVALA, &dev->io_interrupt_chg);
+    return dev->io_interrupt_chg;
 }
 
 void MCP23017_SetDefaults(MCP23017 *dev, uint16_t *defaults) {
-    uint8_t *ptrDefVal = malloc(sizeof(uint8_t));
-    *ptrDefVal = *defaults >> 8;
     // Bit ordering: AAAA AAAA BBBB BBBB
-    MCP23017_WriteRegister(dev, MCP23017_REG_DEFVALA, ptrDefVal);
-    *ptrDefVal = *defaults;
-    MCP23017_WriteRegister(dev, MCP23017_REG_DEFVALB, ptrDefVal);
-    free(ptrDefVal);
+    MCP23017_WriteRegisterPair(dev, MCP23017_REG_DEFVALA, *defaults);
 }
 
 uint8_t MCP23017_GetSingleDefault(MCP23017 *dev, uint8_t gpio) {
@@ -435,11 +420,11 @@ uint8_t MCP23017_GetSingleDefault(MCP23017 *dev, uint8_t gpio) {
     uint8_t bitmask = 1; // 0000 0001
     // Read Bank and extract bit
     if (gpio < 7) { // Bank A
-        data = MCP23017_ReadRegister(dev, MCP23017_REG_DEFVALA);
+        MCP23017_ReadRegister(dev, MCP23017_REG_DEFVALA, &data);
     }
     else{ // Bank B
         gpio =-8; // shift to keep within 0-7
-        data = MCP23017_ReadRegister(dev, MCP23017_REG_DEFVALB);
+        MCP23017_ReadRegister(dev, MCP23017_REG_DEFVALB, &data);
     }
     bitmask = bitmask << gpio; // Bit shift
     if (bitmask == (data & bitmask)) { // Means bit is 1
@@ -461,11 +446,15 @@ void MCP23017_SetSingleDefault(MCP23017 *dev, uint8_t defaults, uint8_t gpio) {
     
     // Set the bitmask and get current polarity
     if (gpio <= 7) { // Bank A
-        current_defaults = MCP23017_ReadRegister(dev, MCP23017_REG_DEFVALA);
+        if (MCP23017_ReadRegister(dev, MCP23017_REG_DEFVALA, &current_defaults) < 0) {
+            return; // Don't write back a guess
+        }
     }
     else { // Bank B
         gpio =- 8;
-        current_defaults = MCP23017_ReadRegister(dev, MCP23017_REG_DEFVALB);
+        if (MCP23017_ReadRegister(dev, MCP23017_REG_DEFVALB, &current_defaults) < 0) {
+            return; // Don't write back a guess
+        }
     }
     bitmask = bitmask << gpio; // Shift bit to correct IO to change
 
@@ -484,19 +473,14 @@ void MCP23017_SetSingleDefault(MCP23017 *dev, uint8_t defaults, uint8_t gpio) {
 }
 
 uint16_t MCP23017_GetInterruptEnable(MCP23017 *dev) {
-    uint16_t intEn = (MCP23017_ReadRegister(dev, MCP23017_REG_GPINTENA) << 8) + MCP23017_ReadRegister(dev, MCP23017_REG_GPINTENB);
-    dev->io_interrupt_en = intEn;
-    return intEn;
+    // Last known value if the read fails
+    MCP23017_ReadRegisterPair(dev, MCP23017_REG_GPINTENA, &dev->io_interrupt_en);
+    return dev->io_interrupt_en;
 }
 
 void MCP23017_SetInterruptEnable(MCP23017 *dev, uint16_t *interrupt) {
-    uint8_t *ptrIntEn = malloc(sizeof(uint8_t));
-    *ptrIntEn = *interrupt >> 8;
     // Bit ordering: AAAA AAAA BBBB BBBB
-    MCP23017_WriteRegister(dev, MCP23017_REG_GPINTENA, ptrIntEn);
-    *ptrIntEn = *interrupt;
-    MCP23017_WriteRegister(dev, MCP23017_REG_GPINTENB, ptrIntEn);
-    free(ptrIntEn);
+    MCP23017_WriteRegisterPair(dev, MCP23017_REG_GPINTENA, *interrupt);
 }
 
 uint8_t MCP23017_GetSingleInterruptEnable(MCP23017 *dev, uint8_t gpio) {
@@ -504,11 +488,11 @@ uint8_t MCP23017_GetSingleInterruptEnable(MCP23017 *dev, uint8_t gpio) {
     uint8_t bitmask = 1; // 0000 0001
     // Read Bank and extract bit
     if (gpio < 7) { // Bank A
-        data = MCP23017_ReadRegister(dev, MCP23017_REG_GPINTENA);
+        MCP23017_ReadRegister(dev, MCP23017_REG_GPINTENA, &data);
     }
     else{ // Bank B
         gpio =-8; // shift to keep within 0-7
-        data = MCP23017_ReadRegister(dev, MCP23017_REG_GPINTENB);
+        MCP23017_ReadRegister(dev, MCP23017_REG_GPINTENB, &data);
     }
     bitmask = bitmask << gpio; // Bit shift
     if (bitmask == (data & bitmask)) { // Means bit is 1
@@ -530,11 +514,15 @@ void MCP23017_SetSingleInterruptEnable(MCP23017 *dev, uint8_t interrupt, uint8_t
     
     // Set the bitmask and get current polarity
     if (gpio <= 7) { // Bank A
-        current_enable_interrupt = MCP23017_ReadRegister(dev, MCP23017_REG_GPINTENA);
+        if (MCP23017_ReadRegister(dev, MCP23017_REG_GPINTENA, &current_enable_interrupt) < 0) {
+            return; // Don't write back a guess
+        }
     }
     else { // Bank B
         gpio =- 8;
-        current_enable_interrupt = MCP23017_ReadRegister(dev, MCP23017_REG_GPINTENB);
+        if (MCP23017_ReadRegister(dev, MCP23017_REG_GPINTENB, &current_enable_interrupt) < 0) {
+            return; // Don't write back a guess
+        }
     }
     bitmask = bitmask << gpio; // Shift bit to correct IO to change
 
@@ -553,19 +541,14 @@ void MCP23017_SetSingleInterruptEnable(MCP23017 *dev, uint8_t interrupt, uint8_t
 }
 
 uint16_t MCP23017_GetOutputLatch(MCP23017 *dev) {
-    uint16_t OutLatch = (MCP23017_ReadRegister(dev, MCP23017_REG_OLATA) << 8) + MCP23017_ReadRegister(dev, MCP23017_REG_OLATB);
-    dev->io_output_latch = OutLatch;
-    return OutLatch;
+    // Last known value if the read fails
+    MCP23017_ReadRegisterPair(dev, MCP23017_REG_OLATA, &dev->io_output_latch);
+    return dev->io_output_latch;
 }
 
 void MCP23017_SetOutputLatch(MCP23017 *dev, uint16_t *OutputLatch) {
-    uint8_t *ptrOutLatch = malloc(sizeof(uint8_t));
-    *ptrOutLatch = *OutputLatch >> 8;
     // Bit ordering: AAAA AAAA BBBB BBBB
-    MCP23017_WriteRegister(dev, MCP23017_REG_OLATA, ptrOutLatch);
-    *ptrOutLatch = *OutputLatch;
-    MCP23017_WriteRegister(dev, MCP23017_REG_OLATB, ptrOutLatch);
-    free(ptrOutLatch);
+    MCP23017_WriteRegisterPair(dev, MCP23017_REG_OLATA, *OutputLatch);
 }
 
 uint8_t MCP23017_GetSingleOutputLatch(MCP23017 *dev, uint8_t gpio) {
@@ -573,11 +556,11 @@ uint8_t MCP23017_GetSingleOutputLatch(MCP23017 *dev, uint8_t gpio) {
     uint8_t bitmask = 1; // 0000 0001
     // Read Bank and extract bit
     if (gpio < 7) { // Bank A
-        data = MCP23017_ReadRegister(dev, MCP23017_REG_OLATA);
+        MCP23017_ReadRegister(dev, MCP23017_REG_OLATA, &data);
     }
     else{ // Bank B
         gpio =-8; // shift to keep within 0-7
-        data = MCP23017_ReadRegister(dev, MCP23017_REG_OLATB);
+        MCP23017_ReadRegister(dev, MCP23017_REG_OLATB, &data);
     }
     bitmask = bitmask << gpio; // Bit shift
     if (bitmask == (data & bitmask)) { // Means bit is 1
@@ -599,11 +582,15 @@ void MCP23017_SetSingleOutputLatch(MCP23017 *dev, uint8_t interrupt, uint8_t gpi
     
     // Set the bitmask and get current polarity
     if (gpio <= 7) { // Bank A
-        current_output_latch = MCP23017_ReadRegister(dev, MCP23017_REG_OLATA);
+        if (MCP23017_ReadRegister(dev, MCP23017_REG_OLATA, &current_output_latch) < 0) {
+            return; // Don't write back a guess
+        }
     }
     else { // Bank B
         gpio =- 8;
-        current_output_latch = MCP23017_ReadRegister(dev, MCP23017_REG_OLATB);
+        if (MCP23017_ReadRegister(dev, MCP23017_REG_OLATB, &current_output_latch) < 0) {
+            return; // Don't write back a guess
+        }
     }
     bitmask = bitmask << gpio; // Shift bit to correct IO to change
 
@@ -621,20 +608,25 @@ void MCP23017_SetSingleOutputLatch(MCP23017 *dev, uint8_t interrupt, uint8_t gpi
     }
 }
 
+int HOT_PATH(MCP23017_WriteOutputLatch)(MCP23017 *dev, uint16_t latch) {
+    // Bit ordering: AAAA AAAA BBBB BBBB
+    uint8_t data[2] = {latch >> 8, latch & 0xFF};
+    int result = MCP23017_TransportWrite(dev, MCP23017_REG_OLATA, data, 2);
+    if (result == 0) {
+        dev->io_output_latch = latch;
+    }
+    return result;
+}
+
 uint16_t MCP23017_GetIOExpanderConfiguration(MCP23017 *dev) {
-    uint16_t IOExpConfig = (MCP23017_ReadRegister(dev, MCP23017_REG_IOCONA) << 8) + MCP23017_ReadRegister(dev, MCP23017_REG_IOCONB);
-    dev->expander_config = IOExpConfig;
-    return IOExpConfig;
+    // Last known value if the read fails
+    MCP23017_ReadRegisterPair(dev, MCP23017_REG_IOCONA, &dev->expander_config);
+    return dev->expander_config;
 }
 
 void MCP23017_SetIOExpanderConfiguration(MCP23017 *dev, uint16_t *IOConfiguration) {
-    uint8_t *ptrIOExpConfig = malloc(sizeof(uint8_t));
-    *ptrIOExpConfig = *IOConfiguration >> 8;
     // Bit ordering: AAAA AAAA BBBB BBBB
-    MCP23017_WriteRegister(dev, MCP23017_REG_IOCONA, ptrIOExpConfig);
-    *ptrIOExpConfig = *IOConfiguration;
-    MCP23017_WriteRegister(dev, MCP23017_REG_IOCONB, ptrIOExpConfig);
-    free(ptrIOExpConfig);
+    MCP23017_WriteRegisterPair(dev, MCP23017_REG_IOCONA, *IOConfiguration);
 }
 
 uint8_t MCP23017_GetSingleIOExpanderConfiguration(MCP23017 *dev, uint8_t gpio) {
@@ -642,11 +634,11 @@ uint8_t MCP23017_GetSingleIOExpanderConfiguration(MCP23017 *dev, uint8_t gpio) {
     uint8_t bitmask = 1; // 0000 0001
     // Read Bank and extract bit
     if (gpio < 7) { // Bank A
-        data = MCP23017_ReadRegister(dev, MCP23017_REG_IOCONA);
+        MCP23017_ReadRegister(dev, MCP23017_REG_IOCONA, &data);
     }
     else{ // Bank B
         gpio =-8; // shift to keep within 0-7
-        data = MCP23017_ReadRegister(dev, MCP23017_REG_IOCONB);
+        MCP23017_ReadRegister(dev, MCP23017_REG_IOCONB, &data);
     }
     bitmask = bitmask << gpio; // Bit shift
     if (bitmask == (data & bitmask)) { // Means bit is 1
@@ -668,11 +660,15 @@ void MCP23017_SetSingleIOExpanderConfiguration(MCP23017 *dev, uint8_t configurat
     
     // Set the bitmask and get current polarity
     if (gpio <= 7) { // Bank A
-        current_io_expander_config = MCP23017_ReadRegister(dev, MCP23017_REG_IOCONA);
+        if (MCP23017_ReadRegister(dev, MCP23017_REG_IOCONA, &current_io_expander_config) < 0) {
+            return; // Don't write back a guess
+        }
     }
     else { // Bank B
         gpio =- 8;
-        current_io_expander_config = MCP23017_ReadRegister(dev, MCP23017_REG_IOCONB);
+        if (MCP23017_ReadRegister(dev, MCP23017_REG_IOCONB, &current_io_expander_config) < 0) {
+            return; // Don't write back a guess
+        }
     }
     bitmask = bitmask << gpio; // Shift bit to correct IO to change
 
@@ -691,19 +687,14 @@ void MCP23017_SetSingleIOExpanderConfiguration(MCP23017 *dev, uint8_t configurat
 }
 
 uint16_t MCP23017_GetInterruptCapture(MCP23017 *dev) {
-    uint16_t IntCap = (MCP23017_ReadRegister(dev, MCP23017_REG_INTCAPA) << 8) + MCP23017_ReadRegister(dev, MCP23017_REG_INTCAPB);
-    dev->io_interrupt_cap = IntCap;
-    return IntCap;
+    // Last known value if the read fails
+    MCP23017_ReadRegisterPair(dev, MCP23017_REG_INTCAPA, &dev->io_interrupt_cap);
+    return dev->io_interrupt_cap;
 }
 
 void MCP23017_SetInterruptCapture(MCP23017 *dev, uint16_t *InterruptCapture) {
-    uint8_t *ptrIntCap = malloc(sizeof(uint8_t));
-    *ptrIntCap = *InterruptCapture >> 8;
     // Bit ordering: AAAA AAAA BBBB BBBB
-    MCP23017_WriteRegister(dev, MCP23017_REG_INTCAPA, ptrIntCap);
-    *ptrIntCap = *InterruptCapture;
-    MCP23017_WriteRegister(dev, MCP23017_REG_INTCAPB, ptrIntCap);
-    free(ptrIntCap);
+    MCP23017_WriteRegisterPair(dev, MCP23017_REG_INTCAPA, *InterruptCapture);
 }
 
 uint8_t MCP23017_GetSingleInterruptCapture(MCP23017 *dev, uint8_t gpio) {
@@ -711,11 +702,11 @@ uint8_t MCP23017_GetSingleInterruptCapture(MCP23017 *dev, uint8_t gpio) {
     uint8_t bitmask = 1; // 0000 0001
     // Read Bank and extract bit
     if (gpio < 7) { // Bank A
-        data = MCP23017_ReadRegister(dev, MCP23017_REG_INTCAPA);
+        MCP23017_ReadRegister(dev, MCP23017_REG_INTCAPA, &data);
     }
     else{ // Bank B
         gpio =-8; // shift to keep within 0-7
-        data = MCP23017_ReadRegister(dev, MCP23017_REG_INTCAPB);
+        MCP23017_ReadRegister(dev, MCP23017_REG_INTCAPB, &data);
     }
     bitmask = bitmask << gpio; // Bit shift
     if (bitmask == (data & bitmask)) { // Means bit is 1
@@ -737,11 +728,15 @@ void MCP23017_SetSingleInterruptCapture(MCP23017 *dev, uint8_t interrupt, uint8_
     
     // Set the bitmask and get current polarity
     if (gpio <= 7) { // Bank A
-        current_interrupt_capture = MCP23017_ReadRegister(dev, MCP23017_REG_INTCAPA);
+        if (MCP23017_ReadRegister(dev, MCP23017_REG_INTCAPA, &current_interrupt_capture) < 0) {
+            return; // Don't write back a guess
+        }
     }
     else { // Bank B
         gpio =- 8;
-        current_interrupt_capture = MCP23017_ReadRegister(dev, MCP23017_REG_INTCAPB);
+        if (MCP23017_ReadRegister(dev, MCP23017_REG_INTCAPB, &current_interrupt_capture) < 0) {
+            return; // Don't write back a guess
+        }
     }
     bitmask = bitmask << gpio; // Shift bit to correct IO to change
 
@@ -762,9 +757,9 @@ void MCP23017_SetSingleInterruptCapture(MCP23017 *dev, uint8_t interrupt, uint8_
 // Read only Registers
 // Read only, Updated when an interrupt occurs, remains unchanged until cleared by reading GPIO or INTCAP
 uint16_t MCP23017_GetInterruptFlag(MCP23017 *dev) {
-    uint16_t intFlag = (MCP23017_ReadRegister(dev, MCP23017_REG_INTFA) << 8) + MCP23017_ReadRegister(dev, MCP23017_REG_INTFB);
-    dev->io_interrupt_flag = intFlag;
-    return intFlag;
+    // Last known value if the read fails
+    MCP23017_ReadRegisterPair(dev, MCP23017_REG_INTFA, &dev->io_interrupt_flag);
+    return dev->io_interrupt_flag;
 }
 // Read only, Updated when an interrupt occurs, remains unchanged until cleared by reading GPIO or INTCAP
 uint8_t MCP23017_GetSingleInterruptFlag(MCP23017 *dev, uint8_t gpio) {
@@ -772,11 +767,11 @@ uint8_t MCP23017_GetSingleInterruptFlag(MCP23017 *dev, uint8_t gpio) {
     uint8_t bitmask = 1; // 0000 0001
     // Read Bank and extract bit
     if (gpio < 7) { // Bank A
-        data = MCP23017_ReadRegister(dev, MCP23017_REG_INTFA);
+        MCP23017_ReadRegister(dev, MCP23017_REG_INTFA, &data);
     }
     else{ // Bank B
         gpio =-8; // shift to keep within 0-7
-        data = MCP23017_ReadRegister(dev, MCP23017_REG_INTFB);
+        MCP23017_ReadRegister(dev, MCP23017_REG_INTFB, &data);
     }
     bitmask = bitmask << gpio; // Bit shift
     if (bitmask == (data & bitmask)) { // Means bit is 1
@@ -787,35 +782,65 @@ uint8_t MCP23017_GetSingleInterruptFlag(MCP23017 *dev, uint8_t gpio) {
     }
 }
 
-// Reads 1 byte into <data> from the register specified by <reg_address>
-uint8_t MCP23017_ReadRegister(MCP23017* dev, uint8_t reg_address) {
-    uint8_t *data = malloc(sizeof(uint8_t));
-    uint8_t *reg = malloc(sizeof(uint8_t));
-    *reg = reg_address;
-    i2c_write_blocking(dev->i2c_instance, dev->mcp23017_i2c_addr, reg, 1, true);
-    free(reg);
-    i2c_read_blocking(dev->i2c_instance, dev->mcp23017_i2c_addr, data, 1, false);
-    uint8_t out = *data;
-    free(data);
-    return out;
+// INTFA/B, INTCAPA/B and GPIOA/B are consecutive (0x0E-0x13), so one 6 byte read gets the
+// pins that interrupted, the inputs when they did and the inputs now. The GPIO read clears
+// the interrupt, INTCAP was latched before that so nothing is lost in between
+int HOT_PATH(MCP23017_ReadCapture)(MCP23017 *dev, uint16_t *flags, uint16_t *capture, uint16_t *io) {
+    uint8_t data[6];
+    int result = MCP23017_TransportRead(dev, MCP23017_REG_INTFA, data, sizeof(data));
+    if (result < 0) {
+        return result;
+    }
+    // Bit ordering: AAAA AAAA BBBB BBBB
+    dev->io_interrupt_flag = (data[0] << 8) | data[1];
+    dev->io_interrupt_cap = (data[2] << 8) | data[3];
+    dev->io_value = (data[4] << 8) | data[5];
+    *flags = dev->io_interrupt_flag;
+    *capture = dev->io_interrupt_cap;
+    *io = dev->io_value;
+    return 0;
 }
 
-// Maybe not needed?
-uint8_t* MCP23017_ReadRegisters(MCP23017 *dev, uint8_t reg_address, uint8_t length) {
-    uint8_t *data = malloc(sizeof(uint8_t) * length);
-    uint8_t *reg = malloc(sizeof(uint8_t));
-    *reg = reg_address;
-    i2c_write_blocking(dev->i2c_instance, dev->mcp23017_i2c_addr, reg, 1, true);
-    free(reg);
-    i2c_read_blocking(dev->i2c_instance, dev->mcp23017_i2c_addr, data, length, false);
-    return data;
+// Reads 1 byte into <data> from the register specified by <reg_address>, <data> is untouched on failure
+int MCP23017_ReadRegister(MCP23017* dev, uint8_t reg_address, uint8_t *data) {
+    uint8_t value = 0;
+    int result = MCP23017_TransportRead(dev, reg_address, &value, 1);
+    if (result < 0) {
+        return result;
+    }
+    *data = value;
+    return 0;
 }
 
-// Writes all of <data> to the register specified by <reg_address>
+// Reads <length> bytes starting at <reg_address> in a single transaction.
+// Relies on IOCON.SEQOP = 0 (default) so the address pointer increments
+int MCP23017_ReadRegisters(MCP23017 *dev, uint8_t reg_address, uint8_t *data, uint8_t length) {
+    return MCP23017_TransportRead(dev, reg_address, data, length);
+}
+
+// Writes a single byte of <data> to the register specified by <reg_address>
 void MCP23017_WriteRegister(MCP23017 *dev, uint8_t reg_address, uint8_t *data) {
-    uint8_t *reg = malloc(sizeof(uint8_t));
-    *reg = reg_address;
-    i2c_write_blocking(dev->i2c_instance, dev->mcp23017_i2c_addr, reg, 1, true);
-    free(reg);
-    i2c_write_blocking(dev->i2c_instance, dev->mcp23017_i2c_addr, data, sizeof(*data), false);
-}
\ No newline at end of file
+    MCP23017_TransportWrite(dev, reg_address, data, 1);
+}
+
+// Writes <length> bytes starting at <reg_address> in a single transaction
+int MCP23017_WriteRegisters(MCP23017 *dev, uint8_t reg_address, const uint8_t *data, uint8_t length) {
+    return MCP23017_TransportWrite(dev, reg_address, data, length);
+}
+
+// Reads an A/B register pair in one burst, <value> is untouched on failure. Bit ordering: AAAA AAAA BBBB BBBB
+int HOT_PATH(MCP23017_ReadRegisterPair)(MCP23017 *dev, uint8_t reg_address_a, uint16_t *value) {
+    uint8_t data[2] = {0, 0};
+    int result = MCP23017_TransportRead(dev, reg_address_a, data, 2);
+    if (result < 0) {
+        return result;
+    }
+    *value = (data[0] << 8) | data[1];
+    return 0;
+}
+
+// Writes an A/B register pair in one burst. Bit ordering: AAAA AAAA BBBB BBBB
+void MCP23017_WriteRegisterPair(MCP23017 *dev, uint8_t reg_address_a, uint16_t value) {
+    uint8_t data[2] = {value >> 8, value & 0xFF};
+    MCP23017_TransportWrite(dev, reg_address_a, data, 2);
+}
@@ -13,6 +13,22 @@
 #ifndef _MCP23017_H
 #define _MCP23017_H
 
+#include <stdint.h>
+
+// Transport backend, selected at compile time by the MCP23017_TRANSPORT CMake option.
+// The MCP23S17 is register compatible with the MCP23017, only the bus differs
+#define MCP23017_TRANSPORT_I2C  0
+#define MCP23017_TRANSPORT_SPI  1
+#ifndef MCP23017_TRANSPORT
+#define MCP23017_TRANSPORT      MCP23017_TRANSPORT_I2C
+#endif
+
+#if MCP23017_TRANSPORT == MCP23017_TRANSPORT_SPI
+#include "hardware/spi.h"
+#else
+#include "I2CBus.h"
+#endif
+
 // I2C address
 #define MCP23017_I2C_ADDRESS    0x20 // Default address is 0x20. Range from 0x20-0x27, bit ordering is 0 0 1 0 0 A2 A1 A0
 
@@ -39,12 +55,32 @@
 #define MCP23017_REG_GPIOB      0x13
 #define MCP23017_REG_OLATA      0x14 // Output Latching
 #define MCP23017_REG_OLATB      0x15
+#define MCP23017_REG_COUNT      0x16
+
+// IOCON bits
+#define MCP23017_IOCON_BANK     0x80 // Register banking, driver assumes 0
+#define MCP23017_IOCON_MIRROR   0x40 // INTA/INTB internally connected
+#define MCP23017_IOCON_SEQOP    0x20 // Disables address pointer increment, driver assumes 0
+#define MCP23017_IOCON_DISSLW   0x10 // Disables SDA slew rate control
+#define MCP23017_IOCON_HAEN     0x08 // MCP23S17 only - enables hardware address pins
+#define MCP23017_IOCON_ODR      0x04 // INT pins open drain
+#define MCP23017_IOCON_INTPOL   0x02 // INT pins active high
+
+// MCP23S17 SPI opcode: 0 1 0 0 A2 A1 A0 R/W
+#define MCP23017_SPI_OPCODE_WRITE(addr) ((uint8_t)((addr) << 1))
+#define MCP23017_SPI_OPCODE_READ(addr)  ((uint8_t)(((addr) << 1) | 1))
 
 typedef struct {
     
-    // I2C instance/Handle
-    i2c_inst_t *i2c_instance;
-    uint8_t mcp23017_i2c_addr;
+#if MCP23017_TRANSPORT == MCP23017_TRANSPORT_SPI
+    // SPI instance/Handle, chip select is driven manually
+    spi_inst_t *spi_instance;
+    uint8_t spi_cs_pin;
+#else
+    // Registry handle, the bus arbitrates and accounts every transfer
+    I2CBus_Device *bus_device;
+#endif
+    uint8_t mcp23017_addr; // 0x20-0x27, also used for the MCP23S17 opcode (HAEN)
     uint16_t io_value;
     uint16_t io_configuration;
     uint16_t io_direction;
@@ -58,10 +94,19 @@ typedef struct {
     uint16_t expander_config;
 } MCP23017;
 
-uint8_t MCP23017_Initialise(MCP23017 *dev, i2c_inst_t *i2c_instance, uint8_t MCP23017_ADDRESS);
+#if MCP23017_TRANSPORT == MCP23017_TRANSPORT_SPI
+// SPI bus must already be initialised (mode 0, up to 10MHz)
+uint8_t MCP23017_InitialiseSPI(MCP23017 *dev, spi_inst_t *spi_instance, uint8_t cs_pin, uint8_t MCP23017_ADDRESS);
+#else
+// Address comes from the handle, normally found by I2CBus_Discover
+uint8_t MCP23017_Initialise(MCP23017 *dev, I2CBus_Device *device);
+#endif
+uint8_t MCP23017_InitialiseState(MCP23017 *dev, uint8_t MCP23017_ADDRESS);
 
 // IO
-uint16_t MCP23017_GetIO(MCP23017 *dev);
+// GetIO returns 0 or a negative PICO_ERROR_ code and only writes <io> on success. The other 16 bit
+// Get functions return the last known value (also kept in the struct) if the read fails
+int MCP23017_GetIO(MCP23017 *dev, uint16_t *io);
 void MCP23017_SetIO(MCP23017 *dev, uint16_t *data);
 uint8_t MCP23017_GetSingleIO(MCP23017 *dev, uint8_t gpio);
 void MCP23017_SetSingleIO(MCP23017 *dev, uint8_t value, uint8_t gpio);
@@ -108,6 +153,8 @@ uint16_t MCP23017_GetOutputLatch(MCP23017 *dev);
 void MCP23017_SetOutputLatch(MCP23017 *dev, uint16_t *interrupt);
 uint8_t MCP23017_GetSingleOutputLatch(MCP23017 *dev, uint8_t gpio);
 void MCP23017_SetSingleOutputLatch(MCP23017 *dev, uint8_t interrupt, uint8_t gpio);
+// Writes OLATA/OLATB in one burst without reading them first. Returns 0 or a negative PICO_ERROR_ code
+int MCP23017_WriteOutputLatch(MCP23017 *dev, uint16_t latch);
 
 // IO Expander Configuration
 uint16_t MCP23017_GetIOExpanderConfiguration(MCP23017 *dev);
@@ -123,14 +170,30 @@ uint8_t MCP23017_GetSingleInterruptFlag(MCP23017 *dev, uint8_t gpio);
 uint16_t MCP23017_GetInterruptCapture(MCP23017 *dev);
 uint8_t MCP23017_GetSingleInterruptCapture(MCP23017 *dev, uint8_t gpio);
 
+// INTF, INTCAP and GPIO in one burst, clearing the interrupt. Returns 0 or a negative PICO_ERROR_ code
+int MCP23017_ReadCapture(MCP23017 *dev, uint16_t *flags, uint16_t *capture, uint16_t *io);
+
 // Direct register manipulation
 
-// Read a single byte from specified register <reg_address>
-uint8_t MCP23017_ReadRegister(MCP23017* dev, uint8_t reg_address);
+// Read a single byte from specified register <reg_address> into <data>. Returns 0 or a negative PICO_ERROR_ code
+int MCP23017_ReadRegister(MCP23017* dev, uint8_t reg_address, uint8_t *data);
 
-// Read <length> bytes from specified register <reg_address>
-uint8_t *MCP23017_ReadRegisters(MCP23017 *dev, uint8_t reg_address, uint8_t length);
+// Read <length> bytes starting at register <reg_address> in one transaction into <data>
+int MCP23017_ReadRegisters(MCP23017 *dev, uint8_t reg_address, uint8_t *data, uint8_t length);
 
 // Write a single byte of data <data> to specified register <reg_address>
 void MCP23017_WriteRegister(MCP23017 *dev, uint8_t reg_address, uint8_t *data);
+
+// Write <length> bytes of <data> starting at register <reg_address> in one transaction
+int MCP23017_WriteRegisters(MCP23017 *dev, uint8_t reg_address, const uint8_t *data, uint8_t length);
+
+// Read/write an A/B register pair in one burst, <reg_address_a> is the Bank A register.
+// The read returns 0 or a negative PICO_ERROR_ code and only writes <value> on success
+int MCP23017_ReadRegisterPair(MCP23017 *dev, uint8_t reg_address_a, uint16_t *value);
+void MCP23017_WriteRegisterPair(MCP23017 *dev, uint8_t reg_address_a, uint16_t value);
+
+// Transport backend - implemented by MCP23017_I2C.c or MCP23017_SPI.c
+// Both return 0 on success or a negative PICO_ERROR_ code
+int MCP23017_TransportRead(MCP23017 *dev, uint8_t reg_address, uint8_t *data, uint8_t length);
+int MCP23017_TransportWrite(MCP23017 *dev, uint8_t reg_address, const uint8_t *data, uint8_t length);
 #endif
\ No newline at end of file
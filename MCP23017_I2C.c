@@ -0,0 +1,43 @@
+/*
+ *
+ *  MCP23017 GPIO Expander Driver - I2C transport
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *  Datasheet: https://ww1.microchip.com/downloads/aemDocuments/documents/APID/ProductDocuments/DataSheets/MCP23017-Data-Sheet-DS20001952.pdf
+ * 
+*/
+
+#include <string.h>
+#include "I2CBus.h"
+#include "MCP23017.h"
+#include "HotPath.h"
+#include "pico/stdlib.h"
+
+uint8_t MCP23017_Initialise(MCP23017 *dev, I2CBus_Device *device) {
+    // Checks a device was found
+    if (device == NULL) {
+        return 1;
+    }
+    dev->bus_device = device;
+    return MCP23017_InitialiseState(dev, device->address);
+}
+
+// Register address then a repeated start into the read, as per datasheet figure 3-5
+int HOT_PATH(MCP23017_TransportRead)(MCP23017 *dev, uint8_t reg_address, uint8_t *data, uint8_t length) {
+    return I2CBus_WriteRead(dev->bus_device, &reg_address, 1, data, length);
+}
+
+// Register address and data must go out in the same transaction, the first byte after
+// a (repeated) start is always taken as the register address
+int HOT_PATH(MCP23017_TransportWrite)(MCP23017 *dev, uint8_t reg_address, const uint8_t *data, uint8_t length) {
+    uint8_t buffer[MCP23017_REG_COUNT + 1];
+    if (length > MCP23017_REG_COUNT) {
+        return PICO_ERROR_INVALID_ARG;
+    }
+    buffer[0] = reg_address;
+    memcpy(&buffer[1], data, length);
+    return I2CBus_Write(dev->bus_device, buffer, length + 1);
+}
@@ -0,0 +1,68 @@
+/*
+ *
+ *  MCP23017 GPIO Expander Driver - SPI transport (MCP23S17)
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *  Datasheet: https://ww1.microchip.com/downloads/aemDocuments/documents/APID/ProductDocuments/DataSheets/MCP23017-Data-Sheet-DS20001952.pdf
+ * 
+*/
+
+// A full 16 bit GPIO read is 4 bytes on the wire, about 3.2us at 10MHz.
+// SPI has no acknowledge, so a failure here is a short transfer rather than a missing device
+#include "hardware/spi.h"
+#include "hardware/gpio.h"
+#include "MCP23017.h"
+#include "HotPath.h"
+#include "pico/stdlib.h"
+
+uint8_t MCP23017_InitialiseSPI(MCP23017 *dev, spi_inst_t *spi_instance, uint8_t cs_pin, uint8_t mcp23017_address) {
+    // Checks HW SPI is functional
+    if (spi_instance == NULL) {
+        return 1;
+    }
+    dev->spi_instance = spi_instance;
+    dev->spi_cs_pin = cs_pin;
+    if (MCP23017_InitialiseState(dev, mcp23017_address)) {
+        return 1;
+    }
+
+    // Chip select is active-low, so initialise it to a driven-high state
+    gpio_init(cs_pin);
+    gpio_set_dir(cs_pin, GPIO_OUT);
+    gpio_put(cs_pin, 1);
+
+    // Hardware address pins are ignored until HAEN is set. Until then every device
+    // answers to A2..A0 = 000, so the write goes to the 0x20 opcode. It is sent and recorded
+    // for 0x20 too: that device shares the chip select, and anything that later rewrites IOCON
+    // from expander_config (the wake setup) must not clear HAEN for the others
+    uint8_t frame[3] = {MCP23017_SPI_OPCODE_WRITE(MCP23017_I2C_ADDRESS), MCP23017_REG_IOCONA, MCP23017_IOCON_HAEN};
+    gpio_put(cs_pin, 0);
+    int written = spi_write_blocking(spi_instance, frame, 3);
+    gpio_put(cs_pin, 1);
+    if (written != 3) {
+        return 1;
+    }
+    dev->expander_config = (MCP23017_IOCON_HAEN << 8) | MCP23017_IOCON_HAEN;
+    return 0;
+}
+
+int HOT_PATH(MCP23017_TransportRead)(MCP23017 *dev, uint8_t reg_address, uint8_t *data, uint8_t length) {
+    uint8_t header[2] = {MCP23017_SPI_OPCODE_READ(dev->mcp23017_addr), reg_address};
+    gpio_put(dev->spi_cs_pin, 0);
+    int result = spi_write_blocking(dev->spi_instance, header, 2) == 2
+              && spi_read_blocking(dev->spi_instance, 0, data, length) == length ? 0 : PICO_ERROR_IO;
+    gpio_put(dev->spi_cs_pin, 1);
+    return result;
+}
+
+int HOT_PATH(MCP23017_TransportWrite)(MCP23017 *dev, uint8_t reg_address, const uint8_t *data, uint8_t length) {
+    uint8_t header[2] = {MCP23017_SPI_OPCODE_WRITE(dev->mcp23017_addr), reg_address};
+    gpio_put(dev->spi_cs_pin, 0);
+    int result = spi_write_blocking(dev->spi_instance, header, 2) == 2
+              && spi_write_blocking(dev->spi_instance, data, length) == length ? 0 : PICO_ERROR_IO;
+    gpio_put(dev->spi_cs_pin, 1);
+    return result;
+}
@@ -1,10 +1,77 @@
 #include <stdio.h>
-#include <malloc.h>
+#include <string.h>
 #include "pico/stdlib.h"
 #include "hardware/spi.h"
 #include "hardware/i2c.h"
-#include "mcp23017.h"
-#include "ssd1306.h"
+#include "Macropad_Config.h"
+#if MACROPAD_I2C
+#include "I2CBus.h"
+#endif
+#if MACROPAD_MATRIX
+#include "Matrix.h"
+#include "Matrix.pio.h"
+#include "hardware/dma.h"
+#else
+#include "MCP23017.h"
+#if MACROPAD_EDGE_CAPTURE
+#include "EdgeCapture.h"
+#endif
+#endif
+#if MACROPAD_INDICATORS
+#include "Indicator.h"
+#endif
+#include "Scheduler.h"
+#include "Power.h"
+#include "KeyPipeline.h"
+#include "Debounce.h"
+#include "Combo.h"
+#include "Keymap.h"
+#include "HidReport.h"
+#include "Layout.h"
+#if MACROPAD_TRACE
+#include "Trace.h"
+#endif
+#if MACROPAD_KEYSTATS
+#include "KeyStats.h"
+#include "FlashStore.h"
+#endif
+#if MACROPAD_USB
+#include "Usb.h"
+#endif
+#if MACROPAD_ENCODER
+#include "Encoder.h"
+#include "Encoder.pio.h"
+#endif
+#if MACROPAD_SDCARD
+#include "SDCard.h"
+#include "SectorCache.h"
+#include "Fat.h"
+#endif
+#if MACROPAD_DISPLAY
+#include "SSD1306.h"
+#include "Animation.h"
+#include "Compositor.h"
+#include "Widgets.h"
+#include "pico/multicore.h"
+#include "pico/flash.h"
+#endif
+#include "Boot.h"
+#include "HotPath.h"
+#include "Console.h"
+#include "Supervisor.h"
+#include "StackCheck.h"
+#if MACROPAD_JITTER
+#include "Jitter.h"
+#include "hardware/structs/systick.h"
+#include "hardware/structs/xip_ctrl.h"
+#endif
+#include "hardware/timer.h"
+#include "hardware/sync.h"
+#include "hardware/clocks.h"
+#include "hardware/uart.h"
+#include "hardware/pio.h"
+#include "hardware/irq.h"
+#include "hardware/watchdog.h"
 
 // SPI Defines
 // We are going to use SPI 0, and allocate it to the following GPIO pins
@@ -14,24 +81,948 @@
 #define PIN_CS   17
 #define PIN_SCK  18
 #define PIN_MOSI 19
+#if MCP23017_TRANSPORT == MCP23017_TRANSPORT_SPI
+#define PIN_SD_CS       20 // PIN_CS belongs to the MCP23S17
+#define SPI_BAUDRATE    10*1000*1000 // MCP23S17 limit, the card shares the bus at the same rate
+#else
+#define PIN_SD_CS       PIN_CS
+#define SPI_BAUDRATE    25*1000*1000
+#endif
 
 // I2C defines
-// This example will use I2C1 on GPIO6 (SDA) and GPIO7 (SCL) running at 400KHz.
+// I2C1, pins and rate come from the board profile (GPIO6/GPIO7 at 400KHz by default).
 // Pins can be changed, see the GPIO function select table in the datasheet for information on GPIO assignments
 #define I2C_PORT i2c1
-#define I2C_SDA 6
-#define I2C_SCL 7
-#define LED_PIN 25 // LED pin is fixed at 25
+#define I2C_SDA MACROPAD_PIN_I2C_SDA
+#define I2C_SCL MACROPAD_PIN_I2C_SCL
+#define I2C_BAUDRATE MACROPAD_I2C_BAUDRATE
+#define LED_PIN MACROPAD_PIN_LED
 
-void setup_i2c(i2c_inst_t i2cBus, uint8_t i2cSDA, uint8_t i2cSCL) {
-    i2c_init(&i2cBus, 400*1000);
+// MCP23017 INTA, open drain with INTA/INTB mirrored. A second expander's INTA is wired to the same pin
+#define MCP23017_INT_PIN MACROPAD_PIN_EXPANDER_INT
+
+// Key matrix on native pins, scanned by PIO. Rows and columns are consecutive from the first pin
+#define MATRIX_PIO              pio1
+#define MATRIX_PIO_IRQ          PIO1_IRQ_0
+#define MATRIX_ROW_MASK         (((1u << MATRIX_ROWS) - 1) << MACROPAD_PIN_MATRIX_ROW0)
+
+// Indicator LEDs on the expander pins after the last key, in this order
+#define INDICATOR_LAYER         0 // Any layer above the base layer active
+#define INDICATOR_CAPS_LOCK     1 // Host LED report
+
+// Rotary encoder on native pins, B must be the pin after A. Sampled by PIO
+#define ENCODER_PIN_A           MACROPAD_PIN_ENCODER_A
+#define ENCODER_PIO             pio0
+#define ENCODER_PIO_IRQ         PIO0_IRQ_0
+#define ENCODER_PIO_CLOCK_HZ    1000000
+#define ENCODER_KEY_CW          20 // Virtual keys in the keymap
+#define ENCODER_KEY_CCW         21
+
+// Display
+#define DISPLAY_WIDTH   128
+#define DISPLAY_HEIGHT  32
+
+// Widgets on core 1 once the boot animation is done. Regions on the 128x32 panel:
+//   layer banner (Font_Medium) | counters       pages 0-1
+//   status line, last combo                    page 2
+//   heat strip, a bar per key                  page 3
+#define DISPLAY_FRAME_US        COMPOSITOR_DEFAULT_FRAME_US
+#define DISPLAY_IDLE_WAIT_US    100000 // Core 1 wakes at least this often to beat
+#define DISPLAY_HEARTBEAT_US    1000000
+#define HEAT_DECAY_US           1000000
+#define RATE_BUCKET_US          10000000 // Presses per minute over 6 buckets
+#define RATE_BUCKETS            6
+
+// Boot logo, built into flash from assets/boot_logo.pbm. A file on the SD card replaces it
+extern const uint8_t Boot_Logo[];
+extern const uint32_t Boot_Logo_Length;
+#define BOOT_ANIMATION_PATH     "/boot.mpa"
+
+// Power manager idle timeouts
+#define POWER_IDLE_AFTER_MS     30000
+#define POWER_SLEEP_AFTER_MS    120000
+#define POWER_DORMANT_AFTER_MS  300000
+#define POWER_PERIOD_US         100000
+#define POWER_SYS_CLOCK_KHZ     125000
+
+// Scheduler
+#define SCAN_PERIOD_US      MACROPAD_SCAN_PERIOD_US // Key scan
+#define CONSOLE_PERIOD_US   50000 // Key event log and serial commands
+#define BOOT_STEP_PERIOD_US 20000 // Deferred boot steps, one per release
+#define KEYSTATS_PERIOD_US  100000 // Key statistics, drained behind the pipeline
+#define KEYSTATS_SAVE_PERIOD_US 3600000000u // Flash save, only if anything changed
+#define WIDGETS_PERIOD_US   50000 // Display widgets, drained behind the pipeline
+#define USB_PERIOD_US       1000 // Device task, also triggered by USB events and new reports
+
+// Raw HID requests, first byte is the command, the reply echoes it
+#define RAW_COMMAND_INFO        0x01 // Reply: version, key count, layer count, toggled layers
+#define RAW_COMMAND_SET_LAYERS  0x02 // Request: toggled layer mask. Reply: the new mask
+#define RAW_REPLY_UNKNOWN       0xFF
+
+// Supervisor. The watchdog outlasts the longest blocking boot step (SD card init)
+#define SUPERVISOR_PERIOD_US        100000
+#define SUPERVISOR_WATCHDOG_MS      3000
+#define SCAN_HEARTBEAT_US           250000
+#define CONSOLE_HEARTBEAT_US        1000000
+#define SUPERVISOR_KEEP_LAYERS      0 // Toggled layer mask
+
+// Flash record slots
+#define FLASHSTORE_SLOT_KEYSTATS    0
+
+// Stack regions from the SDK linker script, core 0 in SCRATCH_Y and core 1 in SCRATCH_X
+extern uint32_t __StackBottom[];
+extern uint32_t __StackTop[];
+extern uint32_t __StackOneBottom[];
+extern uint32_t __StackOneTop[];
+
+static Boot boot;
+static Supervisor supervisor;
+// Left alone by the runtime init, so the previous run's breadcrumbs survive a watchdog reset
+static Supervisor_Crumbs __uninitialized_ram(supervisor_crumbs);
+static StackCheck stack_check;
+#if MACROPAD_JITTER
+// Scan iterations in SysTick cycles: "scan" is the whole task, bus read included, and
+// "process" is debounce through to the report build
+#define JITTER_SYSTICK_MASK     0x00FFFFFF
+static Jitter scan_jitter;
+static Jitter process_jitter;
+static bool jitter_enabled;
+static bool jitter_flush; // Empty the XIP cache before each scan, as if the display or LEDs had evicted it
+#endif
+static int scan_heartbeat;
+static int console_heartbeat;
+static int boot_task_id;
+static Console console;
+static Scheduler scheduler;
+static int idle_alarm;
+static int scan_task_id;
+#if MACROPAD_I2C
+static I2CBus i2c_bus;
+#endif
+#if MACROPAD_MATRIX
+static Matrix matrix;
+static volatile uint32_t matrix_raw = 0xFFFFFFFF; // Latest scan word, written by DMA on every change
+static uint matrix_sm;
+static uint matrix_offset;
+#else
+static MCP23017 expanders[MACROPAD_EXPANDER_COUNT];
+// Inputs with a key on them, the rest are masked off before debounce
+static const uint16_t expander_key_mask[MACROPAD_EXPANDER_COUNT] = MACROPAD_EXPANDER_KEY_MASKS;
+#if MACROPAD_EDGE_CAPTURE
+static EdgeCapture edge_capture;
+static volatile uint32_t capture_time_us; // Last INT falling edge
+static uint32_t last_scan_us;
+#endif
+#endif
+#if MACROPAD_INDICATORS
+static Indicator indicators;
+#endif
+static KeyPipeline pipeline;
+static Debounce debounce;
+static Combo combo;
+static Keymap keymap;
+static HidReport hid;
+#if MACROPAD_TRACE
+static Trace trace;
+#endif
+static int console_consumer;
+#if MACROPAD_KEYSTATS
+static KeyStats keystats;
+static int keystats_consumer;
+#endif
+#if MACROPAD_USB
+static Usb usb;
+static int usb_task_id;
+#endif
+#if MACROPAD_ENCODER
+static Encoder encoder;
+static uint encoder_sm;
+#endif
+#if MACROPAD_SDCARD
+static SDCard sdcard;
+static BlockDevice sd_device;
+static SectorCache sd_cache;
+static Fat_Volume sd_volume;
+static bool sd_ready;
+#endif
+#if MACROPAD_DISPLAY
+static SSD1306 display;
+static bool display_ready;
+static Animation animation;
+#if MACROPAD_SDCARD
+static Fat_File animation_file;
+static Animation_Stream animation_stream;
+#endif
+static int animation_task_id;
+static uint8_t animation_page; // Next page of the decoded frame to flush
+static uint32_t animation_max_decode_us;
+static uint32_t animation_flush_bytes;
+static Compositor compositor;
+static bool compositor_started;
+static int display_heartbeat;
+static int display_consumer;
+static Widget_Layer layer_widget;
+static Widget_Counters counters_widget;
+static Widget_Text status_widget;
+static Widget_Heat heat_widget;
+static int layer_widget_id;
+static int counters_widget_id;
+static int status_widget_id;
+static int heat_widget_id;
+static uint32_t widget_presses;
+static uint16_t rate_buckets[RATE_BUCKETS];
+static uint32_t rate_bucket_us;
+static uint32_t heat_decay_us;
+#endif
+static Power power;
+static volatile bool wake_fired;
+static volatile uint64_t wake_time_us;
+#if MACROPAD_USB
+static volatile bool usb_event_fired; // Ends a dormant wait, the host needs answering
+#endif
+static uint16_t wake_capture[MACROPAD_SCAN_SOURCES];
+
+static uint64_t HOT_PATH(scheduler_clock)(void) {
+    return time_us_64();
+}
+
+static void idle_alarm_callback(uint alarm_num) {
+    // Only here to wake the core
+}
+
+// Tickless idle. Interrupts are masked around the check so a trigger can't slip in between
+// it and the WFI, a masked pending interrupt still wakes the core
+static void scheduler_idle(Scheduler *sched, uint64_t wake_at_us) {
+    uint32_t status = save_and_disable_interrupts();
+    if (!Scheduler_HasWork(sched, time_us_64())) {
+        bool missed = false;
+        if (wake_at_us != UINT64_MAX) {
+            missed = hardware_alarm_set_target(idle_alarm, from_us_since_boot(wake_at_us));
+        }
+        if (!missed) {
+            __wfi();
+        }
+    }
+    restore_interrupts(status);
+}
+
+#if MACROPAD_MATRIX
+// Only the column pins have wake interrupts enabled
+static void matrix_wake_callback(uint gpio, uint32_t events) {
+    wake_time_us = time_us_64();
+    wake_fired = true;
+}
+
+// Raised by the PIO only when the matrix changed, the scan doesn't wait for its next period
+static void HOT_PATH(matrix_irq_handler)(void) {
+    pio_interrupt_clear(MATRIX_PIO, 0);
+    Scheduler_Trigger(&scheduler, scan_task_id);
+}
+
+static void setup_matrix(void) {
+    Matrix_Initialise(&matrix, MACROPAD_MATRIX_DIODES);
+    matrix_offset = pio_add_program(MATRIX_PIO, &Matrix_program);
+    matrix_sm = pio_claim_unused_sm(MATRIX_PIO, true);
+
+    // Every push overwrites matrix_raw. Pushes only happen on a change, so the count never runs out
+    int channel = dma_claim_unused_channel(true);
+    dma_channel_config config = dma_channel_get_default_config(channel);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+    channel_config_set_read_increment(&config, false);
+    channel_config_set_write_increment(&config, false);
+    channel_config_set_dreq(&config, pio_get_dreq(MATRIX_PIO, matrix_sm, false));
+    dma_channel_configure(channel, &config, &matrix_raw, &MATRIX_PIO->rxf[matrix_sm], 0xFFFFFFFF, true);
+
+    PIO_Matrix_Initialise(MATRIX_PIO, matrix_sm, matrix_offset, MACROPAD_PIN_MATRIX_ROW0, MACROPAD_PIN_MATRIX_COL0,
+                          (float)clock_get_hz(clk_sys) / ((float)MACROPAD_MATRIX_SCAN_HZ * MATRIX_PIO_CYCLES_PER_SCAN));
+    pio_set_irq0_source_enabled(MATRIX_PIO, pis_interrupt0, true);
+    // Enabled once the scheduler is up, the first scan is already pending by then
+    irq_set_exclusive_handler(MATRIX_PIO_IRQ, matrix_irq_handler);
+}
+#else
+static void HOT_PATH(expander_irq_callback)(uint gpio, uint32_t events) {
+    if (gpio == MCP23017_INT_PIN) {
+        wake_time_us = time_us_64();
+        wake_fired = true;
+#if MACROPAD_EDGE_CAPTURE
+        capture_time_us = (uint32_t)wake_time_us;
+        Scheduler_Trigger(&scheduler, scan_task_id);
+#endif
+    }
+}
+#endif
+
+#if MACROPAD_ENCODER
+// Drains every transition the PIO has seen, decoding is a table lookup
+static void HOT_PATH(encoder_irq_handler)(void) {
+    while (!pio_sm_is_rx_fifo_empty(ENCODER_PIO, encoder_sm)) {
+        Encoder_Decode(&encoder, pio_sm_get(ENCODER_PIO, encoder_sm));
+    }
+}
+
+static void setup_encoder(void) {
+    // Pins read through SIO once for the starting state, then handed to PIO
+    for (uint pin = ENCODER_PIN_A; pin <= ENCODER_PIN_A + 1; pin++) {
+        gpio_init(pin);
+        gpio_set_dir(pin, GPIO_IN);
+        gpio_pull_up(pin);
+    }
+    uint8_t ab = gpio_get(ENCODER_PIN_A) | (gpio_get(ENCODER_PIN_A + 1) << 1);
+    Encoder_Initialise(&encoder, ab, ENCODER_KEY_CW, ENCODER_KEY_CCW, ENCODER_DEFAULT_STEPS_PER_DETENT);
+
+    uint offset = pio_add_program(ENCODER_PIO, &Encoder_program);
+    encoder_sm = pio_claim_unused_sm(ENCODER_PIO, true);
+    PIO_Encoder_Initialise(ENCODER_PIO, encoder_sm, offset, ENCODER_PIN_A, (float)clock_get_hz(clk_sys) / ENCODER_PIO_CLOCK_HZ);
+    pio_set_irq0_source_enabled(ENCODER_PIO, pis_sm0_rx_fifo_not_empty + encoder_sm, true);
+    irq_set_exclusive_handler(ENCODER_PIO_IRQ, encoder_irq_handler);
+    irq_set_enabled(ENCODER_PIO_IRQ, true);
+}
+#endif
+
+// Feeds the watchdog only while every watched task is beating
+static void supervisor_task(void *context) {
+    if (Supervisor_Check(&supervisor, time_us_32())) {
+        watchdog_update();
+    }
+}
+
+// Core 1 flushes the display while core 0 dispatches tasks, both store breadcrumbs
+static uint32_t HOT_PATH(supervisor_lock)(void *context) {
+    return spin_lock_blocking((spin_lock_t *)context);
+}
+
+static void HOT_PATH(supervisor_unlock)(void *context, uint32_t saved) {
+    spin_unlock((spin_lock_t *)context, saved);
+}
+
+static void HOT_PATH(supervisor_dispatch)(Scheduler *sched, uint8_t task_id) {
+    Supervisor_TaskStarted(&supervisor, task_id, time_us_32() / 1000);
+}
+
+static const char *supervisor_task_name(uint32_t task) {
+    return task < scheduler.task_count ? scheduler.tasks[task].name : "?";
+}
+
+#if MACROPAD_I2C
+// Detail breadcrumb is the address of the I2C transfer in flight on core 0, alongside its
+// task breadcrumb. A display flush hanging on core 1 is named by its stale heartbeat
+static void HOT_PATH(supervisor_i2c_transfer)(void *context, const I2CBus_Device *device) {
+    if (get_core_num() == 0) {
+        Supervisor_Detail(&supervisor, device ? device->address : SUPERVISOR_NONE);
+    }
+}
+#endif
+
+// Waiting for a key in dormant is a legitimate silence, the clocks keep running so the
+// watchdog would otherwise fire
+static void supervisor_pause(void) {
+    watchdog_disable();
+}
+
+static void supervisor_resume(void) {
+    Supervisor_Resume(&supervisor, time_us_32());
+    watchdog_enable(SUPERVISOR_WATCHDOG_MS, true);
+}
+
+#if MACROPAD_INDICATORS
+// Ports are expanders, a whole OLATA/OLATB pair per write
+static int HOT_PATH(indicator_write)(void *context, uint8_t port, uint16_t latch) {
+    return MCP23017_WriteOutputLatch(&expanders[port], latch);
+}
+#endif
+
+// Power manager hooks
+static void power_set_display(void *context, Power_State state) {
+#if MACROPAD_DISPLAY
+    if (!display_ready) {
+        return;
+    }
+    if (state == POWER_ACTIVE) {
+        SSD1306_SetPowerState(&display, SSD1306_POWER_ON);
+    }
+    else if (state == POWER_IDLE) {
+        SSD1306_SetPowerState(&display, SSD1306_POWER_DIM);
+    }
+    else {
+        SSD1306_SetPowerState(&display, SSD1306_POWER_SLEEP);
+    }
+    // No drawing while the panel is off, everything is redrawn when it comes back
+    if (compositor_started) {
+        Compositor_SetEnabled(&compositor, state == POWER_ACTIVE || state == POWER_IDLE);
+        __sev();
+    }
+#endif
+}
+
+static void power_set_leds(void *context, bool on) {
+    // Neopixel driver is not in the build yet, only the indicators to blank
+#if MACROPAD_INDICATORS
+    Indicator_SetEnabled(&indicators, on);
+    Indicator_Flush(&indicators);
+#endif
+}
+
+// Dormant stops the main loop, so USB control requests and the CDC console would go
+// unanswered. Only go dormant once the host has suspended the bus (or there is no USB)
+static bool power_can_go_dormant(void *context) {
+#if MACROPAD_USB
+    // Cleared before the check, so a resume from here on ends the wait straight away
+    usb_event_fired = false;
+    return Usb_Suspended(&usb);
+#else
+    return true;
+#endif
+}
+
+// Woken by a key, or by the host talking to us again
+static bool power_woken(void) {
+#if MACROPAD_USB
+    return wake_fired || usb_event_fired;
+#else
+    return wake_fired;
+#endif
+}
+
+// I2C and UART dividers are derived from the system/peripheral clocks, so recalculate both
+static void power_set_clock_low(void *context, bool low) {
+    if (low) {
+        set_sys_clock_48mhz();
+    }
+    else {
+        set_sys_clock_khz(POWER_SYS_CLOCK_KHZ, true);
+    }
+#if MACROPAD_I2C
+    i2c_set_baudrate(I2C_PORT, I2C_BAUDRATE);
+#endif
+    uart_set_baudrate(uart_default, PICO_DEFAULT_UART_BAUD_RATE);
+}
+
+#if MACROPAD_MATRIX
+// Dormant: PIO stopped, every row driven low, so any key pulls its column low
+static void power_arm_wake(void *context) {
+    pio_sm_set_enabled(MATRIX_PIO, matrix_sm, false);
+    pio_sm_set_pindirs_with_mask(MATRIX_PIO, matrix_sm, MATRIX_ROW_MASK, MATRIX_ROW_MASK);
+    wake_fired = false;
+    for (uint pin = MACROPAD_PIN_MATRIX_COL0; pin < MACROPAD_PIN_MATRIX_COL0 + MATRIX_COLS; pin++) {
+        gpio_set_irq_enabled_with_callback(pin, GPIO_IRQ_EDGE_FALL, true, matrix_wake_callback);
+    }
+}
+
+static bool power_wait_for_wake(void *context, uint64_t *wake_us, uint16_t *captured_io) {
+    supervisor_pause();
+    uint32_t status = save_and_disable_interrupts();
+    while (!power_woken()) {
+        __wfi();
+        restore_interrupts(status);
+        status = save_and_disable_interrupts();
+    }
+    restore_interrupts(status);
+    supervisor_resume();
+    if (!wake_fired) {
+        *wake_us = time_us_64();
+        return false;
+    }
+    *wake_us = wake_time_us;
+    // With every row driven the row of the key isn't known. The restarted scan picks it up,
+    // a tap released before then is lost
+    memset(wake_capture, 0, sizeof(wake_capture));
+    *captured_io = 0;
+    return true;
+}
+
+// Restarts the scan from the top so no half strobed sample is pushed
+static void power_disarm_wake(void *context) {
+    for (uint pin = MACROPAD_PIN_MATRIX_COL0; pin < MACROPAD_PIN_MATRIX_COL0 + MATRIX_COLS; pin++) {
+        gpio_set_irq_enabled(pin, GPIO_IRQ_EDGE_FALL, false);
+    }
+    pio_sm_set_pindirs_with_mask(MATRIX_PIO, matrix_sm, 0, MATRIX_ROW_MASK);
+    pio_sm_restart(MATRIX_PIO, matrix_sm);
+    pio_sm_exec(MATRIX_PIO, matrix_sm, pio_encode_jmp(matrix_offset));
+    pio_sm_set_enabled(MATRIX_PIO, matrix_sm, true);
+}
+#else
+static void power_arm_wake(void *context) {
+    uint16_t compare_previous = 0x0000;
+    for (uint8_t i = 0; i < MACROPAD_EXPANDER_COUNT; i++) {
+        uint16_t keys = expander_key_mask[i];
+        uint8_t iocon = MCP23017_IOCON_MIRROR | MCP23017_IOCON_ODR | (expanders[i].expander_config & MCP23017_IOCON_HAEN);
+        MCP23017_WriteRegister(&expanders[i], MCP23017_REG_IOCONA, &iocon);
+        MCP23017_SetInterruptChange(&expanders[i], &compare_previous);
+        MCP23017_SetInterruptEnable(&expanders[i], &keys);
+        MCP23017_GetInterruptCapture(&expanders[i]); // Clears anything pending
+    }
+    wake_fired = false;
+    gpio_set_irq_enabled_with_callback(MCP23017_INT_PIN, GPIO_IRQ_EDGE_FALL, true, expander_irq_callback);
+}
+
+static bool power_wait_for_wake(void *context, uint64_t *wake_us, uint16_t *captured_io) {
+    supervisor_pause();
+    // Same masked check as the scheduler idle so the edge can't land between check and WFI
+    uint32_t status = save_and_disable_interrupts();
+    while (!power_woken()) {
+        __wfi();
+        restore_interrupts(status);
+        status = save_and_disable_interrupts();
+    }
+    restore_interrupts(status);
+    supervisor_resume();
+    bool key = wake_fired;
+    *wake_us = key ? wake_time_us : time_us_64();
+    // INTCAP holds the inputs as they were when the interrupt fired, even if the key is already up.
+    // Every expander is read to release the shared INT line, the power manager carries the first
+    for (uint8_t i = 0; i < MACROPAD_EXPANDER_COUNT; i++) {
+        wake_capture[i] = MCP23017_GetInterruptCapture(&expanders[i]) & expander_key_mask[i];
+    }
+    *captured_io = wake_capture[0];
+    return key;
+}
+
+static void power_disarm_wake(void *context) {
+#if MACROPAD_EDGE_CAPTURE
+    // Edge capture needs the same interrupts while awake, they stay armed
+#else
+    uint16_t none = 0x0000;
+    gpio_set_irq_enabled(MCP23017_INT_PIN, GPIO_IRQ_EDGE_FALL, false);
+    for (uint8_t i = 0; i < MACROPAD_EXPANDER_COUNT; i++) {
+        MCP23017_SetInterruptEnable(&expanders[i], &none);
+    }
+#endif
+}
+#endif
+
+static const Power_Hooks power_hooks = {
+    .set_display = power_set_display,
+    .set_leds = power_set_leds,
+    .set_clock_low = power_set_clock_low,
+    .can_go_dormant = power_can_go_dormant,
+    .arm_wake = power_arm_wake,
+    .wait_for_wake = power_wait_for_wake,
+    .disarm_wake = power_disarm_wake,
+};
+
+// Input bits set = key pressed, IPOL can invert active low switches in the expander.
+// The source count is a build constant, so the loops unroll and there is nothing to skip.
+// The matrix is scanned by PIO all the time, this only picks up the latest word
+static void HOT_PATH(scan_task)(void *context) {
+#if MACROPAD_JITTER
+    if (jitter_enabled && jitter_flush) {
+        xip_ctrl_hw->flush = 1;
+        (void)xip_ctrl_hw->flush; // Reads back once the flush is done
+    }
+    uint32_t scan_start = systick_hw->cvr;
+#endif
+    uint16_t captured_io;
+    // The key that woke us from dormant goes in first, even if it was released since
+    if (Power_TakeWakeKeys(&power, &captured_io)) {
+        for (uint8_t i = 0; i < MACROPAD_SCAN_SOURCES; i++) {
+#if MACROPAD_TRACE
+            Trace_Record(&trace, TRACE_SAMPLE_WAKE, i, wake_capture[i], (uint32_t)power.wake_us);
+#endif
+            Debounce_Update(&debounce, &pipeline, i, wake_capture[i], (uint32_t)power.wake_us);
+        }
+    }
+
+    uint16_t io[MACROPAD_SCAN_SOURCES];
+#if MACROPAD_MATRIX
+    Matrix_Update(&matrix, matrix_raw);
+    io[0] = (uint16_t)matrix.keys;
+    io[1] = (uint16_t)(matrix.keys >> 16);
+#elif MACROPAD_EDGE_CAPTURE
+    // INTF, INTCAP and GPIO in one read per expander. A key that went down and up again
+    // since the last read is only in INTCAP, which goes in first
+    uint16_t samples[MACROPAD_SCAN_SOURCES][2];
+    uint8_t sample_count[MACROPAD_SCAN_SOURCES];
+    for (uint8_t i = 0; i < MACROPAD_EXPANDER_COUNT; i++) {
+        uint16_t flags = 0;
+        uint16_t capture = 0;
+        if (MCP23017_ReadCapture(&expanders[i], &flags, &capture, &io[i]) < 0) {
+            io[i] = edge_capture.last[i]; // Keys stay as they were
+        }
+        uint16_t mask = expander_key_mask[i];
+        sample_count[i] = EdgeCapture_Decode(&edge_capture, i, flags & mask, capture & mask, io[i] & mask, samples[i]);
+        io[i] &= mask;
+    }
+    // A change during the reads holds the shared INT line low without a new falling edge
+    if (!gpio_get(MCP23017_INT_PIN)) {
+        Scheduler_Trigger(&scheduler, scan_task_id);
+    }
+#else
+    for (uint8_t i = 0; i < MACROPAD_EXPANDER_COUNT; i++) {
+        if (MCP23017_GetIO(&expanders[i], &io[i]) < 0) {
+            io[i] = expanders[i].io_value; // Keys stay as they were
+        }
+        io[i] &= expander_key_mask[i];
+    }
+#endif
+    uint32_t now_us = time_us_32();
+#if MACROPAD_JITTER
+    uint32_t process_start = systick_hw->cvr;
+#endif
+    Boot_MarkFirstScan(&boot);
+    uint8_t edges = 0;
+#if MACROPAD_EDGE_CAPTURE
+    // Timed at the interrupt if it fell since the last scan, otherwise all we know is now
+    uint32_t interrupt_us = capture_time_us;
+    uint32_t captured_us = interrupt_us - last_scan_us <= now_us - last_scan_us ? interrupt_us : now_us;
+    last_scan_us = now_us;
+    for (uint8_t i = 0; i < MACROPAD_SCAN_SOURCES; i++) {
+        if (sample_count[i] == 2) {
+#if MACROPAD_TRACE
+            Trace_Record(&trace, TRACE_SAMPLE_CAPTURE, i, samples[i][0], captured_us);
+#endif
+            edges += Debounce_Update(&debounce, &pipeline, i, samples[i][0], captured_us);
+        }
+    }
+#endif
+    for (uint8_t i = 0; i < MACROPAD_SCAN_SOURCES; i++) {
+#if MACROPAD_TRACE
+        Trace_Record(&trace, TRACE_SAMPLE_SCAN, i, io[i], now_us);
+#endif
+        edges += Debounce_Update(&debounce, &pipeline, i, io[i], now_us);
+    }
+    if (edges) {
+        Power_Activity(&power, time_us_64());
+    }
+#if MACROPAD_ENCODER
+    if (Encoder_Update(&encoder, &pipeline, time_us_32())) {
+        Power_Activity(&power, time_us_64());
+    }
+#endif
+    Combo_SetTime(&combo, time_us_32());
+    KeyPipeline_Run(&pipeline);
+    Power_KeyReported(&power, time_us_64());
+    Supervisor_Keep(&supervisor, SUPERVISOR_KEEP_LAYERS, Keymap_GetToggled(&keymap));
+    Supervisor_Heartbeat(&supervisor, scan_heartbeat, time_us_32());
+#if MACROPAD_INDICATORS
+    // Changes made anywhere since the last tick go out as one latch write, if any
+    Indicator_Set(&indicators, INDICATOR_LAYER, Keymap_ActiveLayer(&keymap) != 0);
+    Indicator_Flush(&indicators);
+#endif
+
+#if MACROPAD_USB
+    // Reports go out from the USB task straight after this one
+    if (HidReport_Pending(&hid)) {
+        Scheduler_Trigger(&scheduler, usb_task_id);
+    }
+#else
+    // No USB in this build, the reports only go to the log
+    HidKeyboardReport report;
+    while (HidReport_Take(&hid, &report, NULL)) {
+        printf("HID: %02x [%02x %02x %02x %02x %02x %02x]\n", report.modifiers,
+               report.keys[0], report.keys[1], report.keys[2], report.keys[3], report.keys[4], report.keys[5]);
+    }
+    uint16_t usage;
+    while (HidReport_TakeConsumer(&hid, &usage)) {
+        printf("HID: consumer %03x\n", usage);
+    }
+#endif
+#if MACROPAD_JITTER
+    if (jitter_enabled) {
+        // SysTick counts down
+        uint32_t end = systick_hw->cvr;
+        Jitter_Record(&scan_jitter, (scan_start - end) & JITTER_SYSTICK_MASK);
+        Jitter_Record(&process_jitter, (process_start - end) & JITTER_SYSTICK_MASK);
+    }
+#endif
+}
+
+#if MACROPAD_USB
+static void usb_task(void *context) {
+    Usb_Task(&usb);
+}
+
+// Runs in the USB interrupt
+static void usb_event(void *context) {
+    usb_event_fired = true;
+    Scheduler_Trigger(&scheduler, usb_task_id);
+}
+
+// Picked up by the indicator flush on the next scan
+static void usb_leds(void *context, uint8_t leds) {
+#if MACROPAD_INDICATORS
+    Indicator_Set(&indicators, INDICATOR_CAPS_LOCK, leds & 0x02);
+#endif
+}
+
+static void usb_raw_request(void *context, const uint8_t *request, uint8_t *reply) {
+    reply[0] = request[0];
+    switch (request[0]) {
+    case RAW_COMMAND_INFO:
+        reply[1] = 1;
+        reply[2] = MACROPAD_KEY_COUNT;
+        reply[3] = LAYOUT_LAYER_COUNT;
+        reply[4] = Keymap_GetToggled(&keymap);
+        break;
+    case RAW_COMMAND_SET_LAYERS:
+        Keymap_SetToggled(&keymap, request[1]);
+        reply[1] = Keymap_GetToggled(&keymap);
+        break;
+    default:
+        reply[0] = RAW_REPLY_UNKNOWN;
+        break;
+    }
+}
+#endif
+
+static void console_task(void *context) {
+    KeyEvent *event;
+    while ((event = KeyPipeline_Peek(&pipeline, console_consumer)) != NULL) {
+        printf("Key %u %s layer %u keycode %04x @%lu\n", event->key, event->edge == KEYEVENT_PRESS ? "down" : "up",
+               event->layer, event->keycode, (unsigned long)event->timestamp_us);
+        KeyPipeline_Release(&pipeline, console_consumer);
+    }
+    int c;
+    while ((c = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT) {
+        Console_Feed(&console, (char)c);
+    }
+    Supervisor_Heartbeat(&supervisor, console_heartbeat, time_us_32());
+}
+
+#if MACROPAD_KEYSTATS
+// Counting happens here rather than in the scan, well inside the time the ring takes to fill
+static void keystats_task(void *context) {
+    KeyStats_Consume(&keystats, &pipeline, keystats_consumer);
+    KeyStats_SyncChatter(&keystats, &debounce);
+}
+
+static void keystats_save(void) {
+    KeyStats_Consume(&keystats, &pipeline, keystats_consumer);
+    KeyStats_SyncChatter(&keystats, &debounce);
+    int result = FlashStore_Save(FLASHSTORE_SLOT_KEYSTATS, KEYSTATS_VERSION, &keystats.record, sizeof(KeyStats_Record));
+    if (result == 0) {
+        KeyStats_MarkSaved(&keystats);
+    }
+    else {
+        printf("Key statistics save failed: %d\n", result);
+    }
+}
+
+static void keystats_save_task(void *context) {
+    if (keystats.dirty) {
+        keystats_save();
+    }
+}
+#endif
+
+static void power_task(void *context) {
+    if (Power_Update(&power, time_us_64()) == POWER_ACTIVE && power.wake_pending) {
+        Scheduler_Trigger(&scheduler, scan_task_id);
+    }
+}
+
+#if MACROPAD_DISPLAY
+// Core 1 only draws and flushes, the widgets are fed on core 0. A frame goes out as soon
+// as a widget is invalidated (SEV wakes the core), then at most one per DISPLAY_FRAME_US
+static void display_core(void) {
+    // Parks this core while core 0 writes flash (key statistics)
+    flash_safe_execute_core_init();
+    // Whatever no widget covers, the cleared frame after a warm boot
+    SSD1306_Flush(&display);
+    while (true) {
+        uint32_t now_us = time_us_32();
+        Compositor_Update(&compositor, now_us);
+        Supervisor_Heartbeat(&supervisor, display_heartbeat, now_us);
+        uint32_t wait_us = Compositor_Pending(&compositor) ? Compositor_WaitUs(&compositor, time_us_32()) : DISPLAY_IDLE_WAIT_US;
+        if (wait_us > 0) {
+            best_effort_wfe_or_timeout(make_timeout_time_us(wait_us));
+        }
+    }
+}
+
+static void display_invalidate(int widget_id) {
+    Compositor_Invalidate(&compositor, widget_id);
+    __sev();
+}
+
+static void display_set_status(const char *text) {
+    if (Widget_SetText(&status_widget, text)) {
+        display_invalidate(status_widget_id);
+    }
+}
+
+// Hands the panel over from the boot animation
+static void start_compositor(void) {
+    if (!display_ready || compositor_started) {
+        return;
+    }
+    compositor_started = true;
+    display_heartbeat = Supervisor_Watch(&supervisor, "display", DISPLAY_HEARTBEAT_US, time_us_32());
+    Compositor_SetEnabled(&compositor, true);
+    multicore_launch_core1(display_core);
+}
+
+static void setup_compositor(void) {
+    static const Compositor_Rect layer_rect = {0, 80, 0, 2};
+    static const Compositor_Rect counters_rect = {80, 48, 0, 2};
+    static const Compositor_Rect status_rect = {0, DISPLAY_WIDTH, 2, 1};
+    static const Compositor_Rect heat_rect = {0, DISPLAY_WIDTH, 3, 1};
+    Compositor_Initialise(&compositor, &display, DISPLAY_FRAME_US);
+    Widget_LayerInitialise(&layer_widget, &Font_Medium, NULL, 0);
+    Widget_CountersInitialise(&counters_widget);
+    Widget_TextInitialise(&status_widget, &Font_Small);
+    Widget_SetText(&status_widget, MACROPAD_PROFILE_NAME);
+    Widget_HeatInitialise(&heat_widget, MACROPAD_KEY_COUNT);
+    layer_widget_id = Compositor_AddWidget(&compositor, &layer_rect, Widget_RenderLayer, &layer_widget);
+    counters_widget_id = Compositor_AddWidget(&compositor, &counters_rect, Widget_RenderCounters, &counters_widget);
+    status_widget_id = Compositor_AddWidget(&compositor, &status_rect, Widget_RenderText, &status_widget);
+    heat_widget_id = Compositor_AddWidget(&compositor, &heat_rect, Widget_RenderHeat, &heat_widget);
+}
+
+// Widget state is fed from a pipeline consumer. Drained whether or not a panel answered,
+// so the ring never backs up behind it
+static void widgets_task(void *context) {
+    KeyEvent *event;
+    uint32_t now_us = time_us_32();
+    bool heat_changed = false;
+    char text[WIDGET_TEXT_MAX];
+    while ((event = KeyPipeline_Peek(&pipeline, display_consumer)) != NULL) {
+        if (event->edge == KEYEVENT_PRESS && (event->flags & KEYEVENT_FLAG_SYNTHETIC)) {
+            snprintf(text, sizeof(text), "Combo %04x", event->keycode);
+            display_set_status(text);
+        }
+        else if (event->edge == KEYEVENT_PRESS && !(event->flags & KEYEVENT_FLAG_CONSUMED)) {
+            widget_presses++;
+            rate_buckets[0]++;
+            heat_changed |= Widget_HeatPress(&heat_widget, event->key);
+        }
+        KeyPipeline_Release(&pipeline, display_consumer);
+    }
+    if (now_us - heat_decay_us >= HEAT_DECAY_US) {
+        heat_decay_us = now_us;
+        heat_changed |= Widget_HeatDecay(&heat_widget);
+    }
+    if (heat_changed) {
+        display_invalidate(heat_widget_id);
+    }
+    if (now_us - rate_bucket_us >= RATE_BUCKET_US) {
+        rate_bucket_us = now_us;
+        memmove(&rate_buckets[1], &rate_buckets[0], sizeof(rate_buckets) - sizeof(rate_buckets[0]));
+        rate_buckets[0] = 0;
+    }
+    uint16_t per_minute = 0;
+    for (uint8_t i = 0; i < RATE_BUCKETS; i++) {
+        per_minute += rate_buckets[i];
+    }
+    if (Widget_SetCounters(&counters_widget, widget_presses, per_minute)) {
+        display_invalidate(counters_widget_id);
+    }
+    if (Widget_SetLayer(&layer_widget, Keymap_ActiveLayer(&keymap))) {
+        display_invalidate(layer_widget_id);
+    }
+}
+
+// A frame is decoded straight into the back buffer, then diff flushed one page per release
+// (at most a page of data, ~3ms at 400kHz) so the scan is never held off for a whole frame
+static void animation_task(void *context) {
+    if (animation_page < display.pages) {
+        animation_flush_bytes += SSD1306_FlushRegion(&display, 0, display.width, animation_page++, 1);
+        if (animation_page < display.pages) {
+            Scheduler_Trigger(&scheduler, animation_task_id);
+        }
+        return;
+    }
+    uint32_t start = time_us_32();
+    int result = Animation_DecodeFrame(&animation, display.buffer, display.width, display.pages,
+                                       (display.width - animation.width) / 2, (display.pages - animation.pages) / 2);
+    if (result < 0) {
+        Scheduler_SetPeriod(&scheduler, animation_task_id, 0);
+        printf("Boot animation: %u frames, max decode %luus, %lu bytes flushed%s\n", animation.frame,
+               (unsigned long)animation_max_decode_us, (unsigned long)animation_flush_bytes,
+               result == ANIMATION_ERROR_END ? "" : " (stopped on error)");
+        start_compositor();
+        return;
+    }
+    uint32_t decode_us = time_us_32() - start;
+    if (decode_us > animation_max_decode_us) {
+        animation_max_decode_us = decode_us;
+    }
+    animation_page = 0;
+    Scheduler_Trigger(&scheduler, animation_task_id);
+}
+
+#if MACROPAD_SDCARD
+static int32_t animation_stream_read(void *context, uint8_t *data, uint32_t length) {
+    return Fat_Read((Fat_File *)context, data, length);
+}
+
+static int animation_stream_seek(void *context, uint32_t position) {
+    return Fat_Seek((Fat_File *)context, position);
+}
+
+#endif
+
+static void start_boot_animation(void) {
+    int result = ANIMATION_ERROR_IO;
+#if MACROPAD_SDCARD
+    if (sd_ready && Fat_Open(&sd_volume, &animation_file, BOOT_ANIMATION_PATH) == FAT_OK) {
+        animation_stream.context = &animation_file;
+        animation_stream.read = animation_stream_read;
+        animation_stream.seek = animation_stream_seek;
+        result = Animation_OpenStream(&animation, &animation_stream);
+    }
+#endif
+    if (result != ANIMATION_OK && Animation_OpenMemory(&animation, Boot_Logo, Boot_Logo_Length) != ANIMATION_OK) {
+        start_compositor();
+        return;
+    }
+    if (animation.width > display.width || animation.pages > display.pages) {
+        start_compositor();
+        return;
+    }
+    animation_page = display.pages; // Nothing decoded yet
+    animation_task_id = Scheduler_AddTask(&scheduler, "animation", animation_task, NULL, animation.frame_period_ms * 1000, 0, SCHEDULER_PRIORITY_LOW);
+    if (animation_task_id >= 0) {
+        Scheduler_Trigger(&scheduler, animation_task_id);
+    }
+    else {
+        start_compositor();
+    }
+}
+#endif
+
+#if MACROPAD_SDCARD
+// A missing card or unformatted card only leaves sd_ready false. Identification is one
+// command per call, returns false until the card is ready or given up on
+static bool setup_sdcard(void) {
+    static bool started;
+    if (!started) {
+        started = true;
+        if (SDCard_Begin(&sdcard, SPI_PORT, PIN_SD_CS, SPI_BAUDRATE)) {
+            printf("No SD card\n");
+            return true;
+        }
+    }
+    int result = SDCard_Step(&sdcard);
+    if (result == SDCARD_STEP_BUSY) {
+        return false;
+    }
+    if (result < 0) {
+        printf("No SD card\n");
+        return true;
+    }
+    SDCard_GetBlockDevice(&sdcard, &sd_device);
+    SectorCache_Initialise(&sd_cache, &sd_device);
+    sd_ready = Fat_Mount(&sd_volume, &sd_cache) == FAT_OK;
+    printf("SD card: %lu sectors, %s\n", (unsigned long)sdcard.sector_count,
+           sd_ready ? (sd_volume.type == FAT_TYPE_32 ? "FAT32" : "FAT16") : "no filesystem");
+    return true;
+}
+#endif
+
+#if MACROPAD_I2C
+void setup_i2c(i2c_inst_t *i2cBus, uint8_t i2cSDA, uint8_t i2cSCL) {
+    i2c_init(i2cBus, I2C_BAUDRATE);
     gpio_set_function(i2cSDA, GPIO_FUNC_I2C);
     gpio_set_function(i2cSCL, GPIO_FUNC_I2C);
     gpio_pull_up(i2cSDA);
     gpio_pull_up(i2cSCL);
 }
 
-void i2c_scan(i2c_inst_t i2cBus) {
+void i2c_scan(i2c_inst_t *i2cBus) {
+    if (I2CBus_Acquire(&i2c_bus) < 0) {
+        printf("I2C bus busy\n");
+        return;
+    }
     printf("Scanning i2c\n");
     printf("   0  1  2  3  4  5  6  7  8  9  A  B  C  D  E  F\n");
     for (int addr = 0; addr < (1 << 7); ++addr) {
@@ -43,62 +1034,327 @@ void i2c_scan(i2c_inst_t i2cBus) {
         if ((addr & 0x78) == 0 || (addr & 0x78) == 0x78)
             ret = PICO_ERROR_GENERIC;
         else
-            ret = i2c_read_blocking(&i2cBus, addr, &rxdata, 1, false);
+            ret = i2c_read_blocking(i2cBus, addr, &rxdata, 1, false);
         printf(ret < 0 ? "." : "@");
         printf(addr % 16 == 15 ? "\n" : "  ");
     }
     printf("Done.\n");
+    I2CBus_Release(&i2c_bus);
+}
+#endif
+
+// Deferred boot steps, run in the background once keys are being scanned
+#if MACROPAD_DISPLAY
+static bool boot_display(void *context) {
+    I2CBus_Device *device = I2CBus_Find(&i2c_bus, I2CBUS_DEVICE_SSD1306, 0);
+    display_ready = SSD1306_Initialise(&display, device, DISPLAY_HEIGHT, DISPLAY_WIDTH) == 0 && SSD1306_DisplayInit(&display) == 0;
+    if (display_ready) {
+        setup_compositor();
+        // No boot animation on the warm path
+        if (Supervisor_IsWarm(&supervisor)) {
+            start_compositor();
+        }
+    }
+    return true;
+}
+
+static bool boot_animation(void *context) {
+    if (display_ready) {
+        start_boot_animation();
+    }
+    return true;
+}
+#endif
+
+#if MACROPAD_SDCARD
+static bool boot_sdcard(void *context) {
+    return setup_sdcard();
+}
+#endif
+
+static bool boot_diagnostics(void *context) {
+    printf("Macropad v0.0.0.1, profile %s\n", MACROPAD_PROFILE_NAME);
+#if MACROPAD_MATRIX
+    printf("Matrix %ux%u, %s, %lu changes, %lu ghost blocks\n", MATRIX_ROWS, MATRIX_COLS, MACROPAD_MATRIX_DIODES ? "diodes" : "no diodes",
+           (unsigned long)matrix.changes, (unsigned long)matrix.ghost_blocks);
+#else
+    for (uint8_t i = 0; i < MACROPAD_EXPANDER_COUNT; i++) {
+        printf("MCP23017 %u direction %04x, pullups %04x\n", i, MCP23017_GetIODirection(&expanders[i]), MCP23017_GetPullups(&expanders[i]));
+    }
+#endif
+    Boot_PrintReport(&boot);
+    Supervisor_PrintReport(&supervisor, supervisor_task_name);
+    return true;
+}
+
+static void boot_task(void *context) {
+    if (!Boot_RunDeferred(&boot)) {
+        Scheduler_SetPeriod(&scheduler, boot_task_id, 0);
+    }
+}
+
+// Console commands
+#if MACROPAD_I2C
+static void command_i2cscan(void *context, const char *arguments) {
+    i2c_scan(I2C_PORT);
+}
+
+static void command_i2cdevices(void *context, const char *arguments) {
+    I2CBus_PrintDevices(&i2c_bus, time_us_64());
+}
+#endif
+
+#if MACROPAD_TRACE
+static void command_trace(void *context, const char *arguments) {
+    if (strcmp(arguments, "on") == 0) {
+        Trace_SetEnabled(&trace, true);
+    }
+    else if (strcmp(arguments, "off") == 0) {
+        Trace_SetEnabled(&trace, false);
+    }
+    else if (strcmp(arguments, "clear") == 0) {
+        Trace_Clear(&trace);
+    }
+    else if (strcmp(arguments, "dump") == 0) {
+        Trace_Dump(&trace);
+        return;
+    }
+    printf("Trace %s, %lu samples, %lu overwritten\n", trace.enabled ? "on" : "off", (unsigned long)trace.count, (unsigned long)trace.overwritten);
+}
+#endif
+
+#if MACROPAD_KEYSTATS
+static void command_keystats(void *context, const char *arguments) {
+    if (strcmp(arguments, "clear") == 0) {
+        KeyStats_Clear(&keystats);
+    }
+    else if (strcmp(arguments, "save") == 0) {
+        keystats_save();
+    }
+    KeyStats_Print(&keystats);
+}
+#endif
+
+#if MACROPAD_USB
+static void command_usb(void *context, const char *arguments) {
+    Usb_PrintStats(&usb);
+}
+#endif
+
+#if MACROPAD_DISPLAY
+static void command_display(void *context, const char *arguments) {
+    Compositor_PrintStats(&compositor);
+}
+#endif
+
+static void command_supervisor(void *context, const char *arguments) {
+    Supervisor_PrintReport(&supervisor, supervisor_task_name);
+}
+
+static void command_boot(void *context, const char *arguments) {
+    Boot_PrintReport(&boot);
+}
+
+static void command_stats(void *context, const char *arguments) {
+    Scheduler_PrintStats(&scheduler);
+}
+
+static void command_power(void *context, const char *arguments) {
+    Power_PrintStats(&power);
+}
+
+static void command_stack(void *context, const char *arguments) {
+    StackCheck_Print(&stack_check);
+}
+
+#if MACROPAD_JITTER
+static void command_jitter(void *context, const char *arguments) {
+    if (strcmp(arguments, "on") == 0) {
+        // Free running at the CPU clock, long enough for any scan
+        systick_hw->rvr = JITTER_SYSTICK_MASK;
+        systick_hw->cvr = 0;
+        systick_hw->csr = M0PLUS_SYST_CSR_CLKSOURCE_BITS | M0PLUS_SYST_CSR_ENABLE_BITS;
+        Jitter_Clear(&scan_jitter);
+        Jitter_Clear(&process_jitter);
+        jitter_enabled = true;
+    }
+    else if (strcmp(arguments, "off") == 0) {
+        jitter_enabled = false;
+    }
+    else if (strcmp(arguments, "clear") == 0) {
+        Jitter_Clear(&scan_jitter);
+        Jitter_Clear(&process_jitter);
+    }
+    else if (strcmp(arguments, "flush") == 0) {
+        jitter_flush = !jitter_flush;
+        Jitter_Clear(&scan_jitter);
+        Jitter_Clear(&process_jitter);
+    }
+#if HOTPATH_IN_RAM
+    const char *placement = "SRAM";
+#else
+    const char *placement = "flash";
+#endif
+    printf("Jitter %s, hot path in %s, XIP cache %s\n", jitter_enabled ? "on" : "off", placement,
+           jitter_flush ? "flushed before each scan" : "left alone");
+    uint32_t cycles_per_us = clock_get_hz(clk_sys) / 1000000;
+    Jitter_Print(&scan_jitter, cycles_per_us);
+    Jitter_Print(&process_jitter, cycles_per_us);
+}
+#endif
+
+static uint64_t boot_clock(void) {
+    return time_us_64();
 }
 
 int main() {
+    // Timer counts from reset, so phases include the boot ROM and runtime init
+    Boot_Initialise(&boot, boot_clock);
+    // Painted before anything deep has run, `stack` reports the high water marks
+    StackCheck_Initialise(&stack_check);
+    StackCheck_AddRegion(&stack_check, "core0", __StackBottom, __StackTop);
+#if MACROPAD_DISPLAY
+    StackCheck_AddRegion(&stack_check, "core1", __StackOneBottom, __StackOneTop);
+#endif
+
+    // Fast path: only what the first key scan needs
+    Boot_Begin(&boot, "stdio");
+    // A watchdog reset with good breadcrumbs takes the warm path: layer toggles are
+    // restored and the SD card and boot animation are left out
+    Supervisor_Initialise(&supervisor, &supervisor_crumbs, watchdog_caused_reboot());
+    Supervisor_SetLock(&supervisor, supervisor_lock, supervisor_unlock, spin_lock_instance(spin_lock_claim_unused(true)));
     stdio_init_all();
-    printf("\n \n \n");
-    // // SPI initialisation. This example will use SPI at 1MHz.
-    // spi_init(SPI_PORT, 1000*1000);
-    // gpio_set_function(PIN_MISO, GPIO_FUNC_SPI);
-    // gpio_set_function(PIN_CS,   GPIO_FUNC_SIO);
-    // gpio_set_function(PIN_SCK,  GPIO_FUNC_SPI);
-    // gpio_set_function(PIN_MOSI, GPIO_FUNC_SPI);
-    
-    // // Chip select is active-low, so we'll initialise it to a driven-high state
-    // gpio_set_dir(PIN_CS, GPIO_OUT);
-    // gpio_put(PIN_CS, 1);
-    // // For more examples of SPI use see https://github.com/raspberrypi/pico-examples/tree/master/spi
-
-    printf("v0.0.0.1\n");
-    printf("Initialising I2C\n");
-    setup_i2c(*I2C_PORT, I2C_SDA, I2C_SCL);
-    i2c_scan(*I2C_PORT);
-    printf("Initialising MCP23017\n");
-    uint8_t* send = malloc(sizeof(int));
-    MCP23017 mcp;
-    uint8_t result = MCP23017_Initialise(&mcp, I2C_PORT, 0x20);
-    
-    printf("Setting Direction\n");
-    uint16_t *dirptr = malloc(sizeof(uint16_t));
-    *dirptr = (255 << 8) + 255;
-    *send = 0x00;
-    // MCP23017_SetIODirection(&mcp, dirptr);
-    MCP23017_SetIODirection(&mcp, dirptr);
-    uint16_t da = MCP23017_GetIODirection(&mcp);
-    printf("Direction Function Config: %d\n", da);
-    printf("Direction Done\n\n");
-
-    printf("Setting Pullups\n");
-    uint16_t *pullupptr = malloc(sizeof(uint16_t));
-    *pullupptr = 0;
-    MCP23017_SetPullups(&mcp, pullupptr);
-    uint16_t pu = MCP23017_GetPullups(&mcp);
-    printf("Pullup config: %d\n", pu);
-    printf("Pullups Done\n\n");
-
-    printf("Setting IO\n");
-    uint16_t* buffer = malloc(sizeof(uint16_t));
-    *send = 0x12;
-    *buffer = 0;
-    printf("IO Done\n\n");
-
-    int sleep_time = 10; // 200ms default
+    Console_Initialise(&console);
+#if MACROPAD_I2C
+    Console_AddCommand(&console, "i2cscan", "Probe every I2C address", command_i2cscan, NULL);
+    Console_AddCommand(&console, "i2cdevices", "I2C device registry and bus time", command_i2cdevices, NULL);
+#endif
+#if MACROPAD_TRACE
+    Console_AddCommand(&console, "trace", "Scan trace: on, off, clear, dump", command_trace, NULL);
+#endif
+#if MACROPAD_KEYSTATS
+    Console_AddCommand(&console, "keystats", "Key statistics: clear, save", command_keystats, NULL);
+#endif
+#if MACROPAD_DISPLAY
+    Console_AddCommand(&console, "display", "Display compositor statistics", command_display, NULL);
+#endif
+#if MACROPAD_USB
+    Console_AddCommand(&console, "usb", "USB endpoint statistics", command_usb, NULL);
+#endif
+    Console_AddCommand(&console, "boot", "Boot phase timings", command_boot, NULL);
+    Console_AddCommand(&console, "supervisor", "Last watchdog reset breadcrumbs", command_supervisor, NULL);
+    Console_AddCommand(&console, "stats", "Scheduler statistics", command_stats, NULL);
+    Console_AddCommand(&console, "power", "Power state and wake to report latency", command_power, NULL);
+    Console_AddCommand(&console, "stack", "Stack high water marks", command_stack, NULL);
+#if MACROPAD_JITTER
+    Jitter_Initialise(&scan_jitter, "scan");
+    Jitter_Initialise(&process_jitter, "process");
+    Console_AddCommand(&console, "jitter", "Scan cycle jitter: on, off, clear, flush", command_jitter, NULL);
+#endif
+    Boot_End(&boot);
+
+    Boot_Begin(&boot, "bus");
+#if MACROPAD_SPI
+    // SPI initialisation, shared by the SD card and the MCP23S17 when it is fitted
+    spi_init(SPI_PORT, SPI_BAUDRATE);
+    gpio_set_function(PIN_MISO, GPIO_FUNC_SPI);
+    gpio_set_function(PIN_SCK,  GPIO_FUNC_SPI);
+    gpio_set_function(PIN_MOSI, GPIO_FUNC_SPI);
+    // Chip selects are driven by the SD card and MCP23017 SPI drivers
+#endif
+#if MACROPAD_I2C
+    // A reset mid transfer can leave an expander holding SDA low
+    I2CBus_RecoverPins(I2C_SDA, I2C_SCL);
+    setup_i2c(I2C_PORT, I2C_SDA, I2C_SCL);
+    // Only the strap ranges of known parts are probed, not all 128 addresses
+    I2CBus_Initialise(&i2c_bus, I2C_PORT);
+    I2CBus_SetTransferHook(&i2c_bus, supervisor_i2c_transfer, NULL);
+    I2CBus_Discover(&i2c_bus);
+#endif
+    Boot_End(&boot);
+
+#if MACROPAD_MATRIX
+    Boot_Begin(&boot, "matrix");
+    setup_matrix();
+    Boot_End(&boot);
+#else
+    Boot_Begin(&boot, "expander");
+    // All inputs apart from the indicators, external pullups. Read back later by the diagnostics step
+    uint16_t pullups = 0x0000;
+#if MACROPAD_INDICATORS
+    Indicator_Initialise(&indicators, indicator_write, NULL);
+    for (uint8_t i = 0; i < MACROPAD_INDICATOR_COUNT; i++) {
+        uint8_t pin = MACROPAD_KEY_COUNT + i;
+        Indicator_Add(&indicators, pin / 16, pin % 16);
+    }
+#endif
+    for (uint8_t i = 0; i < MACROPAD_EXPANDER_COUNT; i++) {
+        uint16_t direction = 0xFFFF;
+#if MACROPAD_INDICATORS
+        direction &= ~Indicator_PortMask(&indicators, i);
+#endif
+#if MCP23017_TRANSPORT == MCP23017_TRANSPORT_SPI
+        // Expanders share the chip select, HAEN is set on every one including the first address
+        MCP23017_InitialiseSPI(&expanders[i], SPI_PORT, PIN_CS, MACROPAD_EXPANDER_ADDRESS + i);
+#else
+        // Didn't answer the probe, carry on at the strap address so the failure shows up as bus errors
+        I2CBus_Device *expander = I2CBus_Find(&i2c_bus, I2CBUS_DEVICE_MCP23017, i);
+        if (expander == NULL) {
+            expander = I2CBus_Register(&i2c_bus, MACROPAD_EXPANDER_ADDRESS + i, I2CBUS_DEVICE_MCP23017);
+        }
+        MCP23017_Initialise(&expanders[i], expander);
+#endif
+        MCP23017_SetIODirection(&expanders[i], &direction);
+        MCP23017_SetPullups(&expanders[i], &pullups);
+    }
+    // Expander interrupt line is open drain
+    gpio_init(MCP23017_INT_PIN);
+    gpio_set_dir(MCP23017_INT_PIN, GPIO_IN);
+    gpio_pull_up(MCP23017_INT_PIN);
+    Boot_End(&boot);
+#endif
+
+    Boot_Begin(&boot, "pipeline");
+    // Key pipeline: debounce -> combos -> keymap -> HID, console reads behind
+    KeyPipeline_Initialise(&pipeline);
+    Debounce_Initialise(&debounce, DEBOUNCE_DEFAULT_WINDOW_US);
+    Combo_Initialise(&combo, Layout_DefaultCombos, Layout_DefaultComboCount, COMBO_DEFAULT_WINDOW_US);
+    Keymap_Initialise(&keymap, Layout_DefaultLayers, LAYOUT_LAYER_COUNT);
+    Keymap_SetToggled(&keymap, Supervisor_Kept(&supervisor, SUPERVISOR_KEEP_LAYERS));
+    HidReport_Initialise(&hid);
+#if MACROPAD_TRACE
+    Trace_Initialise(&trace);
+#endif
+    Combo_Attach(&combo, &pipeline, KeyPipeline_AddStage(&pipeline, Combo_Stage, &combo));
+    KeyPipeline_AddStage(&pipeline, Keymap_Stage, &keymap);
+    KeyPipeline_AddStage(&pipeline, HidReport_Stage, &hid);
+    console_consumer = KeyPipeline_AddConsumer(&pipeline);
+#if MACROPAD_KEYSTATS
+    // Carries on from the last save, a missing or stale record starts from zero
+    static KeyStats_Record saved_keystats;
+    bool have_keystats = FlashStore_Load(FLASHSTORE_SLOT_KEYSTATS, KEYSTATS_VERSION, &saved_keystats, sizeof(KeyStats_Record)) == 0;
+    KeyStats_Initialise(&keystats, have_keystats ? &saved_keystats : NULL);
+    keystats_consumer = KeyPipeline_AddConsumer(&pipeline);
+#endif
+#if MACROPAD_DISPLAY
+    display_consumer = KeyPipeline_AddConsumer(&pipeline);
+#endif
+#if MACROPAD_ENCODER
+    setup_encoder();
+#endif
+
+#if MACROPAD_USB
+    // Enumeration runs from the USB task once the scheduler is up
+    if (Usb_Initialise(&usb, &hid) == 0) {
+        Usb_SetLedHandler(&usb, usb_leds, NULL);
+        Usb_SetRawHandler(&usb, usb_raw_request, NULL);
+        Usb_EnableStdio(&usb);
+    }
+#endif
+
+    Power_Initialise(&power, &power_hooks, NULL, time_us_64());
+    Power_SetTimeouts(&power, POWER_IDLE_AFTER_MS, POWER_SLEEP_AFTER_MS, POWER_DORMANT_AFTER_MS);
+    Boot_End(&boot);
 
     // 22   = 0001 0110
     // 150  = 1001 0110
@@ -113,11 +1369,56 @@ int main() {
     // 73   = 0100 1001
     // 54   = 0011 0110
 
-    printf("Loadup done\n");
+    Boot_Begin(&boot, "scheduler");
+    idle_alarm = hardware_alarm_claim_unused(true);
+    hardware_alarm_set_callback(idle_alarm, idle_alarm_callback);
+    Scheduler_Initialise(&scheduler, scheduler_clock, scheduler_idle);
+    Scheduler_SetDispatchHook(&scheduler, supervisor_dispatch);
+    scan_task_id = Scheduler_AddTask(&scheduler, "scan", scan_task, NULL, SCAN_PERIOD_US, 0, SCHEDULER_PRIORITY_SCAN);
+    Scheduler_AddTask(&scheduler, "power", power_task, NULL, POWER_PERIOD_US, 0, SCHEDULER_PRIORITY_LOW);
+    Scheduler_AddTask(&scheduler, "console", console_task, NULL, CONSOLE_PERIOD_US, 0, SCHEDULER_PRIORITY_LOW);
+#if MACROPAD_DISPLAY
+    Scheduler_AddTask(&scheduler, "widgets", widgets_task, NULL, WIDGETS_PERIOD_US, 0, SCHEDULER_PRIORITY_LOW);
+#endif
+#if MACROPAD_USB
+    usb_task_id = Scheduler_AddTask(&scheduler, "usb", usb_task, NULL, USB_PERIOD_US, 0, SCHEDULER_PRIORITY_HIGH);
+    Usb_SetEventHandler(&usb, usb_event, NULL);
+#endif
+#if MACROPAD_KEYSTATS
+    Scheduler_AddTask(&scheduler, "keystats", keystats_task, NULL, KEYSTATS_PERIOD_US, 0, SCHEDULER_PRIORITY_LOW);
+    Scheduler_AddTask(&scheduler, "keysave", keystats_save_task, NULL, KEYSTATS_SAVE_PERIOD_US, 0, SCHEDULER_PRIORITY_LOW);
+#endif
+    boot_task_id = Scheduler_AddTask(&scheduler, "boot", boot_task, NULL, BOOT_STEP_PERIOD_US, 0, SCHEDULER_PRIORITY_LOW);
+    Scheduler_AddTask(&scheduler, "supervisor", supervisor_task, NULL, SUPERVISOR_PERIOD_US, 0, SCHEDULER_PRIORITY_HIGH);
+    scan_heartbeat = Supervisor_Watch(&supervisor, "scan", SCAN_HEARTBEAT_US, time_us_32());
+    console_heartbeat = Supervisor_Watch(&supervisor, "console", CONSOLE_HEARTBEAT_US, time_us_32());
+    watchdog_enable(SUPERVISOR_WATCHDOG_MS, true);
+#if MACROPAD_MATRIX
+    irq_set_enabled(MATRIX_PIO_IRQ, true);
+#elif MACROPAD_EDGE_CAPTURE
+    // Same interrupt on change as the dormant wake, now also triggering the scan
+    EdgeCapture_Initialise(&edge_capture);
+    power_arm_wake(NULL);
+#endif
+    Boot_End(&boot);
 
-    while (true) {
-        *buffer = MCP23017_GetIO(&mcp);
-        printf("GPIO: %d\n", *buffer);
-        sleep_ms(sleep_time);
+    // Everything else comes up in the background, one step per boot task release
+#if MACROPAD_DISPLAY
+    Boot_Defer(&boot, "display", boot_display, NULL);
+#endif
+#if MACROPAD_SDCARD
+    if (!Supervisor_IsWarm(&supervisor)) {
+        Boot_Defer(&boot, "sdcard", boot_sdcard, NULL);
     }
+#endif
+#if MACROPAD_DISPLAY
+    if (!Supervisor_IsWarm(&supervisor)) {
+        Boot_Defer(&boot, "animation", boot_animation, NULL);
+    }
+#endif
+    Boot_Defer(&boot, "diagnostics", boot_diagnostics, NULL);
+
+    // Scan straight away rather than a period from now
+    Scheduler_Trigger(&scheduler, scan_task_id);
+    Scheduler_Run(&scheduler);
 }
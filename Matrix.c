@@ -0,0 +1,60 @@
+/*
+ *
+ *  Key Matrix Decoder and Ghost Filter
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#include <string.h>
+#include "Matrix.h"
+#include "HotPath.h"
+
+void Matrix_Initialise(Matrix *matrix, bool diodes) {
+    memset(matrix, 0, sizeof(Matrix));
+    matrix->diodes = diodes;
+    matrix->raw = 0xFFFFFFFF; // Nothing pressed
+}
+
+// Two rows sharing two or more pressed columns form at least one rectangle
+uint32_t HOT_PATH(Matrix_GhostMask)(uint32_t keys) {
+    uint32_t mask = 0;
+    for (uint8_t a = 0; a < MATRIX_ROWS - 1; a++) {
+        uint32_t row_a = (keys >> (a * MATRIX_COLS)) & MATRIX_COLUMN_MASK;
+        if ((row_a & (row_a - 1)) == 0) {
+            continue; // Fewer than two keys
+        }
+        for (uint8_t b = a + 1; b < MATRIX_ROWS; b++) {
+            uint32_t common = row_a & (keys >> (b * MATRIX_COLS));
+            if (common & (common - 1)) {
+                mask |= (common << (a * MATRIX_COLS)) | (common << (b * MATRIX_COLS));
+            }
+        }
+    }
+    return mask;
+}
+
+bool HOT_PATH(Matrix_Update)(Matrix *matrix, uint32_t raw) {
+    if (raw == matrix->raw) {
+        return false;
+    }
+    matrix->raw = raw;
+    uint32_t keys = (~raw >> MATRIX_RAW_SHIFT) & MATRIX_KEY_MASK;
+    if (!matrix->diodes) {
+        matrix->ghost_mask = Matrix_GhostMask(keys);
+        uint32_t filtered = (keys & ~matrix->ghost_mask) | (matrix->keys & matrix->ghost_mask);
+        if (filtered != keys) {
+            matrix->ghost_blocks++;
+        }
+        keys = filtered;
+    }
+    if (keys == matrix->keys) {
+        return false;
+    }
+    matrix->keys = keys;
+    matrix->changes++;
+    return true;
+}
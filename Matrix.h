@@ -0,0 +1,48 @@
+/*
+ *
+ *  Key Matrix Decoder and Ghost Filter
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _MATRIX_H
+#define _MATRIX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Turns the packed scan word written by Matrix.pio (via DMA) into a key bitmask, key
+// (row, column) = bit row * MATRIX_COLS + column.
+// Without diodes, three pressed keys on the corners of a rectangle make the fourth corner
+// read as pressed too, so any rectangle of pressed keys is ambiguous. Keys on an ambiguous
+// rectangle hold their last reported state until the rectangle breaks up: a held key stays
+// down, and a key that only appears on a rectangle is not reported
+
+#define MATRIX_ROWS         4 // Unrolled in Matrix.pio
+#define MATRIX_COLS         5
+#define MATRIX_KEYS         (MATRIX_ROWS * MATRIX_COLS)
+#define MATRIX_KEY_MASK     ((1u << MATRIX_KEYS) - 1)
+#define MATRIX_COLUMN_MASK  ((1u << MATRIX_COLS) - 1)
+#define MATRIX_RAW_SHIFT    (32 - MATRIX_KEYS) // Scan word is filled from the top
+
+typedef struct {
+    bool diodes;          // Ghost filter off
+    uint32_t raw;         // Last scan word seen
+    uint32_t keys;        // Reported, 1 = pressed
+    uint32_t ghost_mask;  // Keys held by the filter on the last update
+    uint32_t changes;     // Updates that changed the reported keys
+    uint32_t ghost_blocks; // Updates where the filter held back a change
+} Matrix;
+
+void Matrix_Initialise(Matrix *matrix, bool diodes);
+
+// Keys on the corners of a rectangle of pressed keys in <keys>
+uint32_t Matrix_GhostMask(uint32_t keys);
+
+// Feeds one scan word. Returns true if the reported keys changed
+bool Matrix_Update(Matrix *matrix, uint32_t raw);
+#endif
@@ -0,0 +1,144 @@
+/*
+ *
+ *  Tiered Power Manager
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+// ACTIVE -> IDLE -> SLEEP -> DORMANT on idle time, straight back to ACTIVE on input
+#include <stdio.h>
+#include <string.h>
+#include "Power.h"
+#include "HotPath.h"
+
+// Default wake to first report budget
+#define POWER_WAKE_LATENCY_BUDGET_US    5000
+
+void Power_Initialise(Power *pm, const Power_Hooks *hooks, void *context, uint64_t now_us) {
+    memset(pm, 0, sizeof(Power));
+    if (hooks != NULL) {
+        pm->hooks = *hooks;
+    }
+    pm->context = context;
+    pm->state = POWER_ACTIVE;
+    pm->last_activity_us = now_us;
+    pm->wake_latency_budget_us = POWER_WAKE_LATENCY_BUDGET_US;
+}
+
+void Power_SetTimeouts(Power *pm, uint32_t idle_after_ms, uint32_t sleep_after_ms, uint32_t dormant_after_ms) {
+    pm->idle_after_ms = idle_after_ms;
+    pm->sleep_after_ms = sleep_after_ms;
+    pm->dormant_after_ms = dormant_after_ms;
+}
+
+static void HOT_PATH(Power_Enter)(Power *pm, Power_State state) {
+    if (state == pm->state) {
+        return;
+    }
+    if (pm->hooks.set_display) {
+        pm->hooks.set_display(pm->context, state);
+    }
+    // LEDs only change when crossing the SLEEP boundary
+    bool leds_on = state < POWER_SLEEP;
+    if (pm->hooks.set_leds && leds_on != (pm->state < POWER_SLEEP)) {
+        pm->hooks.set_leds(pm->context, leds_on);
+    }
+    pm->state = state;
+}
+
+void HOT_PATH(Power_Activity)(Power *pm, uint64_t now_us) {
+    pm->last_activity_us = now_us;
+    Power_Enter(pm, POWER_ACTIVE);
+}
+
+static Power_State Power_Target(Power *pm, uint64_t now_us) {
+    uint64_t idle_ms = (now_us - pm->last_activity_us) / 1000;
+    if (pm->dormant_after_ms && idle_ms >= pm->dormant_after_ms
+        && (pm->hooks.can_go_dormant == NULL || pm->hooks.can_go_dormant(pm->context))) {
+        return POWER_DORMANT;
+    }
+    if (pm->sleep_after_ms && idle_ms >= pm->sleep_after_ms) {
+        return POWER_SLEEP;
+    }
+    if (pm->idle_after_ms && idle_ms >= pm->idle_after_ms) {
+        return POWER_IDLE;
+    }
+    return POWER_ACTIVE;
+}
+
+static void Power_Dormant(Power *pm) {
+    uint64_t wake_us = 0;
+    uint16_t captured_io = 0;
+    bool key = true;
+
+    // Display and LEDs go dark first, then the wake source is armed before the clock drops
+    Power_Enter(pm, POWER_DORMANT);
+    if (pm->hooks.arm_wake) {
+        pm->hooks.arm_wake(pm->context);
+    }
+    if (pm->hooks.set_clock_low) {
+        pm->hooks.set_clock_low(pm->context, true);
+    }
+    if (pm->hooks.wait_for_wake) {
+        key = pm->hooks.wait_for_wake(pm->context, &wake_us, &captured_io);
+    }
+    if (pm->hooks.set_clock_low) {
+        pm->hooks.set_clock_low(pm->context, false);
+    }
+    if (pm->hooks.disarm_wake) {
+        pm->hooks.disarm_wake(pm->context);
+    }
+
+    // Woken by the host rather than a key, there is nothing to report or time
+    if (key) {
+        pm->wake_pending = true;
+        pm->wake_io = captured_io;
+        pm->wake_us = wake_us;
+        pm->wake_count++;
+    }
+    Power_Activity(pm, wake_us);
+}
+
+Power_State Power_Update(Power *pm, uint64_t now_us) {
+    Power_State target = Power_Target(pm, now_us);
+    if (target == POWER_DORMANT) {
+        Power_Dormant(pm);
+    }
+    else if (target > pm->state) {
+        Power_Enter(pm, target);
+    }
+    return pm->state;
+}
+
+bool HOT_PATH(Power_TakeWakeKeys)(Power *pm, uint16_t *captured_io) {
+    if (!pm->wake_pending) {
+        return false;
+    }
+    *captured_io = pm->wake_io;
+    return true;
+}
+
+void HOT_PATH(Power_KeyReported)(Power *pm, uint64_t now_us) {
+    if (!pm->wake_pending) {
+        return;
+    }
+    pm->wake_pending = false;
+    pm->last_wake_latency_us = (uint32_t)(now_us - pm->wake_us);
+    if (pm->last_wake_latency_us > pm->max_wake_latency_us) {
+        pm->max_wake_latency_us = pm->last_wake_latency_us;
+    }
+    if (pm->last_wake_latency_us > pm->wake_latency_budget_us) {
+        pm->wake_latency_overruns++;
+    }
+}
+
+void Power_PrintStats(const Power *pm) {
+    static const char *names[] = {"active", "idle", "sleep", "dormant"};
+    printf("Power %s, %lu key wakes\n", names[pm->state], (unsigned long)pm->wake_count);
+    printf("  wake to report: last %luus, max %luus, budget %luus, %lu over budget\n", (unsigned long)pm->last_wake_latency_us,
+           (unsigned long)pm->max_wake_latency_us, (unsigned long)pm->wake_latency_budget_us, (unsigned long)pm->wake_latency_overruns);
+}
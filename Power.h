@@ -0,0 +1,86 @@
+/*
+ *
+ *  Tiered Power Manager
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _POWER_H
+#define _POWER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Portable state machine, the hardware side is supplied through Power_Hooks so it can
+// run against simulated peripherals off target
+
+// Ordered, each state includes everything done by the ones before it
+typedef enum {
+    POWER_ACTIVE = 0,
+    POWER_IDLE,    // Display dimmed
+    POWER_SLEEP,   // Display and LEDs off
+    POWER_DORMANT, // Expander wake interrupt armed, system clock dropped, core asleep
+} Power_State;
+
+// Any hook may be NULL
+typedef struct {
+    void (*set_display)(void *context, Power_State state);
+    void (*set_leds)(void *context, bool on);
+    void (*set_clock_low)(void *context, bool low);
+    // Whether DORMANT may be entered now (e.g. the USB host has suspended the bus). While
+    // it says no, SLEEP is as deep as it goes. NULL means always
+    bool (*can_go_dormant)(void *context);
+    // Enable interrupt-on-change for all inputs and clear anything pending
+    void (*arm_wake)(void *context);
+    // Blocks until the wake interrupt. Returns the time it fired and the input state
+    // captured by the expander at that moment (INTCAP), so the waking key isn't lost.
+    // Returns false if the wait was given up without a key (the host resumed the bus)
+    bool (*wait_for_wake)(void *context, uint64_t *wake_us, uint16_t *captured_io);
+    void (*disarm_wake)(void *context);
+} Power_Hooks;
+
+typedef struct {
+    Power_Hooks hooks;
+    void *context;
+
+    // Idle time before entering each state, 0 disables that state
+    uint32_t idle_after_ms;
+    uint32_t sleep_after_ms;
+    uint32_t dormant_after_ms;
+
+    Power_State state;
+    uint64_t last_activity_us;
+
+    // Wake to report latency
+    bool wake_pending;
+    uint16_t wake_io;
+    uint64_t wake_us;
+    uint32_t wake_count;
+    uint32_t last_wake_latency_us;
+    uint32_t max_wake_latency_us;
+    uint32_t wake_latency_budget_us;
+    uint32_t wake_latency_overruns;
+} Power;
+
+void Power_Initialise(Power *pm, const Power_Hooks *hooks, void *context, uint64_t now_us);
+void Power_SetTimeouts(Power *pm, uint32_t idle_after_ms, uint32_t sleep_after_ms, uint32_t dormant_after_ms);
+
+// Call on any user input, wakes the display and LEDs straight away
+void Power_Activity(Power *pm, uint64_t now_us);
+
+// Steps towards the state the idle time calls for. Entering POWER_DORMANT blocks in
+// wait_for_wake and returns POWER_ACTIVE once woken
+Power_State Power_Update(Power *pm, uint64_t now_us);
+
+// After a dormant wake, hands over the captured key state once. The caller reports it
+// then calls Power_KeyReported to close the latency measurement
+bool Power_TakeWakeKeys(Power *pm, uint16_t *captured_io);
+void Power_KeyReported(Power *pm, uint64_t now_us);
+
+// State, key wakes and the wake to report latency against its budget
+void Power_PrintStats(const Power *pm);
+#endif
@@ -0,0 +1,361 @@
+/*
+ *
+ *  SD Card Driver (SPI mode)
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *  Specification: SD Physical Layer Simplified Specification, section 7 (SPI mode)
+ * 
+*/
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/gpio.h"
+#include "hardware/dma.h"
+#include "SDCard.h"
+
+#define SDCARD_CSD_SIZE             16
+#define SDCARD_READY_TIMEOUT_MS     500
+#define SDCARD_TOKEN_TIMEOUT_MS     100
+#define SDCARD_INIT_TIMEOUT_MS      1000
+#define SDCARD_STEP_TIMEOUT_MS      2    // Longest wait for the card in one identification step
+#define SDCARD_IDLE_ATTEMPTS        10
+
+// DMA source and sink for the side of a transfer that carries nothing
+static const uint8_t sdcard_fill = 0xFF;
+static uint8_t sdcard_discard;
+
+static uint8_t SDCard_Transfer(SDCard *card, uint8_t out) {
+    uint8_t in;
+    spi_write_read_blocking(card->spi_instance, &out, &in, 1);
+    return in;
+}
+
+static void SDCard_Select(SDCard *card) {
+    gpio_put(card->cs_pin, 0);
+}
+
+// The card only lets go of MISO on the clock edge after CS rises
+static void SDCard_Deselect(SDCard *card) {
+    gpio_put(card->cs_pin, 1);
+    SDCard_Transfer(card, 0xFF);
+}
+
+// The card holds MISO low while busy
+static bool SDCard_WaitReady(SDCard *card, uint32_t timeout_ms) {
+    absolute_time_t deadline = make_timeout_time_ms(timeout_ms);
+    while (SDCard_Transfer(card, 0xFF) != 0xFF) {
+        if (time_reached(deadline)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Returns the R1 response, 0xFF if the card never answered or stayed busy for <ready_timeout_ms>
+static uint8_t SDCard_Command(SDCard *card, uint8_t command, uint32_t argument, uint32_t ready_timeout_ms) {
+    // CRC is only checked for CMD0 and CMD8 in SPI mode
+    uint8_t frame[6] = {0x40 | command, argument >> 24, argument >> 16, argument >> 8, argument, 0x01};
+    if (command == SDCARD_CMD_GO_IDLE_STATE) {
+        frame[5] = 0x95;
+    }
+    else if (command == SDCARD_CMD_SEND_IF_COND) {
+        frame[5] = 0x87;
+    }
+    if (command != SDCARD_CMD_STOP_TRANSMISSION && !SDCard_WaitReady(card, ready_timeout_ms)) {
+        return 0xFF;
+    }
+    spi_write_blocking(card->spi_instance, frame, 6);
+    if (command == SDCARD_CMD_STOP_TRANSMISSION) {
+        SDCard_Transfer(card, 0xFF); // Stuff byte
+    }
+    uint8_t r1 = 0xFF;
+    for (uint8_t i = 0; i < 10 && (r1 & 0x80); i++) {
+        r1 = SDCard_Transfer(card, 0xFF);
+    }
+    return r1;
+}
+
+static uint8_t SDCard_AppCommand(SDCard *card, uint8_t command, uint32_t argument, uint32_t ready_timeout_ms) {
+    SDCard_Command(card, SDCARD_CMD_APP_CMD, 0, ready_timeout_ms);
+    return SDCard_Command(card, command, argument, ready_timeout_ms);
+}
+
+// Full duplex DMA transfer, <tx> NULL clocks out 0xFF, <rx> NULL throws the input away
+static void SDCard_Dma(SDCard *card, const uint8_t *tx, uint8_t *rx, uint32_t length) {
+    spi_inst_t *spi = card->spi_instance;
+
+    dma_channel_config config = dma_channel_get_default_config(card->dma_tx);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_8);
+    channel_config_set_read_increment(&config, tx != NULL);
+    channel_config_set_write_increment(&config, false);
+    channel_config_set_dreq(&config, spi_get_dreq(spi, true));
+    dma_channel_configure(card->dma_tx, &config, &spi_get_hw(spi)->dr, tx ? tx : &sdcard_fill, length, false);
+
+    config = dma_channel_get_default_config(card->dma_rx);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_8);
+    channel_config_set_read_increment(&config, false);
+    channel_config_set_write_increment(&config, rx != NULL);
+    channel_config_set_dreq(&config, spi_get_dreq(spi, false));
+    dma_channel_configure(card->dma_rx, &config, rx ? rx : &sdcard_discard, &spi_get_hw(spi)->dr, length, false);
+
+    // Started together so the receive FIFO never overflows
+    dma_start_channel_mask((1u << card->dma_tx) | (1u << card->dma_rx));
+    dma_channel_wait_for_finish_blocking(card->dma_rx);
+}
+
+static int SDCard_ReceiveBlock(SDCard *card, uint8_t *data, uint32_t length, uint32_t timeout_ms) {
+    absolute_time_t deadline = make_timeout_time_ms(timeout_ms);
+    uint8_t token;
+    while ((token = SDCard_Transfer(card, 0xFF)) == 0xFF) {
+        if (time_reached(deadline)) {
+            return PICO_ERROR_TIMEOUT;
+        }
+    }
+    if (token != SDCARD_TOKEN_START_BLOCK) {
+        return PICO_ERROR_IO; // Data error token
+    }
+    SDCard_Dma(card, NULL, data, length);
+    // CRC, not checked
+    SDCard_Transfer(card, 0xFF);
+    SDCard_Transfer(card, 0xFF);
+    return 0;
+}
+
+static int SDCard_SendBlock(SDCard *card, uint8_t token, const uint8_t *data) {
+    if (!SDCard_WaitReady(card, SDCARD_READY_TIMEOUT_MS)) {
+        return PICO_ERROR_TIMEOUT;
+    }
+    SDCard_Transfer(card, token);
+    SDCard_Dma(card, data, NULL, BLOCKDEVICE_SECTOR_SIZE);
+    SDCard_Transfer(card, 0xFF);
+    SDCard_Transfer(card, 0xFF);
+    if ((SDCard_Transfer(card, 0xFF) & SDCARD_DATA_RESPONSE_MASK) != SDCARD_DATA_ACCEPTED) {
+        return PICO_ERROR_IO;
+    }
+    return 0;
+}
+
+// Reads the CSD for the capacity
+static bool SDCard_ReadCapacity(SDCard *card) {
+    uint8_t csd[SDCARD_CSD_SIZE];
+    if (SDCard_Command(card, SDCARD_CMD_SEND_CSD, 0, SDCARD_STEP_TIMEOUT_MS) != 0 || SDCard_ReceiveBlock(card, csd, SDCARD_CSD_SIZE, SDCARD_STEP_TIMEOUT_MS) < 0) {
+        return false;
+    }
+    if ((csd[0] >> 6) == 1) {
+        // CSD version 2, capacity in 512KB units
+        uint32_t c_size = ((csd[7] & 0x3F) << 16) | (csd[8] << 8) | csd[9];
+        card->sector_count = (c_size + 1) * 1024;
+    }
+    else {
+        uint32_t read_bl_len = csd[5] & 0x0F;
+        uint32_t c_size = ((csd[6] & 0x03) << 10) | (csd[7] << 2) | (csd[8] >> 6);
+        uint32_t c_size_mult = ((csd[9] & 0x03) << 1) | (csd[10] >> 7);
+        card->sector_count = ((c_size + 1) << (c_size_mult + 2)) << read_bl_len >> 9;
+    }
+    return true;
+}
+
+// Busy or no answer within the step's wait, try again on the next step until the deadline
+static SDCard_State SDCard_Retry(SDCard *card) {
+    return time_reached(card->deadline) ? SDCARD_STATE_FAILED : card->state;
+}
+
+// One identification command. Returns the next state, or the same one to try again
+static SDCard_State SDCard_Identify(SDCard *card) {
+    uint8_t r1;
+    switch (card->state) {
+        case SDCARD_STATE_GO_IDLE:
+            if (SDCard_Command(card, SDCARD_CMD_GO_IDLE_STATE, 0, SDCARD_STEP_TIMEOUT_MS) == SDCARD_R1_IDLE) {
+                return SDCARD_STATE_IF_COND;
+            }
+            return ++card->attempts < SDCARD_IDLE_ATTEMPTS ? SDCARD_STATE_GO_IDLE : SDCARD_STATE_FAILED;
+
+        case SDCARD_STATE_IF_COND:
+            // Version 2 cards echo the check pattern, version 1 cards don't know CMD8
+            r1 = SDCard_Command(card, SDCARD_CMD_SEND_IF_COND, 0x1AA, SDCARD_STEP_TIMEOUT_MS);
+            if (r1 == 0xFF) {
+                return SDCard_Retry(card);
+            }
+            if (!(r1 & SDCARD_R1_ILLEGAL_COMMAND)) {
+                uint8_t r7[4];
+                spi_read_blocking(card->spi_instance, 0xFF, r7, 4);
+                if (r7[3] != 0xAA) {
+                    return SDCARD_STATE_FAILED;
+                }
+                card->version2 = true;
+            }
+            // The card has up to a second from the first ACMD41 to finish powering up
+            card->deadline = make_timeout_time_ms(SDCARD_INIT_TIMEOUT_MS);
+            return SDCARD_STATE_OP_COND;
+
+        case SDCARD_STATE_OP_COND:
+            r1 = SDCard_AppCommand(card, SDCARD_ACMD_SD_SEND_OP_COND, card->version2 ? 0x40000000 : 0, SDCARD_STEP_TIMEOUT_MS);
+            if (r1 == 0) {
+                return card->version2 ? SDCARD_STATE_READ_OCR : SDCARD_STATE_SET_BLOCKLEN;
+            }
+            return r1 == SDCARD_R1_IDLE || r1 == 0xFF ? SDCard_Retry(card) : SDCARD_STATE_FAILED;
+
+        case SDCARD_STATE_READ_OCR: {
+            uint8_t ocr[4];
+            r1 = SDCard_Command(card, SDCARD_CMD_READ_OCR, 0, SDCARD_STEP_TIMEOUT_MS);
+            if (r1 != 0) {
+                return r1 == 0xFF ? SDCard_Retry(card) : SDCARD_STATE_FAILED;
+            }
+            spi_read_blocking(card->spi_instance, 0xFF, ocr, 4);
+            card->high_capacity = ocr[0] & 0x40;
+            return card->high_capacity ? SDCARD_STATE_READ_CSD : SDCARD_STATE_SET_BLOCKLEN;
+        }
+
+        case SDCARD_STATE_SET_BLOCKLEN:
+            r1 = SDCard_Command(card, SDCARD_CMD_SET_BLOCKLEN, BLOCKDEVICE_SECTOR_SIZE, SDCARD_STEP_TIMEOUT_MS);
+            if (r1 != 0) {
+                return r1 == 0xFF ? SDCard_Retry(card) : SDCARD_STATE_FAILED;
+            }
+            return SDCARD_STATE_READ_CSD;
+
+        case SDCARD_STATE_READ_CSD:
+            return SDCard_ReadCapacity(card) ? SDCARD_STATE_READY : SDCard_Retry(card);
+
+        default:
+            return card->state;
+    }
+}
+
+uint8_t SDCard_Begin(SDCard *card, spi_inst_t *spi_instance, uint8_t cs_pin, uint32_t baudrate) {
+    // Checks HW SPI is functional
+    if (spi_instance == NULL) {
+        return 1;
+    }
+    memset(card, 0, sizeof(SDCard));
+    card->spi_instance = spi_instance;
+    card->cs_pin = cs_pin;
+    card->baudrate = baudrate < SDCARD_MAX_BAUDRATE ? baudrate : SDCARD_MAX_BAUDRATE;
+    card->dma_tx = dma_claim_unused_channel(true);
+    card->dma_rx = dma_claim_unused_channel(true);
+    card->state = SDCARD_STATE_GO_IDLE;
+    card->deadline = make_timeout_time_ms(SDCARD_INIT_TIMEOUT_MS);
+
+    gpio_init(cs_pin);
+    gpio_set_dir(cs_pin, GPIO_OUT);
+    gpio_put(cs_pin, 1);
+
+    // At least 74 clocks with CS high puts the card into SPI mode
+    uint32_t previous = spi_get_baudrate(spi_instance);
+    spi_set_baudrate(spi_instance, SDCARD_INIT_BAUDRATE);
+    for (uint8_t i = 0; i < 10; i++) {
+        SDCard_Transfer(card, 0xFF);
+    }
+    spi_set_baudrate(spi_instance, previous);
+    return 0;
+}
+
+int SDCard_Step(SDCard *card) {
+    if (card->state == SDCARD_STATE_READY) {
+        return 0;
+    }
+    if (card->state == SDCARD_STATE_FAILED) {
+        return PICO_ERROR_IO;
+    }
+
+    // Whoever else is on the bus gets their rate back in between
+    uint32_t previous = spi_get_baudrate(card->spi_instance);
+    spi_set_baudrate(card->spi_instance, SDCARD_INIT_BAUDRATE);
+    SDCard_Select(card);
+    card->state = SDCard_Identify(card);
+    SDCard_Deselect(card);
+    spi_set_baudrate(card->spi_instance, previous);
+
+    if (card->state == SDCARD_STATE_READY) {
+        spi_set_baudrate(card->spi_instance, card->baudrate);
+        return 0;
+    }
+    if (card->state == SDCARD_STATE_FAILED) {
+        dma_channel_unclaim(card->dma_tx);
+        dma_channel_unclaim(card->dma_rx);
+        return PICO_ERROR_IO;
+    }
+    return SDCARD_STEP_BUSY;
+}
+
+uint8_t SDCard_Initialise(SDCard *card, spi_inst_t *spi_instance, uint8_t cs_pin, uint32_t baudrate) {
+    if (SDCard_Begin(card, spi_instance, cs_pin, baudrate)) {
+        return 1;
+    }
+    int result;
+    while ((result = SDCard_Step(card)) == SDCARD_STEP_BUSY) {
+    }
+    return result == 0 ? 0 : 1;
+}
+
+int SDCard_ReadBlocks(void *context, uint32_t lba, uint8_t *data, uint32_t count) {
+    SDCard *card = (SDCard *)context;
+    uint32_t address = card->high_capacity ? lba : lba * BLOCKDEVICE_SECTOR_SIZE;
+    int result = 0;
+
+    SDCard_Select(card);
+    if (count == 1) {
+        if (SDCard_Command(card, SDCARD_CMD_READ_SINGLE_BLOCK, address, SDCARD_READY_TIMEOUT_MS) != 0) {
+            result = PICO_ERROR_IO;
+        }
+        else {
+            result = SDCard_ReceiveBlock(card, data, BLOCKDEVICE_SECTOR_SIZE, SDCARD_TOKEN_TIMEOUT_MS);
+        }
+    }
+    else {
+        if (SDCard_Command(card, SDCARD_CMD_READ_MULTIPLE_BLOCK, address, SDCARD_READY_TIMEOUT_MS) != 0) {
+            result = PICO_ERROR_IO;
+        }
+        else {
+            for (uint32_t i = 0; i < count && result == 0; i++) {
+                result = SDCard_ReceiveBlock(card, data + i * BLOCKDEVICE_SECTOR_SIZE, BLOCKDEVICE_SECTOR_SIZE, SDCARD_TOKEN_TIMEOUT_MS);
+            }
+            SDCard_Command(card, SDCARD_CMD_STOP_TRANSMISSION, 0, SDCARD_READY_TIMEOUT_MS);
+        }
+    }
+    SDCard_Deselect(card);
+    return result;
+}
+
+int SDCard_WriteBlocks(void *context, uint32_t lba, const uint8_t *data, uint32_t count) {
+    SDCard *card = (SDCard *)context;
+    uint32_t address = card->high_capacity ? lba : lba * BLOCKDEVICE_SECTOR_SIZE;
+    int result = 0;
+
+    SDCard_Select(card);
+    if (count == 1) {
+        if (SDCard_Command(card, SDCARD_CMD_WRITE_BLOCK, address, SDCARD_READY_TIMEOUT_MS) != 0) {
+            result = PICO_ERROR_IO;
+        }
+        else {
+            result = SDCard_SendBlock(card, SDCARD_TOKEN_START_BLOCK, data);
+        }
+    }
+    else {
+        if (SDCard_Command(card, SDCARD_CMD_WRITE_MULTIPLE_BLOCK, address, SDCARD_READY_TIMEOUT_MS) != 0) {
+            result = PICO_ERROR_IO;
+        }
+        else {
+            for (uint32_t i = 0; i < count && result == 0; i++) {
+                result = SDCard_SendBlock(card, SDCARD_TOKEN_START_MULTI_WRITE, data + i * BLOCKDEVICE_SECTOR_SIZE);
+            }
+            SDCard_WaitReady(card, SDCARD_READY_TIMEOUT_MS);
+            SDCard_Transfer(card, SDCARD_TOKEN_STOP_MULTI_WRITE);
+        }
+    }
+    // Don't report done until the card has finished programming
+    if (!SDCard_WaitReady(card, SDCARD_READY_TIMEOUT_MS) && result == 0) {
+        result = PICO_ERROR_TIMEOUT;
+    }
+    SDCard_Deselect(card);
+    return result;
+}
+
+void SDCard_GetBlockDevice(SDCard *card, BlockDevice *device) {
+    device->context = card;
+    device->read = SDCard_ReadBlocks;
+    device->write = SDCard_WriteBlocks;
+    device->sector_count = card->sector_count;
+}
@@ -0,0 +1,102 @@
+/*
+ *
+ *  SD Card Driver (SPI mode)
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *  Specification: SD Physical Layer Simplified Specification, section 7 (SPI mode)
+ * 
+*/
+
+#ifndef _SDCARD_H
+#define _SDCARD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hardware/spi.h"
+#include "BlockDevice.h"
+
+// Data blocks are moved by a pair of DMA channels, one clocking bytes out and one
+// collecting them, so a multi-block read streams at the SPI rate without the CPU
+// touching each byte. Multi-block commands are used whenever more than one sector is asked for
+
+#define SDCARD_INIT_BAUDRATE    400000
+#define SDCARD_MAX_BAUDRATE     25000000
+
+// SDCard_Step result while identification is still going
+#define SDCARD_STEP_BUSY        1
+
+// Commands
+#define SDCARD_CMD_GO_IDLE_STATE            0
+#define SDCARD_CMD_SEND_IF_COND             8
+#define SDCARD_CMD_SEND_CSD                 9
+#define SDCARD_CMD_STOP_TRANSMISSION        12
+#define SDCARD_CMD_SET_BLOCKLEN             16
+#define SDCARD_CMD_READ_SINGLE_BLOCK        17
+#define SDCARD_CMD_READ_MULTIPLE_BLOCK      18
+#define SDCARD_CMD_WRITE_BLOCK              24
+#define SDCARD_CMD_WRITE_MULTIPLE_BLOCK     25
+#define SDCARD_CMD_APP_CMD                  55
+#define SDCARD_CMD_READ_OCR                 58
+#define SDCARD_ACMD_SD_SEND_OP_COND         41
+
+// R1 response
+#define SDCARD_R1_IDLE                      0x01
+#define SDCARD_R1_ILLEGAL_COMMAND           0x04
+
+// Data tokens
+#define SDCARD_TOKEN_START_BLOCK            0xFE
+#define SDCARD_TOKEN_START_MULTI_WRITE      0xFC
+#define SDCARD_TOKEN_STOP_MULTI_WRITE       0xFD
+#define SDCARD_DATA_RESPONSE_MASK           0x1F
+#define SDCARD_DATA_ACCEPTED                0x05
+
+// Identification, one command per SDCard_Step
+typedef enum {
+    SDCARD_STATE_GO_IDLE = 0,
+    SDCARD_STATE_IF_COND,
+    SDCARD_STATE_OP_COND,
+    SDCARD_STATE_READ_OCR,
+    SDCARD_STATE_SET_BLOCKLEN,
+    SDCARD_STATE_READ_CSD,
+    SDCARD_STATE_READY,
+    SDCARD_STATE_FAILED,
+} SDCard_State;
+
+typedef struct {
+    spi_inst_t *spi_instance;
+    uint8_t cs_pin;
+    uint32_t baudrate;
+    bool high_capacity; // SDHC/SDXC address by block, SDSC by byte
+    uint32_t sector_count;
+    int dma_tx;
+    int dma_rx;
+
+    // Identification
+    SDCard_State state;
+    uint8_t attempts;          // CMD0 tries, a missing card is given up on quickly
+    bool version2;
+    absolute_time_t deadline;  // Busy steps are retried until then
+} SDCard;
+
+// SPI pins must already be set up. <baudrate> is capped at SDCARD_MAX_BAUDRATE, use the
+// slowest device's rate if the bus is shared. Returns 0 on success, 1 if no card answered.
+// Blocks for up to a second while the card powers up, see SDCard_Begin for the stepped version
+uint8_t SDCard_Initialise(SDCard *card, spi_inst_t *spi_instance, uint8_t cs_pin, uint32_t baudrate);
+
+// Identification split up so the caller can run other work in between. Begin takes the
+// same arguments and returns 0 or 1. Each Step sends one command, waiting at most a couple
+// of milliseconds for the card, and selects the card and sets the init rate only for its own
+// transfer so a shared bus is usable between steps. Step returns SDCARD_STEP_BUSY until
+// the card is ready (0) or given up on (a negative PICO_ERROR_ code)
+uint8_t SDCard_Begin(SDCard *card, spi_inst_t *spi_instance, uint8_t cs_pin, uint32_t baudrate);
+int SDCard_Step(SDCard *card);
+
+// BlockDevice functions, <context> is the SDCard
+int SDCard_ReadBlocks(void *context, uint32_t lba, uint8_t *data, uint32_t count);
+int SDCard_WriteBlocks(void *context, uint32_t lba, const uint8_t *data, uint32_t count);
+
+void SDCard_GetBlockDevice(SDCard *card, BlockDevice *device);
+#endif
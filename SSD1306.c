@@ -11,53 +11,268 @@
 */
 
 #include <stdio.h>
-#include "hardware/i2c.h"
+#include <string.h>
+#include "I2CBus.h"
 #include "SSD1306.h"
 #include "pico/stdlib.h"
-//#include "pico/malloc.h"
-#include <malloc.h>
 
-uint8_t SSD1306_Initialise(SSD1306 *dev, i2c_inst_t *i2c_instance, uint8_t ssd1306_address, uint8_t ssd1306_height, uint8_t ssd1306_width) {
-    // Checks HW I2C is functional + Valid SSD1306 address range
-    if (i2c_instance == NULL || ssd1306_address < 0b00111100 || ssd1306_address > 0b00111101) { // 0x3c to 0x3d
+// Largest I2C payload per transaction, one control byte plus a full page row
+#define SSD1306_MAX_TRANSFER    (SSD1306_MAX_WIDTH + 1)
+
+uint8_t SSD1306_Initialise(SSD1306 *dev, I2CBus_Device *device, uint8_t ssd1306_height, uint8_t ssd1306_width) {
+    // Checks a device was found + Valid SSD1306 address range
+    if (device == NULL || device->address < 0b00111100 || device->address > 0b00111101) { // 0x3c to 0x3d
+        return 1;
+    }
+    // Framebuffer is sized for the largest panel, height must be whole pages
+    if (ssd1306_width == 0 || ssd1306_width > SSD1306_MAX_WIDTH || ssd1306_height == 0 || ssd1306_height > SSD1306_MAX_HEIGHT || (ssd1306_height % SSD1306_PAGE_HEIGHT) != 0) {
         return 1;
     }
 
     // Setup struct
-    dev->i2c_instance= i2c_instance;
-    dev->ssd1306_i2c_addr = ssd1306_address;
+    dev->bus_device = device;
     dev->height = ssd1306_height;
     dev->width = ssd1306_width;
+    dev->pages = ssd1306_height / SSD1306_PAGE_HEIGHT;
+    dev->contrast = SSD1306_DEFAULT_CONTRAST;
+    dev->power_state = SSD1306_POWER_SLEEP;
+    dev->dim_after_ms = 0;
+    dev->sleep_after_ms = 0;
+    dev->scrolling = false;
+    dev->last_flush_bytes = 0;
+    SSD1306_ClearBuffer(dev);
+
+    return 0;
+}
 
+int SSD1306_DisplayInit(SSD1306 *dev) {
+    uint8_t commands[32];
+    uint8_t length = SSD1306_EncodeInitSequence(commands, dev->height, dev->contrast);
+    int ret = SSD1306_WriteCommands(dev, commands, length);
+    if (ret < 0) {
+        return ret;
+    }
+    dev->power_state = SSD1306_POWER_ON;
+    SSD1306_ClearBuffer(dev);
+    SSD1306_Invalidate(dev);
     return 0;
 }
 
 void SSD1306_DisplayPowerOn(SSD1306 *dev) {
-    uint8_t *data = malloc(sizeof(uint8_t));
-    *data = SSD1306_POWERON;
-    SSD1306_WriteRegister(dev, 0x00, data);
-    free(data);
+    uint8_t command = SSD1306_POWERON;
+    SSD1306_WriteCommands(dev, &command, 1);
+}
+
+void SSD1306_DisplayPowerOff(SSD1306 *dev) {
+    uint8_t command = SSD1306_POWEROFF;
+    SSD1306_WriteCommands(dev, &command, 1);
+}
+
+void SSD1306_SetContrast(SSD1306 *dev, uint8_t contrast) {
+    uint8_t commands[SSD1306_CMD_MAX_LENGTH];
+    dev->contrast = contrast;
+    // Dimmed/asleep panels pick it up on wake
+    if (dev->power_state == SSD1306_POWER_ON) {
+        SSD1306_WriteCommands(dev, commands, SSD1306_EncodeContrast(commands, contrast));
+    }
+}
+
+void SSD1306_SetInverted(SSD1306 *dev, bool inverted) {
+    uint8_t command = inverted ? SSD1306_CMD_INVERT_DISPLAY : SSD1306_CMD_NORMAL_DISPLAY;
+    SSD1306_WriteCommands(dev, &command, 1);
+}
+
+void SSD1306_StartScroll(SSD1306 *dev, SSD1306_ScrollDirection direction, uint8_t start_page, uint8_t end_page, SSD1306_ScrollInterval interval) {
+    uint8_t commands[SSD1306_CMD_MAX_LENGTH + 2];
+    // Setup is only valid with scrolling deactivated, all three go in one transaction
+    uint8_t length = SSD1306_EncodeSingle(commands, SSD1306_CMD_DEACTIVATE_SCROLL);
+    length += SSD1306_EncodeHorizontalScroll(&commands[length], direction, start_page, end_page, interval);
+    length += SSD1306_EncodeSingle(&commands[length], SSD1306_CMD_ACTIVATE_SCROLL);
+    SSD1306_WriteCommands(dev, commands, length);
+    dev->scrolling = true;
+}
+
+void SSD1306_StartDiagonalScroll(SSD1306 *dev, SSD1306_ScrollDirection direction, uint8_t start_page, uint8_t end_page, SSD1306_ScrollInterval interval, uint8_t vertical_offset) {
+    uint8_t commands[SSD1306_CMD_MAX_LENGTH + 2];
+    uint8_t length = SSD1306_EncodeSingle(commands, SSD1306_CMD_DEACTIVATE_SCROLL);
+    length += SSD1306_EncodeDiagonalScroll(&commands[length], direction, start_page, end_page, interval, vertical_offset);
+    length += SSD1306_EncodeSingle(&commands[length], SSD1306_CMD_ACTIVATE_SCROLL);
+    SSD1306_WriteCommands(dev, commands, length);
+    dev->scrolling = true;
+}
+
+void SSD1306_SetVerticalScrollArea(SSD1306 *dev, uint8_t fixed_rows, uint8_t scroll_rows) {
+    uint8_t commands[SSD1306_CMD_MAX_LENGTH];
+    SSD1306_WriteCommands(dev, commands, SSD1306_EncodeVerticalScrollArea(commands, fixed_rows, scroll_rows));
+}
+
+void SSD1306_StopScroll(SSD1306 *dev) {
+    uint8_t command = SSD1306_CMD_DEACTIVATE_SCROLL;
+    if (!dev->scrolling) {
+        return;
+    }
+    SSD1306_WriteCommands(dev, &command, 1);
+    dev->scrolling = false;
+    SSD1306_Show(dev);
+}
+
+void SSD1306_SetIdleTimeouts(SSD1306 *dev, uint32_t dim_after_ms, uint32_t sleep_after_ms) {
+    dev->dim_after_ms = dim_after_ms;
+    dev->sleep_after_ms = sleep_after_ms;
+}
+
+void SSD1306_SetPowerState(SSD1306 *dev, SSD1306_PowerState state) {
+    if (state == dev->power_state) {
+        return; // Nothing on the bus
+    }
+
+    uint8_t commands[SSD1306_CMD_MAX_LENGTH];
+    uint8_t length = 0;
+    switch (state) {
+        case SSD1306_POWER_ON:
+            length = SSD1306_EncodeContrast(commands, dev->contrast);
+            length += SSD1306_EncodeSingle(&commands[length], SSD1306_CMD_DISPLAY_ON);
+            break;
+        case SSD1306_POWER_DIM:
+            length = SSD1306_EncodeContrast(commands, SSD1306_DIM_CONTRAST);
+            length += SSD1306_EncodeSingle(&commands[length], SSD1306_CMD_DISPLAY_ON);
+            break;
+        case SSD1306_POWER_SLEEP:
+            length = SSD1306_EncodeSingle(commands, SSD1306_CMD_DISPLAY_OFF);
+            break;
+    }
+    SSD1306_WriteCommands(dev, commands, length);
+    dev->power_state = state;
+}
+
+SSD1306_PowerState SSD1306_UpdateIdle(SSD1306 *dev, uint32_t idle_ms) {
+    SSD1306_PowerState target = SSD1306_POWER_ON;
+    if (dev->sleep_after_ms && idle_ms >= dev->sleep_after_ms) {
+        target = SSD1306_POWER_SLEEP;
+    }
+    else if (dev->dim_after_ms && idle_ms >= dev->dim_after_ms) {
+        target = SSD1306_POWER_DIM;
+    }
+    SSD1306_SetPowerState(dev, target);
+    return target;
 }
 
+void SSD1306_ClearBuffer(SSD1306 *dev) {
+    memset(dev->buffer, 0, (size_t)dev->width * dev->pages);
+}
+
+void SSD1306_Show(SSD1306 *dev) {
+    uint8_t commands[SSD1306_CMD_MAX_LENGTH];
+    uint8_t length = SSD1306_EncodeAddressWindow(commands, 0, dev->width - 1, 0, dev->pages - 1);
+    uint16_t size = (uint16_t)dev->width * dev->pages;
+    if (SSD1306_WriteCommands(dev, commands, length) < 0 || SSD1306_WriteData(dev, dev->buffer, size) < 0) {
+        // Panel contents are unknown
+        SSD1306_Invalidate(dev);
+        dev->last_flush_bytes = 0;
+        return;
+    }
+    memcpy(dev->front, dev->buffer, size);
+    dev->stale_pages = 0;
+    dev->last_flush_bytes = SSD1306_RUN_OVERHEAD_BYTES + size;
+}
+
+// Only flagged here. The front can't be set to differ yet, a byte drawn before the flush
+// could end up equal to it and never be sent
+void SSD1306_Invalidate(SSD1306 *dev) {
+    dev->stale_pages = (uint8_t)((1u << dev->pages) - 1);
+}
+
+uint16_t SSD1306_Flush(SSD1306 *dev) {
+    return SSD1306_FlushRegion(dev, 0, dev->width, 0, dev->pages);
+}
+
+// Only the word aligned columns around the region are compared, so the cost follows the
+// region size rather than the panel
+uint16_t SSD1306_FlushRegion(SSD1306 *dev, uint8_t x, uint8_t width, uint8_t page, uint8_t pages) {
+    SSD1306_Run runs[SSD1306_MAX_RUNS_PER_PAGE];
+    uint8_t commands[SSD1306_CMD_MAX_LENGTH];
+    uint16_t bytes = 0;
+    uint8_t first = x & ~3;
+    uint16_t last = ((uint16_t)x + width + 3) & ~3;
+    if (last > dev->width) {
+        last = dev->width;
+    }
+    if (first >= last) {
+        return 0;
+    }
+
+    for (; page < dev->pages && pages > 0; page++, pages--) {
+        uint16_t offset = (uint16_t)page * dev->width;
+        uint8_t page_first = first;
+        uint16_t page_last = last;
+        bool stale = dev->stale_pages & (1 << page);
+        bool sent = true;
+        // An unknown page goes out whole, set to differ now that the back buffer is drawn
+        if (stale) {
+            page_first = 0;
+            page_last = dev->width;
+            for (uint16_t i = offset; i < offset + dev->width; i++) {
+                dev->front[i] = ~dev->buffer[i];
+            }
+        }
+        uint8_t count = SSD1306_DiffPage(&dev->front[offset + page_first], &dev->buffer[offset + page_first], page_last - page_first, page, SSD1306_RUN_OVERHEAD_BYTES, runs, SSD1306_MAX_RUNS_PER_PAGE);
+        for (uint8_t i = 0; i < count; i++) {
+            runs[i].start += page_first;
+            runs[i].end += page_first;
+            uint8_t length = runs[i].end - runs[i].start + 1;
+            if (SSD1306_WriteCommands(dev, commands, SSD1306_EncodeAddressWindow(commands, runs[i].start, runs[i].end, page, page)) < 0
+                || SSD1306_WriteData(dev, &dev->buffer[offset + runs[i].start], length) < 0) {
+                sent = false;
+                continue; // Front keeps the old bytes so the run goes out again next flush
+            }
+            memcpy(&dev->front[offset + runs[i].start], &dev->buffer[offset + runs[i].start], length);
+            bytes += SSD1306_RunCost(&runs[i]);
+        }
+        if (stale && sent) {
+            dev->stale_pages &= ~(1 << page);
+        }
+    }
+    dev->last_flush_bytes = bytes;
+    return bytes;
+}
+
+int SSD1306_WriteCommands(SSD1306 *dev, const uint8_t *commands, uint8_t length) {
+    uint8_t buffer[SSD1306_MAX_TRANSFER];
+    if (length >= SSD1306_MAX_TRANSFER) {
+        return PICO_ERROR_INVALID_ARG;
+    }
+    buffer[0] = SSD1306_CONTROL_COMMAND;
+    memcpy(&buffer[1], commands, length);
+    return I2CBus_Write(dev->bus_device, buffer, length + 1);
+}
+
+// Split into page sized transactions, the GDDRAM pointer carries on across them
+int SSD1306_WriteData(SSD1306 *dev, const uint8_t *data, uint16_t length) {
+    uint8_t buffer[SSD1306_MAX_TRANSFER];
+    buffer[0] = SSD1306_CONTROL_DATA;
+    while (length) {
+        uint16_t chunk = length < (SSD1306_MAX_TRANSFER - 1) ? length : (SSD1306_MAX_TRANSFER - 1);
+        memcpy(&buffer[1], data, chunk);
+        int ret = I2CBus_Write(dev->bus_device, buffer, chunk + 1);
+        if (ret < 0) {
+            return ret;
+        }
+        data += chunk;
+        length -= chunk;
+    }
+    return 0;
+}
 
 // Reads 1 byte into <data> from the register specified by <reg_address>
+// Only the status byte is readable over I2C
 uint8_t SSD1306_ReadRegister(SSD1306 *dev, uint8_t reg_address) {
-    uint8_t *data = malloc(sizeof(uint8_t));
-    uint8_t *reg = malloc(sizeof(uint8_t));
-    *reg = reg_address;
-    i2c_write_blocking(dev->i2c_instance, dev->ssd1306_i2c_addr, reg, 1, true);
-    free(reg);
-    i2c_read_blocking(dev->i2c_instance, dev->ssd1306_i2c_addr, data, 1, false);
-    uint8_t out = *data;
-    free(data);
-    return out;
-}
-
-// Writes all of <data> to the register specified by <reg_address>
+    uint8_t data = 0;
+    I2CBus_WriteRead(dev->bus_device, &reg_address, 1, &data, 1);
+    return data;
+}
+
+// Writes <data> to the register specified by <reg_address> (control byte) in one transaction
 void SSD1306_WriteRegister(SSD1306 *dev, uint8_t reg_address, uint8_t *data) {
-    uint8_t *reg = malloc(sizeof(uint8_t));
-    *reg = reg_address;
-    i2c_write_blocking(dev->i2c_instance, dev->ssd1306_i2c_addr, reg, 1, true);
-    free(reg);
-    i2c_write_blocking(dev->i2c_instance, dev->ssd1306_i2c_addr, data, sizeof(*data), false);
-}
\ No newline at end of file
+    uint8_t buffer[2] = {reg_address, *data};
+    I2CBus_Write(dev->bus_device, buffer, 2);
+}
@@ -13,25 +13,103 @@
 #ifndef _SSD1306_H
 #define _SSD1306_H
 
+#include <stdint.h>
+#include <stdbool.h>
+#include "I2CBus.h"
+#include "SSD1306_Commands.h"
+#include "SSD1306_Diff.h"
+
 // I2C address
-#define SSD1306_I2C_ADDRESS    0x3C // Default address is 0x20. Range from 0x20-0x27, bit ordering is 0 0 1 0 0 A2 A1 A0
+#define SSD1306_I2C_ADDRESS    0x3C // Default address is 0x3C. Range from 0x3C-0x3D, selected by SA0
+
+#define SSD1306_POWERON         SSD1306_CMD_DISPLAY_ON
+#define SSD1306_POWEROFF        SSD1306_CMD_DISPLAY_OFF
+
+// Contrast used by the idle manager while dimmed
+#define SSD1306_DEFAULT_CONTRAST 0xCF
+#define SSD1306_DIM_CONTRAST     0x08
 
-#define SSD1306_POWERON         0xAE
-#define SSD1306_POWEROFF        0xAF
+// Framebuffer geometry. GDDRAM is organised as 8 pixel high pages, one byte per column,
+// bit 0 being the top row of the page
+#define SSD1306_MAX_WIDTH       128
+#define SSD1306_MAX_HEIGHT      64
+#define SSD1306_PAGE_HEIGHT     8
+#define SSD1306_BUFFER_SIZE     (SSD1306_MAX_WIDTH * SSD1306_MAX_HEIGHT / SSD1306_PAGE_HEIGHT)
+
+typedef enum {
+    SSD1306_POWER_ON = 0,
+    SSD1306_POWER_DIM,
+    SSD1306_POWER_SLEEP, // Panel off, GDDRAM retained
+} SSD1306_PowerState;
 
 typedef struct {
     
-    // I2C instance/Handle
-    i2c_inst_t *i2c_instance;
-    uint8_t ssd1306_i2c_addr;
+    // Registry handle, the bus arbitrates and accounts every transfer
+    I2CBus_Device *bus_device;
     uint8_t height;
     uint8_t width;
+    uint8_t pages;
+
+    // Power management
+    uint8_t contrast;
+    SSD1306_PowerState power_state;
+    uint32_t dim_after_ms;   // 0 disables
+    uint32_t sleep_after_ms; // 0 disables
+    bool scrolling;
+
+    // Back buffer that gets drawn into, page major: buffer[page * width + column]
+    uint8_t buffer[SSD1306_BUFFER_SIZE] __attribute__((aligned(4)));
+    // Front buffer, what the panel currently shows
+    uint8_t front[SSD1306_BUFFER_SIZE] __attribute__((aligned(4)));
+    uint8_t stale_pages; // Bit per page the panel contents are unknown for, sent whole by the next flush
+    uint16_t last_flush_bytes; // Bus bytes used by the last flush
 
 } SSD1306;
 
-uint8_t SSD1306_Initialise(SSD1306 *dev, i2c_inst_t *i2c_instance, uint8_t ssd1306_address, uint8_t ssd1306_height, uint8_t ssd1306_width);
+// Address comes from the handle, normally found by I2CBus_Discover
+uint8_t SSD1306_Initialise(SSD1306 *dev, I2CBus_Device *device, uint8_t ssd1306_height, uint8_t ssd1306_width);
 
+// Sends the power up sequence and clears the back buffer. The cleared frame goes out with
+// the next flush, so the init holds the bus for the commands only (about 1ms at 400kHz)
+int SSD1306_DisplayInit(SSD1306 *dev);
 void SSD1306_DisplayPowerOn(SSD1306 *dev);
+void SSD1306_DisplayPowerOff(SSD1306 *dev);
+void SSD1306_SetContrast(SSD1306 *dev, uint8_t contrast);
+void SSD1306_SetInverted(SSD1306 *dev, bool inverted);
+
+// Hardware scrolling. Once started the controller scrolls on its own with no bus traffic.
+// Pages outside [start_page, end_page] stay put
+void SSD1306_StartScroll(SSD1306 *dev, SSD1306_ScrollDirection direction, uint8_t start_page, uint8_t end_page, SSD1306_ScrollInterval interval);
+void SSD1306_StartDiagonalScroll(SSD1306 *dev, SSD1306_ScrollDirection direction, uint8_t start_page, uint8_t end_page, SSD1306_ScrollInterval interval, uint8_t vertical_offset);
+void SSD1306_SetVerticalScrollArea(SSD1306 *dev, uint8_t fixed_rows, uint8_t scroll_rows);
+// GDDRAM content is undefined after scrolling stops, the framebuffer is resent
+void SSD1306_StopScroll(SSD1306 *dev);
+
+// Commands are only sent if <state> differs from the current one
+void SSD1306_SetPowerState(SSD1306 *dev, SSD1306_PowerState state);
+
+// Idle driven power management. Call with the time since the last user input,
+// commands are only sent on a state change. Returns the new state
+void SSD1306_SetIdleTimeouts(SSD1306 *dev, uint32_t dim_after_ms, uint32_t sleep_after_ms);
+SSD1306_PowerState SSD1306_UpdateIdle(SSD1306 *dev, uint32_t idle_ms);
+
+// Framebuffer
+void SSD1306_ClearBuffer(SSD1306 *dev);
+// Sends the whole framebuffer
+void SSD1306_Show(SSD1306 *dev);
+// Marks every page as unknown on the panel, so the next flush sends the whole frame
+// whatever is drawn in the meantime
+void SSD1306_Invalidate(SSD1306 *dev);
+// Sends only the column runs that differ from what the panel shows. Returns bus bytes used.
+// A run that fails to send is left marked as different and is retried on the next flush
+uint16_t SSD1306_Flush(SSD1306 *dev);
+// Same, limited to columns [x, x + width) of pages [page, page + pages). A page left unknown
+// by SSD1306_Invalidate is sent whole
+uint16_t SSD1306_FlushRegion(SSD1306 *dev, uint8_t x, uint8_t width, uint8_t page, uint8_t pages);
+
+// Raw transfers, a control byte is prepended to each transaction
+int SSD1306_WriteCommands(SSD1306 *dev, const uint8_t *commands, uint8_t length);
+int SSD1306_WriteData(SSD1306 *dev, const uint8_t *data, uint16_t length);
 
 uint8_t SSD1306_ReadRegister(SSD1306 *dev, uint8_t reg_address);
 void SSD1306_WriteRegister(SSD1306 *dev, uint8_t reg_address, uint8_t *data);
@@ -0,0 +1,97 @@
+/*
+ *
+ *  SSD1306 Command Encoder
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *  Datasheet: https://cdn-shop.adafruit.com/datasheets/SSD1306.pdf
+ * 
+*/
+
+// Pure command encoding, the I2C side lives in SSD1306.c
+#include "SSD1306_Commands.h"
+
+uint8_t SSD1306_EncodeSingle(uint8_t *out, uint8_t command) {
+    out[0] = command;
+    return 1;
+}
+
+uint8_t SSD1306_EncodeContrast(uint8_t *out, uint8_t contrast) {
+    out[0] = SSD1306_CMD_SET_CONTRAST;
+    out[1] = contrast;
+    return 2;
+}
+
+// Scroll setup must be sent with scrolling deactivated, see datasheet 10.2.1
+uint8_t SSD1306_EncodeHorizontalScroll(uint8_t *out, SSD1306_ScrollDirection direction, uint8_t start_page, uint8_t end_page, SSD1306_ScrollInterval interval) {
+    out[0] = direction == SSD1306_SCROLL_LEFT ? SSD1306_CMD_LEFT_HORIZONTAL_SCROLL : SSD1306_CMD_RIGHT_HORIZONTAL_SCROLL;
+    out[1] = 0x00; // Dummy byte
+    out[2] = start_page & 0x07;
+    out[3] = interval & 0x07;
+    out[4] = end_page & 0x07;
+    out[5] = 0x00; // Dummy bytes
+    out[6] = 0xFF;
+    return 7;
+}
+
+uint8_t SSD1306_EncodeDiagonalScroll(uint8_t *out, SSD1306_ScrollDirection direction, uint8_t start_page, uint8_t end_page, SSD1306_ScrollInterval interval, uint8_t vertical_offset) {
+    out[0] = direction == SSD1306_SCROLL_LEFT ? SSD1306_CMD_VERTICAL_LEFT_SCROLL : SSD1306_CMD_VERTICAL_RIGHT_SCROLL;
+    out[1] = 0x00; // Dummy byte
+    out[2] = start_page & 0x07;
+    out[3] = interval & 0x07;
+    out[4] = end_page & 0x07;
+    out[5] = vertical_offset & 0x3F; // Rows per step, 1-63
+    return 6;
+}
+
+uint8_t SSD1306_EncodeVerticalScrollArea(uint8_t *out, uint8_t fixed_rows, uint8_t scroll_rows) {
+    out[0] = SSD1306_CMD_SET_VERTICAL_SCROLL;
+    out[1] = fixed_rows & 0x3F;
+    out[2] = scroll_rows & 0x7F;
+    return 3;
+}
+
+// Horizontal addressing mode window, GDDRAM pointer wraps within it
+uint8_t SSD1306_EncodeAddressWindow(uint8_t *out, uint8_t start_column, uint8_t end_column, uint8_t start_page, uint8_t end_page) {
+    out[0] = SSD1306_CMD_COLUMN_ADDRESS;
+    out[1] = start_column & 0x7F;
+    out[2] = end_column & 0x7F;
+    out[3] = SSD1306_CMD_PAGE_ADDRESS;
+    out[4] = start_page & 0x07;
+    out[5] = end_page & 0x07;
+    return 6;
+}
+
+// Based on the application note power up sequence, using the internal charge pump
+uint8_t SSD1306_EncodeInitSequence(uint8_t *out, uint8_t height, uint8_t contrast) {
+    uint8_t i = 0;
+    out[i++] = SSD1306_CMD_DISPLAY_OFF;
+    out[i++] = SSD1306_CMD_CLOCK_DIVIDE;
+    out[i++] = 0x80; // Reset oscillator frequency, divide by 1
+    out[i++] = SSD1306_CMD_MULTIPLEX_RATIO;
+    out[i++] = height - 1;
+    out[i++] = SSD1306_CMD_DISPLAY_OFFSET;
+    out[i++] = 0x00;
+    out[i++] = SSD1306_CMD_DISPLAY_START_LINE | 0;
+    out[i++] = SSD1306_CMD_CHARGE_PUMP;
+    out[i++] = SSD1306_CHARGE_PUMP_ENABLE;
+    out[i++] = SSD1306_CMD_MEMORY_MODE;
+    out[i++] = SSD1306_MEMORY_MODE_HORIZONTAL;
+    out[i++] = SSD1306_CMD_SEGMENT_REMAP_127;
+    out[i++] = SSD1306_CMD_COM_SCAN_DEC;
+    out[i++] = SSD1306_CMD_COM_PINS;
+    out[i++] = height == 32 ? 0x02 : 0x12; // Sequential for 128x32, alternative for 128x64
+    out[i++] = SSD1306_CMD_SET_CONTRAST;
+    out[i++] = contrast;
+    out[i++] = SSD1306_CMD_PRECHARGE;
+    out[i++] = 0xF1;
+    out[i++] = SSD1306_CMD_VCOMH_DESELECT;
+    out[i++] = 0x40;
+    out[i++] = SSD1306_CMD_DEACTIVATE_SCROLL;
+    out[i++] = SSD1306_CMD_DISPLAY_RAM;
+    out[i++] = SSD1306_CMD_NORMAL_DISPLAY;
+    out[i++] = SSD1306_CMD_DISPLAY_ON;
+    return i;
+}
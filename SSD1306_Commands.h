@@ -0,0 +1,104 @@
+/*
+ *
+ *  SSD1306 Command Encoder
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *  Datasheet: https://cdn-shop.adafruit.com/datasheets/SSD1306.pdf
+ * 
+*/
+
+#ifndef _SSD1306_COMMANDS_H
+#define _SSD1306_COMMANDS_H
+
+#include <stdint.h>
+
+// Control byte sent after the I2C address, Co = 0 so the rest of the transaction is one type
+#define SSD1306_CONTROL_COMMAND             0x00
+#define SSD1306_CONTROL_DATA                0x40
+
+// Fundamental commands - datasheet section 10.1
+#define SSD1306_CMD_SET_CONTRAST            0x81 // + contrast 0-255
+#define SSD1306_CMD_DISPLAY_RAM             0xA4 // Output follows GDDRAM
+#define SSD1306_CMD_DISPLAY_ALL_ON          0xA5 // Output ignores GDDRAM
+#define SSD1306_CMD_NORMAL_DISPLAY          0xA6
+#define SSD1306_CMD_INVERT_DISPLAY          0xA7
+#define SSD1306_CMD_DISPLAY_OFF             0xAE // Sleep mode
+#define SSD1306_CMD_DISPLAY_ON              0xAF
+
+// Scrolling commands - section 10.2
+#define SSD1306_CMD_RIGHT_HORIZONTAL_SCROLL 0x26 // + 0x00, start page, interval, end page, 0x00, 0xFF
+#define SSD1306_CMD_LEFT_HORIZONTAL_SCROLL  0x27
+#define SSD1306_CMD_VERTICAL_RIGHT_SCROLL   0x29 // + 0x00, start page, interval, end page, vertical offset
+#define SSD1306_CMD_VERTICAL_LEFT_SCROLL    0x2A
+#define SSD1306_CMD_DEACTIVATE_SCROLL       0x2E
+#define SSD1306_CMD_ACTIVATE_SCROLL         0x2F
+#define SSD1306_CMD_SET_VERTICAL_SCROLL     0xA3 // + fixed top rows, scrolling rows
+
+// Addressing commands - section 10.3
+#define SSD1306_CMD_SET_LOW_COLUMN          0x00 // | lower nibble, page addressing mode only
+#define SSD1306_CMD_SET_HIGH_COLUMN         0x10 // | upper nibble, page addressing mode only
+#define SSD1306_CMD_MEMORY_MODE             0x20 // + mode
+#define SSD1306_CMD_COLUMN_ADDRESS          0x21 // + start, end
+#define SSD1306_CMD_PAGE_ADDRESS            0x22 // + start, end
+#define SSD1306_CMD_PAGE_START              0xB0 // | page, page addressing mode only
+
+#define SSD1306_MEMORY_MODE_HORIZONTAL      0x00
+#define SSD1306_MEMORY_MODE_VERTICAL        0x01
+#define SSD1306_MEMORY_MODE_PAGE            0x02
+
+// Hardware configuration - section 10.4
+#define SSD1306_CMD_DISPLAY_START_LINE      0x40 // | line 0-63
+#define SSD1306_CMD_SEGMENT_REMAP_0         0xA0 // Column 0 is SEG0
+#define SSD1306_CMD_SEGMENT_REMAP_127       0xA1 // Column 127 is SEG0
+#define SSD1306_CMD_MULTIPLEX_RATIO         0xA8 // + height - 1
+#define SSD1306_CMD_COM_SCAN_INC            0xC0
+#define SSD1306_CMD_COM_SCAN_DEC            0xC8
+#define SSD1306_CMD_DISPLAY_OFFSET          0xD3 // + vertical shift
+#define SSD1306_CMD_COM_PINS                0xDA // + pin configuration
+
+// Timing and driving - section 10.5
+#define SSD1306_CMD_CLOCK_DIVIDE            0xD5 // + oscillator frequency << 4 | divide ratio - 1
+#define SSD1306_CMD_PRECHARGE               0xD9 // + phase 2 << 4 | phase 1
+#define SSD1306_CMD_VCOMH_DESELECT          0xDB // + level
+#define SSD1306_CMD_NOP                     0xE3
+
+// Charge pump - application note
+#define SSD1306_CMD_CHARGE_PUMP             0x8D // + enable/disable
+#define SSD1306_CHARGE_PUMP_ENABLE          0x14
+#define SSD1306_CHARGE_PUMP_DISABLE         0x10
+
+// Longest single command is the horizontal scroll setup
+#define SSD1306_CMD_MAX_LENGTH              7
+
+// Scroll step interval in frames, values are the 3 bit register codes
+typedef enum {
+    SSD1306_SCROLL_2_FRAMES   = 0x07,
+    SSD1306_SCROLL_3_FRAMES   = 0x04,
+    SSD1306_SCROLL_4_FRAMES   = 0x05,
+    SSD1306_SCROLL_5_FRAMES   = 0x00,
+    SSD1306_SCROLL_25_FRAMES  = 0x06,
+    SSD1306_SCROLL_64_FRAMES  = 0x01,
+    SSD1306_SCROLL_128_FRAMES = 0x02,
+    SSD1306_SCROLL_256_FRAMES = 0x03,
+} SSD1306_ScrollInterval;
+
+typedef enum {
+    SSD1306_SCROLL_RIGHT = 0,
+    SSD1306_SCROLL_LEFT = 1,
+} SSD1306_ScrollDirection;
+
+// Encoders write the command bytes (without control byte) into <out> and return the length.
+// <out> must hold SSD1306_CMD_MAX_LENGTH bytes. No I/O so they can be checked byte for byte on a host
+uint8_t SSD1306_EncodeContrast(uint8_t *out, uint8_t contrast);
+uint8_t SSD1306_EncodeHorizontalScroll(uint8_t *out, SSD1306_ScrollDirection direction, uint8_t start_page, uint8_t end_page, SSD1306_ScrollInterval interval);
+uint8_t SSD1306_EncodeDiagonalScroll(uint8_t *out, SSD1306_ScrollDirection direction, uint8_t start_page, uint8_t end_page, SSD1306_ScrollInterval interval, uint8_t vertical_offset);
+uint8_t SSD1306_EncodeVerticalScrollArea(uint8_t *out, uint8_t fixed_rows, uint8_t scroll_rows);
+uint8_t SSD1306_EncodeAddressWindow(uint8_t *out, uint8_t start_column, uint8_t end_column, uint8_t start_page, uint8_t end_page);
+uint8_t SSD1306_EncodeSingle(uint8_t *out, uint8_t command);
+
+// Full power up sequence for a panel of <height> rows, returns length written to <out> (at most 32 bytes)
+uint8_t SSD1306_EncodeInitSequence(uint8_t *out, uint8_t height, uint8_t contrast);
+#endif
@@ -0,0 +1,72 @@
+/*
+ *
+ *  SSD1306 Framebuffer Diff
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+// Portable, no SDK dependencies. Assumes a little endian core (RP2040), so the lowest
+// byte of a word is the lowest column
+#include "SSD1306_Diff.h"
+
+typedef uint32_t __attribute__((may_alias)) SSD1306_Word;
+
+// Index of the first/last differing byte in a non zero XOR word
+static inline uint8_t SSD1306_FirstByte(uint32_t x) {
+    return (x & 0x000000FF) ? 0 : (x & 0x0000FF00) ? 1 : (x & 0x00FF0000) ? 2 : 3;
+}
+
+static inline uint8_t SSD1306_LastByte(uint32_t x) {
+    return (x & 0xFF000000) ? 3 : (x & 0x00FF0000) ? 2 : (x & 0x0000FF00) ? 1 : 0;
+}
+
+uint8_t SSD1306_DiffPage(const uint8_t *front, const uint8_t *back, uint8_t width, uint8_t page, uint8_t merge_gap, SSD1306_Run *runs, uint8_t max_runs) {
+    const SSD1306_Word *f = (const SSD1306_Word *)front;
+    const SSD1306_Word *b = (const SSD1306_Word *)back;
+    uint8_t words = width / 4;
+    uint8_t count = 0;
+    uint8_t i = 0;
+
+    if (max_runs == 0) {
+        return 0;
+    }
+
+    while (i < words) {
+        // Skip unchanged words
+        uint32_t x = f[i] ^ b[i];
+        while (x == 0) {
+            if (++i == words) {
+                return count;
+            }
+            x = f[i] ^ b[i];
+        }
+        uint8_t start = i * 4 + SSD1306_FirstByte(x);
+        uint8_t end;
+
+        // Extend over consecutive changed words
+        do {
+            end = i * 4 + SSD1306_LastByte(x);
+            if (++i == words) {
+                break;
+            }
+            x = f[i] ^ b[i];
+        } while (x != 0);
+
+        // Merge when the unchanged gap is cheaper to resend than a new address window,
+        // or when out of slots
+        if (count > 0 && ((start - runs[count - 1].end - 1) <= merge_gap || count == max_runs)) {
+            runs[count - 1].end = end;
+        }
+        else {
+            runs[count].page = page;
+            runs[count].start = start;
+            runs[count].end = end;
+            count++;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,41 @@
+/*
+ *
+ *  SSD1306 Framebuffer Diff
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _SSD1306_DIFF_H
+#define _SSD1306_DIFF_H
+
+#include <stdint.h>
+
+// Bus bytes spent on a run besides its data: address + control + 6 byte address window,
+// then address + control in front of the data
+#define SSD1306_RUN_OVERHEAD_BYTES  10
+
+// Worst case is every other word differing with gaps larger than the overhead
+#define SSD1306_MAX_RUNS_PER_PAGE   8
+
+// Columns [start, end] of <page> that differ between front and back buffer
+typedef struct {
+    uint8_t page;
+    uint8_t start;
+    uint8_t end; // Inclusive
+} SSD1306_Run;
+
+// Finds the column runs that differ within one page row, comparing a word at a time.
+// Rows must be 4 byte aligned and <width> a multiple of 4. Runs separated by <merge_gap>
+// or fewer unchanged columns are merged as resending them is cheaper than a new window.
+// Returns the number of runs written to <runs>, at most <max_runs>
+uint8_t SSD1306_DiffPage(const uint8_t *front, const uint8_t *back, uint8_t width, uint8_t page, uint8_t merge_gap, SSD1306_Run *runs, uint8_t max_runs);
+
+// Bytes on the bus to send <run>
+static inline uint16_t SSD1306_RunCost(const SSD1306_Run *run) {
+    return SSD1306_RUN_OVERHEAD_BYTES + (run->end - run->start + 1);
+}
+#endif
@@ -0,0 +1,180 @@
+/*
+ *
+ *  Cooperative Task Scheduler
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+// Run to completion tasks, periodic and/or event triggered. Selection is fixed priority
+// then earliest deadline. Tasks never preempt each other, so long jobs (display flush)
+// need splitting into chunks shorter than the scan period
+#include <stdio.h>
+#include <string.h>
+#include "Scheduler.h"
+#include "HotPath.h"
+
+void Scheduler_Initialise(Scheduler *sched, Scheduler_ClockFunction clock, Scheduler_IdleFunction idle) {
+    memset(sched, 0, sizeof(Scheduler));
+    sched->clock = clock;
+    sched->idle = idle;
+    sched->started_us = clock();
+}
+
+void Scheduler_SetDispatchHook(Scheduler *sched, Scheduler_DispatchFunction dispatch) {
+    sched->dispatch = dispatch;
+}
+
+int Scheduler_AddTask(Scheduler *sched, const char *name, Scheduler_TaskFunction function, void *context, uint32_t period_us, uint32_t deadline_us, uint8_t priority) {
+    if (sched->task_count >= SCHEDULER_MAX_TASKS || function == NULL) {
+        return -1;
+    }
+    Scheduler_Task *task = &sched->tasks[sched->task_count];
+    memset(task, 0, sizeof(Scheduler_Task));
+    task->name = name;
+    task->function = function;
+    task->context = context;
+    task->period_us = period_us;
+    task->deadline_us = deadline_us ? deadline_us : (period_us ? period_us : UINT32_MAX);
+    task->priority = priority;
+    task->next_release_us = sched->clock() + period_us;
+    return sched->task_count++;
+}
+
+void Scheduler_SetPeriod(Scheduler *sched, uint8_t task_id, uint32_t period_us) {
+    if (task_id >= sched->task_count) {
+        return;
+    }
+    Scheduler_Task *task = &sched->tasks[task_id];
+    task->period_us = period_us;
+    task->deadline_us = period_us ? period_us : UINT32_MAX;
+    task->next_release_us = sched->clock() + period_us;
+}
+
+void HOT_PATH(Scheduler_Trigger)(Scheduler *sched, uint8_t task_id) {
+    if (task_id < sched->task_count) {
+        sched->tasks[task_id].pending = 1;
+    }
+}
+
+// Moves due periodic releases and triggers into the released state
+static void HOT_PATH(Scheduler_Release)(Scheduler *sched, uint64_t now_us) {
+    for (uint8_t i = 0; i < sched->task_count; i++) {
+        Scheduler_Task *task = &sched->tasks[i];
+        if (task->released) {
+            continue;
+        }
+        if (task->pending) {
+            task->released = true;
+            task->release_us = now_us;
+        }
+        else if (task->period_us && now_us >= task->next_release_us) {
+            task->released = true;
+            task->release_us = task->next_release_us;
+            // Drift free, but don't burst to catch up on periods that were missed entirely
+            task->next_release_us += task->period_us;
+            if (now_us >= task->next_release_us) {
+                uint64_t behind = (now_us - task->release_us) / task->period_us;
+                task->skipped_periods += behind;
+                task->next_release_us = task->release_us + (behind + 1) * task->period_us;
+            }
+        }
+        else {
+            continue;
+        }
+        task->deadline_at_us = task->release_us + task->deadline_us;
+    }
+}
+
+bool Scheduler_HasWork(Scheduler *sched, uint64_t now_us) {
+    for (uint8_t i = 0; i < sched->task_count; i++) {
+        Scheduler_Task *task = &sched->tasks[i];
+        if (task->released || task->pending || (task->period_us && now_us >= task->next_release_us)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint64_t Scheduler_NextWake(Scheduler *sched) {
+    uint64_t wake = UINT64_MAX;
+    for (uint8_t i = 0; i < sched->task_count; i++) {
+        if (sched->tasks[i].period_us && sched->tasks[i].next_release_us < wake) {
+            wake = sched->tasks[i].next_release_us;
+        }
+    }
+    return wake;
+}
+
+bool HOT_PATH(Scheduler_RunOnce)(Scheduler *sched) {
+    uint64_t now = sched->clock();
+    Scheduler_Release(sched, now);
+
+    Scheduler_Task *next = NULL;
+    for (uint8_t i = 0; i < sched->task_count; i++) {
+        Scheduler_Task *task = &sched->tasks[i];
+        if (!task->released) {
+            continue;
+        }
+        if (next == NULL || task->priority < next->priority || (task->priority == next->priority && task->deadline_at_us < next->deadline_at_us)) {
+            next = task;
+        }
+    }
+    if (next == NULL) {
+        return false;
+    }
+
+    // Cleared before running so a trigger that lands mid-run releases it again
+    next->pending = 0;
+    next->released = false;
+
+    uint32_t latency = (uint32_t)(now - next->release_us);
+    if (latency > next->max_latency_us) {
+        next->max_latency_us = latency;
+    }
+    if (sched->dispatch) {
+        sched->dispatch(sched, (uint8_t)(next - sched->tasks));
+    }
+    next->function(next->context);
+    uint64_t end = sched->clock();
+
+    uint32_t runtime = (uint32_t)(end - now);
+    next->runs++;
+    next->total_runtime_us += runtime;
+    if (runtime > next->max_runtime_us) {
+        next->max_runtime_us = runtime;
+    }
+    if (end > next->deadline_at_us) {
+        next->missed_deadlines++;
+    }
+    return true;
+}
+
+void Scheduler_Run(Scheduler *sched) {
+    while (true) {
+        if (Scheduler_RunOnce(sched)) {
+            continue;
+        }
+        uint64_t start = sched->clock();
+        sched->idle(sched, Scheduler_NextWake(sched));
+        sched->idle_us += sched->clock() - start;
+    }
+}
+
+void Scheduler_PrintStats(Scheduler *sched) {
+    uint64_t elapsed = sched->clock() - sched->started_us;
+    printf("Task          Runs  Avg(us)  Max(us)  MaxLat(us)  Missed  Skipped\n");
+    for (uint8_t i = 0; i < sched->task_count; i++) {
+        Scheduler_Task *task = &sched->tasks[i];
+        uint32_t average = task->runs ? (uint32_t)(task->total_runtime_us / task->runs) : 0;
+        printf("%-12s %5lu  %7lu  %7lu  %10lu  %6lu  %7lu\n", task->name ? task->name : "?",
+               (unsigned long)task->runs, (unsigned long)average, (unsigned long)task->max_runtime_us,
+               (unsigned long)task->max_latency_us, (unsigned long)task->missed_deadlines, (unsigned long)task->skipped_periods);
+    }
+    if (elapsed) {
+        printf("Idle: %lu%%\n", (unsigned long)(sched->idle_us * 100 / elapsed));
+    }
+}
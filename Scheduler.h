@@ -0,0 +1,99 @@
+/*
+ *
+ *  Cooperative Task Scheduler
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _SCHEDULER_H
+#define _SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Portable C, no SDK dependencies. Time comes from the clock function so the scheduler
+// can be driven by a virtual clock off target
+
+#define SCHEDULER_MAX_TASKS     16
+
+// Priorities, lower value runs first. Within a priority the earliest deadline runs first
+#define SCHEDULER_PRIORITY_SCAN     0
+#define SCHEDULER_PRIORITY_HIGH     1
+#define SCHEDULER_PRIORITY_NORMAL   2
+#define SCHEDULER_PRIORITY_LOW      3
+
+typedef void (*Scheduler_TaskFunction)(void *context);
+
+struct Scheduler;
+// Microseconds, monotonic
+typedef uint64_t (*Scheduler_ClockFunction)(void);
+// Sleep until <wake_at_us> or until an interrupt may have triggered a task
+typedef void (*Scheduler_IdleFunction)(struct Scheduler *sched, uint64_t wake_at_us);
+// Called just before a task runs, e.g. to leave a breadcrumb
+typedef void (*Scheduler_DispatchFunction)(struct Scheduler *sched, uint8_t task_id);
+
+typedef struct {
+    const char *name;
+    Scheduler_TaskFunction function;
+    void *context;
+    uint32_t period_us;   // 0 for event triggered only
+    uint32_t deadline_us; // Relative to release
+    uint8_t priority;
+
+    // State
+    volatile uint8_t pending; // Set by Scheduler_Trigger, may be written from an IRQ
+    uint64_t next_release_us;
+    uint64_t release_us;
+    uint64_t deadline_at_us;
+    bool released;
+
+    // Statistics
+    uint32_t runs;
+    uint32_t missed_deadlines;
+    uint32_t skipped_periods;
+    uint32_t max_runtime_us;
+    uint32_t max_latency_us; // Release to start
+    uint64_t total_runtime_us;
+} Scheduler_Task;
+
+typedef struct Scheduler {
+    Scheduler_Task tasks[SCHEDULER_MAX_TASKS];
+    uint8_t task_count;
+    Scheduler_ClockFunction clock;
+    Scheduler_IdleFunction idle;
+    Scheduler_DispatchFunction dispatch; // May be NULL
+    uint64_t idle_us;
+    uint64_t started_us;
+} Scheduler;
+
+void Scheduler_Initialise(Scheduler *sched, Scheduler_ClockFunction clock, Scheduler_IdleFunction idle);
+
+void Scheduler_SetDispatchHook(Scheduler *sched, Scheduler_DispatchFunction dispatch);
+
+// <deadline_us> of 0 means the deadline is the period, or none for event tasks. Returns the task id or -1 if full
+int Scheduler_AddTask(Scheduler *sched, const char *name, Scheduler_TaskFunction function, void *context, uint32_t period_us, uint32_t deadline_us, uint8_t priority);
+
+// Changes the period from now on, 0 stops periodic releases. The deadline becomes the new period
+void Scheduler_SetPeriod(Scheduler *sched, uint8_t task_id, uint32_t period_us);
+
+// Marks an event triggered task ready. Safe to call from an interrupt handler
+void Scheduler_Trigger(Scheduler *sched, uint8_t task_id);
+
+// True if a task is released or triggered at <now_us>. For idle hooks to recheck with interrupts masked
+bool Scheduler_HasWork(Scheduler *sched, uint64_t now_us);
+
+// Earliest periodic release, what the idle hook should sleep until
+uint64_t Scheduler_NextWake(Scheduler *sched);
+
+// Runs the most urgent ready task to completion. Returns false if nothing was ready
+bool Scheduler_RunOnce(Scheduler *sched);
+
+// RunOnce forever, idling between releases
+void Scheduler_Run(Scheduler *sched);
+
+void Scheduler_PrintStats(Scheduler *sched);
+#endif
@@ -0,0 +1,105 @@
+/*
+ *
+ *  Sector Cache
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#include <string.h>
+#include "SectorCache.h"
+
+void SectorCache_Initialise(SectorCache *cache, const BlockDevice *device) {
+    memset(cache, 0, sizeof(SectorCache));
+    cache->device = device;
+}
+
+static int SectorCache_WriteBack(SectorCache *cache, SectorCache_Entry *entry) {
+    if (!entry->valid || !entry->dirty) {
+        return 0;
+    }
+    if (cache->device->write == NULL) {
+        return -1;
+    }
+    int result = cache->device->write(cache->device->context, entry->lba, entry->data, 1);
+    if (result < 0) {
+        return result;
+    }
+    entry->dirty = false;
+    cache->writebacks++;
+    return 0;
+}
+
+int SectorCache_Get(SectorCache *cache, uint32_t lba, bool for_write, uint8_t **data) {
+    SectorCache_Entry *victim = &cache->entries[0];
+    cache->tick++;
+    for (uint8_t i = 0; i < SECTORCACHE_ENTRIES; i++) {
+        SectorCache_Entry *entry = &cache->entries[i];
+        if (entry->valid && entry->lba == lba) {
+            entry->last_used = cache->tick;
+            entry->dirty |= for_write;
+            cache->hits++;
+            *data = entry->data;
+            return 0;
+        }
+        // Empty slots first, then least recently used
+        if (!entry->valid) {
+            if (victim->valid) {
+                victim = entry;
+            }
+        }
+        else if (victim->valid && entry->last_used < victim->last_used) {
+            victim = entry;
+        }
+    }
+
+    cache->misses++;
+    int result = SectorCache_WriteBack(cache, victim);
+    if (result < 0) {
+        return result;
+    }
+    victim->valid = false;
+    result = cache->device->read(cache->device->context, lba, victim->data, 1);
+    if (result < 0) {
+        return result;
+    }
+    victim->lba = lba;
+    victim->valid = true;
+    victim->dirty = for_write;
+    victim->last_used = cache->tick;
+    *data = victim->data;
+    return 0;
+}
+
+int SectorCache_ReadDirect(SectorCache *cache, uint32_t lba, uint8_t *data, uint32_t count) {
+    for (uint8_t i = 0; i < SECTORCACHE_ENTRIES; i++) {
+        SectorCache_Entry *entry = &cache->entries[i];
+        if (entry->valid && entry->lba >= lba && entry->lba - lba < count) {
+            int result = SectorCache_WriteBack(cache, entry);
+            if (result < 0) {
+                return result;
+            }
+        }
+    }
+    return cache->device->read(cache->device->context, lba, data, count);
+}
+
+int SectorCache_Flush(SectorCache *cache) {
+    for (uint8_t i = 0; i < SECTORCACHE_ENTRIES; i++) {
+        int result = SectorCache_WriteBack(cache, &cache->entries[i]);
+        if (result < 0) {
+            return result;
+        }
+    }
+    return 0;
+}
+
+void SectorCache_Invalidate(SectorCache *cache) {
+    for (uint8_t i = 0; i < SECTORCACHE_ENTRIES; i++) {
+        cache->entries[i].valid = false;
+        cache->entries[i].dirty = false;
+    }
+}
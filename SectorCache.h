@@ -0,0 +1,58 @@
+/*
+ *
+ *  Sector Cache
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _SECTORCACHE_H
+#define _SECTORCACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "BlockDevice.h"
+
+// Small write back LRU cache of whole sectors in front of a block device. FAT and directory
+// sectors are read many times while streaming a file, file data itself can bypass the
+// cache with SectorCache_ReadDirect so a large read turns into one multi-block transfer
+
+#define SECTORCACHE_ENTRIES 4
+
+typedef struct {
+    uint8_t data[BLOCKDEVICE_SECTOR_SIZE] __attribute__((aligned(4)));
+    uint32_t lba;
+    uint32_t last_used;
+    bool valid;
+    bool dirty;
+} SectorCache_Entry;
+
+typedef struct {
+    const BlockDevice *device;
+    SectorCache_Entry entries[SECTORCACHE_ENTRIES];
+    uint32_t tick;
+
+    // Statistics
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t writebacks;
+} SectorCache;
+
+void SectorCache_Initialise(SectorCache *cache, const BlockDevice *device);
+
+// Points <data> at the cached copy of <lba>, valid until the next cache call.
+// With <for_write> the sector is marked dirty and written back on eviction or flush
+int SectorCache_Get(SectorCache *cache, uint32_t lba, bool for_write, uint8_t **data);
+
+// Reads <count> sectors straight into <data>, dirty cached sectors in the range are written back first
+int SectorCache_ReadDirect(SectorCache *cache, uint32_t lba, uint8_t *data, uint32_t count);
+
+// Writes back every dirty sector
+int SectorCache_Flush(SectorCache *cache);
+
+// Drops everything without writing back, for a card change
+void SectorCache_Invalidate(SectorCache *cache);
+#endif
@@ -0,0 +1,70 @@
+/*
+ *
+ *  Painted Stack Check
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "StackCheck.h"
+
+void StackCheck_Initialise(StackCheck *check) {
+    memset(check, 0, sizeof(StackCheck));
+}
+
+int StackCheck_AddRegion(StackCheck *check, const char *name, uint32_t *bottom, uint32_t *top) {
+    if (check->region_count >= STACKCHECK_MAX_REGIONS || top <= bottom) {
+        return -1;
+    }
+    // Our own frame is somewhere below this local if it is the current stack
+    volatile uint32_t here = 0;
+    uintptr_t end = (uintptr_t)top;
+    uintptr_t frame = (uintptr_t)&here - STACKCHECK_MARGIN_WORDS * sizeof(uint32_t);
+    if ((uintptr_t)&here >= (uintptr_t)bottom && (uintptr_t)&here < (uintptr_t)top) {
+        end = frame > (uintptr_t)bottom ? frame : (uintptr_t)bottom;
+    }
+    for (volatile uint32_t *word = bottom; (uintptr_t)word < end; word++) {
+        *word = STACKCHECK_PAINT;
+    }
+
+    StackCheck_Region *region = &check->regions[check->region_count];
+    region->name = name;
+    region->bottom = bottom;
+    region->top = top;
+    region->high_water = (uint32_t)((uintptr_t)top - end);
+    return check->region_count++;
+}
+
+uint32_t StackCheck_Update(StackCheck *check) {
+    uint32_t headroom = UINT32_MAX;
+    for (uint8_t i = 0; i < check->region_count; i++) {
+        StackCheck_Region *region = &check->regions[i];
+        const volatile uint32_t *word = region->bottom;
+        while (word < region->top && *word == STACKCHECK_PAINT) {
+            word++;
+        }
+        region->high_water = (uint32_t)((uintptr_t)region->top - (uintptr_t)word);
+        uint32_t size = (uint32_t)((uintptr_t)region->top - (uintptr_t)region->bottom);
+        if (size - region->high_water < headroom) {
+            headroom = size - region->high_water;
+        }
+    }
+    return headroom;
+}
+
+void StackCheck_Print(StackCheck *check) {
+    StackCheck_Update(check);
+    printf("Stack   Used  Size  Free\n");
+    for (uint8_t i = 0; i < check->region_count; i++) {
+        StackCheck_Region *region = &check->regions[i];
+        uint32_t size = (uint32_t)((uintptr_t)region->top - (uintptr_t)region->bottom);
+        uint32_t free = size - region->high_water;
+        printf("%-6s %5lu %5lu %5lu%s\n", region->name, (unsigned long)region->high_water, (unsigned long)size,
+               (unsigned long)free, free < STACKCHECK_LOW_BYTES ? "  LOW" : "");
+    }
+}
@@ -0,0 +1,49 @@
+/*
+ *
+ *  Painted Stack Check
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _STACKCHECK_H
+#define _STACKCHECK_H
+
+#include <stdint.h>
+
+// Stack high water marks. Each stack is filled with a pattern at boot, and the deepest
+// point ever reached is the lowest word that no longer holds it. Stacks grow down, so
+// the scan starts at the bottom and stops at the first overwritten word. Nothing runs
+// in the hot path, the cost is one scan per StackCheck_Update. Portable, no SDK dependencies
+
+#define STACKCHECK_MAX_REGIONS  2
+#define STACKCHECK_PAINT        0x5AFEC0DEu
+#define STACKCHECK_MARGIN_WORDS 32   // Left unpainted below the caller's frame
+#define STACKCHECK_LOW_BYTES    256  // Less headroom than this is flagged
+
+typedef struct {
+    const char *name;
+    uint32_t *bottom;     // Lowest word
+    uint32_t *top;        // One past the highest word
+    uint32_t high_water;  // Bytes, deepest seen at the last update
+} StackCheck_Region;
+
+typedef struct {
+    StackCheck_Region regions[STACKCHECK_MAX_REGIONS];
+    uint8_t region_count;
+} StackCheck;
+
+void StackCheck_Initialise(StackCheck *check);
+
+// Paints <bottom> up to <top>. If this is the stack we are running on, painting stops
+// short of our own frame. Returns the id or -1 if full
+int StackCheck_AddRegion(StackCheck *check, const char *name, uint32_t *bottom, uint32_t *top);
+
+// Rescans every region. Returns the smallest headroom in bytes
+uint32_t StackCheck_Update(StackCheck *check);
+
+void StackCheck_Print(StackCheck *check);
+#endif
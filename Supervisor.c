@@ -0,0 +1,158 @@
+/*
+ *
+ *  Task Supervisor and Crash Breadcrumbs
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include "Supervisor.h"
+#include "HotPath.h"
+
+static uint32_t Supervisor_Checksum(const Supervisor_Crumbs *crumbs) {
+    const uint32_t *words = (const uint32_t *)crumbs;
+    uint32_t check = 0;
+    for (uint32_t i = 0; i < offsetof(Supervisor_Crumbs, check) / sizeof(uint32_t); i++) {
+        check ^= words[i];
+    }
+    return check;
+}
+
+// Keeps the check word valid with one extra XOR per store. A store from the other core
+// landing in between would leave the check word wrong for good, hence the lock
+static void HOT_PATH(Supervisor_Store)(Supervisor *sup, volatile uint32_t *word, uint32_t value) {
+    if (sup->lock == NULL) {
+        sup->crumbs->check ^= *word ^ value;
+        *word = value;
+        return;
+    }
+    uint32_t saved = sup->lock(sup->lock_context);
+    sup->crumbs->check ^= *word ^ value;
+    *word = value;
+    sup->unlock(sup->lock_context, saved);
+}
+
+void Supervisor_Initialise(Supervisor *sup, volatile Supervisor_Crumbs *crumbs, bool watchdog_reset) {
+    memset(sup, 0, sizeof(Supervisor));
+    sup->crumbs = crumbs;
+    sup->tripped = -1;
+    for (uint32_t i = 0; i < sizeof(Supervisor_Crumbs) / sizeof(uint32_t); i++) {
+        ((uint32_t *)&sup->previous)[i] = ((volatile uint32_t *)crumbs)[i];
+    }
+    sup->warm = watchdog_reset && sup->previous.magic == SUPERVISOR_MAGIC
+                && sup->previous.check == Supervisor_Checksum(&sup->previous);
+
+    Supervisor_Crumbs fresh = {
+        .magic = SUPERVISOR_MAGIC,
+        .task = SUPERVISOR_NONE,
+        .detail = SUPERVISOR_NONE,
+        .stale = SUPERVISOR_NONE,
+    };
+    if (sup->warm) {
+        fresh.resets = sup->previous.resets + 1;
+        memcpy(fresh.keep, sup->previous.keep, sizeof(fresh.keep));
+    }
+    else {
+        memset(&sup->previous, 0, sizeof(Supervisor_Crumbs));
+    }
+    fresh.check = Supervisor_Checksum(&fresh);
+    for (uint32_t i = 0; i < sizeof(Supervisor_Crumbs) / sizeof(uint32_t); i++) {
+        ((volatile uint32_t *)crumbs)[i] = ((uint32_t *)&fresh)[i];
+    }
+}
+
+void Supervisor_SetLock(Supervisor *sup, Supervisor_LockFunction lock, Supervisor_UnlockFunction unlock, void *context) {
+    sup->lock = lock;
+    sup->unlock = unlock;
+    sup->lock_context = context;
+}
+
+bool Supervisor_IsWarm(const Supervisor *sup) {
+    return sup->warm;
+}
+
+uint32_t Supervisor_Kept(const Supervisor *sup, uint8_t index) {
+    return sup->warm && index < SUPERVISOR_KEEP_WORDS ? sup->previous.keep[index] : 0;
+}
+
+int Supervisor_Watch(Supervisor *sup, const char *name, uint32_t timeout_us, uint32_t now_us) {
+    if (sup->watched_count >= SUPERVISOR_MAX_WATCHED) {
+        return -1;
+    }
+    Supervisor_Watched *watched = &sup->watched[sup->watched_count];
+    watched->name = name;
+    watched->timeout_us = timeout_us;
+    watched->last_beat_us = now_us;
+    watched->misses = 0;
+    return sup->watched_count++;
+}
+
+void HOT_PATH(Supervisor_Heartbeat)(Supervisor *sup, uint8_t id, uint32_t now_us) {
+    if (id < sup->watched_count) {
+        sup->watched[id].last_beat_us = now_us;
+    }
+}
+
+void Supervisor_Resume(Supervisor *sup, uint32_t now_us) {
+    for (uint8_t i = 0; i < sup->watched_count; i++) {
+        sup->watched[i].last_beat_us = now_us;
+    }
+}
+
+bool Supervisor_Check(Supervisor *sup, uint32_t now_us) {
+    if (sup->tripped >= 0) {
+        return false;
+    }
+    for (uint8_t i = 0; i < sup->watched_count; i++) {
+        Supervisor_Watched *watched = &sup->watched[i];
+        if (now_us - watched->last_beat_us > watched->timeout_us) {
+            watched->misses++;
+            sup->tripped = i;
+            Supervisor_Store(sup, &sup->crumbs->stale, i);
+            return false;
+        }
+    }
+    return true;
+}
+
+void HOT_PATH(Supervisor_TaskStarted)(Supervisor *sup, uint32_t task, uint32_t uptime_ms) {
+    Supervisor_Store(sup, &sup->crumbs->task, task);
+    Supervisor_Store(sup, &sup->crumbs->uptime_ms, uptime_ms);
+}
+
+void HOT_PATH(Supervisor_Detail)(Supervisor *sup, uint32_t detail) {
+    Supervisor_Store(sup, &sup->crumbs->detail, detail);
+}
+
+void HOT_PATH(Supervisor_Keep)(Supervisor *sup, uint8_t index, uint32_t value) {
+    if (index < SUPERVISOR_KEEP_WORDS && sup->crumbs->keep[index] != value) {
+        Supervisor_Store(sup, &sup->crumbs->keep[index], value);
+    }
+}
+
+void Supervisor_PrintReport(const Supervisor *sup, const char *(*task_name)(uint32_t task)) {
+    if (!sup->warm) {
+        printf("Cold boot\n");
+        return;
+    }
+    const Supervisor_Crumbs *crumbs = &sup->previous;
+    printf("Watchdog reset %lu at %lums uptime\n", (unsigned long)crumbs->resets + 1, (unsigned long)crumbs->uptime_ms);
+    if (crumbs->task != SUPERVISOR_NONE) {
+        printf("  last task started: %s\n", task_name ? task_name(crumbs->task) : "?");
+    }
+    if (crumbs->stale != SUPERVISOR_NONE) {
+        printf("  stale heartbeat: %s\n", crumbs->stale < sup->watched_count ? sup->watched[crumbs->stale].name : "?");
+    }
+    else {
+        printf("  no stale heartbeat, the main loop hung\n");
+    }
+    if (crumbs->detail != SUPERVISOR_NONE) {
+        printf("  detail: %08lx\n", (unsigned long)crumbs->detail);
+    }
+}
@@ -0,0 +1,92 @@
+/*
+ *
+ *  Task Supervisor and Crash Breadcrumbs
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _SUPERVISOR_H
+#define _SUPERVISOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Watched tasks beat with Supervisor_Heartbeat. Supervisor_Check, run from a periodic task,
+// says whether every one of them beat within its timeout, and the caller only feeds the
+// hardware watchdog if so. A hang anywhere in the main loop also stops the feed.
+// Once a task goes stale the supervisor stays tripped until the watchdog resets us.
+// Breadcrumbs (the task that was running, what it was doing, uptime) and a few words of
+// state to carry over are written to a caller supplied record that survives a watchdog
+// reset (uninitialised RAM on target). After a watchdog reset with a good record the
+// caller takes the warm path. Portable, no SDK dependencies
+// Breadcrumbs may be written from both cores. Each store is a read-modify-write of the check
+// word, so the caller supplies a lock (a hardware spinlock on target) to serialise them
+
+#define SUPERVISOR_MAX_WATCHED  8
+#define SUPERVISOR_KEEP_WORDS   2
+#define SUPERVISOR_NONE         0xFFFFFFFFu
+#define SUPERVISOR_MAGIC        0x4D505356u // "MPSV"
+
+typedef struct {
+    uint32_t magic;
+    uint32_t resets;                     // Watchdog resets since the last cold boot
+    uint32_t task;                       // Last task started, SUPERVISOR_NONE if none
+    uint32_t detail;                     // Last detail breadcrumb, e.g. I2C address in flight
+    uint32_t stale;                      // Watched task that tripped the supervisor
+    uint32_t uptime_ms;                  // When the last task started
+    uint32_t keep[SUPERVISOR_KEEP_WORDS];
+    uint32_t check;                      // XOR of every word above, kept up to date per write
+} Supervisor_Crumbs;
+
+typedef struct {
+    const char *name;
+    uint32_t timeout_us;
+    uint32_t last_beat_us;
+    uint32_t misses;                     // Checks that found it stale
+} Supervisor_Watched;
+
+// Returns whatever the unlock needs to restore, e.g. the interrupt state
+typedef uint32_t (*Supervisor_LockFunction)(void *context);
+typedef void (*Supervisor_UnlockFunction)(void *context, uint32_t saved);
+
+typedef struct {
+    volatile Supervisor_Crumbs *crumbs;
+    Supervisor_Crumbs previous;          // As found at boot
+    bool warm;                           // Watchdog reset with a good record
+    Supervisor_Watched watched[SUPERVISOR_MAX_WATCHED];
+    uint8_t watched_count;
+    int8_t tripped;                      // Stale watched task, -1 while healthy
+    Supervisor_LockFunction lock;        // May be NULL with a single writer
+    Supervisor_UnlockFunction unlock;
+    void *lock_context;
+} Supervisor;
+
+// <watchdog_reset> is whether the hardware says the watchdog caused this boot. Anything
+// but a good record after a watchdog reset is treated as a cold boot and cleared
+void Supervisor_Initialise(Supervisor *sup, volatile Supervisor_Crumbs *crumbs, bool watchdog_reset);
+// Held around every breadcrumb store, set before a second core writes any
+void Supervisor_SetLock(Supervisor *sup, Supervisor_LockFunction lock, Supervisor_UnlockFunction unlock, void *context);
+bool Supervisor_IsWarm(const Supervisor *sup);
+// State kept by the previous run, 0 on a cold boot
+uint32_t Supervisor_Kept(const Supervisor *sup, uint8_t index);
+
+// Returns the id or -1 if full. The first interval starts at <now_us>
+int Supervisor_Watch(Supervisor *sup, const char *name, uint32_t timeout_us, uint32_t now_us);
+void Supervisor_Heartbeat(Supervisor *sup, uint8_t id, uint32_t now_us);
+// Every watched task starts a new interval, after a pause that was on purpose (dormant)
+void Supervisor_Resume(Supervisor *sup, uint32_t now_us);
+// Returns true if the watchdog may be fed
+bool Supervisor_Check(Supervisor *sup, uint32_t now_us);
+
+// Breadcrumbs, a few stores each so they can be left in hot paths
+void Supervisor_TaskStarted(Supervisor *sup, uint32_t task, uint32_t uptime_ms);
+void Supervisor_Detail(Supervisor *sup, uint32_t detail);
+void Supervisor_Keep(Supervisor *sup, uint8_t index, uint32_t value);
+
+// Previous run's breadcrumbs if this is a warm restart, <task_name> may be NULL
+void Supervisor_PrintReport(const Supervisor *sup, const char *(*task_name)(uint32_t task));
+#endif
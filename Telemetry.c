@@ -0,0 +1,63 @@
+/*
+ *
+ *  Telemetry Batching
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#include <string.h>
+#include "Telemetry.h"
+
+#define TELEMETRY_MASK  (TELEMETRY_SIZE - 1)
+
+void Telemetry_Initialise(Telemetry *tel) {
+    memset(tel, 0, sizeof(Telemetry));
+}
+
+uint32_t Telemetry_Pending(const Telemetry *tel) {
+    return tel->head - tel->tail;
+}
+
+uint32_t Telemetry_Write(Telemetry *tel, const void *data, uint32_t length, uint32_t now_us) {
+    uint32_t space = TELEMETRY_SIZE - Telemetry_Pending(tel);
+    uint32_t taken = length < space ? length : space;
+    tel->dropped += length - taken;
+    if (taken == 0) {
+        return 0;
+    }
+    if (tel->head == tel->tail) {
+        tel->oldest_us = now_us;
+    }
+    const uint8_t *bytes = (const uint8_t *)data;
+    for (uint32_t i = 0; i < taken; i++) {
+        tel->data[(tel->head + i) & TELEMETRY_MASK] = bytes[i];
+    }
+    tel->head += taken;
+    return taken;
+}
+
+uint32_t Telemetry_TakePacket(Telemetry *tel, uint8_t *packet, uint32_t capacity, uint32_t now_us) {
+    uint32_t pending = Telemetry_Pending(tel);
+    uint32_t length = capacity < TELEMETRY_PACKET_SIZE ? capacity : TELEMETRY_PACKET_SIZE;
+    if (pending == 0 || (pending < length && now_us - tel->oldest_us < TELEMETRY_MAX_AGE_US)) {
+        return 0;
+    }
+    if (pending < length) {
+        length = pending;
+        tel->partial_packets++;
+    }
+    for (uint32_t i = 0; i < length; i++) {
+        packet[i] = tel->data[(tel->tail + i) & TELEMETRY_MASK];
+    }
+    tel->tail += length;
+    tel->packets++;
+    // The remainder gets a fresh window to fill a packet
+    if (tel->head != tel->tail) {
+        tel->oldest_us = now_us;
+    }
+    return length;
+}
@@ -0,0 +1,47 @@
+/*
+ *
+ *  Telemetry Batching
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _TELEMETRY_H
+#define _TELEMETRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Byte ring in front of the CDC channel. Output is handed on in full packets, a partial
+// packet only goes once its oldest byte has waited TELEMETRY_MAX_AGE_US, so a burst of
+// console lines costs a few full transfers instead of one short transfer per printf.
+// A full ring drops new bytes rather than blocking the writer. Portable
+
+#define TELEMETRY_SIZE          1024 // Power of two
+#define TELEMETRY_PACKET_SIZE   64
+#define TELEMETRY_MAX_AGE_US    20000
+
+typedef struct {
+    uint8_t data[TELEMETRY_SIZE];
+    uint32_t head;          // Free running, written at head
+    uint32_t tail;
+    uint32_t oldest_us;     // When the byte at tail was written
+    // Statistics
+    uint32_t dropped;
+    uint32_t packets;
+    uint32_t partial_packets;
+} Telemetry;
+
+void Telemetry_Initialise(Telemetry *tel);
+
+// Returns the number of bytes taken
+uint32_t Telemetry_Write(Telemetry *tel, const void *data, uint32_t length, uint32_t now_us);
+uint32_t Telemetry_Pending(const Telemetry *tel);
+
+// Copies the next packet into <packet> if a full one is waiting or the oldest byte has
+// aged out, at most <capacity> bytes. Returns its length, 0 if nothing is due
+uint32_t Telemetry_TakePacket(Telemetry *tel, uint8_t *packet, uint32_t capacity, uint32_t now_us);
+#endif
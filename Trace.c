@@ -0,0 +1,84 @@
+/*
+ *
+ *  Scan Trace Capture
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "Trace.h"
+#include "HotPath.h"
+
+static const char trace_kind_names[] = {'S', 'W', 'C'};
+
+void Trace_Initialise(Trace *trace) {
+    memset(trace, 0, sizeof(Trace));
+}
+
+void Trace_SetEnabled(Trace *trace, bool enabled) {
+    trace->enabled = enabled;
+}
+
+void Trace_Clear(Trace *trace) {
+    trace->head = 0;
+    trace->count = 0;
+    trace->overwritten = 0;
+}
+
+void HOT_PATH(Trace_Record)(Trace *trace, Trace_SampleKind kind, uint8_t source, uint16_t io, uint32_t time_us) {
+    if (!trace->enabled) {
+        return;
+    }
+    Trace_Sample *sample = &trace->samples[trace->head];
+    sample->time_us = time_us;
+    sample->io = io;
+    sample->kind = kind;
+    sample->source = source;
+    trace->head = (trace->head + 1) % TRACE_CAPACITY;
+    if (trace->count < TRACE_CAPACITY) {
+        trace->count++;
+    }
+    else {
+        trace->overwritten++;
+    }
+}
+
+const Trace_Sample *Trace_Get(const Trace *trace, uint32_t index) {
+    if (index >= trace->count) {
+        return NULL;
+    }
+    return &trace->samples[(trace->head + TRACE_CAPACITY - trace->count + index) % TRACE_CAPACITY];
+}
+
+void Trace_Dump(const Trace *trace) {
+    printf("trace %u %lu %lu\n", TRACE_FORMAT, (unsigned long)trace->count, (unsigned long)trace->overwritten);
+    for (uint32_t i = 0; i < trace->count; i++) {
+        const Trace_Sample *sample = Trace_Get(trace, i);
+        printf("%lu %c %u %04x\n", (unsigned long)sample->time_us, trace_kind_names[sample->kind], sample->source, sample->io);
+    }
+    printf("end\n");
+}
+
+bool Trace_ParseLine(const char *line, Trace_Sample *sample) {
+    unsigned long time_us;
+    char kind;
+    unsigned int source;
+    unsigned int io;
+    if (sscanf(line, "%lu %c %u %x", &time_us, &kind, &source, &io) != 4 || source > 0xFF || io > 0xFFFF) {
+        return false;
+    }
+    const char *name = memchr(trace_kind_names, kind, sizeof(trace_kind_names));
+    if (name == NULL) {
+        return false;
+    }
+    sample->time_us = (uint32_t)time_us;
+    sample->kind = (uint8_t)(name - trace_kind_names);
+    sample->source = (uint8_t)source;
+    sample->io = (uint16_t)io;
+    return true;
+}
@@ -0,0 +1,62 @@
+/*
+ *
+ *  Scan Trace Capture
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _TRACE_H
+#define _TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Flight recorder of raw expander samples, taken before debounce. Once full the oldest
+// samples are overwritten, so a dump after a missed or ghost key holds the lead up to it.
+// Every sample is kept, unchanged ones included, since the debounce lockout depends on
+// when samples were taken and not only on when the inputs changed.
+// The dump is plain text and is fed back through the key pipeline by tools/replay
+
+#define TRACE_CAPACITY      2048 // 20s at the 10ms scan period
+#define TRACE_FORMAT        1
+
+typedef enum {
+    TRACE_SAMPLE_SCAN = 0, // MCP23017_GetIO from the scan
+    TRACE_SAMPLE_WAKE,     // INTCAP of the key that woke us from dormant
+    TRACE_SAMPLE_CAPTURE,  // INTCAP from an edge capture scan, ahead of its GPIO sample
+} Trace_SampleKind;
+
+typedef struct {
+    uint32_t time_us;
+    uint16_t io;
+    uint8_t kind;
+    uint8_t source;
+} Trace_Sample;
+
+typedef struct {
+    Trace_Sample samples[TRACE_CAPACITY];
+    uint32_t head;        // Next slot written
+    uint32_t count;
+    uint32_t overwritten; // Samples lost to wrap since the last clear
+    bool enabled;
+} Trace;
+
+void Trace_Initialise(Trace *trace);
+void Trace_SetEnabled(Trace *trace, bool enabled);
+void Trace_Clear(Trace *trace);
+void Trace_Record(Trace *trace, Trace_SampleKind kind, uint8_t source, uint16_t io, uint32_t time_us);
+// <index>th oldest sample
+const Trace_Sample *Trace_Get(const Trace *trace, uint32_t index);
+
+// Dump format:
+//   trace <format> <count> <overwritten>
+//   <time_us> <S|W> <source> <io hex>   one per sample, oldest first
+//   end
+void Trace_Dump(const Trace *trace);
+// Parses one sample line of a dump. Returns false for anything else (headers, log output)
+bool Trace_ParseLine(const char *line, Trace_Sample *sample);
+#endif
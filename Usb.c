@@ -0,0 +1,230 @@
+/*
+ *
+ *  USB Composite Device (TinyUSB)
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/stdio/driver.h"
+#include "pico/unique_id.h"
+#include "tusb.h"
+#include "Usb.h"
+
+// Order decides interface numbers, endpoints and HID instances
+static const UsbDescriptors_Function usb_functions[] = {
+    {USBDESC_FUNCTION_KEYBOARD, 1, USBDESC_STRING_KEYBOARD},
+    {USBDESC_FUNCTION_CONSUMER, 1, USBDESC_STRING_CONSUMER},
+    {USBDESC_FUNCTION_RAW_HID, 1, USBDESC_STRING_RAW},
+    {USBDESC_FUNCTION_CDC, 0, USBDESC_STRING_CDC},
+};
+
+static const char *const usb_strings[] = {
+    [USBDESC_STRING_MANUFACTURER] = "Jennifer Chan",
+    [USBDESC_STRING_PRODUCT] = "Macropad",
+    [USBDESC_STRING_KEYBOARD] = "Macropad Keyboard",
+    [USBDESC_STRING_RAW] = "Macropad Raw HID",
+    [USBDESC_STRING_CDC] = "Macropad Console",
+    [USBDESC_STRING_CONSUMER] = "Macropad Media Keys",
+};
+
+static Usb *usb_instance;
+
+// Transport hooks
+static bool usb_mounted(void *context) {
+    return tud_mounted();
+}
+
+static bool usb_suspended(void *context) {
+    return tud_suspended();
+}
+
+static void usb_remote_wakeup(void *context) {
+    tud_remote_wakeup();
+}
+
+static uint8_t usb_hid_instance(Usb *usb, UsbTransport_Channel channel) {
+    if (channel == USBTRANSPORT_KEYBOARD) {
+        return usb->keyboard_instance;
+    }
+    return channel == USBTRANSPORT_CONSUMER ? usb->consumer_instance : usb->raw_instance;
+}
+
+static bool usb_ready(void *context, UsbTransport_Channel channel) {
+    return tud_hid_n_ready(usb_hid_instance((Usb *)context, channel));
+}
+
+static bool usb_send(void *context, UsbTransport_Channel channel, const uint8_t *data, uint32_t length) {
+    Usb *usb = (Usb *)context;
+    if (channel == USBTRANSPORT_CDC) {
+        uint32_t written = tud_cdc_n_write(usb->cdc_instance, data, length);
+        tud_cdc_n_write_flush(usb->cdc_instance);
+        return written == length;
+    }
+    return tud_hid_n_report(usb_hid_instance(usb, channel), 0, data, (uint16_t)length);
+}
+
+static uint32_t usb_cdc_space(void *context) {
+    return tud_cdc_n_write_available(((Usb *)context)->cdc_instance);
+}
+
+static const UsbTransport_Hooks usb_hooks = {
+    .mounted = usb_mounted,
+    .suspended = usb_suspended,
+    .remote_wakeup = usb_remote_wakeup,
+    .ready = usb_ready,
+    .send = usb_send,
+    .cdc_space = usb_cdc_space,
+};
+
+// stdio driver, output goes through the telemetry batching
+static void usb_stdio_out_chars(const char *buffer, int length) {
+    UsbTransport_Write(&usb_instance->transport, buffer, length, time_us_32());
+}
+
+static int usb_stdio_in_chars(char *buffer, int length) {
+    if (!tud_cdc_n_available(usb_instance->cdc_instance)) {
+        return PICO_ERROR_NO_DATA;
+    }
+    return (int)tud_cdc_n_read(usb_instance->cdc_instance, buffer, length);
+}
+
+static stdio_driver_t usb_stdio = {
+    .out_chars = usb_stdio_out_chars,
+    .in_chars = usb_stdio_in_chars,
+#if PICO_STDIO_ENABLE_CRLF_SUPPORT
+    .crlf_enabled = PICO_STDIO_DEFAULT_CRLF,
+#endif
+};
+
+uint8_t Usb_Initialise(Usb *usb, HidReport *hid) {
+    memset(usb, 0, sizeof(Usb));
+    if (UsbDescriptors_BuildConfiguration(&usb->configuration, usb_functions, count_of(usb_functions), USB_MAX_POWER_MA, true) < 0) {
+        return 1;
+    }
+    UsbDescriptors_BuildDevice(usb->device_descriptor, USB_VID, USB_PID, USB_BCD_DEVICE);
+    usb->keyboard_instance = usb->configuration.assigned[0].instance;
+    usb->consumer_instance = usb->configuration.assigned[1].instance;
+    usb->raw_instance = usb->configuration.assigned[2].instance;
+    usb->cdc_instance = usb->configuration.assigned[3].instance;
+    UsbTransport_Initialise(&usb->transport, &usb_hooks, usb, hid);
+    usb_instance = usb;
+    usb->started = true;
+    tusb_init();
+    return 0;
+}
+
+void Usb_SetLedHandler(Usb *usb, Usb_LedFunction function, void *context) {
+    usb->led_function = function;
+    usb->led_context = context;
+}
+
+void Usb_SetEventHandler(Usb *usb, Usb_EventFunction function, void *context) {
+    usb->event_function = function;
+    usb->event_context = context;
+}
+
+void Usb_SetRawHandler(Usb *usb, UsbTransport_RawHandler handler, void *context) {
+    UsbTransport_SetRawHandler(&usb->transport, handler, context);
+}
+
+void Usb_EnableStdio(Usb *usb) {
+    stdio_set_driver_enabled(&usb_stdio, true);
+}
+
+void Usb_Task(Usb *usb) {
+    if (!usb->started) {
+        return;
+    }
+    tud_task();
+    UsbTransport_Poll(&usb->transport, time_us_32());
+}
+
+bool Usb_Suspended(Usb *usb) {
+    return !usb->started || tud_suspended();
+}
+
+void Usb_PrintStats(Usb *usb) {
+    UsbTransport *transport = &usb->transport;
+    printf("USB %s%s, %u interfaces\n", tud_mounted() ? "mounted" : "not mounted", tud_suspended() ? ", suspended" : "",
+           usb->configuration.interface_count);
+    printf("  keyboard %lu reports, %lu dropped without a host, %lu wakeups\n", (unsigned long)transport->sent[USBTRANSPORT_KEYBOARD],
+           (unsigned long)transport->keyboard_dropped, (unsigned long)transport->wakeups);
+    printf("  consumer %lu reports\n", (unsigned long)transport->sent[USBTRANSPORT_CONSUMER]);
+    printf("  raw HID %lu replies, %lu overrun\n", (unsigned long)transport->sent[USBTRANSPORT_RAW], (unsigned long)transport->raw_overrun);
+    printf("  %lu HID sends refused and retried\n", (unsigned long)transport->send_failed);
+    printf("  CDC %lu packets (%lu partial), %lu bytes dropped\n", (unsigned long)transport->telemetry.packets,
+           (unsigned long)transport->telemetry.partial_packets, (unsigned long)transport->telemetry.dropped);
+}
+
+// TinyUSB callbacks
+void tud_event_hook_cb(uint8_t rhport, uint32_t eventid, bool in_isr) {
+    if (usb_instance && usb_instance->event_function) {
+        usb_instance->event_function(usb_instance->event_context);
+    }
+}
+
+uint8_t const *tud_descriptor_device_cb(void) {
+    return usb_instance->device_descriptor;
+}
+
+uint8_t const *tud_descriptor_configuration_cb(uint8_t index) {
+    return usb_instance->configuration.data;
+}
+
+uint8_t const *tud_hid_descriptor_report_cb(uint8_t instance) {
+    uint16_t length;
+    UsbDescriptors_FunctionType type = USBDESC_FUNCTION_RAW_HID;
+    if (instance == usb_instance->keyboard_instance) {
+        type = USBDESC_FUNCTION_KEYBOARD;
+    }
+    else if (instance == usb_instance->consumer_instance) {
+        type = USBDESC_FUNCTION_CONSUMER;
+    }
+    return UsbDescriptors_HidReport(type, &length);
+}
+
+uint16_t tud_hid_get_report_cb(uint8_t instance, uint8_t report_id, hid_report_type_t report_type, uint8_t *buffer, uint16_t reqlen) {
+    return 0;
+}
+
+// Keyboard LED output reports, and raw HID requests from the OUT endpoint
+void tud_hid_set_report_cb(uint8_t instance, uint8_t report_id, hid_report_type_t report_type, uint8_t const *buffer, uint16_t bufsize) {
+    if (instance == usb_instance->keyboard_instance) {
+        if (report_type == HID_REPORT_TYPE_OUTPUT && bufsize >= 1 && usb_instance->led_function) {
+            usb_instance->led_function(usb_instance->led_context, buffer[0]);
+        }
+    }
+    else if (instance == usb_instance->raw_instance) {
+        UsbTransport_RawReceived(&usb_instance->transport, buffer, bufsize);
+    }
+}
+
+uint16_t const *tud_descriptor_string_cb(uint8_t index, uint16_t langid) {
+    static uint16_t descriptor[33];
+    char serial[2 * PICO_UNIQUE_BOARD_ID_SIZE_BYTES + 1];
+    const char *text;
+    if (index == USBDESC_STRING_LANGUAGE) {
+        descriptor[0] = (TUSB_DESC_STRING << 8) | 4;
+        descriptor[1] = 0x0409; // English (US)
+        return descriptor;
+    }
+    if (index == USBDESC_STRING_SERIAL) {
+        pico_get_unique_board_id_string(serial, sizeof(serial));
+        text = serial;
+    }
+    else if (index < count_of(usb_strings) && usb_strings[index] != NULL) {
+        text = usb_strings[index];
+    }
+    else {
+        return NULL;
+    }
+    UsbDescriptors_BuildString(descriptor, count_of(descriptor), text);
+    return descriptor;
+}
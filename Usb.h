@@ -0,0 +1,64 @@
+/*
+ *
+ *  USB Composite Device (TinyUSB)
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _USB_H
+#define _USB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "HidReport.h"
+#include "UsbDescriptors.h"
+#include "UsbTransport.h"
+
+// One USB connection carrying the boot keyboard, consumer control for volume and media
+// keys, a raw HID channel for a desktop app and a CDC ACM serial port. The CDC port is a stdio driver next to the UART, so console
+// commands work on either and all output is batched through UsbTransport.
+// TinyUSB callbacks are global, so there is a single instance
+
+#define USB_VID         0x1209 // pid.codes test VID/PID, replace before shipping boards
+#define USB_PID         0x0001
+#define USB_BCD_DEVICE  0x0100
+#define USB_MAX_POWER_MA 100
+
+// Host keyboard LEDs (bit 0 num lock, 1 caps lock, 2 scroll lock)
+typedef void (*Usb_LedFunction)(void *context, uint8_t leds);
+// Called from the USB interrupt whenever TinyUSB queues an event, to schedule Usb_Task
+typedef void (*Usb_EventFunction)(void *context);
+
+typedef struct {
+    UsbTransport transport;
+    UsbDescriptors_Configuration configuration;
+    uint8_t device_descriptor[18];
+    uint8_t keyboard_instance;
+    uint8_t consumer_instance;
+    uint8_t raw_instance;
+    uint8_t cdc_instance;
+    bool started;
+    Usb_LedFunction led_function;
+    void *led_context;
+    Usb_EventFunction event_function;
+    void *event_context;
+} Usb;
+
+// Builds the descriptors and starts TinyUSB. Returns 0 or 1 if the descriptors don't fit
+uint8_t Usb_Initialise(Usb *usb, HidReport *hid);
+void Usb_SetLedHandler(Usb *usb, Usb_LedFunction function, void *context);
+void Usb_SetEventHandler(Usb *usb, Usb_EventFunction function, void *context);
+void Usb_SetRawHandler(Usb *usb, UsbTransport_RawHandler handler, void *context);
+// Adds the CDC port to stdio, input and output
+void Usb_EnableStdio(Usb *usb);
+
+// TinyUSB device task then one pass of the endpoint policy
+void Usb_Task(Usb *usb);
+// Nothing for the device to answer: not started, or the host has suspended the bus
+bool Usb_Suspended(Usb *usb);
+void Usb_PrintStats(Usb *usb);
+#endif
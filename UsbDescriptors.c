@@ -0,0 +1,268 @@
+/*
+ *
+ *  USB Composite Descriptor Builder
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *  Specification: USB 2.0 chapter 9, HID 1.11, CDC 1.2 (ACM), IAD ECN
+ * 
+*/
+
+#include <string.h>
+#include "UsbDescriptors.h"
+
+#define USB_DESC_DEVICE         0x01
+#define USB_DESC_CONFIGURATION  0x02
+#define USB_DESC_STRING         0x03
+#define USB_DESC_INTERFACE      0x04
+#define USB_DESC_ENDPOINT       0x05
+#define USB_DESC_IAD            0x0B
+#define USB_DESC_HID            0x21
+#define USB_DESC_HID_REPORT     0x22
+#define USB_DESC_CS_INTERFACE   0x24
+
+#define USB_CLASS_CDC           0x02
+#define USB_CLASS_HID           0x03
+#define USB_CLASS_CDC_DATA      0x0A
+#define USB_CLASS_MISC          0xEF
+
+#define USB_XFER_BULK           0x02
+#define USB_XFER_INTERRUPT      0x03
+
+// Boot keyboard, modifiers byte, reserved byte, 6 keys in, 5 LEDs out. HID 1.11 appendix B.1
+const uint8_t UsbDescriptors_KeyboardReport[] = {
+    0x05, 0x01,       // Usage page (generic desktop)
+    0x09, 0x06,       // Usage (keyboard)
+    0xA1, 0x01,       // Collection (application)
+    0x05, 0x07,       //   Usage page (key codes)
+    0x19, 0xE0,       //   Usage minimum (left control)
+    0x29, 0xE7,       //   Usage maximum (right GUI)
+    0x15, 0x00,       //   Logical minimum (0)
+    0x25, 0x01,       //   Logical maximum (1)
+    0x75, 0x01,       //   Report size (1)
+    0x95, 0x08,       //   Report count (8)
+    0x81, 0x02,       //   Input (data, variable, absolute), modifiers
+    0x95, 0x01,       //   Report count (1)
+    0x75, 0x08,       //   Report size (8)
+    0x81, 0x01,       //   Input (constant), reserved
+    0x95, 0x05,       //   Report count (5)
+    0x75, 0x01,       //   Report size (1)
+    0x05, 0x08,       //   Usage page (LEDs)
+    0x19, 0x01,       //   Usage minimum (num lock)
+    0x29, 0x05,       //   Usage maximum (kana)
+    0x91, 0x02,       //   Output (data, variable, absolute), LEDs
+    0x95, 0x01,       //   Report count (1)
+    0x75, 0x03,       //   Report size (3)
+    0x91, 0x01,       //   Output (constant), padding
+    0x95, 0x06,       //   Report count (6)
+    0x75, 0x08,       //   Report size (8)
+    0x15, 0x00,       //   Logical minimum (0)
+    0x25, 0xFF,       //   Logical maximum (255)
+    0x05, 0x07,       //   Usage page (key codes)
+    0x19, 0x00,       //   Usage minimum (0)
+    0x29, 0xFF,       //   Usage maximum (255)
+    0x81, 0x00,       //   Input (data, array), keys
+    0xC0,             // End collection
+};
+const uint16_t UsbDescriptors_KeyboardReportLength = sizeof(UsbDescriptors_KeyboardReport);
+
+// 64 bytes each way on a vendor page, so the host doesn't claim it as an input device
+const uint8_t UsbDescriptors_RawReport[] = {
+    0x06, 0x60, 0xFF, // Usage page (vendor 0xFF60)
+    0x09, 0x61,       // Usage (0x61)
+    0xA1, 0x01,       // Collection (application)
+    0x09, 0x62,       //   Usage (0x62)
+    0x15, 0x00,       //   Logical minimum (0)
+    0x26, 0xFF, 0x00, //   Logical maximum (255)
+    0x95, 0x40,       //   Report count (64)
+    0x75, 0x08,       //   Report size (8)
+    0x81, 0x02,       //   Input (data, variable, absolute)
+    0x09, 0x63,       //   Usage (0x63)
+    0x15, 0x00,       //   Logical minimum (0)
+    0x26, 0xFF, 0x00, //   Logical maximum (255)
+    0x95, 0x40,       //   Report count (64)
+    0x75, 0x08,       //   Report size (8)
+    0x91, 0x02,       //   Output (data, variable, absolute)
+    0xC0,             // End collection
+};
+const uint16_t UsbDescriptors_RawReportLength = sizeof(UsbDescriptors_RawReport);
+
+// One 16 bit consumer page usage, 0 when nothing is held. HID usage tables chapter 15
+const uint8_t UsbDescriptors_ConsumerReport[] = {
+    0x05, 0x0C,       // Usage page (consumer)
+    0x09, 0x01,       // Usage (consumer control)
+    0xA1, 0x01,       // Collection (application)
+    0x15, 0x00,       //   Logical minimum (0)
+    0x26, 0xFF, 0x03, //   Logical maximum (0x3FF)
+    0x19, 0x00,       //   Usage minimum (0)
+    0x2A, 0xFF, 0x03, //   Usage maximum (0x3FF)
+    0x95, 0x01,       //   Report count (1)
+    0x75, 0x10,       //   Report size (16)
+    0x81, 0x00,       //   Input (data, array)
+    0xC0,             // End collection
+};
+const uint16_t UsbDescriptors_ConsumerReportLength = sizeof(UsbDescriptors_ConsumerReport);
+
+typedef struct {
+    UsbDescriptors_Configuration *config;
+    bool overflow;
+} UsbDescriptors_Writer;
+
+static void UsbDescriptors_Put(UsbDescriptors_Writer *writer, const uint8_t *bytes, uint8_t length) {
+    UsbDescriptors_Configuration *config = writer->config;
+    if (config->length + length > USBDESC_CONFIG_MAX_LENGTH) {
+        writer->overflow = true;
+        return;
+    }
+    memcpy(&config->data[config->length], bytes, length);
+    config->length += length;
+}
+
+static void UsbDescriptors_Interface(UsbDescriptors_Writer *writer, uint8_t number, uint8_t endpoints,
+                                     uint8_t class, uint8_t subclass, uint8_t protocol, uint8_t string_index) {
+    uint8_t descriptor[9] = {9, USB_DESC_INTERFACE, number, 0, endpoints, class, subclass, protocol, string_index};
+    UsbDescriptors_Put(writer, descriptor, sizeof(descriptor));
+}
+
+static void UsbDescriptors_Endpoint(UsbDescriptors_Writer *writer, uint8_t address, uint8_t type, uint16_t size, uint8_t interval) {
+    uint8_t descriptor[7] = {7, USB_DESC_ENDPOINT, address, type, size & 0xFF, size >> 8, interval};
+    UsbDescriptors_Put(writer, descriptor, sizeof(descriptor));
+}
+
+static void UsbDescriptors_Hid(UsbDescriptors_Writer *writer, uint16_t report_length) {
+    // HID 1.11, country 0, one report descriptor
+    uint8_t descriptor[9] = {9, USB_DESC_HID, 0x11, 0x01, 0, 1, USB_DESC_HID_REPORT, report_length & 0xFF, report_length >> 8};
+    UsbDescriptors_Put(writer, descriptor, sizeof(descriptor));
+}
+
+static void UsbDescriptors_Cdc(UsbDescriptors_Writer *writer, const UsbDescriptors_Function *function, const UsbDescriptors_Assigned *assigned) {
+    uint8_t control = assigned->interface;
+    uint8_t data = assigned->interface + 1;
+    uint8_t iad[8] = {8, USB_DESC_IAD, control, 2, USB_CLASS_CDC, 0x02, 0x00, 0};
+    UsbDescriptors_Put(writer, iad, sizeof(iad));
+    UsbDescriptors_Interface(writer, control, 1, USB_CLASS_CDC, 0x02, 0x00, function->string_index);
+    uint8_t header[5] = {5, USB_DESC_CS_INTERFACE, 0x00, 0x20, 0x01};  // CDC 1.20
+    uint8_t call[5] = {5, USB_DESC_CS_INTERFACE, 0x01, 0x00, data};    // Call management
+    uint8_t acm[4] = {4, USB_DESC_CS_INTERFACE, 0x02, 0x02};           // Line coding and state
+    uint8_t unio[5] = {5, USB_DESC_CS_INTERFACE, 0x06, control, data}; // Union
+    UsbDescriptors_Put(writer, header, sizeof(header));
+    UsbDescriptors_Put(writer, call, sizeof(call));
+    UsbDescriptors_Put(writer, acm, sizeof(acm));
+    UsbDescriptors_Put(writer, unio, sizeof(unio));
+    UsbDescriptors_Endpoint(writer, assigned->ep_notify, USB_XFER_INTERRUPT, USBDESC_CDC_NOTIFY_EP_SIZE, 16);
+    UsbDescriptors_Interface(writer, data, 2, USB_CLASS_CDC_DATA, 0, 0, 0);
+    UsbDescriptors_Endpoint(writer, assigned->ep_out, USB_XFER_BULK, USBDESC_CDC_EP_SIZE, 0);
+    UsbDescriptors_Endpoint(writer, assigned->ep_in, USB_XFER_BULK, USBDESC_CDC_EP_SIZE, 0);
+}
+
+void UsbDescriptors_BuildDevice(uint8_t *out, uint16_t vid, uint16_t pid, uint16_t bcd_device) {
+    const uint8_t descriptor[18] = {
+        18, USB_DESC_DEVICE, 0x00, 0x02,       // USB 2.0
+        USB_CLASS_MISC, 0x02, 0x01,            // Interface association
+        64,                                    // Control endpoint size
+        vid & 0xFF, vid >> 8, pid & 0xFF, pid >> 8, bcd_device & 0xFF, bcd_device >> 8,
+        USBDESC_STRING_MANUFACTURER, USBDESC_STRING_PRODUCT, USBDESC_STRING_SERIAL,
+        1,                                     // One configuration
+    };
+    memcpy(out, descriptor, sizeof(descriptor));
+}
+
+int UsbDescriptors_BuildConfiguration(UsbDescriptors_Configuration *config, const UsbDescriptors_Function *functions,
+                                      uint8_t count, uint16_t max_power_ma, bool remote_wakeup) {
+    memset(config, 0, sizeof(UsbDescriptors_Configuration));
+    if (count > USBDESC_MAX_FUNCTIONS) {
+        return -1;
+    }
+    UsbDescriptors_Writer writer = {config, false};
+    // Header first, total length and interface count are patched in at the end
+    uint8_t header[9] = {9, USB_DESC_CONFIGURATION, 0, 0, 0, 1, 0, 0x80 | (remote_wakeup ? 0x20 : 0), max_power_ma / 2};
+    UsbDescriptors_Put(&writer, header, sizeof(header));
+
+    // Endpoint numbers are handed out once each, used for both directions of a function
+    uint8_t next_endpoint = 1;
+    uint8_t hid_instance = 0;
+    uint8_t cdc_instance = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        const UsbDescriptors_Function *function = &functions[i];
+        UsbDescriptors_Assigned *assigned = &config->assigned[i];
+        assigned->interface = config->interface_count;
+        switch (function->type) {
+        case USBDESC_FUNCTION_KEYBOARD:
+            assigned->ep_in = 0x80 | next_endpoint++;
+            assigned->instance = hid_instance++;
+            UsbDescriptors_Interface(&writer, assigned->interface, 1, USB_CLASS_HID, 0x01, 0x01, function->string_index);
+            UsbDescriptors_Hid(&writer, UsbDescriptors_KeyboardReportLength);
+            UsbDescriptors_Endpoint(&writer, assigned->ep_in, USB_XFER_INTERRUPT, USBDESC_KEYBOARD_EP_SIZE, function->poll_ms);
+            config->interface_count++;
+            break;
+        case USBDESC_FUNCTION_CONSUMER:
+            assigned->ep_in = 0x80 | next_endpoint++;
+            assigned->instance = hid_instance++;
+            UsbDescriptors_Interface(&writer, assigned->interface, 1, USB_CLASS_HID, 0, 0, function->string_index);
+            UsbDescriptors_Hid(&writer, UsbDescriptors_ConsumerReportLength);
+            UsbDescriptors_Endpoint(&writer, assigned->ep_in, USB_XFER_INTERRUPT, USBDESC_CONSUMER_EP_SIZE, function->poll_ms);
+            config->interface_count++;
+            break;
+        case USBDESC_FUNCTION_RAW_HID:
+            assigned->ep_out = next_endpoint;
+            assigned->ep_in = 0x80 | next_endpoint++;
+            assigned->instance = hid_instance++;
+            UsbDescriptors_Interface(&writer, assigned->interface, 2, USB_CLASS_HID, 0, 0, function->string_index);
+            UsbDescriptors_Hid(&writer, UsbDescriptors_RawReportLength);
+            UsbDescriptors_Endpoint(&writer, assigned->ep_out, USB_XFER_INTERRUPT, USBDESC_RAW_EP_SIZE, function->poll_ms);
+            UsbDescriptors_Endpoint(&writer, assigned->ep_in, USB_XFER_INTERRUPT, USBDESC_RAW_EP_SIZE, function->poll_ms);
+            config->interface_count++;
+            break;
+        case USBDESC_FUNCTION_CDC:
+            assigned->ep_notify = 0x80 | next_endpoint++;
+            assigned->ep_out = next_endpoint;
+            assigned->ep_in = 0x80 | next_endpoint++;
+            assigned->instance = cdc_instance++;
+            UsbDescriptors_Cdc(&writer, function, assigned);
+            config->interface_count += 2;
+            break;
+        default:
+            return -1;
+        }
+        if (next_endpoint > USBDESC_MAX_ENDPOINT + 1) {
+            return -1;
+        }
+        config->function_count++;
+    }
+    if (writer.overflow) {
+        return -1;
+    }
+    config->data[2] = config->length & 0xFF;
+    config->data[3] = config->length >> 8;
+    config->data[4] = config->interface_count;
+    return config->length;
+}
+
+const uint8_t *UsbDescriptors_HidReport(UsbDescriptors_FunctionType type, uint16_t *length) {
+    if (type == USBDESC_FUNCTION_KEYBOARD) {
+        *length = UsbDescriptors_KeyboardReportLength;
+        return UsbDescriptors_KeyboardReport;
+    }
+    if (type == USBDESC_FUNCTION_CONSUMER) {
+        *length = UsbDescriptors_ConsumerReportLength;
+        return UsbDescriptors_ConsumerReport;
+    }
+    if (type == USBDESC_FUNCTION_RAW_HID) {
+        *length = UsbDescriptors_RawReportLength;
+        return UsbDescriptors_RawReport;
+    }
+    *length = 0;
+    return NULL;
+}
+
+uint8_t UsbDescriptors_BuildString(uint16_t *out, uint8_t capacity, const char *text) {
+    uint8_t count = 0;
+    while (text[count] != '\0' && count + 1 < capacity) {
+        out[count + 1] = (uint8_t)text[count];
+        count++;
+    }
+    out[0] = (USB_DESC_STRING << 8) | (2 + 2 * count);
+    return 2 + 2 * count;
+}
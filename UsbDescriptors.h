@@ -0,0 +1,94 @@
+/*
+ *
+ *  USB Composite Descriptor Builder
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *  Specification: USB 2.0 chapter 9, HID 1.11, CDC 1.2 (ACM), IAD ECN
+ * 
+*/
+
+#ifndef _USBDESCRIPTORS_H
+#define _USBDESCRIPTORS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Builds the configuration descriptor from a list of functions, handing out interface
+// numbers and endpoint addresses in order so no two functions can share an endpoint.
+// Each function gets endpoints of its own, so a bulk CDC transfer never sits in front
+// of a keyboard report. HID instance numbers follow the order of the HID functions,
+// which is how TinyUSB numbers them. Portable, no TinyUSB or SDK dependencies
+
+#define USBDESC_MAX_FUNCTIONS       4
+#define USBDESC_MAX_ENDPOINT        15
+#define USBDESC_CONFIG_MAX_LENGTH   256
+
+#define USBDESC_KEYBOARD_EP_SIZE    8
+#define USBDESC_CONSUMER_EP_SIZE    8
+#define USBDESC_RAW_EP_SIZE         64
+#define USBDESC_CDC_NOTIFY_EP_SIZE  8
+#define USBDESC_CDC_EP_SIZE         64
+
+// String indices
+#define USBDESC_STRING_LANGUAGE     0
+#define USBDESC_STRING_MANUFACTURER 1
+#define USBDESC_STRING_PRODUCT      2
+#define USBDESC_STRING_SERIAL       3
+#define USBDESC_STRING_KEYBOARD     4
+#define USBDESC_STRING_RAW          5
+#define USBDESC_STRING_CDC          6
+#define USBDESC_STRING_CONSUMER     7
+
+typedef enum {
+    USBDESC_FUNCTION_KEYBOARD = 0, // Boot protocol keyboard, interrupt IN
+    USBDESC_FUNCTION_RAW_HID,      // Vendor page 64 byte reports, interrupt IN and OUT
+    USBDESC_FUNCTION_CDC,          // ACM, notification IN plus bulk IN and OUT, two interfaces
+    USBDESC_FUNCTION_CONSUMER,     // Consumer control (volume, media keys), interrupt IN
+} UsbDescriptors_FunctionType;
+
+typedef struct {
+    UsbDescriptors_FunctionType type;
+    uint8_t poll_ms;      // Interrupt endpoints
+    uint8_t string_index; // Interface name, 0 for none
+} UsbDescriptors_Function;
+
+// What a function was given, endpoint addresses have bit 7 set for IN
+typedef struct {
+    uint8_t interface;
+    uint8_t ep_in;
+    uint8_t ep_out;    // 0 if none
+    uint8_t ep_notify; // CDC only
+    uint8_t instance;  // Nth function of its class (HID or CDC)
+} UsbDescriptors_Assigned;
+
+typedef struct {
+    uint8_t data[USBDESC_CONFIG_MAX_LENGTH];
+    uint16_t length;
+    uint8_t interface_count;
+    UsbDescriptors_Assigned assigned[USBDESC_MAX_FUNCTIONS];
+    uint8_t function_count;
+} UsbDescriptors_Configuration;
+
+extern const uint8_t UsbDescriptors_KeyboardReport[];
+extern const uint16_t UsbDescriptors_KeyboardReportLength;
+extern const uint8_t UsbDescriptors_RawReport[];
+extern const uint16_t UsbDescriptors_RawReportLength;
+extern const uint8_t UsbDescriptors_ConsumerReport[];
+extern const uint16_t UsbDescriptors_ConsumerReportLength;
+
+// 18 byte device descriptor, class defined per interface (IADs)
+void UsbDescriptors_BuildDevice(uint8_t *out, uint16_t vid, uint16_t pid, uint16_t bcd_device);
+
+// Returns the total length or -1 if the functions don't fit (endpoints or buffer)
+int UsbDescriptors_BuildConfiguration(UsbDescriptors_Configuration *config, const UsbDescriptors_Function *functions,
+                                      uint8_t count, uint16_t max_power_ma, bool remote_wakeup);
+
+// Report descriptor of a HID function
+const uint8_t *UsbDescriptors_HidReport(UsbDescriptors_FunctionType type, uint16_t *length);
+
+// UTF-16LE string descriptor from ASCII into <out> (2 + 2 * length bytes), returns its length
+uint8_t UsbDescriptors_BuildString(uint16_t *out, uint8_t capacity, const char *text);
+#endif
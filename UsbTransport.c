@@ -0,0 +1,130 @@
+/*
+ *
+ *  USB Endpoint Scheduling
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#include <string.h>
+#include "UsbTransport.h"
+
+void UsbTransport_Initialise(UsbTransport *usb, const UsbTransport_Hooks *hooks, void *context, HidReport *hid) {
+    memset(usb, 0, sizeof(UsbTransport));
+    usb->hooks = *hooks;
+    usb->context = context;
+    usb->hid = hid;
+    Telemetry_Initialise(&usb->telemetry);
+}
+
+void UsbTransport_SetRawHandler(UsbTransport *usb, UsbTransport_RawHandler handler, void *context) {
+    usb->raw_handler = handler;
+    usb->raw_context = context;
+}
+
+void UsbTransport_RawReceived(UsbTransport *usb, const uint8_t *request, uint32_t length) {
+    if (usb->raw_handler == NULL) {
+        return;
+    }
+    uint8_t padded[USBTRANSPORT_RAW_REPORT_SIZE] = {0};
+    memcpy(padded, request, length < sizeof(padded) ? length : sizeof(padded));
+    if (usb->raw_pending) {
+        usb->raw_overrun++;
+    }
+    memset(usb->raw_reply, 0, sizeof(usb->raw_reply));
+    usb->raw_handler(usb->raw_context, padded, usb->raw_reply);
+    usb->raw_pending = true;
+}
+
+uint32_t UsbTransport_Write(UsbTransport *usb, const void *data, uint32_t length, uint32_t now_us) {
+    return Telemetry_Write(&usb->telemetry, data, length, now_us);
+}
+
+static void UsbTransport_Keyboard(UsbTransport *usb) {
+    UsbTransport_Hooks *hooks = &usb->hooks;
+    HidKeyboardReport report;
+    uint16_t usage;
+    if (!hooks->mounted(usb->context)) {
+        while (HidReport_Take(usb->hid, &report, NULL)) {
+            usb->keyboard_dropped++;
+        }
+        while (HidReport_TakeConsumer(usb->hid, &usage)) {
+            usb->keyboard_dropped++;
+        }
+        return;
+    }
+    // A key press wakes a suspended host, the report follows once it has resumed
+    if (hooks->suspended(usb->context)) {
+        if (HidReport_Pending(usb->hid) && !usb->wakeup_requested) {
+            hooks->remote_wakeup(usb->context);
+            usb->wakeup_requested = true;
+            usb->wakeups++;
+        }
+        return;
+    }
+    usb->wakeup_requested = false;
+    // HidKeyboardReport is the boot report layout byte for byte. The endpoint can still
+    // refuse between ready and send (busy again, or the bus suspended), a dropped release
+    // would leave the key stuck on the host
+    if (hooks->ready(usb->context, USBTRANSPORT_KEYBOARD) && HidReport_Peek(usb->hid, &report, NULL)) {
+        if (hooks->send(usb->context, USBTRANSPORT_KEYBOARD, (const uint8_t *)&report, sizeof(report))) {
+            HidReport_Release(usb->hid);
+            usb->sent[USBTRANSPORT_KEYBOARD]++;
+        }
+        else {
+            usb->send_failed++;
+        }
+    }
+    // Consumer report is the usage, little endian
+    if (hooks->ready(usb->context, USBTRANSPORT_CONSUMER) && HidReport_PeekConsumer(usb->hid, &usage)) {
+        uint8_t data[2] = {usage & 0xFF, usage >> 8};
+        if (hooks->send(usb->context, USBTRANSPORT_CONSUMER, data, sizeof(data))) {
+            HidReport_ReleaseConsumer(usb->hid);
+            usb->sent[USBTRANSPORT_CONSUMER]++;
+        }
+        else {
+            usb->send_failed++;
+        }
+    }
+}
+
+static void UsbTransport_Raw(UsbTransport *usb) {
+    if (!usb->raw_pending || !usb->hooks.ready(usb->context, USBTRANSPORT_RAW)) {
+        return;
+    }
+    if (usb->hooks.send(usb->context, USBTRANSPORT_RAW, usb->raw_reply, sizeof(usb->raw_reply))) {
+        usb->raw_pending = false;
+        usb->sent[USBTRANSPORT_RAW]++;
+    }
+    else {
+        usb->send_failed++;
+    }
+}
+
+static void UsbTransport_Cdc(UsbTransport *usb, uint32_t now_us) {
+    uint8_t packet[TELEMETRY_PACKET_SIZE];
+    for (uint8_t i = 0; i < USBTRANSPORT_CDC_PACKETS_PER_POLL; i++) {
+        uint32_t space = usb->hooks.cdc_space(usb->context);
+        if (space < TELEMETRY_PACKET_SIZE && space < Telemetry_Pending(&usb->telemetry)) {
+            return; // Wait for room for a whole packet
+        }
+        uint32_t length = Telemetry_TakePacket(&usb->telemetry, packet, space, now_us);
+        if (length == 0) {
+            return;
+        }
+        usb->hooks.send(usb->context, USBTRANSPORT_CDC, packet, length);
+        usb->sent[USBTRANSPORT_CDC]++;
+    }
+}
+
+void UsbTransport_Poll(UsbTransport *usb, uint32_t now_us) {
+    UsbTransport_Keyboard(usb);
+    if (!usb->hooks.mounted(usb->context) || usb->hooks.suspended(usb->context)) {
+        return;
+    }
+    UsbTransport_Raw(usb);
+    UsbTransport_Cdc(usb, now_us);
+}
@@ -0,0 +1,86 @@
+/*
+ *
+ *  USB Endpoint Scheduling
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _USBTRANSPORT_H
+#define _USBTRANSPORT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "HidReport.h"
+#include "Telemetry.h"
+
+// What goes out on each poll, in order:
+//   1. Keyboard, the next queued report as soon as its endpoint is free
+//   2. Consumer control, likewise on its own endpoint
+//   3. Raw HID, the reply to the last request
+//   4. CDC, at most USBTRANSPORT_CDC_PACKETS_PER_POLL batched telemetry packets
+// Endpoints are separate so the host never queues a keyboard report behind bulk data,
+// and the CDC budget bounds how long a poll takes before the next keyboard check.
+// Reports are only released from HidReport once the endpoint has accepted them, so
+// a busy endpoint, or a send refused after all, leaves them queued for the next poll. With no host they are dropped, otherwise the
+// pipeline would back up behind them. Portable, the endpoints are supplied as hooks
+
+#define USBTRANSPORT_RAW_REPORT_SIZE        64
+#define USBTRANSPORT_CDC_PACKETS_PER_POLL   2
+
+typedef enum {
+    USBTRANSPORT_KEYBOARD = 0,
+    USBTRANSPORT_CONSUMER,
+    USBTRANSPORT_RAW,
+    USBTRANSPORT_CDC,
+    USBTRANSPORT_CHANNEL_COUNT,
+} UsbTransport_Channel;
+
+// Hooks, none may be NULL
+typedef struct {
+    bool (*mounted)(void *context);
+    bool (*suspended)(void *context);
+    void (*remote_wakeup)(void *context);
+    // Keyboard, consumer and raw HID, true if a report can be queued on the endpoint
+    bool (*ready)(void *context, UsbTransport_Channel channel);
+    bool (*send)(void *context, UsbTransport_Channel channel, const uint8_t *data, uint32_t length);
+    // CDC, bytes the IN FIFO can take
+    uint32_t (*cdc_space)(void *context);
+} UsbTransport_Hooks;
+
+// Builds the reply to a raw HID request in place
+typedef void (*UsbTransport_RawHandler)(void *context, const uint8_t *request, uint8_t *reply);
+
+typedef struct {
+    UsbTransport_Hooks hooks;
+    void *context;
+    HidReport *hid;
+    Telemetry telemetry;
+    UsbTransport_RawHandler raw_handler;
+    void *raw_context;
+    uint8_t raw_reply[USBTRANSPORT_RAW_REPORT_SIZE];
+    bool raw_pending;
+    bool wakeup_requested;      // Once per suspend
+    // Statistics
+    uint32_t sent[USBTRANSPORT_CHANNEL_COUNT];
+    uint32_t keyboard_dropped;   // Keyboard and consumer reports taken with no host
+    uint32_t send_failed;        // HID sends refused by a ready endpoint, retried next poll
+    uint32_t raw_overrun;        // Requests that replaced an unsent reply
+    uint32_t wakeups;
+} UsbTransport;
+
+void UsbTransport_Initialise(UsbTransport *usb, const UsbTransport_Hooks *hooks, void *context, HidReport *hid);
+void UsbTransport_SetRawHandler(UsbTransport *usb, UsbTransport_RawHandler handler, void *context);
+
+// From the raw HID OUT endpoint
+void UsbTransport_RawReceived(UsbTransport *usb, const uint8_t *request, uint32_t length);
+
+// Console and log output for the CDC channel, batched
+uint32_t UsbTransport_Write(UsbTransport *usb, const void *data, uint32_t length, uint32_t now_us);
+
+// One pass of the policy above
+void UsbTransport_Poll(UsbTransport *usb, uint32_t now_us);
+#endif
@@ -0,0 +1,143 @@
+/*
+ *
+ *  Display Widgets
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "Widgets.h"
+
+// Font_DrawChar clears the spacing after a glyph, so only whole advances that fit are drawn
+static void Widget_DrawText(SSD1306 *dev, const Font *font, const Compositor_Rect *rect, uint8_t line, const char *text) {
+    if ((line + 1) * font->pages > rect->pages) {
+        return;
+    }
+    int16_t x = rect->x;
+    int16_t end = rect->x + rect->width;
+    uint8_t page = rect->page + line * font->pages;
+    while (*text && x + Font_MeasureChar(font, *text) <= end) {
+        x += Font_DrawChar(dev, font, x, page, *text++);
+    }
+}
+
+void Widget_TextInitialise(Widget_Text *widget, const Font *font) {
+    memset(widget, 0, sizeof(Widget_Text));
+    widget->font = font;
+}
+
+bool Widget_SetText(Widget_Text *widget, const char *text) {
+    if (strncmp(widget->text, text, WIDGET_TEXT_MAX - 1) == 0) {
+        return false;
+    }
+    strncpy(widget->text, text, WIDGET_TEXT_MAX - 1);
+    widget->text[WIDGET_TEXT_MAX - 1] = '\0';
+    return true;
+}
+
+void Widget_RenderText(void *context, SSD1306 *dev, const Compositor_Rect *rect) {
+    Widget_Text *widget = (Widget_Text *)context;
+    Widget_DrawText(dev, widget->font, rect, 0, widget->text);
+}
+
+void Widget_LayerInitialise(Widget_Layer *widget, const Font *font, const char *const *names, uint8_t name_count) {
+    memset(widget, 0, sizeof(Widget_Layer));
+    widget->font = font;
+    widget->names = names;
+    widget->name_count = name_count;
+}
+
+bool Widget_SetLayer(Widget_Layer *widget, uint8_t layer) {
+    if (widget->layer == layer) {
+        return false;
+    }
+    widget->layer = layer;
+    return true;
+}
+
+void Widget_RenderLayer(void *context, SSD1306 *dev, const Compositor_Rect *rect) {
+    Widget_Layer *widget = (Widget_Layer *)context;
+    char text[WIDGET_TEXT_MAX];
+    if (widget->layer < widget->name_count) {
+        Widget_DrawText(dev, widget->font, rect, 0, widget->names[widget->layer]);
+        return;
+    }
+    snprintf(text, sizeof(text), "Layer %u", widget->layer);
+    Widget_DrawText(dev, widget->font, rect, 0, text);
+}
+
+void Widget_CountersInitialise(Widget_Counters *widget) {
+    memset(widget, 0, sizeof(Widget_Counters));
+}
+
+bool Widget_SetCounters(Widget_Counters *widget, uint32_t presses, uint16_t per_minute) {
+    if (widget->presses == presses && widget->per_minute == per_minute) {
+        return false;
+    }
+    widget->presses = presses;
+    widget->per_minute = per_minute;
+    return true;
+}
+
+void Widget_RenderCounters(void *context, SSD1306 *dev, const Compositor_Rect *rect) {
+    Widget_Counters *widget = (Widget_Counters *)context;
+    char text[WIDGET_TEXT_MAX];
+    snprintf(text, sizeof(text), "%lu keys", (unsigned long)widget->presses);
+    Widget_DrawText(dev, &Font_Small, rect, 0, text);
+    snprintf(text, sizeof(text), "%u/min", widget->per_minute);
+    Widget_DrawText(dev, &Font_Small, rect, 1, text);
+}
+
+void Widget_HeatInitialise(Widget_Heat *widget, uint8_t keys) {
+    memset(widget, 0, sizeof(Widget_Heat));
+    widget->keys = keys < WIDGET_HEAT_MAX_KEYS ? keys : WIDGET_HEAT_MAX_KEYS;
+}
+
+bool Widget_HeatPress(Widget_Heat *widget, uint8_t key) {
+    if (key >= widget->keys || widget->heat[key] == WIDGET_HEAT_MAX) {
+        return false;
+    }
+    widget->heat[key]++;
+    return true;
+}
+
+bool Widget_HeatDecay(Widget_Heat *widget) {
+    bool changed = false;
+    for (uint8_t i = 0; i < widget->keys; i++) {
+        if (widget->heat[i] > 0) {
+            widget->heat[i]--;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+// Bars grow up from the bottom row, a column gap between keys
+void Widget_RenderHeat(void *context, SSD1306 *dev, const Compositor_Rect *rect) {
+    Widget_Heat *widget = (Widget_Heat *)context;
+    if (widget->keys == 0) {
+        return;
+    }
+    uint8_t bar_width = rect->width / widget->keys;
+    uint16_t rows = rect->pages * SSD1306_PAGE_HEIGHT;
+    if (bar_width < 2) {
+        return;
+    }
+    for (uint8_t key = 0; key < widget->keys; key++) {
+        uint16_t height = (uint16_t)widget->heat[key] * rows / WIDGET_HEAT_MAX;
+        uint8_t x = rect->x + key * bar_width;
+        for (uint8_t i = 0; i < rect->pages && height > 0; i++) {
+            uint8_t page = rect->page + rect->pages - 1 - i;
+            uint8_t fill = height >= SSD1306_PAGE_HEIGHT ? SSD1306_PAGE_HEIGHT : height;
+            // Bit 0 is the top row of a page
+            uint8_t bits = (uint8_t)(0xFF << (SSD1306_PAGE_HEIGHT - fill));
+            memset(&dev->buffer[page * dev->width + x], bits, bar_width - 1);
+            height -= fill;
+        }
+    }
+}
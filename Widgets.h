@@ -0,0 +1,70 @@
+/*
+ *
+ *  Display Widgets
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+#ifndef _WIDGETS_H
+#define _WIDGETS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "Compositor.h"
+#include "Font.h"
+
+// Compositor widgets. The setters run on the input core and return true if anything
+// visible changed, for the caller to invalidate the widget. The render functions run on
+// the display core and clip to their rectangle, text is cut at the last whole glyph
+
+#define WIDGET_TEXT_MAX         24
+#define WIDGET_HEAT_MAX_KEYS    32
+#define WIDGET_HEAT_MAX         8 // Presses to fill a bar
+
+// One line of text, e.g. the last combo or host state
+typedef struct {
+    const Font *font;
+    char text[WIDGET_TEXT_MAX];
+} Widget_Text;
+
+// Active layer, by name if there is one
+typedef struct {
+    const Font *font;
+    const char *const *names;
+    uint8_t name_count;
+    uint8_t layer;
+} Widget_Layer;
+
+// Key presses since boot and over the last minute, two lines of Font_Small
+typedef struct {
+    uint32_t presses;
+    uint16_t per_minute;
+} Widget_Counters;
+
+// A bar per key, up a step per press and down a step per decay
+typedef struct {
+    uint8_t heat[WIDGET_HEAT_MAX_KEYS];
+    uint8_t keys;
+} Widget_Heat;
+
+void Widget_TextInitialise(Widget_Text *widget, const Font *font);
+bool Widget_SetText(Widget_Text *widget, const char *text);
+void Widget_RenderText(void *context, SSD1306 *dev, const Compositor_Rect *rect);
+
+void Widget_LayerInitialise(Widget_Layer *widget, const Font *font, const char *const *names, uint8_t name_count);
+bool Widget_SetLayer(Widget_Layer *widget, uint8_t layer);
+void Widget_RenderLayer(void *context, SSD1306 *dev, const Compositor_Rect *rect);
+
+void Widget_CountersInitialise(Widget_Counters *widget);
+bool Widget_SetCounters(Widget_Counters *widget, uint32_t presses, uint16_t per_minute);
+void Widget_RenderCounters(void *context, SSD1306 *dev, const Compositor_Rect *rect);
+
+void Widget_HeatInitialise(Widget_Heat *widget, uint8_t keys);
+bool Widget_HeatPress(Widget_Heat *widget, uint8_t key);
+bool Widget_HeatDecay(Widget_Heat *widget);
+void Widget_RenderHeat(void *context, SSD1306 *dev, const Compositor_Rect *rect);
+#endif
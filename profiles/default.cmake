@@ -0,0 +1,15 @@
+# Macropad as built: one MCP23017 on I2C, 128x32 display, SD card, rotary encoder
+set(PROFILE_SCAN EXPANDER)
+set(PROFILE_MATRIX_DIODES OFF)
+set(PROFILE_KEY_COUNT 16)
+set(PROFILE_EXPANDER_COUNT 1)
+set(PROFILE_TRANSPORT I2C)
+set(PROFILE_DISPLAY ON)
+set(PROFILE_SDCARD ON)
+set(PROFILE_ENCODER ON)
+set(PROFILE_KEYSTATS ON)
+set(PROFILE_USB ON)
+set(PROFILE_EDGE_CAPTURE ON)
+set(PROFILE_TRACE ON)
+set(PROFILE_INDICATOR_COUNT 0)
+set(PROFILE_LED_COUNT 0)
@@ -0,0 +1,16 @@
+# Second MCP23017 (0x21) for keys 16-19, shares the open drain INT line.
+# Its next two outputs (GPB4, GPB5) drive the layer and caps lock indicator LEDs
+set(PROFILE_SCAN EXPANDER)
+set(PROFILE_MATRIX_DIODES OFF)
+set(PROFILE_KEY_COUNT 20)
+set(PROFILE_EXPANDER_COUNT 2)
+set(PROFILE_TRANSPORT I2C)
+set(PROFILE_DISPLAY ON)
+set(PROFILE_SDCARD ON)
+set(PROFILE_ENCODER ON)
+set(PROFILE_KEYSTATS ON)
+set(PROFILE_USB ON)
+set(PROFILE_EDGE_CAPTURE ON)
+set(PROFILE_TRACE ON)
+set(PROFILE_INDICATOR_COUNT 2)
+set(PROFILE_LED_COUNT 0)
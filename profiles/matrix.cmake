@@ -0,0 +1,16 @@
+# 4x5 matrix on native pins (rows GPIO12-15, columns GPIO16-20) without diodes, scanned by PIO.
+# Columns take the spi0 pins, so no SD card
+set(PROFILE_SCAN MATRIX)
+set(PROFILE_MATRIX_DIODES OFF)
+set(PROFILE_KEY_COUNT 20)
+set(PROFILE_EXPANDER_COUNT 1)
+set(PROFILE_TRANSPORT I2C)
+set(PROFILE_DISPLAY ON)
+set(PROFILE_SDCARD OFF)
+set(PROFILE_ENCODER ON)
+set(PROFILE_KEYSTATS ON)
+set(PROFILE_USB ON)
+set(PROFILE_EDGE_CAPTURE OFF)
+set(PROFILE_TRACE ON)
+set(PROFILE_INDICATOR_COUNT 0)
+set(PROFILE_LED_COUNT 0)
@@ -0,0 +1,15 @@
+# Keys only: one MCP23017, no display, SD card, encoder or trace
+set(PROFILE_SCAN EXPANDER)
+set(PROFILE_MATRIX_DIODES OFF)
+set(PROFILE_KEY_COUNT 16)
+set(PROFILE_EXPANDER_COUNT 1)
+set(PROFILE_TRANSPORT I2C)
+set(PROFILE_DISPLAY OFF)
+set(PROFILE_SDCARD OFF)
+set(PROFILE_ENCODER OFF)
+set(PROFILE_KEYSTATS OFF)
+set(PROFILE_USB ON)
+set(PROFILE_EDGE_CAPTURE ON)
+set(PROFILE_TRACE OFF)
+set(PROFILE_INDICATOR_COUNT 0)
+set(PROFILE_LED_COUNT 0)
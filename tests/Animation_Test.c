@@ -0,0 +1,384 @@
+/*
+ *
+ *  Animation Player Tests
+ *
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *
+*/
+
+// The boot logo as tools/anim_convert.py writes it, decoded and checked pixel by pixel against
+// its PBM. Then generated animations encoded here, played from memory and from streams read
+// in awkward chunk sizes into a framebuffer at an offset, and flushed to the panel model
+// for the bus bytes each frame costs
+
+#include <stdlib.h>
+#include <string.h>
+#include "Test.h"
+#include "FakeSdk.h"
+#include "FakeSsd1306.h"
+#include "SSD1306.h"
+#include "Animation.h"
+
+#define STRIDE      128
+#define PAGES       8
+#define MAX_FRAMES  48
+#define MAX_ENCODED 65536
+
+extern const uint8_t Boot_Logo[];
+extern const uint32_t Boot_Logo_Length;
+
+// A stream over a byte array, each read returning at most <chunk> bytes
+typedef struct {
+    const uint8_t *data;
+    uint32_t length;
+    uint32_t position;
+    uint32_t chunk;
+    uint32_t reads;
+    uint32_t largest;   // Longest read asked for
+    int32_t fail_after; // Reads before an error, -1 for never
+} Source;
+
+static int32_t source_read(void *context, uint8_t *data, uint32_t length) {
+    Source *source = (Source *)context;
+    if (source->fail_after >= 0 && source->reads >= (uint32_t)source->fail_after) {
+        return -5;
+    }
+    source->reads++;
+    source->largest = length > source->largest ? length : source->largest;
+    uint32_t count = source->length - source->position;
+    count = count < length ? count : length;
+    count = count < source->chunk ? count : source->chunk;
+    memcpy(data, source->data + source->position, count);
+    source->position += count;
+    return count;
+}
+
+static int source_seek(void *context, uint32_t position) {
+    Source *source = (Source *)context;
+    if (position > source->length) {
+        return -1;
+    }
+    source->position = position;
+    return 0;
+}
+
+static Animation_Stream stream_over(Source *source, const uint8_t *data, uint32_t length, uint32_t chunk) {
+    memset(source, 0, sizeof(Source));
+    source->data = data;
+    source->length = length;
+    source->chunk = chunk;
+    source->fail_after = -1;
+    return (Animation_Stream){source, source_read, source_seek};
+}
+
+// Frames as page major column bytes, [frame][page][column]
+static uint8_t frames[MAX_FRAMES][PAGES][STRIDE];
+
+// Encoder for the format in Animation.h, packets as anim_convert.py chooses them
+static uint32_t rle(uint8_t *out, const uint8_t *data, uint8_t width) {
+    uint32_t length = 0;
+    uint8_t i = 0;
+    while (i < width) {
+        uint8_t run = 1;
+        while (i + run < width && data[i + run] == data[i] && run < 128) {
+            run++;
+        }
+        if (run >= 3) {
+            out[length++] = 0x80 | (run - 1);
+            out[length++] = data[i];
+            i += run;
+            continue;
+        }
+        // Literal up to the next run of 3 or 128 bytes
+        uint8_t start = i;
+        while (i < width && i - start < 128 && !(i + 2 < width && data[i] == data[i + 1] && data[i] == data[i + 2])) {
+            i++;
+        }
+        out[length++] = i - start - 1;
+        memcpy(&out[length], &data[start], i - start);
+        length += i - start;
+    }
+    return length;
+}
+
+static uint32_t encode(uint8_t *out, uint8_t width, uint8_t pages, uint16_t count, uint16_t period_ms, uint16_t keyframe) {
+    const uint8_t header[ANIMATION_HEADER_SIZE] = {'M', 'P', 'A', '1', width, pages, count & 0xFF, count >> 8, period_ms & 0xFF, period_ms >> 8, 0, 0};
+    memcpy(out, header, sizeof(header));
+    uint32_t length = sizeof(header);
+    for (uint16_t f = 0; f < count; f++) {
+        bool key = f == 0 || (keyframe && f % keyframe == 0);
+        uint32_t start = length;
+        out[length++] = key ? ANIMATION_FRAME_KEY : ANIMATION_FRAME_DELTA;
+        out[length++] = 0;
+        for (uint8_t p = 0; p < pages; p++) {
+            uint8_t page[STRIDE];
+            for (uint8_t x = 0; x < width; x++) {
+                page[x] = key ? frames[f][p][x] : frames[f][p][x] ^ frames[f - 1][p][x];
+            }
+            if (!key && memcmp(frames[f][p], frames[f - 1][p], width) == 0) {
+                continue;
+            }
+            out[start + 1] |= 1 << p;
+            length += rle(&out[length], page, width);
+        }
+    }
+    return length;
+}
+
+// A ball bouncing over a static border, with a noisy patch on some frames
+static void make_frames(uint8_t width, uint8_t pages, uint16_t count) {
+    memset(frames, 0, sizeof(frames));
+    for (uint16_t f = 0; f < count; f++) {
+        for (uint8_t p = 0; p < pages; p++) {
+            frames[f][p][0] = frames[f][p][width - 1] = 0xFF;
+        }
+        frames[f][0][width / 2] = 0x01;
+        uint8_t x = 2 + (f * 5) % (width - 8);
+        uint8_t y = (f * 3) % (pages * 8 - 4);
+        for (uint8_t dx = 0; dx < 4; dx++) {
+            for (uint8_t dy = 0; dy < 4; dy++) {
+                frames[f][(y + dy) / 8][x + dx] |= 1 << ((y + dy) % 8);
+            }
+        }
+        if (f % 7 == 3) {
+            for (uint8_t i = 0; i < width / 4; i++) {
+                frames[f][pages - 1][1 + i] ^= rand();
+            }
+        }
+    }
+}
+
+// Decodes every frame into a framebuffer at (x, page) and checks it, and that nothing around
+// the animation was touched
+static uint32_t play_and_check(Animation *anim, uint16_t count, uint8_t x, uint8_t page) {
+    static uint8_t framebuffer[PAGES * STRIDE];
+    memset(framebuffer, 0x5A, sizeof(framebuffer));
+    uint32_t wrong = 0;
+    for (uint16_t f = 0; f < count; f++) {
+        if (Animation_DecodeFrame(anim, framebuffer, STRIDE, PAGES, x, page) != ANIMATION_OK) {
+            return count + 1;
+        }
+        for (uint8_t p = 0; p < PAGES; p++) {
+            for (uint8_t c = 0; c < STRIDE; c++) {
+                bool in = p >= page && p < page + anim->pages && c >= x && c < x + anim->width;
+                uint8_t expected = in ? frames[f][p - page][c - x] : 0x5A;
+                wrong += framebuffer[p * STRIDE + c] != expected;
+            }
+        }
+    }
+    return wrong;
+}
+
+static bool read_pbm(const char *path, uint8_t *width, uint8_t *height, uint8_t *pixels) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return false;
+    }
+    char line[256];
+    unsigned w = 0, h = 0;
+    // P1, comments, size
+    while (fgets(line, sizeof(line), file) && (line[0] == '#' || line[0] == 'P' || sscanf(line, "%u %u", &w, &h) != 2)) {
+    }
+    uint32_t count = 0;
+    int c;
+    while ((c = fgetc(file)) != EOF && count < w * h) {
+        if (c == '#') {
+            while ((c = fgetc(file)) != EOF && c != '\n') {
+            }
+        }
+        else if (c == '0' || c == '1') {
+            pixels[count++] = c - '0';
+        }
+    }
+    fclose(file);
+    *width = w;
+    *height = h;
+    return count == w * h;
+}
+
+static void test_boot_logo(void) {
+    static uint8_t pixels[128 * 64];
+    static uint8_t framebuffer[PAGES * STRIDE];
+    uint8_t width = 0;
+    uint8_t height = 0;
+    TEST_CHECK(read_pbm(BOOT_LOGO_PBM, &width, &height, pixels));
+    Animation anim;
+    TEST_EQUAL(Animation_OpenMemory(&anim, Boot_Logo, Boot_Logo_Length), ANIMATION_OK);
+    TEST_EQUAL(anim.width, width);
+    TEST_EQUAL(anim.pages, (height + 7) / 8);
+    TEST_EQUAL(anim.frame_count, 1);
+    memset(framebuffer, 0xFF, sizeof(framebuffer));
+    TEST_EQUAL(Animation_DecodeFrame(&anim, framebuffer, STRIDE, PAGES, 0, 0), ANIMATION_OK);
+    // Every pixel where the PBM has it, bit 0 the top of a page
+    uint32_t wrong = 0;
+    for (uint8_t y = 0; y < height; y++) {
+        for (uint8_t x = 0; x < width; x++) {
+            wrong += ((framebuffer[(y / 8) * STRIDE + x] >> (y % 8)) & 1) != pixels[y * width + x];
+        }
+    }
+    TEST_EQUAL(wrong, 0);
+    TEST_EQUAL(ANIMATION_HEADER_SIZE + anim.last_frame_bytes, Boot_Logo_Length);
+    TEST_EQUAL(Animation_DecodeFrame(&anim, framebuffer, STRIDE, PAGES, 0, 0), ANIMATION_ERROR_END);
+}
+
+static void test_memory_and_stream(void) {
+    static uint8_t encoded[MAX_ENCODED];
+    srand(36);
+    const uint8_t widths[] = {128, 64, 13};
+    const uint8_t heights[] = {4, 2, 1};
+    const uint32_t chunks[] = {1, 7, 64, 1000};
+    for (uint8_t shape = 0; shape < 3; shape++) {
+        uint8_t width = widths[shape];
+        uint8_t pages = heights[shape];
+        make_frames(width, pages, MAX_FRAMES);
+        uint32_t length = encode(encoded, width, pages, MAX_FRAMES, 40, shape == 1 ? 10 : 0);
+        uint8_t x = STRIDE - width;
+        uint8_t page = PAGES - pages;
+
+        Animation anim;
+        TEST_EQUAL(Animation_OpenMemory(&anim, encoded, length), ANIMATION_OK);
+        TEST_EQUAL(anim.frame_period_ms, 40);
+        TEST_EQUAL(play_and_check(&anim, MAX_FRAMES, x, page), 0);
+        TEST_EQUAL(anim.position, length);
+        // Played out, then round again from the start
+        TEST_EQUAL(Animation_DecodeFrame(&anim, NULL, STRIDE, PAGES, x, page), ANIMATION_ERROR_END);
+        TEST_EQUAL(Animation_Rewind(&anim), ANIMATION_OK);
+        TEST_EQUAL(play_and_check(&anim, MAX_FRAMES, 0, 0), 0);
+
+        for (uint8_t i = 0; i < 4; i++) {
+            Source source;
+            Animation_Stream stream = stream_over(&source, encoded, length, chunks[i]);
+            TEST_EQUAL(Animation_OpenStream(&anim, &stream), ANIMATION_OK);
+            TEST_EQUAL(play_and_check(&anim, MAX_FRAMES, x, page), 0);
+            // Rewound part way through, with the rest of a read still buffered
+            TEST_EQUAL(Animation_Rewind(&anim), ANIMATION_OK);
+            TEST_EQUAL(play_and_check(&anim, 5, x / 2, 0), 0);
+            TEST_EQUAL(Animation_Rewind(&anim), ANIMATION_OK);
+            TEST_EQUAL(play_and_check(&anim, MAX_FRAMES, x / 2, 0), 0);
+            // Never asks for more than its buffer holds, however much the stream could give
+            TEST_EQUAL(source.largest, ANIMATION_STREAM_BUFFER);
+        }
+    }
+}
+
+static void test_errors(void) {
+    static uint8_t encoded[MAX_ENCODED];
+    static uint8_t framebuffer[PAGES * STRIDE];
+    make_frames(32, 2, 4);
+    uint32_t length = encode(encoded, 32, 2, 4, 100, 0);
+    Animation anim;
+
+    uint8_t bad[ANIMATION_HEADER_SIZE + 4];
+    memcpy(bad, encoded, sizeof(bad));
+    bad[3] = '2';
+    TEST_EQUAL(Animation_OpenMemory(&anim, bad, sizeof(bad)), ANIMATION_ERROR_FORMAT);
+    memcpy(bad, encoded, sizeof(bad));
+    bad[5] = ANIMATION_MAX_PAGES + 1;
+    TEST_EQUAL(Animation_OpenMemory(&anim, bad, sizeof(bad)), ANIMATION_ERROR_FORMAT);
+    bad[5] = 2;
+    bad[6] = 0;
+    TEST_EQUAL(Animation_OpenMemory(&anim, bad, sizeof(bad)), ANIMATION_ERROR_FORMAT);
+    TEST_EQUAL(Animation_OpenMemory(&anim, encoded, ANIMATION_HEADER_SIZE - 1), ANIMATION_ERROR_IO);
+
+    // Doesn't fit where it was asked to go
+    TEST_EQUAL(Animation_OpenMemory(&anim, encoded, length), ANIMATION_OK);
+    TEST_EQUAL(Animation_DecodeFrame(&anim, framebuffer, STRIDE, PAGES, STRIDE - 31, 0), ANIMATION_ERROR_FORMAT);
+    TEST_EQUAL(Animation_DecodeFrame(&anim, framebuffer, STRIDE, PAGES, 0, PAGES - 1), ANIMATION_ERROR_FORMAT);
+    TEST_EQUAL(anim.frame, 0);
+
+    // A first frame that isn't a key frame, or a frame type that doesn't exist
+    memcpy(bad, encoded, sizeof(bad));
+    bad[ANIMATION_HEADER_SIZE] = ANIMATION_FRAME_DELTA;
+    TEST_EQUAL(Animation_OpenMemory(&anim, bad, sizeof(bad)), ANIMATION_OK);
+    TEST_EQUAL(Animation_DecodeFrame(&anim, framebuffer, STRIDE, PAGES, 0, 0), ANIMATION_ERROR_FORMAT);
+    bad[ANIMATION_HEADER_SIZE] = 2;
+    TEST_EQUAL(Animation_OpenMemory(&anim, bad, sizeof(bad)), ANIMATION_OK);
+    TEST_EQUAL(Animation_DecodeFrame(&anim, framebuffer, STRIDE, PAGES, 0, 0), ANIMATION_ERROR_FORMAT);
+
+    // A packet running past the page width is refused, not written past it
+    static uint8_t overrun[ANIMATION_HEADER_SIZE + 8];
+    memcpy(overrun, encoded, ANIMATION_HEADER_SIZE);
+    const uint8_t frame[] = {ANIMATION_FRAME_KEY, 0x01, 0x80 | 30, 0xAA, 0x81, 0xBB};
+    memcpy(&overrun[ANIMATION_HEADER_SIZE], frame, sizeof(frame));
+    TEST_EQUAL(Animation_OpenMemory(&anim, overrun, ANIMATION_HEADER_SIZE + sizeof(frame)), ANIMATION_OK);
+    memset(framebuffer, 0, sizeof(framebuffer));
+    TEST_EQUAL(Animation_DecodeFrame(&anim, framebuffer, STRIDE, PAGES, 0, 0), ANIMATION_ERROR_FORMAT);
+    TEST_EQUAL(framebuffer[30], 0xAA);
+    TEST_EQUAL(framebuffer[31], 0);
+
+    // Cut short, in memory and on a stream, and a stream that fails part way
+    TEST_EQUAL(Animation_OpenMemory(&anim, encoded, length - 1), ANIMATION_OK);
+    int result = ANIMATION_OK;
+    for (uint8_t f = 0; f < 4 && result == ANIMATION_OK; f++) {
+        result = Animation_DecodeFrame(&anim, framebuffer, STRIDE, PAGES, 0, 0);
+    }
+    TEST_EQUAL(result, ANIMATION_ERROR_IO);
+    TEST_EQUAL(anim.frame, 3);
+    Source source;
+    Animation_Stream stream = stream_over(&source, encoded, length - 1, 5);
+    TEST_EQUAL(Animation_OpenStream(&anim, &stream), ANIMATION_OK);
+    result = ANIMATION_OK;
+    for (uint8_t f = 0; f < 4 && result == ANIMATION_OK; f++) {
+        result = Animation_DecodeFrame(&anim, framebuffer, STRIDE, PAGES, 0, 0);
+    }
+    TEST_EQUAL(result, ANIMATION_ERROR_IO);
+    stream = stream_over(&source, encoded, length, 5);
+    TEST_EQUAL(Animation_OpenStream(&anim, &stream), ANIMATION_OK);
+    source.fail_after = source.reads + 1;
+    TEST_EQUAL(Animation_DecodeFrame(&anim, framebuffer, STRIDE, PAGES, 0, 0), ANIMATION_ERROR_IO);
+}
+
+static void bench_playback(void) {
+    static uint8_t encoded[MAX_ENCODED];
+    static I2CBus bus;
+    static FakeSsd1306 panel;
+    static SSD1306 dev;
+    // Full width 128x32, as the boot animation on the firmware's panel
+    srand(136);
+    make_frames(128, 4, MAX_FRAMES);
+    uint32_t length = encode(encoded, 128, 4, MAX_FRAMES, 40, 0);
+    static Animation anim;
+    Animation_OpenMemory(&anim, encoded, length);
+    static uint8_t framebuffer[PAGES * STRIDE];
+    TEST_BENCH("decode frame, flash", 200000,
+               (void)(Animation_DecodeFrame(&anim, framebuffer, STRIDE, PAGES, 0, 0) == ANIMATION_ERROR_END && Animation_Rewind(&anim)));
+    static Source source;
+    static Animation_Stream stream;
+    stream = stream_over(&source, encoded, length, ANIMATION_STREAM_BUFFER);
+    Animation_OpenStream(&anim, &stream);
+    TEST_BENCH("decode frame, stream", 200000,
+               (void)(Animation_DecodeFrame(&anim, framebuffer, STRIDE, PAGES, 0, 0) == ANIMATION_ERROR_END && Animation_Rewind(&anim)));
+
+    // Bus bytes per frame with the page flushes, the panel showing each frame exactly
+    FakeSdk_Reset();
+    FakeSsd1306_Initialise(&panel, SSD1306_I2C_ADDRESS);
+    FakeSsd1306_AttachI2C(&panel);
+    I2CBus_Initialise(&bus, i2c0);
+    I2CBus_Discover(&bus);
+    memset(&dev, 0, sizeof(dev));
+    SSD1306_Initialise(&dev, I2CBus_Find(&bus, I2CBUS_DEVICE_SSD1306, 0), 32, 128);
+    SSD1306_DisplayInit(&dev);
+    Animation_OpenMemory(&anim, encoded, length);
+    uint32_t bytes = 0;
+    uint32_t wrong = 0;
+    for (uint16_t f = 0; f < MAX_FRAMES; f++) {
+        Animation_DecodeFrame(&anim, dev.buffer, dev.width, dev.pages, 0, 0);
+        for (uint8_t page = 0; page < dev.pages; page++) {
+            bytes += SSD1306_FlushRegion(&dev, 0, dev.width, page, 1);
+        }
+        wrong += memcmp(panel.gddram, frames[f], 4 * 128) != 0;
+    }
+    TEST_EQUAL(wrong, 0);
+    printf("bench %-32s %5u encoded, %u bus bytes per frame\n", "128x32 animation", (length - ANIMATION_HEADER_SIZE) / MAX_FRAMES, bytes / MAX_FRAMES);
+}
+
+int main(void) {
+    TEST_RUN(test_boot_logo);
+    TEST_RUN(test_memory_and_stream);
+    TEST_RUN(test_errors);
+    bench_playback();
+    return TEST_RESULT();
+}
@@ -0,0 +1,363 @@
+/*
+ *
+ *  Combo Engine Tests
+ *
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *
+*/
+
+// The default combos by hand, then generated traces: chords of random keys pressed in
+// random order with random gaps, some past the window, over the default table and a
+// generated one of 200 combos. The presses that come out are checked against a reference
+// of the matching rules, and every press that comes out must be released exactly once
+
+#include <stdlib.h>
+#include <string.h>
+#include "Test.h"
+#include "Combo.h"
+#include "Layout.h"
+
+#define WINDOW_US       COMBO_DEFAULT_WINDOW_US
+#define TRACE_KEYS      20 // 16-19 are never in a combo
+#define MAX_CHORD       5
+#define TOKEN_COMBO     0x10000
+#define MAX_OUTPUT      64
+
+static KeyPipeline pipe;
+static Combo engine;
+static int consumer;
+static uint32_t now_us;
+
+// What came out of the stage, one token per event that wasn't consumed: the key for a
+// plain event, TOKEN_COMBO | keycode for a combo
+typedef struct {
+    uint32_t token;
+    uint8_t edge;
+} Output;
+
+static Output output[MAX_OUTPUT];
+static uint8_t output_count;
+
+static void setup(const Combo_Definition *combos, uint16_t count) {
+    KeyPipeline_Initialise(&pipe);
+    TEST_EQUAL(Combo_Initialise(&engine, combos, count, WINDOW_US), 0);
+    Combo_Attach(&engine, &pipe, KeyPipeline_AddStage(&pipe, Combo_Stage, &engine));
+    consumer = KeyPipeline_AddConsumer(&pipe);
+    output_count = 0;
+    now_us = 1000000;
+}
+
+static void collect(void) {
+    KeyEvent *event;
+    while ((event = KeyPipeline_Peek(&pipe, consumer)) != NULL) {
+        if (!(event->flags & KEYEVENT_FLAG_CONSUMED) && output_count < MAX_OUTPUT) {
+            bool combo = event->flags & KEYEVENT_FLAG_SYNTHETIC;
+            output[output_count].token = combo ? TOKEN_COMBO | event->keycode : event->key;
+            output[output_count].edge = event->edge;
+            output_count++;
+        }
+        KeyPipeline_Release(&pipe, consumer);
+    }
+}
+
+// As the scan task does: the event, the time, then the pipeline
+static void key(uint8_t k, uint8_t edge, uint32_t after_us) {
+    now_us += after_us;
+    KeyPipeline_Push(&pipe, k, edge, 0, now_us);
+    Combo_SetTime(&engine, now_us);
+    KeyPipeline_Run(&pipe);
+    collect();
+}
+
+static void wait(uint32_t us) {
+    now_us += us;
+    Combo_SetTime(&engine, now_us);
+    KeyPipeline_Run(&pipe);
+    collect();
+}
+
+// <expected> as made by PRESS and RELEASE below
+static bool output_is(const uint32_t *expected, uint8_t count) {
+    bool same = output_count == count;
+    for (uint8_t i = 0; same && i < count; i++) {
+        uint8_t edge = (expected[i] >> 24) ? KEYEVENT_PRESS : KEYEVENT_RELEASE;
+        same = output[i].token == (expected[i] & 0xFFFFFF) && output[i].edge == edge;
+    }
+    if (!same) {
+        fprintf(stderr, "  output:");
+        for (uint8_t i = 0; i < output_count; i++) {
+            fprintf(stderr, " %s%x", output[i].edge ? "+" : "-", (unsigned)output[i].token);
+        }
+        fprintf(stderr, "\n");
+    }
+    output_count = 0;
+    return same;
+}
+
+#define OUTPUT_IS(...) do { \
+        const uint32_t expected[] = {__VA_ARGS__}; \
+        TEST_CHECK(output_is(expected, sizeof(expected) / sizeof(expected[0]))); \
+    } while (0)
+
+// Tokens for OUTPUT_IS
+#define PRESS(token)    ((1u << 24) | (token))
+#define RELEASE(token)  (token)
+#define COMBO(keycode)  (TOKEN_COMBO | (keycode))
+
+#define KC_ESCAPE       0x29
+#define KC_BACKSPACE    0x2A
+#define KC_DELETE       0x4C
+
+static void test_default_combos(void) {
+    setup(Layout_DefaultCombos, Layout_DefaultComboCount);
+    // 0+1 could still become 0+1+2, so escape waits for the window
+    key(0, KEYEVENT_PRESS, 0);
+    key(1, KEYEVENT_PRESS, 10000);
+    TEST_EQUAL(output_count, 0);
+    wait(WINDOW_US);
+    OUTPUT_IS(PRESS(COMBO(KC_ESCAPE)));
+    // Released with the first member
+    key(1, KEYEVENT_RELEASE, 100000);
+    OUTPUT_IS(RELEASE(COMBO(KC_ESCAPE)));
+    key(0, KEYEVENT_RELEASE, 10000);
+    TEST_EQUAL(output_count, 0);
+
+    // 2+3 can't grow, fires on the second press
+    key(3, KEYEVENT_PRESS, 100000);
+    key(2, KEYEVENT_PRESS, 5000);
+    OUTPUT_IS(PRESS(COMBO(KC_BACKSPACE)));
+    key(2, KEYEVENT_RELEASE, 100000);
+    key(3, KEYEVENT_RELEASE, 100000);
+    OUTPUT_IS(RELEASE(COMBO(KC_BACKSPACE)));
+
+    // Longest match, held until the last member is up
+    key(2, KEYEVENT_PRESS, 100000);
+    key(0, KEYEVENT_PRESS, 1000);
+    key(1, KEYEVENT_PRESS, 1000);
+    OUTPUT_IS(PRESS(COMBO(KC_DELETE)));
+    key(0, KEYEVENT_RELEASE, 100000);
+    key(2, KEYEVENT_RELEASE, 1000);
+    TEST_EQUAL(output_count, 0);
+    key(1, KEYEVENT_RELEASE, 1000);
+    OUTPUT_IS(RELEASE(COMBO(KC_DELETE)));
+
+    // Too slow, both plain, the first is held for the whole window
+    key(0, KEYEVENT_PRESS, 100000);
+    key(1, KEYEVENT_PRESS, WINDOW_US + 1);
+    OUTPUT_IS(PRESS(0));
+    wait(WINDOW_US + 1);
+    OUTPUT_IS(PRESS(1));
+    key(0, KEYEVENT_RELEASE, 1000);
+    key(1, KEYEVENT_RELEASE, 1000);
+    OUTPUT_IS(RELEASE(0), RELEASE(1));
+
+    // A key outside every combo ends the chord and never waits
+    key(0, KEYEVENT_PRESS, 100000);
+    key(7, KEYEVENT_PRESS, 1000);
+    OUTPUT_IS(PRESS(0), PRESS(7));
+    key(7, KEYEVENT_RELEASE, 1000);
+    key(0, KEYEVENT_RELEASE, 1000);
+    OUTPUT_IS(RELEASE(7), RELEASE(0));
+    // A release ends it too
+    key(0, KEYEVENT_PRESS, 100000);
+    key(0, KEYEVENT_RELEASE, 1000);
+    OUTPUT_IS(PRESS(0), RELEASE(0));
+
+    TEST_EQUAL(engine.fired, 3);
+    TEST_EQUAL(engine.timeouts, 2);
+}
+
+static void test_invalid_tables(void) {
+    const Combo_Definition single[] = {{1 << 3, 0x04, COMBO_RELEASE_ANY}};
+    const Combo_Definition duplicate[] = {{3, 0x04, COMBO_RELEASE_ANY}, {3, 0x05, COMBO_RELEASE_ALL}};
+    TEST_EQUAL(Combo_Initialise(&engine, single, 1, WINDOW_US), 1);
+    TEST_EQUAL(Combo_Initialise(&engine, duplicate, 2, WINDOW_US), 1);
+    TEST_EQUAL(Combo_Initialise(&engine, Layout_DefaultCombos, COMBO_MAX + 1, WINDOW_US), 1);
+    TEST_EQUAL(Combo_Initialise(&engine, NULL, 0, WINDOW_US), 0);
+    TEST_EQUAL(Combo_Lookup(&engine, 3), -1);
+}
+
+static Combo_Definition generated[COMBO_MAX];
+
+// Unique key sets of 2-5 keys over 0-15, keycodes 0x100 + index so each is recognisable
+static uint16_t generate_combos(uint16_t count) {
+    uint16_t made = 0;
+    while (made < count) {
+        uint32_t keys = 0;
+        uint8_t size = 2 + rand() % 4;
+        while (__builtin_popcount(keys) < size) {
+            keys |= 1u << (rand() % 16);
+        }
+        bool duplicate = false;
+        for (uint16_t i = 0; i < made; i++) {
+            duplicate |= generated[i].keys == keys;
+        }
+        if (duplicate) {
+            continue;
+        }
+        generated[made].keys = keys;
+        generated[made].keycode = 0x100 + made;
+        generated[made].release_rule = rand() % 2 ? COMBO_RELEASE_ALL : COMBO_RELEASE_ANY;
+        made++;
+    }
+    return made;
+}
+
+// The presses the rules call for, for distinct keys <keys> pressed at <times> with
+// nothing held. From each key in a combo, later presses extend the chord while some combo
+// still contains all of them and they're inside the window from its first press. The
+// longest exact match wins and its members are used up, otherwise the key goes out alone
+static uint8_t reference_presses(const Combo_Definition *combos, uint16_t combo_count, const uint8_t *keys, const uint32_t *times, uint8_t count, uint32_t *tokens) {
+    uint32_t combo_keys = 0;
+    for (uint16_t c = 0; c < combo_count; c++) {
+        combo_keys |= combos[c].keys;
+    }
+    uint8_t out = 0;
+    uint8_t i = 0;
+    while (i < count) {
+        if (!(combo_keys & (1u << keys[i]))) {
+            tokens[out++] = keys[i++];
+            continue;
+        }
+        uint32_t pending = 1u << keys[i];
+        int16_t best = -1;
+        uint8_t best_members = 0;
+        for (uint8_t j = i + 1; j < count; j++) {
+            uint32_t bit = 1u << keys[j];
+            if (times[j] - times[i] > WINDOW_US || !(combo_keys & bit)) {
+                break;
+            }
+            bool any = false;
+            for (uint16_t c = 0; c < combo_count; c++) {
+                any |= (combos[c].keys & (pending | bit)) == (pending | bit);
+            }
+            if (!any) {
+                break;
+            }
+            pending |= bit;
+            for (uint16_t c = 0; c < combo_count; c++) {
+                if (combos[c].keys == pending) {
+                    best = c;
+                    best_members = j - i;
+                }
+            }
+        }
+        if (best >= 0) {
+            tokens[out++] = TOKEN_COMBO | combos[best].keycode;
+            i += 1 + best_members;
+        }
+        else {
+            tokens[out++] = keys[i++];
+        }
+    }
+    return out;
+}
+
+// Runs <chords> generated chords and returns how many fired at least one combo
+static uint32_t run_generated(const Combo_Definition *combos, uint16_t combo_count, uint32_t chords) {
+    uint32_t with_combo = 0;
+    for (uint32_t chord = 0; chord < chords; chord++) {
+        uint8_t keys[MAX_CHORD];
+        uint32_t times[MAX_CHORD];
+        uint8_t count = 1 + rand() % MAX_CHORD;
+        uint32_t used = 0;
+        for (uint8_t i = 0; i < count; i++) {
+            do {
+                keys[i] = rand() % TRACE_KEYS;
+            } while (used & (1u << keys[i]));
+            used |= 1u << keys[i];
+        }
+
+        // Presses mostly inside the window, one in eight gaps past it
+        output_count = 0;
+        for (uint8_t i = 0; i < count; i++) {
+            uint32_t gap = i == 0 ? 200000 : (rand() % 8 ? rand() % 20000 : WINDOW_US + rand() % 20000);
+            key(keys[i], KEYEVENT_PRESS, gap);
+            times[i] = now_us;
+        }
+        wait(WINDOW_US + 1);
+
+        uint32_t expected[MAX_CHORD];
+        uint8_t expected_count = reference_presses(combos, combo_count, keys, times, count, expected);
+        bool same = output_count == expected_count;
+        for (uint8_t i = 0; same && i < expected_count; i++) {
+            same = output[i].token == expected[i] && output[i].edge == KEYEVENT_PRESS;
+        }
+        TEST_CHECK(same);
+        if (!same) {
+            fprintf(stderr, "  chord");
+            for (uint8_t i = 0; i < count; i++) {
+                fprintf(stderr, " %u@%u", keys[i], (unsigned)(times[i] - times[0]));
+            }
+            fprintf(stderr, ": %u presses out, expected %u\n", output_count, expected_count);
+            return with_combo;
+        }
+        for (uint8_t i = 0; i < expected_count; i++) {
+            with_combo += (expected[i] & TOKEN_COMBO) && i == 0;
+        }
+
+        // Released in random order: every press that came out is released once, nothing else
+        for (uint8_t i = count; i > 1; i--) {
+            uint8_t j = rand() % i;
+            uint8_t swap = keys[i - 1];
+            keys[i - 1] = keys[j];
+            keys[j] = swap;
+        }
+        for (uint8_t i = 0; i < count; i++) {
+            key(keys[i], KEYEVENT_RELEASE, rand() % 30000);
+        }
+        for (uint8_t i = 0; i < expected_count; i++) {
+            uint8_t releases = 0;
+            for (uint8_t j = expected_count; j < output_count; j++) {
+                releases += output[j].token == expected[i] && output[j].edge == KEYEVENT_RELEASE;
+            }
+            TEST_EQUAL(releases, 1);
+        }
+        TEST_EQUAL(output_count, 2 * expected_count);
+        TEST_EQUAL(engine.active_keys, 0);
+    }
+    return with_combo;
+}
+
+static void test_generated_traces(void) {
+    srand(33);
+    setup(Layout_DefaultCombos, Layout_DefaultComboCount);
+    uint32_t fired = run_generated(Layout_DefaultCombos, Layout_DefaultComboCount, 5000);
+    printf("      default table: %u of 5000 chords started with a combo\n", (unsigned)fired);
+
+    uint16_t count = generate_combos(200);
+    setup(generated, count);
+    fired = run_generated(generated, count, 5000);
+    printf("      200 combos: %u of 5000 chords started with a combo\n", (unsigned)fired);
+    TEST_EQUAL(pipe.overflows, 0);
+}
+
+static void bench_lookup(void) {
+    // A chord on keys outside the generated table's first few combos, timed per event, to
+    // show the cost doesn't follow the table size
+    const uint32_t events = 200000;
+    srand(3300);
+    uint16_t sizes[] = {3, COMBO_MAX};
+    for (uint8_t s = 0; s < 2; s++) {
+        uint16_t count = s ? generate_combos(sizes[s]) : Layout_DefaultComboCount;
+        setup(s ? generated : Layout_DefaultCombos, count);
+        char label[40];
+        snprintf(label, sizeof(label), "%u combos, per event", count);
+        TEST_BENCH(label, events, {
+            uint8_t k = (test_i / 2) % 4;
+            key(k, (test_i & 1) ? KEYEVENT_RELEASE : KEYEVENT_PRESS, 30000);
+        });
+        output_count = 0;
+    }
+}
+
+int main(void) {
+    TEST_RUN(test_default_combos);
+    TEST_RUN(test_invalid_tables);
+    TEST_RUN(test_generated_traces);
+    bench_lookup();
+    return TEST_RESULT();
+}
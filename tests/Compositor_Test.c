@@ -0,0 +1,394 @@
+/*
+ *
+ *  Display Compositor Tests
+ *
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *
+*/
+
+// The firmware's widget layout on a 128x32 panel, every flush recorded and read back by the
+// panel model: a frame sends only the invalid rectangles, never touches the others, is
+// capped at one per frame period, and an incremental frame matches a full redraw
+
+#include <stdlib.h>
+#include <string.h>
+#include "Test.h"
+#include "FakeSdk.h"
+#include "FakeSsd1306.h"
+#include "SSD1306.h"
+#include "Compositor.h"
+#include "Widgets.h"
+
+#define WIDTH       128
+#define HEIGHT      32
+#define PAGES       (HEIGHT / SSD1306_PAGE_HEIGHT)
+#define FRAME_US    COMPOSITOR_DEFAULT_FRAME_US
+#define KEYS        16
+
+static I2CBus bus;
+static FakeSsd1306 panel;
+static SSD1306 dev;
+static Compositor comp;
+
+static Widget_Layer layer_widget;
+static Widget_Counters counters_widget;
+static Widget_Text status_widget;
+static Widget_Heat heat_widget;
+
+// As Macropad.c
+static const Compositor_Rect layer_rect = {0, 80, 0, 2};
+static const Compositor_Rect counters_rect = {80, 48, 0, 2};
+static const Compositor_Rect status_rect = {0, WIDTH, 2, 1};
+static const Compositor_Rect heat_rect = {0, WIDTH, 3, 1};
+static int layer_id, counters_id, status_id, heat_id;
+
+static void setup(void) {
+    FakeSdk_Reset();
+    FakeSsd1306_Initialise(&panel, SSD1306_I2C_ADDRESS);
+    FakeSsd1306_AttachI2C(&panel);
+    I2CBus_Initialise(&bus, i2c0);
+    I2CBus_Discover(&bus);
+    memset(&dev, 0, sizeof(dev));
+    SSD1306_Initialise(&dev, I2CBus_Find(&bus, I2CBUS_DEVICE_SSD1306, 0), HEIGHT, WIDTH);
+    SSD1306_DisplayInit(&dev);
+    SSD1306_Show(&dev);
+
+    Compositor_Initialise(&comp, &dev, FRAME_US);
+    Widget_LayerInitialise(&layer_widget, &Font_Medium, NULL, 0);
+    Widget_CountersInitialise(&counters_widget);
+    Widget_TextInitialise(&status_widget, &Font_Small);
+    Widget_SetText(&status_widget, "default");
+    Widget_HeatInitialise(&heat_widget, KEYS);
+    layer_id = Compositor_AddWidget(&comp, &layer_rect, Widget_RenderLayer, &layer_widget);
+    counters_id = Compositor_AddWidget(&comp, &counters_rect, Widget_RenderCounters, &counters_widget);
+    status_id = Compositor_AddWidget(&comp, &status_rect, Widget_RenderText, &status_widget);
+    heat_id = Compositor_AddWidget(&comp, &heat_rect, Widget_RenderHeat, &heat_widget);
+    Fake_ClearLog();
+}
+
+// Bytes on the bus since the last clear, each transfer's address byte included
+static uint32_t bus_bytes(void) {
+    uint32_t bytes = 0;
+    for (uint32_t i = 0; i < Fake_TransferCount(); i++) {
+        bytes += Fake_GetTransfer(i)->length + 1;
+    }
+    return bytes;
+}
+
+static bool panel_matches(void) {
+    return memcmp(panel.gddram, dev.buffer, PAGES * WIDTH) == 0;
+}
+
+static bool inside(const Compositor_Rect *rect, uint8_t column, uint8_t page) {
+    return column >= rect->x && column < rect->x + rect->width && page >= rect->page && page < rect->page + rect->pages;
+}
+
+// Panel bytes that changed outside <rect> since <before>
+static uint32_t changed_outside(const uint8_t *before, const Compositor_Rect *rect) {
+    uint32_t changed = 0;
+    for (uint8_t page = 0; page < PAGES; page++) {
+        for (uint8_t column = 0; column < WIDTH; column++) {
+            changed += !inside(rect, column, page) && panel.gddram[page * WIDTH + column] != before[page * WIDTH + column];
+        }
+    }
+    return changed;
+}
+
+static void test_add_widget(void) {
+    setup();
+    TEST_EQUAL(layer_id, 0);
+    TEST_EQUAL(heat_id, 3);
+    // Off the panel, empty, or on top of another widget
+    const Compositor_Rect off_right = {100, 29, 4, 1};
+    const Compositor_Rect off_bottom = {0, 8, 4, 1};
+    const Compositor_Rect empty = {0, 0, 4, 1};
+    const Compositor_Rect overlap = {79, 2, 1, 1};
+    TEST_EQUAL(Compositor_AddWidget(&comp, &off_right, Widget_RenderText, &status_widget), -1);
+    TEST_EQUAL(Compositor_AddWidget(&comp, &off_bottom, Widget_RenderText, &status_widget), -1);
+    TEST_EQUAL(Compositor_AddWidget(&comp, &empty, Widget_RenderText, &status_widget), -1);
+    TEST_EQUAL(Compositor_AddWidget(&comp, &overlap, Widget_RenderText, &status_widget), -1);
+    // Nothing pending until enabled
+    TEST_CHECK(!Compositor_Pending(&comp));
+    TEST_EQUAL(Compositor_Update(&comp, 0), 0);
+    TEST_EQUAL(Fake_TransferCount(), 0);
+}
+
+static void test_first_frame(void) {
+    setup();
+    Compositor_SetEnabled(&comp, true);
+    TEST_CHECK(Compositor_Pending(&comp));
+    uint32_t bytes = Compositor_Update(&comp, 1000);
+    TEST_CHECK(bytes > 0);
+    TEST_EQUAL(bytes, bus_bytes());
+    TEST_CHECK(panel_matches());
+    TEST_EQUAL(panel.malformed, 0);
+    TEST_EQUAL(comp.frames, 1);
+    TEST_EQUAL(comp.regions, 4);
+    TEST_CHECK(!Compositor_Pending(&comp));
+    // Something was drawn in each widget
+    uint32_t lit[4] = {0};
+    const Compositor_Rect *rects[4] = {&layer_rect, &counters_rect, &status_rect, &heat_rect};
+    for (uint8_t page = 0; page < PAGES; page++) {
+        for (uint8_t column = 0; column < WIDTH; column++) {
+            for (uint8_t i = 0; i < 4; i++) {
+                lit[i] += inside(rects[i], column, page) && panel.gddram[page * WIDTH + column] != 0;
+            }
+        }
+    }
+    TEST_CHECK(lit[0] > 0 && lit[1] > 0 && lit[2] > 0);
+    // No key pressed yet, the heat strip is dark
+    TEST_EQUAL(lit[3], 0);
+}
+
+static void test_only_invalid_regions(void) {
+    static uint8_t before[PAGES * WIDTH];
+    setup();
+    Compositor_SetEnabled(&comp, true);
+    Compositor_Update(&comp, 0);
+
+    // A stray byte in the status row, which is not invalid, must not go out with the counters
+    dev.buffer[status_rect.page * WIDTH + 3] ^= 0xFF;
+    memcpy(before, panel.gddram, sizeof(before));
+    Fake_ClearLog();
+    TEST_CHECK(Widget_SetCounters(&counters_widget, 1234, 56));
+    Compositor_Invalidate(&comp, counters_id);
+    uint32_t bytes = Compositor_Update(&comp, FRAME_US);
+    TEST_CHECK(bytes > 0);
+    TEST_EQUAL(bytes, bus_bytes());
+    TEST_EQUAL(changed_outside(before, &counters_rect), 0);
+    TEST_EQUAL(memcmp(before, panel.gddram, sizeof(before)) != 0, 1);
+    // Bounded by the rectangle, not the screen
+    TEST_CHECK(bytes <= counters_rect.pages * (SSD1306_MAX_RUNS_PER_PAGE * SSD1306_RUN_OVERHEAD_BYTES + counters_rect.width));
+    TEST_EQUAL(comp.regions, 5);
+
+    // Same value again: nothing visible changed, nothing to do
+    TEST_CHECK(!Widget_SetCounters(&counters_widget, 1234, 56));
+    TEST_CHECK(!Compositor_Pending(&comp));
+
+    // The stray byte goes once its widget is redrawn, and is cleared back to the text
+    Compositor_Invalidate(&comp, status_id);
+    Compositor_Update(&comp, 2 * FRAME_US);
+    TEST_CHECK(panel_matches());
+    TEST_EQUAL(panel.gddram[status_rect.page * WIDTH + 3], before[status_rect.page * WIDTH + 3]);
+
+    // Ids that don't exist are ignored
+    Compositor_Invalidate(&comp, -1);
+    Compositor_Invalidate(&comp, COMPOSITOR_MAX_WIDGETS);
+    TEST_CHECK(!Compositor_Pending(&comp));
+}
+
+static void test_frame_cap(void) {
+    setup();
+    Compositor_SetEnabled(&comp, true);
+    Compositor_Update(&comp, 100000);
+    Widget_HeatPress(&heat_widget, 0);
+    Compositor_Invalidate(&comp, heat_id);
+    Fake_ClearLog();
+    // Too soon, the change waits for the next frame
+    TEST_EQUAL(Compositor_WaitUs(&comp, 100000 + 10000), FRAME_US - 10000);
+    TEST_EQUAL(Compositor_Update(&comp, 100000 + 10000), 0);
+    TEST_EQUAL(Fake_TransferCount(), 0);
+    TEST_CHECK(Compositor_Pending(&comp));
+    // Further changes inside the period are folded into that frame
+    Widget_HeatPress(&heat_widget, 0);
+    Widget_HeatPress(&heat_widget, 5);
+    TEST_EQUAL(Compositor_WaitUs(&comp, 100000 + FRAME_US), 0);
+    TEST_CHECK(Compositor_Update(&comp, 100000 + FRAME_US) > 0);
+    TEST_EQUAL(comp.frames, 2);
+    TEST_CHECK(panel_matches());
+    // Two of eight steps on a one page bar, the bottom two rows of key 0's columns
+    uint8_t bar = WIDTH / KEYS;
+    TEST_EQUAL(panel.gddram[heat_rect.page * WIDTH + 0], 0xC0);
+    TEST_EQUAL(panel.gddram[heat_rect.page * WIDTH + bar - 2], 0xC0);
+    TEST_EQUAL(panel.gddram[heat_rect.page * WIDTH + bar - 1], 0x00);
+    TEST_EQUAL(panel.gddram[heat_rect.page * WIDTH + 5 * bar], 0x80);
+    // The clock wraps
+    comp.last_frame_us = 0xFFFFFFFF - 1000;
+    Compositor_Invalidate(&comp, heat_id);
+    TEST_EQUAL(Compositor_WaitUs(&comp, FRAME_US - 1002), 1);
+    TEST_EQUAL(Compositor_WaitUs(&comp, FRAME_US - 1001), 0);
+}
+
+static void test_disable(void) {
+    static uint8_t before[PAGES * WIDTH];
+    setup();
+    Compositor_SetEnabled(&comp, true);
+    Compositor_Update(&comp, 0);
+    // The display has another owner, nothing is drawn however much changes
+    Compositor_SetEnabled(&comp, false);
+    Widget_SetLayer(&layer_widget, 3);
+    Compositor_Invalidate(&comp, layer_id);
+    TEST_CHECK(!Compositor_Pending(&comp));
+    Fake_ClearLog();
+    TEST_EQUAL(Compositor_Update(&comp, FRAME_US), 0);
+    TEST_EQUAL(Fake_TransferCount(), 0);
+    // It drew over the panel, enabling brings every widget back
+    memset(dev.buffer, 0xAA, PAGES * WIDTH);
+    SSD1306_Flush(&dev);
+    memcpy(before, panel.gddram, sizeof(before));
+    Compositor_SetEnabled(&comp, true);
+    Compositor_Update(&comp, 2 * FRAME_US);
+    TEST_EQUAL(comp.regions, 8);
+    TEST_CHECK(panel_matches());
+    for (uint16_t i = 0; i < PAGES * WIDTH; i++) {
+        if (panel.gddram[i] == 0xAA) {
+            TEST_CHECK(!"left over from the other owner");
+            break;
+        }
+    }
+}
+
+// Marks its widget invalid again while it draws, as a setter on the other core would
+static void render_and_invalidate(void *context, SSD1306 *d, const Compositor_Rect *rect) {
+    Widget_RenderText(&status_widget, d, rect);
+    Compositor_Invalidate(&comp, *(int *)context);
+}
+
+static void test_change_while_drawing(void) {
+    setup();
+    Compositor_SetEnabled(&comp, true);
+    comp.widgets[status_id].render = render_and_invalidate;
+    comp.widgets[status_id].context = &status_id;
+    Compositor_Update(&comp, 0);
+    // Not lost: drawn again next frame
+    TEST_CHECK(Compositor_Pending(&comp));
+    TEST_EQUAL(comp.regions, 4);
+    Compositor_Update(&comp, FRAME_US);
+    TEST_EQUAL(comp.regions, 5);
+}
+
+static void test_clipping(void) {
+    setup();
+    Compositor_SetEnabled(&comp, true);
+    // Longer than any widget is wide
+    Widget_SetText(&status_widget, "WWWWWWWWWWWWWWWWWWWWWWW");
+    Widget_SetLayer(&layer_widget, 200);
+    Widget_SetCounters(&counters_widget, 4000000000u, 65535);
+    for (uint8_t key = 0; key < KEYS; key++) {
+        for (uint8_t i = 0; i < WIDGET_HEAT_MAX + 2; i++) {
+            Widget_HeatPress(&heat_widget, key);
+        }
+    }
+    // Each widget drawn on its own over a blank buffer stays in its rectangle
+    for (uint8_t i = 0; i < comp.widget_count; i++) {
+        Compositor_Widget *widget = &comp.widgets[i];
+        memset(dev.buffer, 0, sizeof(dev.buffer));
+        widget->render(widget->context, &dev, &widget->rect);
+        uint32_t outside = 0;
+        for (uint8_t page = 0; page < PAGES; page++) {
+            for (uint8_t column = 0; column < WIDTH; column++) {
+                outside += !inside(&widget->rect, column, page) && dev.buffer[page * WIDTH + column] != 0;
+            }
+        }
+        TEST_EQUAL(outside, 0);
+    }
+    // A full bar fills the page, with a gap column between keys
+    TEST_EQUAL(dev.buffer[heat_rect.page * WIDTH], 0xFF);
+    TEST_EQUAL(dev.buffer[heat_rect.page * WIDTH + WIDTH / KEYS - 1], 0x00);
+}
+
+// Random widget changes over many frames. After each frame the panel holds the back
+// buffer, and now and then a full redraw must come out the same as the increments did
+static void test_random_frames(void) {
+    static uint8_t incremental[PAGES * WIDTH];
+    setup();
+    Compositor_SetEnabled(&comp, true);
+    srand(46);
+    uint32_t presses = 0;
+    uint32_t now = 0;
+    for (uint32_t frame = 0; frame < 3000; frame++) {
+        now += FRAME_US / 2 + rand() % FRAME_US;
+        switch (rand() % 5) {
+        case 0:
+            if (Widget_SetLayer(&layer_widget, rand() % 4)) {
+                Compositor_Invalidate(&comp, layer_id);
+            }
+            break;
+        case 1:
+            presses += rand() % 3;
+            if (Widget_SetCounters(&counters_widget, presses, rand() % 200)) {
+                Compositor_Invalidate(&comp, counters_id);
+            }
+            break;
+        case 2: {
+            static const char *const texts[] = {"default", "combo: copy", "macro 3", "host asleep"};
+            if (Widget_SetText(&status_widget, texts[rand() % 4])) {
+                Compositor_Invalidate(&comp, status_id);
+            }
+            break;
+        }
+        case 3:
+            if (Widget_HeatPress(&heat_widget, rand() % KEYS)) {
+                Compositor_Invalidate(&comp, heat_id);
+            }
+            break;
+        default:
+            if (Widget_HeatDecay(&heat_widget)) {
+                Compositor_Invalidate(&comp, heat_id);
+            }
+            break;
+        }
+        Fake_ClearLog();
+        uint32_t bytes = Compositor_Update(&comp, now);
+        if (bytes != bus_bytes() || !panel_matches()) {
+            TEST_CHECK(!"panel differs from the back buffer");
+            return;
+        }
+        if (frame % 100 == 99) {
+            // Let a change held back by the frame cap go first
+            now += FRAME_US;
+            Compositor_Update(&comp, now);
+            memcpy(incremental, panel.gddram, sizeof(incremental));
+            Compositor_InvalidateAll(&comp);
+            now += FRAME_US;
+            Compositor_Update(&comp, now);
+            if (memcmp(incremental, panel.gddram, sizeof(incremental)) != 0) {
+                TEST_CHECK(!"full redraw differs from the increments");
+                return;
+            }
+        }
+    }
+    TEST_EQUAL(panel.malformed, 0);
+}
+
+static void bench_region_cost(void) {
+    // A counter tick on the bus against sending the whole frame
+    setup();
+    Compositor_SetEnabled(&comp, true);
+    Compositor_Update(&comp, 0);
+    uint32_t now = 0;
+    uint32_t counter_bytes = 0;
+    for (uint32_t i = 0; i < 100; i++) {
+        Widget_SetCounters(&counters_widget, i * 7, i);
+        Compositor_Invalidate(&comp, counters_id);
+        counter_bytes += Compositor_Update(&comp, now += FRAME_US);
+    }
+    SSD1306_Show(&dev);
+    printf("bench %-32s %5u vs %u bus bytes per frame\n", "counter tick vs whole frame", counter_bytes / 100, dev.last_flush_bytes);
+    TEST_CHECK(counter_bytes / 100 < dev.last_flush_bytes / 4);
+
+    // Redrawing every widget finds the same bytes to send, but draws and diffs the whole screen
+
+    TEST_BENCH("Compositor_Update, counters", 20000,
+               (Widget_SetCounters(&counters_widget, test_i, test_i & 0xFF), Compositor_Invalidate(&comp, counters_id),
+                Compositor_Update(&comp, now += FRAME_US)));
+    TEST_BENCH("Compositor_Update, every widget", 20000,
+               (Widget_SetCounters(&counters_widget, test_i, test_i & 0xFF), Compositor_InvalidateAll(&comp),
+                Compositor_Update(&comp, now += FRAME_US)));
+}
+
+int main(void) {
+    TEST_RUN(test_add_widget);
+    TEST_RUN(test_first_frame);
+    TEST_RUN(test_only_invalid_regions);
+    TEST_RUN(test_frame_cap);
+    TEST_RUN(test_disable);
+    TEST_RUN(test_change_while_drawing);
+    TEST_RUN(test_clipping);
+    TEST_RUN(test_random_frames);
+    bench_region_cost();
+    return TEST_RESULT();
+}
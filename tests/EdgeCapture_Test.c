@@ -0,0 +1,189 @@
+/*
+ *
+ *  Expander Edge Capture Tests
+ *
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *
+*/
+
+// One INTF/INTCAP/GPIO burst at a time: INTCAP is only taken for a port with INTF bits,
+// a tap that is already over by the read comes out as a press then a release, and the
+// captures and recovered counts say how often. Then the samples through debounce in the
+// order and at the times scan_task feeds them
+
+#include "Test.h"
+#include "EdgeCapture.h"
+#include "Debounce.h"
+#include "KeyPipeline.h"
+
+static EdgeCapture cap;
+static uint16_t samples[2];
+
+static void test_no_change(void) {
+    EdgeCapture_Initialise(&cap);
+    // A periodic read with nothing latched hands on GPIO alone
+    TEST_EQUAL(EdgeCapture_Decode(&cap, 0, 0, 0, 0, samples), 1);
+    TEST_EQUAL(samples[0], 0);
+    // A key held since the last read, GPIO shows it
+    TEST_EQUAL(EdgeCapture_Decode(&cap, 0, 0, 0, 0x0004, samples), 1);
+    TEST_EQUAL(samples[0], 0x0004);
+    TEST_EQUAL(cap.last[0], 0x0004);
+    // INTF set but INTCAP holds what was last handed on (the change was seen in GPIO
+    // through an earlier read), nothing extra
+    TEST_EQUAL(EdgeCapture_Decode(&cap, 0, 0x0004, 0x0004, 0x0004, samples), 1);
+    TEST_EQUAL(cap.captures, 0);
+    TEST_EQUAL(cap.recovered, 0);
+}
+
+static void test_tap_recovered(void) {
+    EdgeCapture_Initialise(&cap);
+    // Pressed and released between two reads: INTCAP has the press, GPIO the release
+    TEST_EQUAL(EdgeCapture_Decode(&cap, 0, 0x0001, 0x0001, 0x0000, samples), 2);
+    TEST_EQUAL(samples[0], 0x0001);
+    TEST_EQUAL(samples[1], 0x0000);
+    TEST_EQUAL(cap.captures, 1);
+    TEST_EQUAL(cap.recovered, 1);
+    TEST_EQUAL(cap.last[0], 0x0000);
+
+    // Released and pressed again while another key is held
+    EdgeCapture_Decode(&cap, 0, 0, 0, 0x0011, samples);
+    TEST_EQUAL(EdgeCapture_Decode(&cap, 0, 0x0010, 0x0001, 0x0011, samples), 2);
+    TEST_EQUAL(samples[0], 0x0001);
+    TEST_EQUAL(samples[1], 0x0011);
+    TEST_EQUAL(cap.recovered, 2);
+
+    // INTCAP shows a press GPIO still has: a capture, nothing recovered
+    EdgeCapture_Decode(&cap, 0, 0, 0, 0, samples);
+    TEST_EQUAL(EdgeCapture_Decode(&cap, 0, 0x0002, 0x0002, 0x0002, samples), 2);
+    TEST_EQUAL(samples[0], 0x0002);
+    TEST_EQUAL(samples[1], 0x0002);
+    TEST_EQUAL(cap.captures, 3);
+    TEST_EQUAL(cap.recovered, 2);
+
+    // One tap per port in the same read, both recovered
+    EdgeCapture_Decode(&cap, 0, 0, 0, 0, samples);
+    TEST_EQUAL(EdgeCapture_Decode(&cap, 0, 0x0180, 0x0180, 0x0000, samples), 2);
+    TEST_EQUAL(samples[0], 0x0180);
+    TEST_EQUAL(samples[1], 0x0000);
+    TEST_EQUAL(cap.captures, 4);
+    TEST_EQUAL(cap.recovered, 4);
+}
+
+// INTCAP keeps its last latch until the port changes again, a port with no INTF bits
+// must be taken from what was last handed on
+static void test_stale_port(void) {
+    EdgeCapture_Initialise(&cap);
+    // Port B latched a press of key 8 some reads ago, since released
+    EdgeCapture_Decode(&cap, 0, 0x0100, 0x0100, 0x0100, samples);
+    EdgeCapture_Decode(&cap, 0, 0, 0x0100, 0x0000, samples);
+    uint32_t captures = cap.captures;
+    // Now only port A latches. Port B's INTCAP still says key 8 is down
+    TEST_EQUAL(EdgeCapture_Decode(&cap, 0, 0x0002, 0x0102, 0x0000, samples), 2);
+    TEST_EQUAL(samples[0], 0x0002);
+    TEST_EQUAL(samples[1], 0x0000);
+    TEST_EQUAL(cap.captures, captures + 1);
+    TEST_EQUAL(cap.recovered, 1);
+
+    // Port A stale the other way round, with key 1 held on it
+    EdgeCapture_Decode(&cap, 0, 0, 0, 0x0001, samples);
+    TEST_EQUAL(EdgeCapture_Decode(&cap, 0, 0x0400, 0x0400, 0x0001, samples), 2);
+    TEST_EQUAL(samples[0], 0x0401);
+    TEST_EQUAL(samples[1], 0x0001);
+
+    // Nothing in INTF at all, every INTCAP bit is stale
+    EdgeCapture_Decode(&cap, 0, 0, 0, 0, samples);
+    captures = cap.captures;
+    TEST_EQUAL(EdgeCapture_Decode(&cap, 0, 0, 0xFFFF, 0x0000, samples), 1);
+    TEST_EQUAL(samples[0], 0x0000);
+    TEST_EQUAL(cap.captures, captures);
+}
+
+static void test_sources(void) {
+    EdgeCapture_Initialise(&cap);
+    EdgeCapture_Decode(&cap, 0, 0, 0, 0x0003, samples);
+    // The other expander keeps its own last sample
+    TEST_EQUAL(EdgeCapture_Decode(&cap, 1, 0x0001, 0x0001, 0x0000, samples), 2);
+    TEST_EQUAL(samples[0], 0x0001);
+    TEST_EQUAL(cap.last[0], 0x0003);
+    TEST_EQUAL(cap.last[1], 0x0000);
+    // Source 0 released key 0, key 1 still down: the capture is against source 0's last
+    TEST_EQUAL(EdgeCapture_Decode(&cap, 0, 0x0001, 0x0002, 0x0002, samples), 2);
+    TEST_EQUAL(samples[0], 0x0002);
+    TEST_EQUAL(cap.recovered, 1);
+}
+
+typedef struct {
+    uint8_t key;
+    uint8_t edge;
+    uint32_t time_us;
+} Event;
+
+// As scan_task: the capture timed at the interrupt first, then GPIO timed at the read
+static uint8_t scan(Debounce *db, KeyPipeline *pipe, int consumer, uint16_t flags, uint16_t capture, uint16_t io,
+                    uint32_t interrupt_us, uint32_t now_us, Event *events) {
+    if (EdgeCapture_Decode(&cap, 0, flags, capture, io, samples) == 2) {
+        Debounce_Update(db, pipe, 0, samples[0], interrupt_us);
+    }
+    Debounce_Update(db, pipe, 0, io, now_us);
+    uint8_t count = 0;
+    KeyEvent *event;
+    while ((event = KeyPipeline_Peek(pipe, consumer)) != NULL) {
+        events[count++] = (Event){event->key, event->edge, event->timestamp_us};
+        KeyPipeline_Release(pipe, consumer);
+    }
+    return count;
+}
+
+static void test_through_debounce(void) {
+    static Debounce db;
+    static KeyPipeline pipe;
+    Event events[8];
+    EdgeCapture_Initialise(&cap);
+    Debounce_Initialise(&db, DEBOUNCE_DEFAULT_WINDOW_US);
+    KeyPipeline_Initialise(&pipe);
+    int consumer = KeyPipeline_AddConsumer(&pipe);
+
+    // A 2ms tap of key 3 at 10ms, the read 3ms after the interrupt. The press is reported
+    // at the interrupt, the release once the debounce window is over
+    TEST_EQUAL(scan(&db, &pipe, consumer, 0x0008, 0x0008, 0x0000, 10000, 13000, events), 1);
+    TEST_EQUAL(events[0].key, 3);
+    TEST_EQUAL(events[0].edge, KEYEVENT_PRESS);
+    TEST_EQUAL(events[0].time_us, 10000);
+    TEST_EQUAL(scan(&db, &pipe, consumer, 0, 0, 0x0000, 0, 20000, events), 1);
+    TEST_EQUAL(events[0].key, 3);
+    TEST_EQUAL(events[0].edge, KEYEVENT_RELEASE);
+    TEST_EQUAL(events[0].time_us, 20000);
+
+    // Held key 12 on port B released and a tap of key 0 on port A, both over by the read
+    TEST_EQUAL(scan(&db, &pipe, consumer, 0, 0, 0x1000, 0, 40000, events), 1);
+    TEST_EQUAL(events[0].edge, KEYEVENT_PRESS);
+    TEST_EQUAL(scan(&db, &pipe, consumer, 0x1001, 0x0001, 0x0000, 50000, 52000, events), 2);
+    TEST_EQUAL(events[0].key, 0);
+    TEST_EQUAL(events[0].edge, KEYEVENT_PRESS);
+    TEST_EQUAL(events[1].key, 12);
+    TEST_EQUAL(events[1].edge, KEYEVENT_RELEASE);
+    TEST_EQUAL(events[1].time_us, 50000);
+    TEST_EQUAL(scan(&db, &pipe, consumer, 0, 0, 0x0000, 0, 60000, events), 1);
+    TEST_EQUAL(events[0].key, 0);
+    TEST_EQUAL(events[0].edge, KEYEVENT_RELEASE);
+    TEST_EQUAL(cap.recovered, 2);
+}
+
+static void bench_decode(void) {
+    EdgeCapture_Initialise(&cap);
+    TEST_BENCH("decode, no change", 10000000, (void)EdgeCapture_Decode(&cap, 0, 0, 0, 0x0004, samples));
+    TEST_BENCH("decode, tap recovered", 10000000, (void)EdgeCapture_Decode(&cap, test_i & 1, 0x0101, 0x0101, test_i & 0x0100, samples));
+}
+
+int main(void) {
+    TEST_RUN(test_no_change);
+    TEST_RUN(test_tap_recovered);
+    TEST_RUN(test_stale_port);
+    TEST_RUN(test_sources);
+    TEST_RUN(test_through_debounce);
+    TEST_RUN(bench_decode);
+    return TEST_RESULT();
+}
@@ -0,0 +1,315 @@
+/*
+ *
+ *  Rotary Encoder Tests
+ *
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *
+*/
+
+// The decoder on synthetic quadrature with bounce and skipped states, then detents turned
+// into taps: acceleration, the pending cap, back pressure, and through the keymap to the
+// consumer report
+
+#include <stdlib.h>
+#include <string.h>
+#include "Test.h"
+#include "Encoder.h"
+#include "Layout.h"
+#include "HidReport.h"
+
+#define KEY_CW  20
+#define KEY_CCW 21
+#define MS      1000u
+
+// A | B << 1 around one clockwise cycle
+static const uint8_t gray[4] = {0, 1, 3, 2};
+
+static Encoder enc;
+static uint8_t phase;   // Index into gray of the pins now
+
+static void setup(uint8_t start_phase) {
+    phase = start_phase;
+    Encoder_Initialise(&enc, gray[phase], KEY_CW, KEY_CCW, 0);
+}
+
+// One step, the new state bouncing back to the old one <bounces> times before it settles
+static void turn_step(int8_t direction, uint8_t bounces) {
+    uint8_t next = (phase + direction) & 3;
+    for (uint8_t i = 0; i < bounces; i++) {
+        Encoder_Decode(&enc, gray[next]);
+        Encoder_Decode(&enc, gray[phase]);
+    }
+    Encoder_Decode(&enc, gray[next]);
+    phase = next;
+}
+
+static void turn_detents(int32_t detents, uint8_t bounces) {
+    int8_t direction = detents > 0 ? 1 : -1;
+    for (int32_t i = 0; i < abs(detents) * ENCODER_DEFAULT_STEPS_PER_DETENT; i++) {
+        turn_step(direction, bounces);
+    }
+}
+
+static void test_clean_waveform(void) {
+    setup(0);
+    TEST_EQUAL(enc.steps_per_detent, ENCODER_DEFAULT_STEPS_PER_DETENT);
+    turn_detents(5, 0);
+    TEST_EQUAL(enc.detents, 5);
+    TEST_EQUAL(enc.sub_steps, 0);
+    turn_detents(-7, 0);
+    TEST_EQUAL(enc.detents, -2);
+    TEST_EQUAL(Encoder_TakeDetents(&enc), -2);
+    TEST_EQUAL(Encoder_TakeDetents(&enc), 0);
+    TEST_EQUAL(enc.errors, 0);
+
+    // Three steps isn't a detent yet, the fourth is
+    for (uint8_t i = 0; i < 3; i++) {
+        turn_step(1, 0);
+    }
+    TEST_EQUAL(Encoder_TakeDetents(&enc), 0);
+    turn_step(1, 0);
+    TEST_EQUAL(Encoder_TakeDetents(&enc), 1);
+
+    // Starting from the pins read at initialise, not from 00
+    setup(2);
+    turn_detents(1, 0);
+    TEST_EQUAL(enc.detents, 1);
+    TEST_EQUAL(enc.errors, 0);
+
+    // Other detent sizes
+    Encoder_Initialise(&enc, gray[phase], KEY_CW, KEY_CCW, 2);
+    turn_detents(-1, 0);
+    TEST_EQUAL(enc.detents, -2);
+}
+
+static void test_bounce_cancels(void) {
+    setup(0);
+    turn_detents(3, 5);
+    TEST_EQUAL(enc.detents, 3);
+    TEST_EQUAL(enc.errors, 0);
+    // Chatter on one pin at rest never makes a detent, however long it goes on
+    for (uint16_t i = 0; i < 1000; i++) {
+        Encoder_Decode(&enc, gray[(phase + 1) & 3]);
+        Encoder_Decode(&enc, gray[phase]);
+    }
+    TEST_EQUAL(enc.detents, 3);
+    // Nor does rocking a step either side of the detent
+    for (uint16_t i = 0; i < 1000; i++) {
+        turn_step(1, 0);
+        turn_step(-1, 0);
+        turn_step(-1, 0);
+        turn_step(1, 0);
+    }
+    TEST_EQUAL(enc.detents, 3);
+    // Repeated samples of the same state are no change
+    Encoder_Decode(&enc, gray[phase]);
+    TEST_EQUAL(enc.sub_steps, 0);
+    TEST_EQUAL(enc.errors, 0);
+}
+
+static void test_skipped_states(void) {
+    setup(0);
+    // Both pins changed: an error, and no step guessed either way
+    Encoder_Decode(&enc, gray[2]);
+    TEST_EQUAL(enc.errors, 1);
+    TEST_EQUAL(enc.sub_steps, 0);
+    Encoder_Decode(&enc, gray[0]);
+    Encoder_Decode(&enc, gray[1]);
+    Encoder_Decode(&enc, gray[3]);
+    TEST_EQUAL(enc.errors, 3);
+    TEST_EQUAL(enc.detents, 0);
+    // Decoding carries on from the state it landed in
+    phase = 2;
+    turn_detents(2, 0);
+    TEST_EQUAL(enc.detents, 2);
+    TEST_EQUAL(enc.errors, 3);
+}
+
+// Random speed and direction with bounce and the odd skipped state. Every step the decoder
+// accepted is accounted for by detents plus the partial count
+static void test_random_waveform(void) {
+    srand(34);
+    for (uint8_t round = 0; round < 20; round++) {
+        setup(rand() & 3);
+        int32_t counted = 0;
+        uint32_t skips = 0;
+        for (uint32_t i = 0; i < 20000; i++) {
+            uint8_t r = rand() % 64;
+            if (r == 0) {
+                // Missed a sample, the decoder can't know which way it went
+                phase = (phase + 2) & 3;
+                Encoder_Decode(&enc, gray[phase]);
+                skips++;
+                continue;
+            }
+            int8_t direction = (r & 1) ? 1 : -1;
+            turn_step(direction, r % 5 == 0 ? 1 + rand() % 4 : 0);
+            counted += direction;
+            if (enc.detents * enc.steps_per_detent + enc.sub_steps != counted) {
+                TEST_CHECK(!"steps lost");
+                return;
+            }
+            TEST_CHECK(abs(enc.sub_steps) < enc.steps_per_detent);
+        }
+        TEST_EQUAL(enc.errors, skips);
+    }
+}
+
+static KeyPipeline pipe;
+static int consumer;
+
+// Counts the taps waiting in the pipeline, checking each is a press then release of one key
+// from the encoder. Negative for anticlockwise
+static int32_t drain_taps(void) {
+    int32_t taps = 0;
+    bool pressed = false;
+    KeyEvent *event;
+    while ((event = KeyPipeline_Peek(&pipe, consumer)) != NULL) {
+        TEST_EQUAL(event->source, ENCODER_EVENT_SOURCE);
+        TEST_CHECK(event->key == KEY_CW || event->key == KEY_CCW);
+        TEST_EQUAL(event->edge, pressed ? KEYEVENT_RELEASE : KEYEVENT_PRESS);
+        if (!pressed) {
+            taps += event->key == KEY_CW ? 1 : -1;
+        }
+        pressed = !pressed;
+        KeyPipeline_Release(&pipe, consumer);
+    }
+    TEST_CHECK(!pressed);
+    return taps;
+}
+
+static void setup_pipeline(void) {
+    setup(0);
+    KeyPipeline_Initialise(&pipe);
+    consumer = KeyPipeline_AddConsumer(&pipe);
+}
+
+// Turns <detents> and runs the update at <now_ms>, returns the taps it made
+static int32_t turn_and_update(int32_t detents, uint32_t now_ms) {
+    if (detents != 0) {
+        turn_detents(detents, 0);
+    }
+    bool moved = Encoder_Update(&enc, &pipe, now_ms * MS);
+    TEST_EQUAL(moved, detents != 0);
+    KeyPipeline_Run(&pipe);
+    return drain_taps();
+}
+
+static void test_acceleration(void) {
+    setup_pipeline();
+    // A new direction always starts at 1x
+    TEST_EQUAL(turn_and_update(1, 1000), 1);
+    TEST_EQUAL(turn_and_update(1, 1100), 1);  // 100ms
+    TEST_EQUAL(turn_and_update(1, 1130), 2);  // 30ms
+    TEST_EQUAL(turn_and_update(1, 1145), 4);  // 15ms
+    TEST_EQUAL(turn_and_update(1, 1150), 8);  // 5ms
+    // The interval is per detent: two in 40ms is 20ms each
+    TEST_EQUAL(turn_and_update(2, 1190), 8);
+    TEST_EQUAL(turn_and_update(0, 1200), 0);
+    // Turning back starts over at 1x
+    TEST_EQUAL(turn_and_update(-1, 1205), -1);
+    TEST_EQUAL(turn_and_update(-1, 1210), -8);
+
+    // A custom curve, and none at all
+    static const Encoder_AccelerationStep curve[] = {{20000, 3}};
+    Encoder_SetAcceleration(&enc, curve, 1);
+    TEST_EQUAL(turn_and_update(-1, 1220), -3);
+    Encoder_SetAcceleration(&enc, NULL, 5);
+    TEST_EQUAL(turn_and_update(-1, 1221), -1);
+}
+
+static void test_pending_limit(void) {
+    static const Encoder_AccelerationStep fast[] = {{1000000, 40}};
+    setup_pipeline();
+    Encoder_SetAcceleration(&enc, fast, 1);
+    TEST_EQUAL(turn_and_update(1, 0), 1);
+    // 40 taps asked for, capped at the limit, which fits the ring exactly
+    TEST_EQUAL(turn_and_update(1, 10), ENCODER_MAX_PENDING_TAPS);
+
+    // Nobody reading: the ring fills, the rest waits in the encoder, nothing overflows
+    turn_detents(1, 0);
+    Encoder_Update(&enc, &pipe, 20 * MS);
+    turn_detents(1, 0);
+    Encoder_Update(&enc, &pipe, 30 * MS);
+    TEST_EQUAL(KeyPipeline_Free(&pipe), 0);
+    TEST_EQUAL(pipe.overflows, 0);
+    TEST_EQUAL(enc.pending_taps, ENCODER_MAX_PENDING_TAPS);
+    TEST_EQUAL(drain_taps(), ENCODER_MAX_PENDING_TAPS);
+    TEST_EQUAL(turn_and_update(0, 40), ENCODER_MAX_PENDING_TAPS);
+    TEST_EQUAL(enc.pending_taps, 0);
+
+    // A tap is never left half done: with one slot free the press waits for two
+    for (uint8_t i = 0; i < KEYPIPELINE_RING_SIZE - 1; i++) {
+        KeyPipeline_Push(&pipe, 0, KEYEVENT_PRESS, 0, 0);
+    }
+    turn_detents(1, 0);
+    Encoder_Update(&enc, &pipe, 50 * MS);
+    TEST_EQUAL(KeyPipeline_Free(&pipe), 1);
+    TEST_CHECK(!enc.tap_pressed);
+    for (uint8_t i = 0; i < KEYPIPELINE_RING_SIZE - 1; i++) {
+        KeyPipeline_Release(&pipe, consumer);
+    }
+
+    // Turning back while taps are queued drops them
+    TEST_EQUAL(enc.pending_taps, ENCODER_MAX_PENDING_TAPS);
+    TEST_EQUAL(turn_and_update(-1, 60), -1);
+    TEST_EQUAL(enc.pending_taps, 0);
+}
+
+static void test_consumer_report(void) {
+    static Keymap keymap;
+    static HidReport hid;
+    HidKeyboardReport report;
+    uint16_t usage;
+    setup_pipeline();
+    KeyPipeline_Initialise(&pipe);
+    Keymap_Initialise(&keymap, Layout_DefaultLayers, LAYOUT_LAYER_COUNT);
+    HidReport_Initialise(&hid);
+    KeyPipeline_AddStage(&pipe, Keymap_Stage, &keymap);
+    KeyPipeline_AddStage(&pipe, HidReport_Stage, &hid);
+    consumer = KeyPipeline_AddConsumer(&pipe);
+
+    // Base layer: volume up then down, each tap a usage then an empty report
+    const uint16_t expected[] = {0xE9, 0, 0xE9, 0, 0xEA, 0};
+    TEST_EQUAL(turn_and_update(2, 1000), 2);
+    TEST_EQUAL(turn_and_update(-1, 2000), -1);
+    for (uint8_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+        TEST_CHECK(HidReport_TakeConsumer(&hid, &usage));
+        TEST_EQUAL(usage, expected[i]);
+    }
+    TEST_CHECK(!HidReport_TakeConsumer(&hid, &usage));
+    TEST_CHECK(!HidReport_Take(&hid, &report, NULL));
+
+    // Holding the layer key, the same turn is an arrow key on the keyboard report
+    KeyPipeline_Push(&pipe, 15, KEYEVENT_PRESS, 0, 3000 * MS);
+    KeyPipeline_Run(&pipe);
+    KeyPipeline_Release(&pipe, consumer);
+    TEST_EQUAL(turn_and_update(-1, 3100), -1);
+    TEST_CHECK(HidReport_Take(&hid, &report, NULL));
+    TEST_EQUAL(report.keys[0], 0x52);
+    TEST_CHECK(HidReport_Take(&hid, &report, NULL));
+    TEST_EQUAL(report.keys[0], 0);
+    TEST_CHECK(!HidReport_TakeConsumer(&hid, &usage));
+}
+
+static void bench_decode(void) {
+    setup(0);
+    TEST_BENCH("Encoder_Decode per sample", 10000000, Encoder_Decode(&enc, gray[test_i & 3]));
+    // The first sample is the rest state, every other one a step
+    TEST_EQUAL(enc.detents, (10000000 - 1) / ENCODER_DEFAULT_STEPS_PER_DETENT);
+}
+
+int main(void) {
+    TEST_RUN(test_clean_waveform);
+    TEST_RUN(test_bounce_cancels);
+    TEST_RUN(test_skipped_states);
+    TEST_RUN(test_random_waveform);
+    TEST_RUN(test_acceleration);
+    TEST_RUN(test_pending_limit);
+    TEST_RUN(test_consumer_report);
+    bench_decode();
+    return TEST_RESULT();
+}
@@ -0,0 +1,174 @@
+/*
+ *
+ *  MCP23017 / MCP23S17 Register Model
+ *
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *
+*/
+
+#include <string.h>
+#include "FakeMcp23017.h"
+#include "MCP23017.h"
+
+void FakeMcp23017_Initialise(FakeMcp23017 *part, uint8_t address) {
+    memset(part, 0, sizeof(FakeMcp23017));
+    part->address = address;
+    // Power on: all inputs
+    part->regs[MCP23017_REG_IODIRA] = 0xFF;
+    part->regs[MCP23017_REG_IODIRB] = 0xFF;
+    part->pins = 0;
+}
+
+uint16_t FakeMcp23017_Pair(const FakeMcp23017 *part, uint8_t reg_a) {
+    return (part->regs[reg_a] << 8) | part->regs[reg_a + 1];
+}
+
+// Port value as read from GPIO: inputs through IPOL, outputs from OLAT. <port> 0 is A
+static uint8_t FakeMcp23017_Port(const FakeMcp23017 *part, uint8_t port) {
+    uint8_t pins = port ? part->pins & 0xFF : part->pins >> 8;
+    uint8_t direction = part->regs[MCP23017_REG_IODIRA + port];
+    uint8_t inputs = (pins ^ part->regs[MCP23017_REG_IPOLA + port]) & direction;
+    return inputs | (part->regs[MCP23017_REG_OLATA + port] & ~direction);
+}
+
+void FakeMcp23017_SetPins(FakeMcp23017 *part, uint16_t pins) {
+    uint16_t previous = part->pins;
+    part->pins = pins;
+    for (uint8_t port = 0; port < 2; port++) {
+        uint8_t shift = port ? 0 : 8;
+        uint8_t now = pins >> shift;
+        uint8_t was = previous >> shift;
+        uint8_t enabled = part->regs[MCP23017_REG_GPINTENA + port] & part->regs[MCP23017_REG_IODIRA + port];
+        uint8_t compare = part->regs[MCP23017_REG_INTCONA + port];
+        // INTCON set compares against DEFVAL, clear against the previous level
+        uint8_t against = (part->regs[MCP23017_REG_DEFVALA + port] & compare) | (was & ~compare);
+        uint8_t fired = (now ^ against) & enabled;
+        if (fired == 0) {
+            continue;
+        }
+        if (part->regs[MCP23017_REG_INTFA + port] == 0) {
+            part->regs[MCP23017_REG_INTCAPA + port] = FakeMcp23017_Port(part, port);
+        }
+        part->regs[MCP23017_REG_INTFA + port] |= fired;
+    }
+}
+
+static uint8_t FakeMcp23017_Read(FakeMcp23017 *part) {
+    uint8_t reg = part->pointer;
+    uint8_t value;
+    if (reg == MCP23017_REG_GPIOA || reg == MCP23017_REG_GPIOB) {
+        value = FakeMcp23017_Port(part, reg & 1);
+    }
+    else {
+        value = part->regs[reg];
+    }
+    // Reading GPIO or INTCAP clears the port's interrupt
+    if (reg == MCP23017_REG_GPIOA || reg == MCP23017_REG_GPIOB || reg == MCP23017_REG_INTCAPA || reg == MCP23017_REG_INTCAPB) {
+        part->regs[MCP23017_REG_INTFA + (reg & 1)] = 0;
+    }
+    part->pointer = (part->pointer + 1) % MCP23017_REG_COUNT;
+    return value;
+}
+
+static void FakeMcp23017_Write(FakeMcp23017 *part, uint8_t value) {
+    uint8_t reg = part->pointer;
+    switch (reg) {
+    case MCP23017_REG_IOCONA:
+    case MCP23017_REG_IOCONB:
+        // One register at two addresses
+        part->regs[MCP23017_REG_IOCONA] = value;
+        part->regs[MCP23017_REG_IOCONB] = value;
+        break;
+    case MCP23017_REG_INTFA:
+    case MCP23017_REG_INTFB:
+    case MCP23017_REG_INTCAPA:
+    case MCP23017_REG_INTCAPB:
+        break; // Read only
+    case MCP23017_REG_GPIOA:
+    case MCP23017_REG_GPIOB:
+        part->regs[MCP23017_REG_OLATA + (reg & 1)] = value;
+        break;
+    default:
+        part->regs[reg] = value;
+        break;
+    }
+    part->pointer = (part->pointer + 1) % MCP23017_REG_COUNT;
+}
+
+// I2C: the first byte written is the register address
+static bool FakeMcp23017_I2CWrite(void *context, const uint8_t *data, size_t length) {
+    FakeMcp23017 *part = (FakeMcp23017 *)context;
+    if (length == 0) {
+        return true;
+    }
+    part->pointer = data[0] % MCP23017_REG_COUNT;
+    if (length > 1) {
+        part->writes++;
+    }
+    for (size_t i = 1; i < length; i++) {
+        FakeMcp23017_Write(part, data[i]);
+    }
+    return true;
+}
+
+static bool FakeMcp23017_I2CRead(void *context, uint8_t *data, size_t length) {
+    FakeMcp23017 *part = (FakeMcp23017 *)context;
+    part->reads++;
+    for (size_t i = 0; i < length; i++) {
+        data[i] = FakeMcp23017_Read(part);
+    }
+    return true;
+}
+
+void FakeMcp23017_AttachI2C(FakeMcp23017 *part) {
+    FakeI2C_Device device = {FakeMcp23017_I2CWrite, FakeMcp23017_I2CRead, part};
+    FakeI2C_Attach(part->address, &device);
+}
+
+// SPI: opcode, register address, then data. Without HAEN only A2..A0 = 000 matches
+static void FakeMcp23017_Select(void *context, bool selected) {
+    FakeMcp23017 *part = (FakeMcp23017 *)context;
+    if (!selected && part->spi_addressed && part->spi_count > 2) {
+        if (part->spi_read) {
+            part->reads++;
+        }
+        else {
+            part->writes++;
+        }
+    }
+    part->spi_selected = selected;
+    part->spi_count = 0;
+    part->spi_addressed = false;
+}
+
+static uint8_t FakeMcp23017_Transfer(void *context, uint8_t out) {
+    FakeMcp23017 *part = (FakeMcp23017 *)context;
+    uint8_t index = part->spi_count < 0xFF ? part->spi_count++ : 0xFF;
+    if (index == 0) {
+        bool haen = part->regs[MCP23017_REG_IOCONA] & MCP23017_IOCON_HAEN;
+        uint8_t address = haen ? part->address : MCP23017_I2C_ADDRESS;
+        part->spi_addressed = (out >> 1) == address;
+        part->spi_read = out & 1;
+        return 0;
+    }
+    if (!part->spi_addressed) {
+        return 0;
+    }
+    if (index == 1) {
+        part->pointer = out % MCP23017_REG_COUNT;
+        return 0;
+    }
+    if (part->spi_read) {
+        return FakeMcp23017_Read(part);
+    }
+    FakeMcp23017_Write(part, out);
+    return 0;
+}
+
+void FakeMcp23017_AttachSPI(FakeMcp23017 *part, uint8_t cs_pin) {
+    FakeSPI_Device device = {FakeMcp23017_Select, FakeMcp23017_Transfer, part, cs_pin};
+    FakeSPI_Attach(&device);
+}
@@ -0,0 +1,47 @@
+/*
+ *
+ *  MCP23017 / MCP23S17 Register Model
+ *
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *
+*/
+
+#ifndef _FAKEMCP23017_H
+#define _FAKEMCP23017_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "FakeSdk.h"
+
+// IOCON.BANK = 0 register file with the sequential address pointer, interrupt on change
+// (INTF/INTCAP, cleared by reading GPIO or INTCAP) and, on SPI, the HAEN address match:
+// until HAEN is set a part only answers to A2..A0 = 000. Pins are set from the test,
+// reads return them through IPOL for inputs and OLAT for outputs
+
+typedef struct {
+    uint8_t address;      // Strapped, 0x20-0x27
+    uint8_t regs[0x16];
+    uint16_t pins;        // External levels, AAAA AAAA BBBB BBBB
+    uint8_t pointer;
+    // SPI frame state
+    uint8_t spi_count;
+    bool spi_selected;
+    bool spi_addressed;
+    bool spi_read;
+    // Accounting
+    uint32_t reads;       // Transactions, not bytes
+    uint32_t writes;
+} FakeMcp23017;
+
+void FakeMcp23017_Initialise(FakeMcp23017 *part, uint8_t address);
+void FakeMcp23017_AttachI2C(FakeMcp23017 *part);
+void FakeMcp23017_AttachSPI(FakeMcp23017 *part, uint8_t cs_pin);
+
+// New pin levels, latching INTF/INTCAP for enabled inputs that changed
+void FakeMcp23017_SetPins(FakeMcp23017 *part, uint16_t pins);
+// A/B register pair as the driver sees it, AAAA AAAA BBBB BBBB
+uint16_t FakeMcp23017_Pair(const FakeMcp23017 *part, uint8_t reg_a);
+#endif
@@ -0,0 +1,186 @@
+/*
+ *
+ *  SSD1306 Panel Model
+ *
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *
+*/
+
+#include <string.h>
+#include "FakeSsd1306.h"
+#include "SSD1306_Commands.h"
+
+void FakeSsd1306_Initialise(FakeSsd1306 *panel, uint8_t address) {
+    memset(panel, 0, sizeof(FakeSsd1306));
+    panel->address = address;
+    // Reset values, datasheet section 10
+    panel->memory_mode = SSD1306_MEMORY_MODE_PAGE;
+    panel->column_end = FAKESSD1306_COLUMNS - 1;
+    panel->page_end = FAKESSD1306_PAGES - 1;
+    panel->contrast = 0x7F;
+    panel->multiplex = 63;
+    panel->com_pins = 0x12;
+}
+
+// Argument bytes after each opcode, -1 for an opcode the model doesn't know
+static int FakeSsd1306_Arguments(uint8_t opcode) {
+    if (opcode < 0x20 || (opcode >= 0x40 && opcode <= 0x7F) || (opcode >= 0xB0 && opcode <= 0xB7)) {
+        return 0; // Column nibbles, start line and page start carry their value in the opcode
+    }
+    switch (opcode) {
+    case SSD1306_CMD_RIGHT_HORIZONTAL_SCROLL:
+    case SSD1306_CMD_LEFT_HORIZONTAL_SCROLL:
+        return 6;
+    case SSD1306_CMD_VERTICAL_RIGHT_SCROLL:
+    case SSD1306_CMD_VERTICAL_LEFT_SCROLL:
+        return 5;
+    case SSD1306_CMD_SET_VERTICAL_SCROLL:
+    case SSD1306_CMD_COLUMN_ADDRESS:
+    case SSD1306_CMD_PAGE_ADDRESS:
+        return 2;
+    case SSD1306_CMD_SET_CONTRAST:
+    case SSD1306_CMD_MEMORY_MODE:
+    case SSD1306_CMD_MULTIPLEX_RATIO:
+    case SSD1306_CMD_DISPLAY_OFFSET:
+    case SSD1306_CMD_COM_PINS:
+    case SSD1306_CMD_CLOCK_DIVIDE:
+    case SSD1306_CMD_PRECHARGE:
+    case SSD1306_CMD_VCOMH_DESELECT:
+    case SSD1306_CMD_CHARGE_PUMP:
+        return 1;
+    case SSD1306_CMD_DEACTIVATE_SCROLL:
+    case SSD1306_CMD_ACTIVATE_SCROLL:
+    case SSD1306_CMD_DISPLAY_RAM:
+    case SSD1306_CMD_DISPLAY_ALL_ON:
+    case SSD1306_CMD_NORMAL_DISPLAY:
+    case SSD1306_CMD_INVERT_DISPLAY:
+    case SSD1306_CMD_DISPLAY_OFF:
+    case SSD1306_CMD_DISPLAY_ON:
+    case SSD1306_CMD_SEGMENT_REMAP_0:
+    case SSD1306_CMD_SEGMENT_REMAP_127:
+    case SSD1306_CMD_COM_SCAN_INC:
+    case SSD1306_CMD_COM_SCAN_DEC:
+    case SSD1306_CMD_NOP:
+        return 0;
+    default:
+        return -1;
+    }
+}
+
+static void FakeSsd1306_Command(FakeSsd1306 *panel, const uint8_t *command, uint8_t length) {
+    switch (command[0]) {
+    case SSD1306_CMD_SET_CONTRAST:
+        panel->contrast = command[1];
+        break;
+    case SSD1306_CMD_DISPLAY_ON:
+    case SSD1306_CMD_DISPLAY_OFF:
+        panel->display_on = command[0] == SSD1306_CMD_DISPLAY_ON;
+        break;
+    case SSD1306_CMD_NORMAL_DISPLAY:
+    case SSD1306_CMD_INVERT_DISPLAY:
+        panel->inverted = command[0] == SSD1306_CMD_INVERT_DISPLAY;
+        break;
+    case SSD1306_CMD_DISPLAY_RAM:
+    case SSD1306_CMD_DISPLAY_ALL_ON:
+        panel->all_on = command[0] == SSD1306_CMD_DISPLAY_ALL_ON;
+        break;
+    case SSD1306_CMD_CHARGE_PUMP:
+        panel->charge_pump = command[1] == SSD1306_CHARGE_PUMP_ENABLE;
+        break;
+    case SSD1306_CMD_MULTIPLEX_RATIO:
+        panel->multiplex = command[1];
+        break;
+    case SSD1306_CMD_COM_PINS:
+        panel->com_pins = command[1];
+        break;
+    case SSD1306_CMD_MEMORY_MODE:
+        panel->memory_mode = command[1] & 0x03;
+        break;
+    case SSD1306_CMD_COLUMN_ADDRESS:
+        panel->column_start = panel->column = command[1] & 0x7F;
+        panel->column_end = command[2] & 0x7F;
+        break;
+    case SSD1306_CMD_PAGE_ADDRESS:
+        panel->page_start = panel->page = command[1] & 0x07;
+        panel->page_end = command[2] & 0x07;
+        break;
+    case SSD1306_CMD_ACTIVATE_SCROLL:
+        panel->scrolling = true;
+        break;
+    case SSD1306_CMD_DEACTIVATE_SCROLL:
+        panel->scrolling = false;
+        break;
+    case SSD1306_CMD_RIGHT_HORIZONTAL_SCROLL:
+    case SSD1306_CMD_LEFT_HORIZONTAL_SCROLL:
+    case SSD1306_CMD_VERTICAL_RIGHT_SCROLL:
+    case SSD1306_CMD_VERTICAL_LEFT_SCROLL:
+        // Only takes effect while scrolling is deactivated, datasheet 10.2.1
+        if (panel->scrolling) {
+            panel->malformed++;
+        }
+        memcpy(panel->scroll_setup, command, length);
+        panel->scroll_setup_length = length;
+        break;
+    default:
+        break;
+    }
+}
+
+// Horizontal addressing: column wraps within the window onto the next page
+static void FakeSsd1306_Data(FakeSsd1306 *panel, uint8_t value) {
+    panel->gddram[panel->page * FAKESSD1306_COLUMNS + panel->column] = value;
+    if (panel->memory_mode != SSD1306_MEMORY_MODE_HORIZONTAL) {
+        panel->column = (panel->column + 1) & 0x7F;
+        return;
+    }
+    if (panel->column++ == panel->column_end) {
+        panel->column = panel->column_start;
+        panel->page = panel->page == panel->page_end ? panel->page_start : panel->page + 1;
+    }
+}
+
+static bool FakeSsd1306_I2CWrite(void *context, const uint8_t *data, size_t length) {
+    FakeSsd1306 *panel = (FakeSsd1306 *)context;
+    if (length == 0) {
+        return true; // Probe
+    }
+    if (data[0] == SSD1306_CONTROL_DATA) {
+        panel->data_transfers++;
+        panel->data_bytes += length - 1;
+        for (size_t i = 1; i < length; i++) {
+            FakeSsd1306_Data(panel, data[i]);
+        }
+        return true;
+    }
+    if (data[0] != SSD1306_CONTROL_COMMAND) {
+        panel->malformed++;
+        return true;
+    }
+    panel->command_transfers++;
+    size_t i = 1;
+    while (i < length) {
+        int arguments = FakeSsd1306_Arguments(data[i]);
+        if (arguments < 0 || i + arguments >= length) {
+            panel->malformed++;
+            return true;
+        }
+        FakeSsd1306_Command(panel, &data[i], arguments + 1);
+        i += arguments + 1;
+    }
+    return true;
+}
+
+static bool FakeSsd1306_I2CRead(void *context, uint8_t *data, size_t length) {
+    // Status byte, D6 set while the display is off
+    FakeSsd1306 *panel = (FakeSsd1306 *)context;
+    memset(data, panel->display_on ? 0x00 : 0x40, length);
+    return true;
+}
+
+void FakeSsd1306_AttachI2C(FakeSsd1306 *panel) {
+    FakeI2C_Device device = {FakeSsd1306_I2CWrite, FakeSsd1306_I2CRead, panel};
+    FakeI2C_Attach(panel->address, &device);
+}
@@ -0,0 +1,56 @@
+/*
+ *
+ *  SSD1306 Panel Model
+ *
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *
+*/
+
+#ifndef _FAKESSD1306_H
+#define _FAKESSD1306_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "FakeSdk.h"
+
+// Parses the command stream after each control byte and keeps GDDRAM, written through the
+// horizontal addressing window. A command cut off by the end of a transaction, or an
+// opcode the model doesn't know, is counted as malformed rather than guessed at
+
+#define FAKESSD1306_COLUMNS 128
+#define FAKESSD1306_PAGES   8
+
+typedef struct {
+    uint8_t address;
+    uint8_t gddram[FAKESSD1306_PAGES * FAKESSD1306_COLUMNS]; // [page * 128 + column]
+
+    // Addressing
+    uint8_t memory_mode;
+    uint8_t column_start, column_end, column;
+    uint8_t page_start, page_end, page;
+
+    // Display state
+    bool display_on;
+    bool inverted;
+    bool all_on;
+    bool charge_pump;
+    bool scrolling;
+    uint8_t contrast;
+    uint8_t multiplex;   // Rows - 1
+    uint8_t com_pins;
+    uint8_t scroll_setup[7]; // Last scroll setup command as sent
+    uint8_t scroll_setup_length;
+
+    // Accounting
+    uint32_t command_transfers;
+    uint32_t data_transfers;
+    uint32_t data_bytes;
+    uint32_t malformed;
+} FakeSsd1306;
+
+void FakeSsd1306_Initialise(FakeSsd1306 *panel, uint8_t address);
+void FakeSsd1306_AttachI2C(FakeSsd1306 *panel);
+#endif
@@ -0,0 +1,671 @@
+/*
+ *
+ *  FAT Filesystem and Sector Cache Tests
+ *
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *
+*/
+
+// The cache's LRU and write back against a counting block device, then the filesystem
+// against FAT16 and FAT32 disk images built here: mounting, listing, long names, paths,
+// streamed reads checked byte for byte, corrupt chains and read errors
+
+#include <stdlib.h>
+#include <string.h>
+#include "Test.h"
+#include "Fat.h"
+
+#define SECTOR BLOCKDEVICE_SECTOR_SIZE
+
+// Block device over memory, counting what was asked of it
+typedef struct {
+    uint8_t *data;
+    uint32_t reads;
+    uint32_t multi_reads;   // Reads of more than one sector
+    uint32_t largest_read;
+    uint32_t writes;
+    int32_t fail_reads_after; // Reads left before they start failing, -1 never
+} Disk;
+
+static int disk_read(void *context, uint32_t lba, uint8_t *data, uint32_t count) {
+    Disk *disk = (Disk *)context;
+    if (disk->fail_reads_after == 0) {
+        return -1;
+    }
+    if (disk->fail_reads_after > 0) {
+        disk->fail_reads_after--;
+    }
+    disk->reads++;
+    disk->multi_reads += count > 1;
+    if (count > disk->largest_read) {
+        disk->largest_read = count;
+    }
+    memcpy(data, disk->data + lba * SECTOR, count * SECTOR);
+    return 0;
+}
+
+static int disk_write(void *context, uint32_t lba, const uint8_t *data, uint32_t count) {
+    Disk *disk = (Disk *)context;
+    disk->writes++;
+    memcpy(disk->data + lba * SECTOR, data, count * SECTOR);
+    return 0;
+}
+
+static Disk disk;
+static BlockDevice device;
+static SectorCache cache;
+
+static void attach(uint8_t *data, uint32_t sectors, bool writable) {
+    memset(&disk, 0, sizeof(disk));
+    disk.data = data;
+    disk.fail_reads_after = -1;
+    device.context = &disk;
+    device.read = disk_read;
+    device.write = writable ? disk_write : NULL;
+    device.sector_count = sectors;
+    SectorCache_Initialise(&cache, &device);
+}
+
+static void test_cache_lru(void) {
+    static uint8_t data[16 * SECTOR];
+    for (uint32_t i = 0; i < sizeof(data); i++) {
+        data[i] = i / SECTOR;
+    }
+    attach(data, 16, true);
+    uint8_t *sector;
+    for (uint8_t lba = 0; lba < SECTORCACHE_ENTRIES; lba++) {
+        TEST_EQUAL(SectorCache_Get(&cache, lba, false, &sector), 0);
+        TEST_EQUAL(sector[0], lba);
+    }
+    TEST_EQUAL(cache.misses, SECTORCACHE_ENTRIES);
+    // Use 0 again, so 1 is now the oldest
+    SectorCache_Get(&cache, 0, false, &sector);
+    TEST_EQUAL(cache.hits, 1);
+    SectorCache_Get(&cache, 9, false, &sector);
+    TEST_EQUAL(sector[0], 9);
+    TEST_EQUAL(disk.reads, SECTORCACHE_ENTRIES + 1);
+    SectorCache_Get(&cache, 0, false, &sector);
+    TEST_EQUAL(disk.reads, SECTORCACHE_ENTRIES + 1);
+    SectorCache_Get(&cache, 1, false, &sector);
+    TEST_EQUAL(disk.reads, SECTORCACHE_ENTRIES + 2);
+    // Nothing dirty, nothing written
+    TEST_EQUAL(disk.writes, 0);
+    TEST_EQUAL(SectorCache_Flush(&cache), 0);
+    TEST_EQUAL(disk.writes, 0);
+}
+
+static void test_cache_write_back(void) {
+    static uint8_t data[16 * SECTOR];
+    static uint8_t direct[4 * SECTOR];
+    memset(data, 0, sizeof(data));
+    attach(data, 16, true);
+    uint8_t *sector;
+    SectorCache_Get(&cache, 5, true, &sector);
+    sector[0] = 0xA5;
+    // Only on the device once evicted
+    TEST_EQUAL(data[5 * SECTOR], 0);
+    for (uint8_t lba = 10; lba < 10 + SECTORCACHE_ENTRIES - 1; lba++) {
+        SectorCache_Get(&cache, lba, false, &sector);
+    }
+    TEST_EQUAL(disk.writes, 0);
+    SectorCache_Get(&cache, 15, false, &sector);
+    TEST_EQUAL(disk.writes, 1);
+    TEST_EQUAL(cache.writebacks, 1);
+    TEST_EQUAL(data[5 * SECTOR], 0xA5);
+
+    // A direct read sees what's still only in the cache
+    SectorCache_Get(&cache, 2, true, &sector);
+    sector[1] = 0x5A;
+    TEST_EQUAL(SectorCache_ReadDirect(&cache, 1, direct, 4), 0);
+    TEST_EQUAL(direct[SECTOR + 1], 0x5A);
+    TEST_EQUAL(disk.writes, 2);
+    // Outside the range it stays dirty
+    SectorCache_Get(&cache, 8, true, &sector);
+    sector[0] = 1;
+    SectorCache_ReadDirect(&cache, 9, direct, 4);
+    TEST_EQUAL(disk.writes, 2);
+    TEST_EQUAL(SectorCache_Flush(&cache), 0);
+    TEST_EQUAL(disk.writes, 3);
+    TEST_EQUAL(data[8 * SECTOR], 1);
+
+    // Invalidated changes are gone, and the next get reads the device again
+    SectorCache_Get(&cache, 8, true, &sector);
+    sector[0] = 2;
+    SectorCache_Invalidate(&cache);
+    TEST_EQUAL(SectorCache_Flush(&cache), 0);
+    uint32_t reads = disk.reads;
+    SectorCache_Get(&cache, 8, false, &sector);
+    TEST_EQUAL(sector[0], 1);
+    TEST_EQUAL(disk.reads, reads + 1);
+}
+
+static void test_cache_errors(void) {
+    static uint8_t data[16 * SECTOR];
+    uint8_t *sector;
+    // Read only device: dirty sectors can't be written back
+    attach(data, 16, false);
+    SectorCache_Get(&cache, 0, true, &sector);
+    TEST_CHECK(SectorCache_Flush(&cache) < 0);
+    // Failed reads are passed on and don't leave a valid entry behind
+    attach(data, 16, true);
+    disk.fail_reads_after = 0;
+    TEST_CHECK(SectorCache_Get(&cache, 3, false, &sector) < 0);
+    disk.fail_reads_after = -1;
+    TEST_EQUAL(SectorCache_Get(&cache, 3, false, &sector), 0);
+    TEST_EQUAL(cache.hits, 0);
+}
+
+// FAT image builder. Only the first FAT is read, both copies are written as a formatter would
+static struct {
+    uint8_t *data;
+    uint32_t sectors;
+    Fat_Type type;
+    uint8_t sectors_per_cluster;
+    uint32_t fat_lba;
+    uint32_t fat_size;
+    uint32_t root_lba;
+    uint32_t root_entries;
+    uint32_t data_lba;
+    uint32_t clusters;
+    uint32_t next_cluster;
+} image;
+
+typedef struct {
+    uint32_t first_cluster; // 0 for the FAT16 root
+    uint32_t last_cluster;
+    uint32_t count;
+} ImageDir;
+
+static void put16(uint8_t *p, uint16_t value) {
+    p[0] = value;
+    p[1] = value >> 8;
+}
+
+static void put32(uint8_t *p, uint32_t value) {
+    put16(p, value);
+    put16(p + 2, value >> 16);
+}
+
+static uint32_t end_of_chain(void) {
+    return image.type == FAT_TYPE_16 ? 0xFFFF : 0x0FFFFFFF;
+}
+
+static void set_fat(uint32_t cluster, uint32_t value) {
+    for (uint8_t copy = 0; copy < 2; copy++) {
+        uint8_t *fat = image.data + (image.fat_lba + copy * image.fat_size) * SECTOR;
+        if (image.type == FAT_TYPE_16) {
+            put16(fat + cluster * 2, value);
+        }
+        else {
+            put32(fat + cluster * 4, value);
+        }
+    }
+}
+
+static uint8_t *cluster_data(uint32_t cluster) {
+    return image.data + (image.data_lba + (cluster - 2) * image.sectors_per_cluster) * SECTOR;
+}
+
+// <count> clusters chained, <gap> free clusters left between each. Returns the first, 0 for none
+static uint32_t allocate_chain(uint32_t count, uint32_t gap) {
+    uint32_t first = 0;
+    uint32_t previous = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t cluster = image.next_cluster;
+        image.next_cluster += 1 + gap;
+        if (previous) {
+            set_fat(previous, cluster);
+        }
+        else {
+            first = cluster;
+        }
+        set_fat(cluster, end_of_chain());
+        previous = cluster;
+    }
+    return first;
+}
+
+// A volume of <clusters> clusters, at LBA 2048 behind an MBR or at 0 without one
+static void format(Fat_Type type, bool partitioned, uint8_t sectors_per_cluster, uint32_t clusters) {
+    uint32_t start = partitioned ? 2048 : 0;
+    uint32_t reserved = type == FAT_TYPE_32 ? 32 : 4;
+    image.type = type;
+    image.sectors_per_cluster = sectors_per_cluster;
+    image.clusters = clusters;
+    image.root_entries = type == FAT_TYPE_16 ? 512 : 0;
+    image.fat_size = ((clusters + 2) * (type / 8) + SECTOR - 1) / SECTOR;
+    image.fat_lba = start + reserved;
+    image.root_lba = image.fat_lba + 2 * image.fat_size;
+    image.data_lba = image.root_lba + image.root_entries * 32 / SECTOR;
+    uint32_t total = image.data_lba - start + clusters * sectors_per_cluster;
+    image.sectors = start + total;
+    free(image.data);
+    image.data = calloc(image.sectors, SECTOR);
+
+    uint8_t *boot = image.data + start * SECTOR;
+    boot[0] = 0xEB;
+    boot[1] = 0x58;
+    boot[2] = 0x90;
+    memcpy(boot + 3, "MSWIN4.1", 8);
+    put16(boot + 11, SECTOR);
+    boot[13] = sectors_per_cluster;
+    put16(boot + 14, reserved);
+    boot[16] = 2;
+    put16(boot + 17, image.root_entries);
+    if (total < 0x10000) {
+        put16(boot + 19, total);
+    }
+    else {
+        put32(boot + 32, total);
+    }
+    boot[21] = 0xF8;
+    if (type == FAT_TYPE_16) {
+        put16(boot + 22, image.fat_size);
+    }
+    else {
+        put32(boot + 36, image.fat_size);
+        put32(boot + 44, 2);
+    }
+    boot[510] = 0x55;
+    boot[511] = 0xAA;
+
+    if (partitioned) {
+        uint8_t *partition = image.data + 0x1BE;
+        partition[4] = type == FAT_TYPE_16 ? 0x06 : 0x0C;
+        put32(partition + 8, start);
+        put32(partition + 12, total);
+        image.data[510] = 0x55;
+        image.data[511] = 0xAA;
+    }
+
+    set_fat(0, 0xFFFFFFF8);
+    set_fat(1, end_of_chain());
+    image.next_cluster = 2;
+    if (type == FAT_TYPE_32) {
+        allocate_chain(1, 0); // Root directory
+    }
+}
+
+static ImageDir root_dir(void) {
+    ImageDir dir = {0, 0, 0};
+    if (image.type == FAT_TYPE_32) {
+        dir.first_cluster = dir.last_cluster = 2;
+    }
+    return dir;
+}
+
+// The next free 32 byte entry, growing a cluster chained directory as it fills
+static uint8_t *dir_slot(ImageDir *dir) {
+    uint32_t index = dir->count++;
+    if (dir->first_cluster == 0) {
+        return image.data + image.root_lba * SECTOR + index * 32;
+    }
+    uint32_t per_cluster = image.sectors_per_cluster * SECTOR / 32;
+    if (index > 0 && index % per_cluster == 0) {
+        uint32_t next = allocate_chain(1, 0);
+        set_fat(dir->last_cluster, next);
+        dir->last_cluster = next;
+    }
+    return cluster_data(dir->last_cluster) + (index % per_cluster) * 32;
+}
+
+static uint8_t checksum(const char *short_name) {
+    uint8_t sum = 0;
+    for (uint8_t i = 0; i < 11; i++) {
+        sum = ((sum & 1) << 7) + (sum >> 1) + (uint8_t)short_name[i];
+    }
+    return sum;
+}
+
+// Long name parts (if any, last part first) then the short entry. <short_name> is the raw
+// 11 characters, space padded
+static void add_entry(ImageDir *dir, const char *long_name, const char *short_name, uint8_t attributes, uint32_t cluster, uint32_t size) {
+    static const uint8_t offsets[13] = {1, 3, 5, 7, 9, 14, 16, 18, 20, 22, 24, 28, 30};
+    if (long_name) {
+        uint32_t length = strlen(long_name);
+        uint8_t parts = (length + 12) / 13;
+        for (uint8_t sequence = parts; sequence >= 1; sequence--) {
+            uint8_t *raw = dir_slot(dir);
+            raw[0] = sequence | (sequence == parts ? 0x40 : 0);
+            raw[11] = FAT_ATTRIBUTE_LONG_NAME;
+            raw[13] = checksum(short_name);
+            for (uint8_t i = 0; i < 13; i++) {
+                uint32_t position = (sequence - 1) * 13 + i;
+                put16(raw + offsets[i], position < length ? (uint8_t)long_name[position] : position == length ? 0x0000 : 0xFFFF);
+            }
+        }
+    }
+    uint8_t *raw = dir_slot(dir);
+    memcpy(raw, short_name, 11);
+    raw[11] = attributes;
+    put16(raw + 20, cluster >> 16);
+    put16(raw + 26, cluster);
+    put32(raw + 28, size);
+}
+
+static uint8_t pattern(uint32_t seed, uint32_t offset) {
+    return (offset * 131 + (offset >> 9) * 7 + seed) ^ (offset >> 13);
+}
+
+// A file of pattern bytes over a chain with <gap> free clusters between its clusters
+static uint32_t add_file(ImageDir *dir, const char *long_name, const char *short_name, uint32_t size, uint32_t gap, uint32_t seed) {
+    uint32_t cluster_bytes = image.sectors_per_cluster * SECTOR;
+    uint32_t first = allocate_chain((size + cluster_bytes - 1) / cluster_bytes, gap);
+    uint32_t cluster = first;
+    for (uint32_t offset = 0; offset < size; offset++) {
+        if (offset && offset % cluster_bytes == 0) {
+            cluster += 1 + gap;
+        }
+        cluster_data(cluster)[offset % cluster_bytes] = pattern(seed, offset);
+    }
+    add_entry(dir, long_name, short_name, FAT_ATTRIBUTE_ARCHIVE, first, size);
+    return first;
+}
+
+static ImageDir add_dir(ImageDir *parent, const char *long_name, const char *short_name) {
+    ImageDir dir = {allocate_chain(1, 0), 0, 0};
+    dir.last_cluster = dir.first_cluster;
+    add_entry(&dir, NULL, ".          ", FAT_ATTRIBUTE_DIRECTORY, dir.first_cluster, 0);
+    add_entry(&dir, NULL, "..         ", FAT_ATTRIBUTE_DIRECTORY, parent->first_cluster, 0);
+    add_entry(parent, long_name, short_name, FAT_ATTRIBUTE_DIRECTORY, dir.first_cluster, 0);
+    return dir;
+}
+
+#define LONG_NAME "A file name well past the sixty three characters a directory entry keeps.txt"
+#define MANY_FILES 40
+
+typedef struct {
+    const char *path;
+    uint32_t size;
+    uint32_t seed;
+} ImageFile;
+
+// Every file build_tree() makes, by path
+static const ImageFile files[] = {
+    {"README.TXT", 1000, 1},
+    {"/Animations/boot.mpa", 70000, 2},
+    {"animations/FRAGMENTED.MPA", 40000, 3},
+    {"ANIMAT~1/Nested/deep.bin", 5000, 4},
+    {"empty.txt", 0, 5},
+    {"BADLFN.TXT", 300, 6},
+};
+
+// The same tree on every image. Root: a volume label, README.TXT, a deleted entry,
+// Animations/, empty.txt, and BADLFN.TXT behind a long name whose checksum is wrong
+static uint32_t build_tree(void) {
+    ImageDir root = root_dir();
+    add_entry(&root, NULL, "MACROPAD   ", FAT_ATTRIBUTE_VOLUME_ID, 0, 0);
+    uint32_t readme = add_file(&root, NULL, "README  TXT", 1000, 0, 1);
+    uint8_t *deleted = dir_slot(&root);
+    memcpy(deleted, "\xE5OLD    TXT", 11);
+    ImageDir animations = add_dir(&root, "Animations", "ANIMAT~1   ");
+    add_file(&animations, "boot.mpa", "BOOT    MPA", 70000, 0, 2);
+    add_file(&animations, "fragmented.mpa", "FRAGME~1MPA", 40000, 1, 3);
+    for (uint8_t i = 0; i < MANY_FILES; i++) {
+        char name[24];
+        char short_name[12];
+        snprintf(name, sizeof(name), "frame %02u.pbm", i);
+        snprintf(short_name, sizeof(short_name), "FRAME~%02uPBM", i);
+        add_file(&animations, name, short_name, 10 + i, 0, 100 + i);
+    }
+    add_file(&animations, LONG_NAME, "AFILEN~1TXT", 1, 0, 7);
+    ImageDir nested = add_dir(&animations, "Nested", "NESTED     ");
+    add_file(&nested, "deep.bin", "DEEP    BIN", 5000, 2, 4);
+    add_file(&root, "empty.txt", "EMPTY   TXT", 0, 0, 5);
+    // A long name whose checksum is for some other short entry
+    add_file(&root, "stale name.txt", "BADLFN  TXT", 300, 0, 6);
+    for (uint8_t part = 2; part <= 3; part++) {
+        uint32_t index = root.count - part;
+        uint8_t *raw = root.first_cluster ? cluster_data(root.first_cluster) : image.data + image.root_lba * SECTOR;
+        raw[index * 32 + 13] ^= 0x01;
+    }
+    return readme;
+}
+
+static Fat_Volume volume;
+
+static bool mount_image(void) {
+    attach(image.data, image.sectors, false);
+    int result = Fat_Mount(&volume, &cache);
+    TEST_EQUAL(result, FAT_OK);
+    return result == FAT_OK;
+}
+
+static void check_volume(void) {
+    TEST_EQUAL(volume.type, image.type);
+    TEST_EQUAL(volume.sectors_per_cluster, image.sectors_per_cluster);
+    TEST_EQUAL(volume.cluster_count, image.clusters);
+    TEST_EQUAL(volume.fat_lba, image.fat_lba);
+    TEST_EQUAL(volume.data_lba, image.data_lba);
+}
+
+static void check_listing(void) {
+    Fat_Dir dir;
+    Fat_DirEntry entry;
+    TEST_EQUAL(Fat_OpenDir(&volume, &dir, "/"), FAT_OK);
+    // Label, deleted entry and the orphaned long name part skipped
+    const char *names[] = {"README.TXT", "Animations", "empty.txt", "BADLFN.TXT"};
+    for (uint8_t i = 0; i < 4; i++) {
+        TEST_EQUAL(Fat_ReadDir(&dir, &entry), 1);
+        TEST_CHECK(strcmp(entry.name, names[i]) == 0);
+    }
+    TEST_EQUAL(Fat_ReadDir(&dir, &entry), 0);
+    TEST_EQUAL(Fat_ReadDir(&dir, &entry), 0);
+
+    // Spread over several clusters, . and .. skipped
+    TEST_EQUAL(Fat_OpenDir(&volume, &dir, "Animations"), FAT_OK);
+    uint32_t count = 0;
+    bool in_order = true;
+    while (Fat_ReadDir(&dir, &entry) == 1) {
+        if (count >= 2 && count < 2 + MANY_FILES) {
+            char name[24];
+            snprintf(name, sizeof(name), "frame %02u.pbm", count - 2);
+            in_order &= strcmp(entry.name, name) == 0 && entry.size == 10 + count - 2;
+        }
+        if (count == 2 + MANY_FILES) {
+            // Truncated to what fits
+            TEST_EQUAL(strlen(entry.name), FAT_MAX_NAME - 1);
+            TEST_EQUAL(strncmp(entry.name, LONG_NAME, FAT_MAX_NAME - 1), 0);
+            TEST_CHECK(strcmp(entry.short_name, "AFILEN~1.TXT") == 0);
+        }
+        if (count == 3 + MANY_FILES) {
+            TEST_CHECK(strcmp(entry.name, "Nested") == 0);
+            TEST_CHECK(entry.attributes & FAT_ATTRIBUTE_DIRECTORY);
+        }
+        count++;
+    }
+    TEST_CHECK(in_order);
+    TEST_EQUAL(count, 4 + MANY_FILES);
+}
+
+static void check_lookup(void) {
+    Fat_File file;
+    Fat_Dir dir;
+    TEST_EQUAL(Fat_Open(&volume, &file, "ANIMATIONS/BOOT.MPA"), FAT_OK);
+    TEST_EQUAL(Fat_Open(&volume, &file, "//animations//frame 07.pbm"), FAT_OK);
+    TEST_EQUAL(file.size, 17);
+    TEST_EQUAL(Fat_Open(&volume, &file, "ANIMAT~1/FRAME~07.PBM"), FAT_OK);
+    TEST_EQUAL(Fat_Open(&volume, &file, "Animations/frame 7.pbm"), FAT_ERROR_NOT_FOUND);
+    TEST_EQUAL(Fat_Open(&volume, &file, "missing/boot.mpa"), FAT_ERROR_NOT_FOUND);
+    TEST_EQUAL(Fat_Open(&volume, &file, "Animations"), FAT_ERROR_NOT_A_FILE);
+    TEST_EQUAL(Fat_Open(&volume, &file, "README.TXT/x"), FAT_ERROR_NOT_A_DIRECTORY);
+    TEST_EQUAL(Fat_OpenDir(&volume, &dir, "README.TXT"), FAT_ERROR_NOT_A_DIRECTORY);
+    // The stale long name isn't a name for anything
+    TEST_EQUAL(Fat_Open(&volume, &file, "stale name.txt"), FAT_ERROR_NOT_FOUND);
+    // Nor is the label
+    TEST_EQUAL(Fat_Open(&volume, &file, "MACROPAD"), FAT_ERROR_NOT_FOUND);
+}
+
+// Every file read through in random chunks with random seeks, against the bytes written
+static void check_reads(void) {
+    static uint8_t buffer[8192];
+    for (uint8_t f = 0; f < sizeof(files) / sizeof(files[0]); f++) {
+        Fat_File file;
+        TEST_EQUAL(Fat_Open(&volume, &file, files[f].path), FAT_OK);
+        TEST_EQUAL(file.size, files[f].size);
+        for (uint16_t round = 0; round < 200; round++) {
+            uint32_t position = round == 0 ? 0 : rand() % (file.size + 1);
+            uint32_t length = rand() % 4 == 0 ? rand() % sizeof(buffer) : rand() % 700;
+            TEST_EQUAL(Fat_Seek(&file, position), FAT_OK);
+            int32_t expected = length < file.size - position ? length : file.size - position;
+            int32_t got = Fat_Read(&file, buffer, length);
+            TEST_EQUAL(got, expected);
+            bool same = true;
+            for (int32_t i = 0; i < got; i++) {
+                same &= buffer[i] == pattern(files[f].seed, position + i);
+            }
+            if (!same) {
+                fprintf(stderr, "  %s differs reading %u at %u\n", files[f].path, length, position);
+                TEST_CHECK(same);
+                return;
+            }
+            TEST_EQUAL(file.position, position + got);
+        }
+        TEST_EQUAL(Fat_Seek(&file, file.size + 1), FAT_ERROR_INVALID_ARG);
+        Fat_Seek(&file, file.size);
+        TEST_EQUAL(Fat_Read(&file, buffer, 10), 0);
+    }
+}
+
+static void check_multi_block(void) {
+    static uint8_t buffer[70000];
+    Fat_File file;
+    Fat_Open(&volume, &file, "Animations/boot.mpa");
+    disk.multi_reads = 0;
+    disk.largest_read = 0;
+    // A contiguous file's whole sectors come in one transfer, the tail through the cache
+    TEST_EQUAL(Fat_Read(&file, buffer, sizeof(buffer)), 70000);
+    TEST_EQUAL(disk.multi_reads, 1);
+    TEST_EQUAL(disk.largest_read, 70000 / SECTOR);
+
+    // Fragmented, one transfer per cluster
+    Fat_Open(&volume, &file, "Animations/fragmented.mpa");
+    disk.multi_reads = 0;
+    disk.largest_read = 0;
+    Fat_Read(&file, buffer, 40000);
+    TEST_EQUAL(disk.largest_read, image.sectors_per_cluster);
+}
+
+static void test_images(void) {
+    const struct {
+        Fat_Type type;
+        bool partitioned;
+        uint8_t sectors_per_cluster;
+        uint32_t clusters;
+    } images[] = {
+        {FAT_TYPE_16, false, 1, 4085},
+        {FAT_TYPE_16, true, 4, 20000},
+        {FAT_TYPE_32, true, 1, 65525},
+        {FAT_TYPE_32, false, 2, 66000},
+    };
+    srand(35);
+    for (uint8_t i = 0; i < sizeof(images) / sizeof(images[0]); i++) {
+        format(images[i].type, images[i].partitioned, images[i].sectors_per_cluster, images[i].clusters);
+        build_tree();
+        if (!mount_image()) {
+            continue;
+        }
+        check_volume();
+        check_listing();
+        check_lookup();
+        check_reads();
+        check_multi_block();
+        // Read only throughout
+        TEST_EQUAL(disk.writes, 0);
+    }
+}
+
+static void test_not_mounted(void) {
+    // Blank
+    format(FAT_TYPE_16, false, 1, 5000);
+    memset(image.data, 0, SECTOR);
+    attach(image.data, image.sectors, false);
+    TEST_EQUAL(Fat_Mount(&volume, &cache), FAT_ERROR_NO_FILESYSTEM);
+    // FAT12 sized, whatever else it says
+    format(FAT_TYPE_16, false, 1, 4084);
+    attach(image.data, image.sectors, false);
+    TEST_EQUAL(Fat_Mount(&volume, &cache), FAT_ERROR_NO_FILESYSTEM);
+    // A partition that isn't FAT
+    format(FAT_TYPE_16, true, 1, 5000);
+    image.data[0x1BE + 4] = 0x83;
+    attach(image.data, image.sectors, false);
+    TEST_EQUAL(Fat_Mount(&volume, &cache), FAT_ERROR_NO_FILESYSTEM);
+    // A FAT partition with no boot sector in it
+    image.data[0x1BE + 4] = 0x06;
+    memset(image.data + 2048 * SECTOR, 0, SECTOR);
+    attach(image.data, image.sectors, false);
+    TEST_EQUAL(Fat_Mount(&volume, &cache), FAT_ERROR_NO_FILESYSTEM);
+    // Can't read it at all
+    format(FAT_TYPE_16, false, 1, 5000);
+    attach(image.data, image.sectors, false);
+    disk.fail_reads_after = 0;
+    TEST_EQUAL(Fat_Mount(&volume, &cache), FAT_ERROR_IO);
+}
+
+static void test_corrupt(void) {
+    static uint8_t buffer[1000];
+    Fat_File file;
+    format(FAT_TYPE_16, false, 1, 5000);
+    uint32_t readme = build_tree();
+    // Chain ends a cluster short of the size
+    set_fat(readme, end_of_chain());
+    mount_image();
+    TEST_EQUAL(Fat_Open(&volume, &file, "README.TXT"), FAT_OK);
+    TEST_EQUAL(Fat_Read(&file, buffer, 400), 400);
+    TEST_EQUAL(Fat_Read(&file, buffer, 600), FAT_ERROR_CORRUPT);
+    // Into a reserved cluster, and off the end of the volume
+    set_fat(readme, 1);
+    mount_image();
+    Fat_Open(&volume, &file, "README.TXT");
+    TEST_EQUAL(Fat_Read(&file, buffer, 1000), FAT_ERROR_CORRUPT);
+    set_fat(readme, image.clusters + 2);
+    mount_image();
+    Fat_Open(&volume, &file, "README.TXT");
+    TEST_EQUAL(Fat_Read(&file, buffer, 1000), FAT_ERROR_CORRUPT);
+
+    // Read errors part way through
+    set_fat(readme, readme + 1);
+    mount_image();
+    Fat_Open(&volume, &file, "README.TXT");
+    disk.fail_reads_after = 0;
+    TEST_EQUAL(Fat_Read(&file, buffer, 1000), FAT_ERROR_IO);
+    SectorCache_Invalidate(&cache);
+    TEST_EQUAL(Fat_Open(&volume, &file, "Animations/boot.mpa"), FAT_ERROR_IO);
+    disk.fail_reads_after = -1;
+    TEST_EQUAL(Fat_Open(&volume, &file, "Animations/boot.mpa"), FAT_OK);
+}
+
+static void bench_streaming(void) {
+    static uint8_t buffer[4096];
+    const uint16_t chunks[] = {64, 512, 4096};
+    format(FAT_TYPE_16, true, 4, 20000);
+    build_tree();
+    mount_image();
+    // Device transfers to stream the 70000 byte file in each chunk size
+    for (uint8_t i = 0; i < 3; i++) {
+        Fat_File file;
+        Fat_Open(&volume, &file, "Animations/boot.mpa");
+        uint32_t reads = disk.reads;
+        while (Fat_Read(&file, buffer, chunks[i]) > 0) {
+        }
+        char label[40];
+        snprintf(label, sizeof(label), "boot.mpa in %u byte reads", chunks[i]);
+        printf("bench %-32s %5u device reads\n", label, disk.reads - reads);
+    }
+    free(image.data);
+    image.data = NULL;
+}
+
+int main(void) {
+    TEST_RUN(test_cache_lru);
+    TEST_RUN(test_cache_write_back);
+    TEST_RUN(test_cache_errors);
+    TEST_RUN(test_images);
+    TEST_RUN(test_not_mounted);
+    TEST_RUN(test_corrupt);
+    bench_streaming();
+    return TEST_RESULT();
+}
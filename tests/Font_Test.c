@@ -0,0 +1,138 @@
+/*
+ *
+ *  Font Renderer Tests
+ *
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *
+*/
+
+// The page aligned column copy against a pixel by pixel reference over the generated
+// atlas, at every clipping position, then the two timed against each other
+
+#include <string.h>
+#include "Test.h"
+#include "Font.h"
+
+static SSD1306 dev;
+static SSD1306 expected;
+
+static void panel(SSD1306 *panel, uint8_t width, uint8_t height) {
+    memset(panel, 0, sizeof(SSD1306));
+    panel->width = width;
+    panel->height = height;
+    panel->pages = height / SSD1306_PAGE_HEIGHT;
+    // Anything the text doesn't cover must survive
+    memset(panel->buffer, 0xA5, sizeof(panel->buffer));
+}
+
+static void reference_pixel(SSD1306 *panel, int16_t x, int16_t y, bool on) {
+    if (x < 0 || x >= panel->width || y < 0 || y >= panel->pages * SSD1306_PAGE_HEIGHT) {
+        return;
+    }
+    uint8_t *byte = &panel->buffer[(y / 8) * panel->width + x];
+    *byte = on ? *byte | (1 << (y % 8)) : *byte & ~(1 << (y % 8));
+}
+
+// One pixel at a time through the glyph, as a renderer without the page alignment would
+static int16_t reference_string(SSD1306 *panel, const Font *font, int16_t x, uint8_t page, const char *str) {
+    while (*str && x < panel->width) {
+        uint8_t code = (uint8_t)*str++;
+        if (code < font->first_char || code > font->last_char) {
+            code = '?';
+        }
+        const FontGlyph *glyph = &font->glyphs[code - font->first_char];
+        uint8_t advance = glyph->width + font->spacing;
+        for (uint8_t column = 0; column < advance; column++) {
+            for (uint8_t row = 0; row < font->pages * 8; row++) {
+                bool on = false;
+                if (column < glyph->width) {
+                    uint8_t bits = font->bitmap[glyph->offset + (row / 8) * glyph->width + column];
+                    on = bits & (1 << (row % 8));
+                }
+                reference_pixel(panel, x + column, page * 8 + row, on);
+            }
+        }
+        x += advance;
+    }
+    return x;
+}
+
+static void check_against_reference(const Font *font, uint8_t height, const char *str) {
+    for (int16_t x = -40; x <= 132; x++) {
+        for (uint8_t page = 0; page < height / 8; page++) {
+            panel(&dev, 128, height);
+            panel(&expected, 128, height);
+            int16_t end = Font_DrawString(&dev, font, x, page, str);
+            int16_t expected_end = reference_string(&expected, font, x, page, str);
+            TEST_EQUAL(end, expected_end);
+            if (memcmp(dev.buffer, expected.buffer, sizeof(dev.buffer)) != 0) {
+                TEST_CHECK(!"buffer differs from the reference");
+                fprintf(stderr, "  \"%s\" at x %d page %d, %d pages tall\n", str, x, page, height / 8);
+                return;
+            }
+        }
+    }
+}
+
+static void test_blit_matches_reference(void) {
+    const char *text = "Layer 2: Vol+ ~{}";
+    check_against_reference(&Font_Small, 64, text);
+    check_against_reference(&Font_Medium, 64, text);
+    check_against_reference(&Font_Large, 64, text);
+    // Taller glyphs than the panel has pages left are cut at the bottom
+    check_against_reference(&Font_Large, 32, text);
+}
+
+static void test_measure(void) {
+    const char *text = "Mute 100%";
+    panel(&dev, 128, 64);
+    TEST_EQUAL(Font_DrawString(&dev, &Font_Small, 0, 0, text), Font_MeasureString(&Font_Small, text));
+    uint16_t sum = 0;
+    for (const char *c = text; *c; c++) {
+        sum += Font_MeasureChar(&Font_Small, *c);
+    }
+    TEST_EQUAL(Font_MeasureString(&Font_Small, text), sum);
+    // Proportional, an i is narrower than an m
+    TEST_CHECK(Font_MeasureChar(&Font_Medium, 'i') < Font_MeasureChar(&Font_Medium, 'm'));
+    TEST_EQUAL(Font_MeasureChar(&Font_Medium, ' '), 6 + Font_Medium.spacing);
+}
+
+static void test_unknown_character(void) {
+    panel(&dev, 128, 64);
+    panel(&expected, 128, 64);
+    TEST_EQUAL(Font_DrawChar(&dev, &Font_Small, 10, 2, '\x7F'), Font_MeasureChar(&Font_Small, '?'));
+    Font_DrawChar(&expected, &Font_Small, 10, 2, '?');
+    TEST_CHECK(memcmp(dev.buffer, expected.buffer, sizeof(dev.buffer)) == 0);
+}
+
+static void test_off_panel(void) {
+    panel(&dev, 128, 64);
+    panel(&expected, 128, 64);
+    // Entirely left, right and below still advance and touch nothing
+    TEST_EQUAL(Font_DrawChar(&dev, &Font_Small, -20, 0, 'W'), Font_MeasureChar(&Font_Small, 'W'));
+    TEST_EQUAL(Font_DrawChar(&dev, &Font_Small, 128, 0, 'W'), Font_MeasureChar(&Font_Small, 'W'));
+    Font_DrawChar(&dev, &Font_Small, 0, 8, 'W');
+    TEST_CHECK(memcmp(dev.buffer, expected.buffer, sizeof(dev.buffer)) == 0);
+}
+
+static void bench_blit(void) {
+    // A full line of the layer banner, redrawn as the widget would every change
+    const char *text = "Layer 3 Media";
+    uint32_t glyphs = strlen(text);
+    panel(&dev, 128, 64);
+    TEST_BENCH("Font_DrawString medium line", 100000, Font_DrawString(&dev, &Font_Medium, 0, 0, text));
+    TEST_BENCH("per pixel reference", 10000, reference_string(&dev, &Font_Medium, 0, 0, text));
+    printf("      (%u glyphs per line)\n", (unsigned)glyphs);
+}
+
+int main(void) {
+    TEST_RUN(test_blit_matches_reference);
+    TEST_RUN(test_measure);
+    TEST_RUN(test_unknown_character);
+    TEST_RUN(test_off_panel);
+    bench_blit();
+    return TEST_RESULT();
+}
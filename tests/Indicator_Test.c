@@ -0,0 +1,229 @@
+/*
+ *
+ *  Indicator Output Tests
+ *
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *
+*/
+
+// Indicators on two expanders through the same latch write as the firmware, counting bus
+// transactions per flush: one burst per changed port, none for a tick with no net change,
+// and the latch in the register model always matching what was asked for
+
+#include <stdlib.h>
+#include <string.h>
+#include "Test.h"
+#include "FakeSdk.h"
+#include "FakeMcp23017.h"
+#include "MCP23017.h"
+#include "Indicator.h"
+
+#define ADDRESS_0 0x20
+#define ADDRESS_1 0x21
+
+static FakeMcp23017 parts[INDICATOR_MAX_PORTS];
+static I2CBus bus;
+static MCP23017 expanders[INDICATOR_MAX_PORTS];
+static Indicator ind;
+
+// As Macropad.c: a port is an expander, one OLATA/OLATB burst per write
+static int indicator_write(void *context, uint8_t port, uint16_t latch) {
+    return MCP23017_WriteOutputLatch(&expanders[port], latch);
+}
+
+static void setup(void) {
+    FakeSdk_Reset();
+    FakeMcp23017_Initialise(&parts[0], ADDRESS_0);
+    FakeMcp23017_Initialise(&parts[1], ADDRESS_1);
+    FakeMcp23017_AttachI2C(&parts[0]);
+    FakeMcp23017_AttachI2C(&parts[1]);
+    I2CBus_Initialise(&bus, i2c0);
+    I2CBus_Discover(&bus);
+    memset(expanders, 0, sizeof(expanders));
+    for (uint8_t i = 0; i < INDICATOR_MAX_PORTS; i++) {
+        MCP23017_Initialise(&expanders[i], I2CBus_Find(&bus, I2CBUS_DEVICE_MCP23017, i));
+    }
+    Indicator_Initialise(&ind, indicator_write, NULL);
+    Fake_ClearLog();
+}
+
+static uint32_t port_writes(uint8_t address) {
+    return Fake_CountTransfers(FAKE_I2C_WRITE, address);
+}
+
+static uint32_t bus_transactions(void) {
+    return Fake_TransferCount();
+}
+
+static void test_add(void) {
+    setup();
+    TEST_EQUAL(Indicator_Add(&ind, 0, 12), 0);
+    TEST_EQUAL(Indicator_Add(&ind, 0, 3), 1);
+    TEST_EQUAL(Indicator_Add(&ind, 1, 15), 2);
+    TEST_EQUAL(Indicator_Add(&ind, INDICATOR_MAX_PORTS, 0), -1);
+    TEST_EQUAL(Indicator_Add(&ind, 0, 16), -1);
+    TEST_EQUAL(Indicator_PortMask(&ind, 0), (1 << 12) | (1 << 3));
+    TEST_EQUAL(Indicator_PortMask(&ind, 1), 1 << 15);
+    for (uint8_t i = 3; i < INDICATOR_MAX; i++) {
+        TEST_EQUAL(Indicator_Add(&ind, 1, i - 3), i);
+    }
+    TEST_EQUAL(Indicator_Add(&ind, 1, 14), -1);
+    // Ids that don't exist are ignored
+    Indicator_Set(&ind, INDICATOR_MAX, true);
+    TEST_CHECK(!Indicator_Get(&ind, INDICATOR_MAX));
+}
+
+static void test_writes_only_changes(void) {
+    setup();
+    uint8_t layer = Indicator_Add(&ind, 0, 12);
+    uint8_t caps = Indicator_Add(&ind, 0, 13);
+    uint8_t other = Indicator_Add(&ind, 1, 0);
+    // Latches are unknown at first, both ports written even though nothing is lit
+    TEST_EQUAL(Indicator_Flush(&ind), 2);
+    TEST_EQUAL(port_writes(ADDRESS_0), 1);
+    TEST_EQUAL(port_writes(ADDRESS_1), 1);
+    // Each a single burst of the register address then both latches, no read first
+    TEST_EQUAL(Fake_CountTransfers(FAKE_I2C_READ, 0xFF), 0);
+    const Fake_Transfer *transfer = Fake_GetTransfer(0);
+    TEST_EQUAL(transfer->length, 3);
+    TEST_EQUAL(Fake_TransferData(transfer)[0], MCP23017_REG_OLATA);
+
+    // Nothing changed, nothing sent
+    Fake_ClearLog();
+    TEST_EQUAL(Indicator_Flush(&ind), 0);
+    TEST_EQUAL(bus_transactions(), 0);
+
+    // Several changes on one port in a tick are one write, to that port only
+    Indicator_Set(&ind, layer, true);
+    Indicator_Set(&ind, caps, true);
+    Indicator_Set(&ind, caps, false);
+    Indicator_Set(&ind, caps, true);
+    TEST_EQUAL(Indicator_Flush(&ind), 1);
+    TEST_EQUAL(port_writes(ADDRESS_0), 1);
+    TEST_EQUAL(port_writes(ADDRESS_1), 0);
+    TEST_EQUAL(FakeMcp23017_Pair(&parts[0], MCP23017_REG_OLATA), (1 << 12) | (1 << 13));
+    TEST_CHECK(Indicator_Get(&ind, caps));
+
+    // Set and put back within a tick: no net change, no write
+    Fake_ClearLog();
+    Indicator_Set(&ind, layer, false);
+    Indicator_Set(&ind, other, true);
+    Indicator_Set(&ind, layer, true);
+    Indicator_Set(&ind, other, false);
+    TEST_EQUAL(Indicator_Flush(&ind), 0);
+    TEST_EQUAL(bus_transactions(), 0);
+    TEST_EQUAL(ind.flushes, 4);
+    TEST_EQUAL(ind.writes, 3);
+}
+
+static void test_enable_and_retry(void) {
+    setup();
+    uint8_t layer = Indicator_Add(&ind, 0, 12);
+    uint8_t other = Indicator_Add(&ind, 1, 7);
+    Indicator_Set(&ind, layer, true);
+    Indicator_Flush(&ind);
+    Fake_ClearLog();
+
+    // Dark while disabled, only the port with something lit is written
+    Indicator_SetEnabled(&ind, false);
+    TEST_EQUAL(Indicator_Flush(&ind), 1);
+    TEST_EQUAL(FakeMcp23017_Pair(&parts[0], MCP23017_REG_OLATA), 0);
+    // Changes while dark are kept but cost nothing
+    Indicator_Set(&ind, other, true);
+    TEST_EQUAL(Indicator_Flush(&ind), 0);
+    TEST_CHECK(Indicator_Get(&ind, other));
+    Indicator_SetEnabled(&ind, true);
+    TEST_EQUAL(Indicator_Flush(&ind), 2);
+    TEST_EQUAL(FakeMcp23017_Pair(&parts[0], MCP23017_REG_OLATA), 1 << 12);
+    TEST_EQUAL(FakeMcp23017_Pair(&parts[1], MCP23017_REG_OLATA), 1 << 7);
+
+    // A NAKed write is reported, counted and retried next tick, the other port still goes
+    Indicator_Set(&ind, layer, false);
+    Indicator_Set(&ind, other, false);
+    FakeI2C_FailNext(1, PICO_ERROR_GENERIC);
+    TEST_EQUAL(Indicator_Flush(&ind), PICO_ERROR_GENERIC);
+    TEST_EQUAL(ind.errors, 1);
+    TEST_EQUAL(FakeMcp23017_Pair(&parts[0], MCP23017_REG_OLATA), 1 << 12);
+    TEST_EQUAL(FakeMcp23017_Pair(&parts[1], MCP23017_REG_OLATA), 0);
+    Fake_ClearLog();
+    TEST_EQUAL(Indicator_Flush(&ind), 1);
+    TEST_EQUAL(port_writes(ADDRESS_0), 1);
+    TEST_EQUAL(FakeMcp23017_Pair(&parts[0], MCP23017_REG_OLATA), 0);
+
+    // After an expander reset the shadow is written again whether it changed or not
+    parts[0].regs[MCP23017_REG_OLATA] = 0xFF;
+    Indicator_Invalidate(&ind);
+    TEST_EQUAL(Indicator_Flush(&ind), 2);
+    TEST_EQUAL(FakeMcp23017_Pair(&parts[0], MCP23017_REG_OLATA), 0);
+}
+
+// Random sets each tick: a port is written exactly when its wanted latch differs from
+// what it last accepted, and the part always ends up holding the wanted latch
+static void test_random_ticks(void) {
+    setup();
+    for (uint8_t i = 0; i < INDICATOR_MAX; i++) {
+        Indicator_Add(&ind, i % INDICATOR_MAX_PORTS, i / INDICATOR_MAX_PORTS);
+    }
+    Indicator_Flush(&ind);
+    srand(43);
+    uint16_t previous[INDICATOR_MAX_PORTS] = {0, 0};
+    uint32_t expected_writes = 0;
+    Fake_ClearLog();
+    for (uint32_t tick = 0; tick < 5000; tick++) {
+        uint8_t sets = rand() % 4;
+        for (uint8_t i = 0; i < sets; i++) {
+            Indicator_Set(&ind, rand() % INDICATOR_MAX, rand() % 2);
+        }
+        for (uint8_t port = 0; port < INDICATOR_MAX_PORTS; port++) {
+            expected_writes += ind.latch[port] != previous[port];
+            previous[port] = ind.latch[port];
+        }
+        Indicator_Flush(&ind);
+        for (uint8_t port = 0; port < INDICATOR_MAX_PORTS; port++) {
+            if (FakeMcp23017_Pair(&parts[port], MCP23017_REG_OLATA) != ind.latch[port]) {
+                TEST_CHECK(!"latch differs");
+                return;
+            }
+        }
+    }
+    TEST_EQUAL(bus_transactions(), expected_writes);
+}
+
+static void bench_bus_writes(void) {
+    // A typing session: the keymap stage sets the layer indicator every scan, caps lock
+    // toggles now and then, the layer changes now and then
+    setup();
+    uint8_t layer = Indicator_Add(&ind, 0, 12);
+    uint8_t caps = Indicator_Add(&ind, 0, 13);
+    Indicator_Flush(&ind);
+    Fake_ClearLog();
+    uint32_t sets = 0;
+    bool layer_on = false;
+    for (uint32_t tick = 0; tick < 10000; tick++) {
+        if (tick % 700 == 0) {
+            layer_on = !layer_on;
+        }
+        Indicator_Set(&ind, layer, layer_on);
+        sets++;
+        if (tick % 2500 == 1000) {
+            Indicator_Set(&ind, caps, !Indicator_Get(&ind, caps));
+            sets++;
+        }
+        Indicator_Flush(&ind);
+    }
+    printf("bench %-32s %5u bus writes for %u sets\n", "10000 scan ticks", bus_transactions(), sets);
+    // 15 layer changes and 4 caps lock toggles, one of them in the same tick as a layer change
+    TEST_EQUAL(bus_transactions(), 15 + 4 - 1);
+}
+
+int main(void) {
+    TEST_RUN(test_add);
+    TEST_RUN(test_writes_only_changes);
+    TEST_RUN(test_enable_and_retry);
+    TEST_RUN(test_random_ticks);
+    bench_bus_writes();
+    return TEST_RESULT();
+}
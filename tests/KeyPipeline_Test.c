@@ -0,0 +1,240 @@
+/*
+ *
+ *  Key Event Pipeline Tests
+ *
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *
+*/
+
+// Ordering, holding and back pressure through the ring, across the index wrap, then the
+// firmware's stages (combos, keymap, HID) timed per event
+
+#include <string.h>
+#include "Test.h"
+#include "KeyPipeline.h"
+#include "Layout.h"
+#include "HidReport.h"
+
+static KeyPipeline pipe;
+
+typedef struct {
+    uint8_t stage;
+    bool hold;
+    uint32_t seen;
+    uint32_t out_of_order;
+    uint8_t last_key;
+} Stage;
+
+// Each stage checks the one before it has been over the event, then marks it
+static bool mark(void *context, KeyEvent *event) {
+    Stage *s = (Stage *)context;
+    if (s->hold) {
+        return false;
+    }
+    if (event->reserved != s->stage || (s->seen && event->key != (uint8_t)(s->last_key + 1))) {
+        s->out_of_order++;
+    }
+    event->reserved = s->stage + 1;
+    event->keycode = event->key + 100;
+    s->last_key = event->key;
+    s->seen++;
+    return true;
+}
+
+static Stage stages[3];
+static int consumer;
+
+static void setup(uint32_t start_index, uint8_t stage_count) {
+    KeyPipeline_Initialise(&pipe);
+    // Free running indices start anywhere
+    pipe.head = start_index;
+    memset(stages, 0, sizeof(stages));
+    for (uint8_t i = 0; i < stage_count; i++) {
+        stages[i].stage = i;
+        TEST_EQUAL(KeyPipeline_AddStage(&pipe, mark, &stages[i]), i);
+    }
+    consumer = KeyPipeline_AddConsumer(&pipe);
+    TEST_EQUAL(consumer, 0);
+}
+
+// Pushes <count> keys numbered on from <first> and drains them, checking every one arrives
+// once, in order, marked by every stage
+static uint8_t push_and_drain(uint8_t first, uint32_t count, uint8_t stage_count) {
+    uint8_t expected = first;
+    for (uint32_t i = 0; i < count; i++) {
+        TEST_CHECK(KeyPipeline_Push(&pipe, (uint8_t)(first + i), KEYEVENT_PRESS, 0, i));
+    }
+    KeyPipeline_Run(&pipe);
+    KeyEvent *event;
+    while ((event = KeyPipeline_Peek(&pipe, consumer)) != NULL) {
+        TEST_EQUAL(event->key, expected);
+        TEST_EQUAL(event->reserved, stage_count);
+        expected++;
+        KeyPipeline_Release(&pipe, consumer);
+    }
+    TEST_EQUAL((uint8_t)(expected - first), count);
+    return expected;
+}
+
+static void test_order_across_wrap(void) {
+    // Twice round the ring from zero, then across the 32 bit wrap
+    const uint32_t starts[] = {0, UINT32_MAX - 100};
+    for (uint8_t s = 0; s < 2; s++) {
+        setup(starts[s], 3);
+        uint8_t key = 0;
+        for (uint8_t burst = 1; burst <= 20; burst++) {
+            key = push_and_drain(key, burst % 17 + 1, 3);
+            TEST_EQUAL(KeyPipeline_Free(&pipe), KEYPIPELINE_RING_SIZE);
+        }
+        for (uint8_t i = 0; i < 3; i++) {
+            TEST_EQUAL(stages[i].out_of_order, 0);
+        }
+        TEST_EQUAL(pipe.overflows, 0);
+    }
+}
+
+static void test_hold_and_lookahead(void) {
+    setup(0, 2);
+    stages[0].hold = true;
+    for (uint8_t i = 0; i < 5; i++) {
+        KeyPipeline_Push(&pipe, i, KEYEVENT_PRESS, 0, i * 1000);
+    }
+    KeyPipeline_Run(&pipe);
+    // Nothing gets past a held stage
+    TEST_EQUAL(stages[1].seen, 0);
+    TEST_CHECK(KeyPipeline_Peek(&pipe, consumer) == NULL);
+    // The held stage can see what's queued behind it, the next stage can't yet
+    KeyEvent *ahead = KeyPipeline_Lookahead(&pipe, 0, 4);
+    TEST_CHECK(ahead != NULL && ahead->key == 4);
+    TEST_CHECK(KeyPipeline_Lookahead(&pipe, 0, 5) == NULL);
+    TEST_CHECK(KeyPipeline_Lookahead(&pipe, 1, 0) == NULL);
+    // Held events still occupy the ring
+    TEST_EQUAL(KeyPipeline_Free(&pipe), KEYPIPELINE_RING_SIZE - 5);
+
+    stages[0].hold = false;
+    KeyPipeline_Run(&pipe);
+    TEST_EQUAL(stages[1].seen, 5);
+    uint8_t count = 0;
+    while (KeyPipeline_Peek(&pipe, consumer)) {
+        KeyPipeline_Release(&pipe, consumer);
+        count++;
+    }
+    TEST_EQUAL(count, 5);
+}
+
+static void test_back_pressure(void) {
+    setup(0, 1);
+    int slow = KeyPipeline_AddConsumer(&pipe);
+    for (uint32_t i = 0; i < KEYPIPELINE_RING_SIZE; i++) {
+        TEST_CHECK(KeyPipeline_Push(&pipe, (uint8_t)i, KEYEVENT_PRESS, 0, i));
+    }
+    // Full: refused and counted, never overwritten
+    TEST_CHECK(!KeyPipeline_Push(&pipe, 0xEE, KEYEVENT_PRESS, 0, 0));
+    TEST_EQUAL(pipe.overflows, 1);
+    KeyPipeline_Run(&pipe);
+    // The fast consumer reads everything, the slow one still holds the slots
+    while (KeyPipeline_Peek(&pipe, consumer)) {
+        KeyPipeline_Release(&pipe, consumer);
+    }
+    TEST_EQUAL(KeyPipeline_Free(&pipe), 0);
+    KeyEvent *oldest = KeyPipeline_Peek(&pipe, slow);
+    TEST_CHECK(oldest != NULL && oldest->key == 0);
+    KeyPipeline_Release(&pipe, slow);
+    TEST_EQUAL(KeyPipeline_Free(&pipe), 1);
+    TEST_CHECK(KeyPipeline_Push(&pipe, 0x40, KEYEVENT_PRESS, 0, 0));
+    // The first unread one is still intact
+    oldest = KeyPipeline_Peek(&pipe, slow);
+    TEST_CHECK(oldest != NULL && oldest->key == 1);
+
+    // A held stage backs up the producer the same way
+    setup(0, 1);
+    stages[0].hold = true;
+    for (uint32_t i = 0; i < KEYPIPELINE_RING_SIZE; i++) {
+        KeyPipeline_Push(&pipe, (uint8_t)i, KEYEVENT_PRESS, 0, i);
+    }
+    KeyPipeline_Run(&pipe);
+    TEST_CHECK(!KeyPipeline_Push(&pipe, 0, KEYEVENT_PRESS, 0, 0));
+}
+
+static void test_limits(void) {
+    KeyPipeline_Initialise(&pipe);
+    TEST_EQUAL(KeyPipeline_AddStage(&pipe, NULL, NULL), -1);
+    for (uint8_t i = 0; i < KEYPIPELINE_MAX_STAGES; i++) {
+        TEST_EQUAL(KeyPipeline_AddStage(&pipe, mark, &stages[0]), i);
+    }
+    TEST_EQUAL(KeyPipeline_AddStage(&pipe, mark, &stages[0]), -1);
+    for (uint8_t i = 0; i < KEYPIPELINE_MAX_CONSUMERS; i++) {
+        TEST_EQUAL(KeyPipeline_AddConsumer(&pipe), i);
+    }
+    TEST_EQUAL(KeyPipeline_AddConsumer(&pipe), -1);
+}
+
+static bool pass(void *context, KeyEvent *event) {
+    return true;
+}
+
+static Combo combo;
+static Keymap keymap;
+static HidReport hid;
+
+// One scan's worth: an event on a key outside every combo, so nothing waits on the combo
+// window, run through and drained. Returns the reports it made
+static uint32_t firmware_event(uint32_t i) {
+    HidKeyboardReport report;
+    uint32_t reports = 0;
+    uint8_t key = 4 + (i / 2) % 8;
+    KeyPipeline_Push(&pipe, key, (i & 1) ? KEYEVENT_RELEASE : KEYEVENT_PRESS, 0, i * 1000);
+    Combo_SetTime(&combo, i * 1000);
+    KeyPipeline_Run(&pipe);
+    while (KeyPipeline_Peek(&pipe, consumer)) {
+        KeyPipeline_Release(&pipe, consumer);
+    }
+    while (HidReport_Take(&hid, &report, NULL)) {
+        reports++;
+    }
+    return reports;
+}
+
+static void bench_throughput(void) {
+    // Same stages, same order as main()
+    KeyPipeline_Initialise(&pipe);
+    Combo_Initialise(&combo, Layout_DefaultCombos, Layout_DefaultComboCount, COMBO_DEFAULT_WINDOW_US);
+    Keymap_Initialise(&keymap, Layout_DefaultLayers, LAYOUT_LAYER_COUNT);
+    HidReport_Initialise(&hid);
+    Combo_Attach(&combo, &pipe, KeyPipeline_AddStage(&pipe, Combo_Stage, &combo));
+    KeyPipeline_AddStage(&pipe, Keymap_Stage, &keymap);
+    KeyPipeline_AddStage(&pipe, HidReport_Stage, &hid);
+    consumer = KeyPipeline_AddConsumer(&pipe);
+    // Every event makes a report, nothing is dropped or held
+    uint32_t reports = 0;
+    for (uint32_t i = 0; i < 1000; i++) {
+        reports += firmware_event(i);
+    }
+    TEST_EQUAL(reports, 1000);
+    TEST_EQUAL(pipe.overflows, 0);
+    TEST_BENCH("firmware stages, per event", 1000000, firmware_event(test_i));
+
+    KeyPipeline_Initialise(&pipe);
+    for (uint8_t i = 0; i < 3; i++) {
+        KeyPipeline_AddStage(&pipe, pass, NULL);
+    }
+    consumer = KeyPipeline_AddConsumer(&pipe);
+    TEST_BENCH("3 empty stages, per event", 1000000, {
+        KeyPipeline_Push(&pipe, 1, KEYEVENT_PRESS, 0, 0);
+        KeyPipeline_Run(&pipe);
+        KeyPipeline_Peek(&pipe, consumer);
+        KeyPipeline_Release(&pipe, consumer);
+    });
+}
+
+int main(void) {
+    TEST_RUN(test_order_across_wrap);
+    TEST_RUN(test_hold_and_lookahead);
+    TEST_RUN(test_back_pressure);
+    TEST_RUN(test_limits);
+    bench_throughput();
+    return TEST_RESULT();
+}
@@ -0,0 +1,323 @@
+/*
+ *
+ *  Key Statistics Tests
+ *
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *
+*/
+
+// Bucket edges, filters and saturation on single events, then a typing trace with bouncing
+// contacts through debounce and the pipeline as the firmware runs them, the statistics
+// checked against the keystrokes that made the trace. The bench times the scan with and
+// without the statistics consumer attached
+
+#include <stdlib.h>
+#include <string.h>
+#include "Test.h"
+#include "KeyStats.h"
+#include "Debounce.h"
+#include "Encoder.h"
+
+#define MS  1000
+
+static KeyStats stats;
+
+static void event(uint8_t key, uint8_t edge, uint32_t timestamp_us) {
+    KeyEvent e = {0};
+    e.key = key;
+    e.source = key / DEBOUNCE_KEYS_PER_SOURCE;
+    e.edge = edge;
+    e.timestamp_us = timestamp_us;
+    KeyStats_Event(&stats, &e);
+}
+
+// Bucket for <ms>, by walking the edges rather than counting bits
+static uint8_t reference_bucket(uint32_t us) {
+    uint8_t bucket = 0;
+    while (bucket < KEYSTATS_BUCKETS - 1 && us >= ((uint32_t)KEYSTATS_BUCKET_MIN_MS * MS << bucket)) {
+        bucket++;
+    }
+    return bucket;
+}
+
+static void test_record_layout(void) {
+    // Persisted as is, the README and the flash slot depend on it
+    TEST_EQUAL(sizeof(KeyStats_Record), 804);
+    KeyStats_Initialise(&stats, NULL);
+    TEST_EQUAL(stats.record.version, KEYSTATS_VERSION);
+    TEST_CHECK(!stats.dirty);
+}
+
+static void test_hold_buckets(void) {
+    KeyStats_Initialise(&stats, NULL);
+    // Either side of every edge, and far past the last
+    const uint32_t holds_us[] = {0, 15999, 16000, 31999, 32000, 63999, 64000, 511999, 512000, 1023999, 1024000, 3600000000u};
+    uint32_t t = 1000;
+    for (uint8_t i = 0; i < sizeof(holds_us) / sizeof(holds_us[0]); i++) {
+        event(3, KEYEVENT_PRESS, t);
+        event(3, KEYEVENT_RELEASE, t + holds_us[i]);
+        t += holds_us[i] + 1;
+    }
+    uint16_t expected[KEYSTATS_BUCKETS] = {0};
+    for (uint8_t i = 0; i < sizeof(holds_us) / sizeof(holds_us[0]); i++) {
+        expected[reference_bucket(holds_us[i])]++;
+    }
+    TEST_EQUAL(memcmp(stats.record.keys[3].hold, expected, sizeof(expected)), 0);
+    TEST_EQUAL(expected[0], 2);
+    TEST_EQUAL(expected[KEYSTATS_BUCKETS - 1], 2);
+    TEST_EQUAL(stats.record.keys[3].presses, 12);
+
+    // A hold across the clock wrapping
+    event(4, KEYEVENT_PRESS, 0xFFFFFFFF - 10 * MS);
+    event(4, KEYEVENT_RELEASE, 10 * MS);
+    TEST_EQUAL(stats.record.keys[4].hold[1], 1);
+}
+
+static void test_intervals(void) {
+    KeyStats_Initialise(&stats, NULL);
+    // The first press has nothing to measure from
+    event(0, KEYEVENT_PRESS, 100 * MS);
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < KEYSTATS_BUCKETS; i++) {
+        total += stats.record.interval[i];
+    }
+    TEST_EQUAL(total, 0);
+    // Press to press on any key, releases don't count
+    event(17, KEYEVENT_PRESS, 110 * MS);
+    event(0, KEYEVENT_RELEASE, 130 * MS);
+    event(5, KEYEVENT_PRESS, 210 * MS);
+    event(5, KEYEVENT_PRESS, 2210 * MS);
+    TEST_EQUAL(stats.record.interval[0], 1);
+    TEST_EQUAL(stats.record.interval[3], 1);
+    TEST_EQUAL(stats.record.interval[7], 1);
+}
+
+static void test_filters_and_saturation(void) {
+    KeyStats_Initialise(&stats, NULL);
+    // Encoder taps, synthetic events and keys past the table aren't counted
+    KeyEvent e = {0};
+    e.edge = KEYEVENT_PRESS;
+    e.source = ENCODER_EVENT_SOURCE;
+    KeyStats_Event(&stats, &e);
+    e.source = 0;
+    e.flags = KEYEVENT_FLAG_SYNTHETIC;
+    KeyStats_Event(&stats, &e);
+    e.flags = 0;
+    e.key = KEYSTATS_MAX_KEYS;
+    KeyStats_Event(&stats, &e);
+    TEST_CHECK(!stats.dirty);
+    // A release with no press seen (held through a reset) has no hold time
+    event(2, KEYEVENT_RELEASE, 5 * MS);
+    uint32_t holds = 0;
+    for (uint8_t i = 0; i < KEYSTATS_BUCKETS; i++) {
+        holds += stats.record.keys[2].hold[i];
+    }
+    TEST_EQUAL(holds, 0);
+
+    // Histogram counts stop at their maximum instead of wrapping
+    stats.record.keys[1].hold[0] = UINT16_MAX - 1;
+    stats.record.interval[0] = UINT32_MAX - 1;
+    for (uint8_t i = 0; i < 3; i++) {
+        event(1, KEYEVENT_PRESS, i * MS);
+        event(1, KEYEVENT_RELEASE, i * MS + 1);
+    }
+    TEST_EQUAL(stats.record.keys[1].hold[0], UINT16_MAX);
+    TEST_EQUAL(stats.record.interval[0], UINT32_MAX);
+}
+
+static void test_chatter_sync(void) {
+    static Debounce db;
+    KeyStats_Initialise(&stats, NULL);
+    Debounce_Initialise(&db, DEBOUNCE_DEFAULT_WINDOW_US);
+    db.chatter[0][3] = 10;
+    db.chatter[1][15] = 2;
+    KeyStats_SyncChatter(&stats, &db);
+    TEST_EQUAL(stats.record.keys[3].chatter, 10);
+    TEST_EQUAL(stats.record.keys[31].chatter, 2);
+    TEST_CHECK(stats.dirty);
+    // Only what debounce counted since the last sync
+    KeyStats_MarkSaved(&stats);
+    KeyStats_SyncChatter(&stats, &db);
+    TEST_CHECK(!stats.dirty);
+    db.chatter[0][3] = 15;
+    KeyStats_SyncChatter(&stats, &db);
+    TEST_EQUAL(stats.record.keys[3].chatter, 15);
+    // Debounce's counter wraps, the total saturates
+    db.chatter[0][3] = 65530;
+    KeyStats_SyncChatter(&stats, &db);
+    TEST_EQUAL(stats.record.keys[3].chatter, 65530);
+    db.chatter[0][3] = 4;
+    KeyStats_SyncChatter(&stats, &db);
+    TEST_EQUAL(stats.record.keys[3].chatter, UINT16_MAX);
+}
+
+static void test_saved_record(void) {
+    static KeyStats_Record saved;
+    KeyStats_Initialise(&stats, NULL);
+    event(9, KEYEVENT_PRESS, 0);
+    event(9, KEYEVENT_RELEASE, 40 * MS);
+    saved = stats.record;
+    // Carries on from a good record
+    KeyStats_Initialise(&stats, &saved);
+    TEST_EQUAL(stats.record.keys[9].presses, 1);
+    TEST_EQUAL(stats.record.keys[9].hold[2], 1);
+    TEST_CHECK(!stats.dirty);
+    // Not one of another layout
+    saved.version = KEYSTATS_VERSION + 1;
+    KeyStats_Initialise(&stats, &saved);
+    TEST_EQUAL(stats.record.keys[9].presses, 0);
+    TEST_EQUAL(stats.record.version, KEYSTATS_VERSION);
+    KeyStats_Initialise(&stats, NULL);
+    event(9, KEYEVENT_PRESS, 0);
+    KeyStats_Clear(&stats);
+    TEST_EQUAL(stats.record.keys[9].presses, 0);
+    TEST_EQUAL(stats.record.version, KEYSTATS_VERSION);
+    TEST_CHECK(stats.dirty);
+}
+
+// One keystroke of the trace: contacts bounce on both edges for 2ms
+typedef struct {
+    uint8_t key;
+    uint32_t press_ms;
+    uint32_t release_ms;
+} Stroke;
+
+static bool contact_closed(const Stroke *stroke, uint32_t ms) {
+    if (ms < stroke->press_ms || ms > stroke->release_ms + 2) {
+        return false;
+    }
+    if (ms < stroke->press_ms + 3) {
+        return ms != stroke->press_ms + 1;
+    }
+    if (ms >= stroke->release_ms) {
+        return ms == stroke->release_ms + 1;
+    }
+    return true;
+}
+
+// Random keystrokes, one key at a time, scanned every 1ms through debounce into the
+// pipeline, drained and synced every 100ms as the firmware's task does
+static void test_typing_trace(void) {
+    static Debounce db;
+    static KeyPipeline pipe;
+    static Stroke strokes[2000];
+    const uint32_t holds_ms[] = {8, 20, 45, 90, 180, 400, 800, 1500};
+    const uint32_t gaps_ms[] = {6, 30, 70, 150, 600, 2000};
+    srand(42);
+    uint32_t t = 10;
+    for (uint32_t i = 0; i < 2000; i++) {
+        strokes[i].key = rand() % KEYSTATS_MAX_KEYS;
+        strokes[i].press_ms = t;
+        strokes[i].release_ms = t + holds_ms[rand() % 8];
+        t = strokes[i].release_ms + gaps_ms[rand() % 6];
+    }
+    uint32_t end_ms = t + 10;
+
+    Debounce_Initialise(&db, DEBOUNCE_DEFAULT_WINDOW_US);
+    KeyPipeline_Initialise(&pipe);
+    int consumer = KeyPipeline_AddConsumer(&pipe);
+    KeyStats_Initialise(&stats, NULL);
+    uint32_t stroke = 0;
+    uint32_t taken = 0;
+    for (uint32_t ms = 0; ms < end_ms; ms++) {
+        while (stroke < 2000 && ms > strokes[stroke].release_ms + 2) {
+            stroke++;
+        }
+        uint16_t raw[DEBOUNCE_MAX_SOURCES] = {0};
+        if (stroke < 2000 && contact_closed(&strokes[stroke], ms)) {
+            raw[strokes[stroke].key / DEBOUNCE_KEYS_PER_SOURCE] |= 1 << (strokes[stroke].key % DEBOUNCE_KEYS_PER_SOURCE);
+        }
+        for (uint8_t source = 0; source < DEBOUNCE_MAX_SOURCES; source++) {
+            Debounce_Update(&db, &pipe, source, raw[source], ms * MS);
+        }
+        KeyPipeline_Run(&pipe);
+        if (ms % 100 == 0) {
+            taken += KeyStats_Consume(&stats, &pipe, consumer);
+            KeyStats_SyncChatter(&stats, &db);
+        }
+    }
+    taken += KeyStats_Consume(&stats, &pipe, consumer);
+    KeyStats_SyncChatter(&stats, &db);
+    TEST_EQUAL(taken, 2 * 2000);
+    TEST_EQUAL(pipe.overflows, 0);
+
+    // What the strokes say the statistics should be
+    static KeyStats_Record expected;
+    memset(&expected, 0, sizeof(expected));
+    for (uint32_t i = 0; i < 2000; i++) {
+        KeyStats_Key *key = &expected.keys[strokes[i].key];
+        key->presses++;
+        key->hold[reference_bucket((strokes[i].release_ms - strokes[i].press_ms) * MS)]++;
+        // Two bounces on each edge, all inside the window
+        key->chatter += 4;
+        if (i > 0) {
+            expected.interval[reference_bucket((strokes[i].press_ms - strokes[i - 1].press_ms) * MS)]++;
+        }
+    }
+    uint32_t wrong = 0;
+    for (uint8_t key = 0; key < KEYSTATS_MAX_KEYS; key++) {
+        const KeyStats_Key *got = &stats.record.keys[key];
+        const KeyStats_Key *want = &expected.keys[key];
+        wrong += got->presses != want->presses || memcmp(got->hold, want->hold, sizeof(got->hold)) != 0;
+        wrong += got->chatter != db.chatter[key / DEBOUNCE_KEYS_PER_SOURCE][key % DEBOUNCE_KEYS_PER_SOURCE];
+        wrong += got->chatter != want->chatter;
+    }
+    TEST_EQUAL(wrong, 0);
+    TEST_EQUAL(memcmp(stats.record.interval, expected.interval, sizeof(expected.interval)), 0);
+    TEST_EQUAL(stats.held, 0);
+}
+
+static void bench_scan(void) {
+    // The scan's part: a sample per source, pushed edges, stages run. Timed with no consumer
+    // and with the statistics consumer attached, drained outside the timed loop as the
+    // firmware's low priority task does
+    static Debounce db;
+    static KeyPipeline pipe;
+    static volatile uint8_t sink;
+    for (uint8_t attached = 0; attached < 2; attached++) {
+        Debounce_Initialise(&db, 0);
+        KeyPipeline_Initialise(&pipe);
+        int consumer = attached ? KeyPipeline_AddConsumer(&pipe) : -1;
+        KeyStats_Initialise(&stats, NULL);
+        uint64_t scan_ns = 0;
+        uint32_t scans = 0;
+        for (uint32_t round = 0; round < 2000; round++) {
+            uint64_t start = test_now_ns();
+            // A key down and up every other scan, 32 scans per round
+            for (uint32_t i = 0; i < 32; i++) {
+                uint16_t raw = (i & 2) ? 1 << (round % 16) : 0;
+                sink = Debounce_Update(&db, &pipe, 0, raw, (round * 32 + i) * MS);
+                sink = Debounce_Update(&db, &pipe, 1, 0, (round * 32 + i) * MS);
+                KeyPipeline_Run(&pipe);
+            }
+            scan_ns += test_now_ns() - start;
+            scans += 32;
+            if (consumer >= 0) {
+                KeyStats_Consume(&stats, &pipe, consumer);
+            }
+        }
+        printf("bench %-32s %8.1f ns\n", attached ? "scan, statistics attached" : "scan, no consumer", (double)scan_ns / scans);
+        if (attached) {
+            TEST_EQUAL(stats.record.keys[0].presses, 2000 / 16 * 8);
+        }
+    }
+    KeyStats_Initialise(&stats, NULL);
+    TEST_BENCH("KeyStats_Event, off the scan", 10000000,
+               event(test_i & 31, test_i & 1 ? KEYEVENT_RELEASE : KEYEVENT_PRESS, test_i * 3000));
+    (void)sink;
+}
+
+int main(void) {
+    TEST_RUN(test_record_layout);
+    TEST_RUN(test_hold_buckets);
+    TEST_RUN(test_intervals);
+    TEST_RUN(test_filters_and_saturation);
+    TEST_RUN(test_chatter_sync);
+    TEST_RUN(test_saved_record);
+    TEST_RUN(test_typing_trace);
+    bench_scan();
+    return TEST_RESULT();
+}
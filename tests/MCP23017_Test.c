@@ -0,0 +1,285 @@
+/*
+ *
+ *  MCP23017 Driver Tests
+ *
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *
+*/
+
+// The driver core against the register model, built once per transport backend.
+// Checks what ends up in the part's registers and what the driver reports back,
+// including bus failures, which must never be taken as data
+
+#include <string.h>
+#include "Test.h"
+#include "FakeSdk.h"
+#include "FakeMcp23017.h"
+#include "MCP23017.h"
+
+#define TEST_CS_PIN 17
+
+static FakeMcp23017 part;
+static FakeMcp23017 second; // Second part on the same bus (SPI: same chip select)
+static MCP23017 dev;
+static MCP23017 dev2;
+
+#if MCP23017_TRANSPORT == MCP23017_TRANSPORT_SPI
+static void setup(void) {
+    FakeSdk_Reset();
+    FakeMcp23017_Initialise(&part, 0x20);
+    FakeMcp23017_Initialise(&second, 0x21);
+    FakeMcp23017_AttachSPI(&part, TEST_CS_PIN);
+    FakeMcp23017_AttachSPI(&second, TEST_CS_PIN);
+    memset(&dev, 0, sizeof(dev));
+    memset(&dev2, 0, sizeof(dev2));
+    TEST_EQUAL(MCP23017_InitialiseSPI(&dev, spi0, TEST_CS_PIN, 0x20), 0);
+    TEST_EQUAL(MCP23017_InitialiseSPI(&dev2, spi0, TEST_CS_PIN, 0x21), 0);
+}
+
+// Reads fail on SPI as a short transfer
+static void fail_next(uint32_t count) {
+    FakeSPI_ShortNext(count);
+}
+#else
+static I2CBus bus;
+
+static void setup(void) {
+    FakeSdk_Reset();
+    FakeMcp23017_Initialise(&part, 0x20);
+    FakeMcp23017_Initialise(&second, 0x21);
+    FakeMcp23017_AttachI2C(&part);
+    FakeMcp23017_AttachI2C(&second);
+    I2CBus_Initialise(&bus, i2c0);
+    TEST_EQUAL(I2CBus_Discover(&bus), 2);
+    memset(&dev, 0, sizeof(dev));
+    memset(&dev2, 0, sizeof(dev2));
+    TEST_EQUAL(MCP23017_Initialise(&dev, I2CBus_Find(&bus, I2CBUS_DEVICE_MCP23017, 0)), 0);
+    TEST_EQUAL(MCP23017_Initialise(&dev2, I2CBus_Find(&bus, I2CBUS_DEVICE_MCP23017, 1)), 0);
+}
+
+static void fail_next(uint32_t count) {
+    FakeI2C_FailNext(count, PICO_ERROR_GENERIC);
+}
+#endif
+
+static void test_register_pairs(void) {
+    setup();
+    uint16_t direction = 0xF00F;
+    uint16_t pullups = 0x1234;
+    uint16_t polarity = 0x8001;
+    MCP23017_SetIODirection(&dev, &direction);
+    MCP23017_SetPullups(&dev, &pullups);
+    MCP23017_SetIOPolarity(&dev, &polarity);
+    // Bank A is the high byte
+    TEST_EQUAL(part.regs[MCP23017_REG_IODIRA], 0xF0);
+    TEST_EQUAL(part.regs[MCP23017_REG_IODIRB], 0x0F);
+    TEST_EQUAL(FakeMcp23017_Pair(&part, MCP23017_REG_GPPUA), 0x1234);
+    TEST_EQUAL(FakeMcp23017_Pair(&part, MCP23017_REG_IPOLA), 0x8001);
+    TEST_EQUAL(MCP23017_GetIODirection(&dev), 0xF00F);
+    TEST_EQUAL(MCP23017_GetPullups(&dev), 0x1234);
+    TEST_EQUAL(MCP23017_GetIOPolarity(&dev), 0x8001);
+    // The other part is untouched
+    TEST_EQUAL(FakeMcp23017_Pair(&second, MCP23017_REG_IODIRA), 0xFFFF);
+    TEST_EQUAL(FakeMcp23017_Pair(&second, MCP23017_REG_GPPUA), 0);
+}
+
+static void test_get_io(void) {
+    setup();
+    uint16_t polarity = 0x0100;
+    MCP23017_SetIOPolarity(&dev, &polarity);
+    FakeMcp23017_SetPins(&part, 0x8002);
+    FakeMcp23017_SetPins(&second, 0x00FF);
+    uint16_t io = 0;
+    TEST_EQUAL(MCP23017_GetIO(&dev, &io), 0);
+    TEST_EQUAL(io, 0x8102);
+    TEST_EQUAL(dev.io_value, 0x8102);
+    TEST_EQUAL(MCP23017_GetIO(&dev2, &io), 0);
+    TEST_EQUAL(io, 0x00FF);
+}
+
+static void test_read_failure(void) {
+    setup();
+    FakeMcp23017_SetPins(&part, 0x0001);
+    uint16_t io = 0;
+    TEST_EQUAL(MCP23017_GetIO(&dev, &io), 0);
+    TEST_EQUAL(io, 0x0001);
+
+    // A failed read leaves the caller's value and the cache as they were
+    FakeMcp23017_SetPins(&part, 0xFFFF);
+    io = 0xABCD;
+    fail_next(1);
+    TEST_CHECK(MCP23017_GetIO(&dev, &io) < 0);
+    TEST_EQUAL(io, 0xABCD);
+    TEST_EQUAL(dev.io_value, 0x0001);
+
+    uint8_t value = 0x5A;
+    fail_next(1);
+    TEST_CHECK(MCP23017_ReadRegister(&dev, MCP23017_REG_IODIRA, &value) < 0);
+    TEST_EQUAL(value, 0x5A);
+
+    // 16 bit getters fall back to the last known value
+    uint16_t pullups = 0x00F0;
+    MCP23017_SetPullups(&dev, &pullups);
+    TEST_EQUAL(MCP23017_GetPullups(&dev), 0x00F0);
+    part.regs[MCP23017_REG_GPPUB] = 0xFF;
+    fail_next(1);
+    TEST_EQUAL(MCP23017_GetPullups(&dev), 0x00F0);
+    TEST_EQUAL(MCP23017_GetPullups(&dev), 0x00FF);
+}
+
+static void test_no_write_after_failed_read(void) {
+    setup();
+    uint32_t writes = part.writes;
+    fail_next(1);
+    MCP23017_SetSingleIODirection(&dev, 0, 3);
+    TEST_EQUAL(part.writes, writes);
+    TEST_EQUAL(FakeMcp23017_Pair(&part, MCP23017_REG_IODIRA), 0xFFFF);
+}
+
+static void test_read_capture(void) {
+    setup();
+    uint16_t enable = 0xFFFF;
+    uint16_t previous = 0;
+    MCP23017_SetInterruptChange(&dev, &previous);
+    MCP23017_SetInterruptEnable(&dev, &enable);
+    // Pressed and released again before the read, INTCAP still has it
+    FakeMcp23017_SetPins(&part, 0x0010);
+    FakeMcp23017_SetPins(&part, 0x0000);
+    uint16_t flags = 0;
+    uint16_t capture = 0;
+    uint16_t io = 0xFFFF;
+    uint32_t reads = part.reads;
+    TEST_EQUAL(MCP23017_ReadCapture(&dev, &flags, &capture, &io), 0);
+    TEST_EQUAL(part.reads, reads + 1); // One burst
+    TEST_EQUAL(flags, 0x0010);
+    TEST_EQUAL(capture, 0x0010);
+    TEST_EQUAL(io, 0x0000);
+    // The read cleared the interrupt
+    TEST_EQUAL(FakeMcp23017_Pair(&part, MCP23017_REG_INTFA), 0);
+
+    fail_next(1);
+    flags = capture = io = 0x1111;
+    TEST_CHECK(MCP23017_ReadCapture(&dev, &flags, &capture, &io) < 0);
+    TEST_EQUAL(flags, 0x1111);
+    TEST_EQUAL(io, 0x1111);
+}
+
+static void test_output_latch(void) {
+    setup();
+    uint16_t direction = 0x00FF; // Bank A outputs
+    MCP23017_SetIODirection(&dev, &direction);
+    uint32_t writes = part.writes;
+    TEST_EQUAL(MCP23017_WriteOutputLatch(&dev, 0xA500), 0);
+    TEST_EQUAL(part.writes, writes + 1);
+    TEST_EQUAL(FakeMcp23017_Pair(&part, MCP23017_REG_OLATA), 0xA500);
+    TEST_EQUAL(dev.io_output_latch, 0xA500);
+    uint16_t io = 0;
+    TEST_EQUAL(MCP23017_GetIO(&dev, &io), 0);
+    TEST_EQUAL(io & 0xFF00, 0xA500);
+
+    // Not recorded unless it got there
+    fail_next(1);
+    TEST_CHECK(MCP23017_WriteOutputLatch(&dev, 0x5A00) < 0);
+    TEST_EQUAL(dev.io_output_latch, 0xA500);
+}
+
+#if MCP23017_TRANSPORT == MCP23017_TRANSPORT_SPI
+static void test_spi_hardware_address(void) {
+    setup();
+    // HAEN went to every part sharing the chip select and is in both drivers' IOCON copy
+    TEST_CHECK(part.regs[MCP23017_REG_IOCONA] & MCP23017_IOCON_HAEN);
+    TEST_CHECK(second.regs[MCP23017_REG_IOCONA] & MCP23017_IOCON_HAEN);
+    TEST_CHECK(dev.expander_config & MCP23017_IOCON_HAEN);
+    TEST_CHECK(dev2.expander_config & MCP23017_IOCON_HAEN);
+
+    // From then on each opcode only reaches its own part
+    uint16_t direction = 0x1234;
+    MCP23017_SetIODirection(&dev2, &direction);
+    TEST_EQUAL(FakeMcp23017_Pair(&second, MCP23017_REG_IODIRA), 0x1234);
+    TEST_EQUAL(FakeMcp23017_Pair(&part, MCP23017_REG_IODIRA), 0xFFFF);
+
+    // A GPIO read is 4 bytes on the wire: opcode, register, A, B
+    Fake_ClearLog();
+    uint16_t io;
+    TEST_EQUAL(MCP23017_GetIO(&dev2, &io), 0);
+    TEST_EQUAL(Fake_TransferCount(), 1);
+    const Fake_Transfer *frame = Fake_GetTransfer(0);
+    TEST_EQUAL(frame->length, 4);
+    TEST_EQUAL(Fake_TransferData(frame)[0], MCP23017_SPI_OPCODE_READ(0x21));
+    TEST_EQUAL(Fake_TransferData(frame)[1], MCP23017_REG_GPIOA);
+    TEST_CHECK(FakeGpio_Output(TEST_CS_PIN)); // Deselected after
+
+    // Rewriting IOCON with HAEN kept, as the wake setup does, keeps the parts apart
+    uint8_t iocon = MCP23017_IOCON_MIRROR | (dev.expander_config & MCP23017_IOCON_HAEN);
+    MCP23017_WriteRegister(&dev, MCP23017_REG_IOCONA, &iocon);
+    MCP23017_SetIODirection(&dev2, &direction);
+    TEST_EQUAL(FakeMcp23017_Pair(&part, MCP23017_REG_IODIRA), 0xFFFF);
+}
+
+static void test_spi_short_transfer(void) {
+    setup();
+    uint8_t data[2] = {0x12, 0x34};
+    FakeSPI_ShortNext(1);
+    TEST_EQUAL(MCP23017_WriteRegisters(&dev, MCP23017_REG_GPPUA, data, 2), PICO_ERROR_IO);
+    uint8_t value = 0;
+    FakeSPI_ShortNext(1);
+    TEST_EQUAL(MCP23017_ReadRegister(&dev, MCP23017_REG_IODIRA, &value), PICO_ERROR_IO);
+    TEST_EQUAL(value, 0);
+}
+#else
+static void test_i2c_transactions(void) {
+    setup();
+    // Register address then a repeated start into the read
+    Fake_ClearLog();
+    uint16_t io;
+    TEST_EQUAL(MCP23017_GetIO(&dev, &io), 0);
+    TEST_EQUAL(Fake_TransferCount(), 2);
+    const Fake_Transfer *write = Fake_GetTransfer(0);
+    const Fake_Transfer *read = Fake_GetTransfer(1);
+    TEST_EQUAL(write->kind, FAKE_I2C_WRITE);
+    TEST_CHECK(write->nostop);
+    TEST_EQUAL(write->length, 1);
+    TEST_EQUAL(Fake_TransferData(write)[0], MCP23017_REG_GPIOA);
+    TEST_EQUAL(read->kind, FAKE_I2C_READ);
+    TEST_EQUAL(read->length, 2);
+
+    // A failed read stops at the address write, and is accounted against the device
+    uint32_t errors = dev.bus_device->errors;
+    Fake_ClearLog();
+    fail_next(1);
+    TEST_CHECK(MCP23017_GetIO(&dev, &io) < 0);
+    TEST_EQUAL(Fake_TransferCount(), 1);
+    TEST_EQUAL(dev.bus_device->errors, errors + 1);
+}
+
+static void test_i2c_missing_part(void) {
+    setup();
+    I2CBus_Device *missing = I2CBus_Register(&bus, 0x27, I2CBUS_DEVICE_MCP23017);
+    MCP23017 absent;
+    TEST_EQUAL(MCP23017_Initialise(&absent, missing), 0);
+    uint16_t io = 0x4242;
+    TEST_CHECK(MCP23017_GetIO(&absent, &io) < 0);
+    TEST_EQUAL(io, 0x4242);
+    TEST_EQUAL(MCP23017_Initialise(&absent, NULL), 1);
+}
+#endif
+
+int main(void) {
+    TEST_RUN(test_register_pairs);
+    TEST_RUN(test_get_io);
+    TEST_RUN(test_read_failure);
+    TEST_RUN(test_no_write_after_failed_read);
+    TEST_RUN(test_read_capture);
+    TEST_RUN(test_output_latch);
+#if MCP23017_TRANSPORT == MCP23017_TRANSPORT_SPI
+    TEST_RUN(test_spi_hardware_address);
+    TEST_RUN(test_spi_short_transfer);
+#else
+    TEST_RUN(test_i2c_transactions);
+    TEST_RUN(test_i2c_missing_part);
+#endif
+    return TEST_RESULT();
+}
@@ -0,0 +1,182 @@
+/*
+ *
+ *  Key Matrix Ghost Filter Tests
+ *
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *
+*/
+
+// The ghost mask against every rectangle found the slow way, for all 2^20 key sets, then
+// the filter fed by a model of a diodeless matrix: a key it newly reports is always really
+// pressed, and a reading with no rectangle is reported as it is
+
+#include <stdlib.h>
+#include "Test.h"
+#include "Matrix.h"
+
+#define KEY(row, column) (1u << ((row) * MATRIX_COLS + (column)))
+
+// Scan word as Matrix.pio leaves it: keys in the top bits, 0 = pressed
+static uint32_t scan_word(uint32_t keys, uint32_t low_bits) {
+    return ~(keys << MATRIX_RAW_SHIFT) ^ (low_bits & ((1u << MATRIX_RAW_SHIFT) - 1));
+}
+
+static bool pressed(uint32_t keys, uint8_t row, uint8_t column) {
+    return keys & KEY(row, column);
+}
+
+// Every corner of every rectangle of pressed keys
+static uint32_t reference_ghost_mask(uint32_t keys) {
+    uint32_t mask = 0;
+    for (uint8_t a = 0; a < MATRIX_ROWS; a++) {
+        for (uint8_t b = a + 1; b < MATRIX_ROWS; b++) {
+            for (uint8_t c = 0; c < MATRIX_COLS; c++) {
+                for (uint8_t d = c + 1; d < MATRIX_COLS; d++) {
+                    if (pressed(keys, a, c) && pressed(keys, a, d) && pressed(keys, b, c) && pressed(keys, b, d)) {
+                        mask |= KEY(a, c) | KEY(a, d) | KEY(b, c) | KEY(b, d);
+                    }
+                }
+            }
+        }
+    }
+    return mask;
+}
+
+// What a matrix without diodes reads: strobing a row, a column reads low if any path of
+// pressed switches joins them, so the pressed keys' rows and columns are closed over
+static uint32_t diodeless_read(uint32_t keys) {
+    uint32_t read = keys;
+    bool grew = true;
+    while (grew) {
+        grew = false;
+        for (uint8_t a = 0; a < MATRIX_ROWS; a++) {
+            for (uint8_t b = 0; b < MATRIX_ROWS; b++) {
+                uint32_t row_a = (read >> (a * MATRIX_COLS)) & MATRIX_COLUMN_MASK;
+                uint32_t row_b = (read >> (b * MATRIX_COLS)) & MATRIX_COLUMN_MASK;
+                // Rows sharing a pressed column are joined, each reads the other's columns
+                if (a != b && (row_a & row_b) && (row_a | row_b) != row_a) {
+                    read |= row_b << (a * MATRIX_COLS);
+                    grew = true;
+                }
+            }
+        }
+    }
+    return read;
+}
+
+static void test_ghost_mask_exhaustive(void) {
+    uint32_t wrong = 0;
+    for (uint32_t keys = 0; keys <= MATRIX_KEY_MASK; keys++) {
+        if (Matrix_GhostMask(keys) != reference_ghost_mask(keys)) {
+            if (wrong++ == 0) {
+                fprintf(stderr, "  keys 0x%05x: mask 0x%05x, expected 0x%05x\n", keys, Matrix_GhostMask(keys), reference_ghost_mask(keys));
+            }
+        }
+    }
+    TEST_EQUAL(wrong, 0);
+}
+
+static void test_decode(void) {
+    Matrix matrix;
+    Matrix_Initialise(&matrix, true);
+    // Idle word, nothing pressed
+    TEST_CHECK(!Matrix_Update(&matrix, 0xFFFFFFFF));
+    TEST_EQUAL(matrix.keys, 0);
+    TEST_CHECK(Matrix_Update(&matrix, scan_word(KEY(0, 0) | KEY(3, 4), 0)));
+    TEST_EQUAL(matrix.keys, KEY(0, 0) | KEY(3, 4));
+    // Bits below the keys are ignored
+    TEST_CHECK(!Matrix_Update(&matrix, scan_word(KEY(0, 0) | KEY(3, 4), 0xABC)));
+    TEST_EQUAL(matrix.changes, 1);
+    // With diodes a rectangle is just four keys
+    uint32_t square = KEY(1, 1) | KEY(1, 2) | KEY(2, 1) | KEY(2, 2);
+    TEST_CHECK(Matrix_Update(&matrix, scan_word(square, 0)));
+    TEST_EQUAL(matrix.keys, square);
+    TEST_EQUAL(matrix.ghost_blocks, 0);
+}
+
+static void test_ghost_held(void) {
+    Matrix matrix;
+    Matrix_Initialise(&matrix, false);
+    uint32_t top = KEY(0, 0) | KEY(0, 1);
+    TEST_CHECK(Matrix_Update(&matrix, scan_word(top, 0)));
+    TEST_EQUAL(matrix.keys, top);
+    // A third corner: the fourth reads pressed as well, neither new key is believed
+    uint32_t read = diodeless_read(top | KEY(1, 0));
+    TEST_EQUAL(read, top | KEY(1, 0) | KEY(1, 1));
+    TEST_CHECK(!Matrix_Update(&matrix, scan_word(read, 0)));
+    TEST_EQUAL(matrix.keys, top);
+    TEST_EQUAL(matrix.ghost_mask, read);
+    TEST_EQUAL(matrix.ghost_blocks, 1);
+    // Keys off the rectangle still get through
+    TEST_CHECK(Matrix_Update(&matrix, scan_word(read | KEY(3, 3), 0)));
+    TEST_EQUAL(matrix.keys, top | KEY(3, 3));
+    // The rectangle breaks up and the real third key shows
+    TEST_CHECK(Matrix_Update(&matrix, scan_word(KEY(0, 0) | KEY(1, 0) | KEY(3, 3), 0)));
+    TEST_EQUAL(matrix.keys, KEY(0, 0) | KEY(1, 0) | KEY(3, 3));
+    TEST_EQUAL(matrix.ghost_mask, 0);
+}
+
+// Random presses and releases through the diodeless model
+static void test_random_presses(void) {
+    Matrix matrix;
+    uint32_t blocked = 0;
+    srand(41);
+    for (uint8_t round = 0; round < 50; round++) {
+        Matrix_Initialise(&matrix, false);
+        uint32_t actual = 0;
+        uint32_t phantom = 0;
+        uint32_t inexact = 0;
+        for (uint32_t i = 0; i < 5000; i++) {
+            // Mostly two or three keys down, now and then a handful
+            uint32_t key = 1u << (rand() % MATRIX_KEYS);
+            if ((actual & key) || __builtin_popcount(actual) >= 2 + (rand() % 8 == 0) * 4) {
+                actual &= ~(rand() % 2 ? key : actual & -actual);
+            }
+            else {
+                actual |= key;
+            }
+            uint32_t before = matrix.keys;
+            uint32_t read = diodeless_read(actual);
+            Matrix_Update(&matrix, scan_word(read, rand()));
+            // Newly reported keys are really down, newly released keys really up
+            phantom += __builtin_popcount(matrix.keys & ~before & ~actual);
+            phantom += __builtin_popcount(before & ~matrix.keys & actual);
+            // No rectangle, nothing to be unsure of
+            if (reference_ghost_mask(read) == 0) {
+                inexact += read != actual || matrix.keys != actual;
+            }
+        }
+        TEST_EQUAL(phantom, 0);
+        TEST_EQUAL(inexact, 0);
+        blocked += matrix.ghost_blocks;
+    }
+    // The filter had something to do
+    TEST_CHECK(blocked > 1000);
+}
+
+static void bench_update(void) {
+    static Matrix matrix;
+    static uint32_t words[2];
+    Matrix_Initialise(&matrix, false);
+    // Two scans a key apart, with a rectangle held in both
+    uint32_t square = KEY(1, 1) | KEY(1, 2) | KEY(2, 1) | KEY(2, 2);
+    words[0] = scan_word(square, 0);
+    words[1] = scan_word(square | KEY(3, 0), 0);
+    TEST_BENCH("Matrix_Update, changed word", 10000000, Matrix_Update(&matrix, words[test_i & 1]));
+    static volatile uint32_t sink;
+    TEST_BENCH("Matrix_GhostMask", 10000000, sink = Matrix_GhostMask(test_i & MATRIX_KEY_MASK));
+    TEST_BENCH("every rectangle, one at a time", 10000000, sink = reference_ghost_mask(test_i & MATRIX_KEY_MASK));
+    (void)sink;
+}
+
+int main(void) {
+    TEST_RUN(test_ghost_mask_exhaustive);
+    TEST_RUN(test_decode);
+    TEST_RUN(test_ghost_held);
+    TEST_RUN(test_random_presses);
+    bench_update();
+    return TEST_RESULT();
+}
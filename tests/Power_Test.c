@@ -0,0 +1,277 @@
+/*
+ *
+ *  Power Manager Tests
+ *
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *
+*/
+
+// The state machine against recording hooks: which hooks run, in what order, for each
+// transition, including DORMANT being held off by can_go_dormant and a wait that ends
+// without a key
+
+#include <string.h>
+#include <unistd.h>
+#include "Test.h"
+#include "Power.h"
+
+#define MS 1000ull
+
+// Every hook call appends a token, "D2 L0 A C1 W C0 X" for a dormant entry
+static char calls[256];
+
+static struct {
+    bool dormant_allowed;
+    bool key;           // wait_for_wake result
+    uint64_t wake_us;
+    uint16_t captured_io;
+    uint32_t waits;
+} sim;
+
+static void record(const char *token) {
+    if (calls[0]) {
+        strncat(calls, " ", sizeof(calls) - strlen(calls) - 1);
+    }
+    strncat(calls, token, sizeof(calls) - strlen(calls) - 1);
+}
+
+static void set_display(void *context, Power_State state) {
+    char token[3] = {'D', '0' + state, '\0'};
+    record(token);
+}
+
+static void set_leds(void *context, bool on) {
+    record(on ? "L1" : "L0");
+}
+
+static void set_clock_low(void *context, bool low) {
+    record(low ? "C1" : "C0");
+}
+
+static bool can_go_dormant(void *context) {
+    return sim.dormant_allowed;
+}
+
+static void arm_wake(void *context) {
+    record("A");
+}
+
+static bool wait_for_wake(void *context, uint64_t *wake_us, uint16_t *captured_io) {
+    record("W");
+    sim.waits++;
+    *wake_us = sim.wake_us;
+    if (sim.key) {
+        *captured_io = sim.captured_io;
+    }
+    return sim.key;
+}
+
+static void disarm_wake(void *context) {
+    record("X");
+}
+
+static const Power_Hooks hooks = {
+    .set_display = set_display,
+    .set_leds = set_leds,
+    .set_clock_low = set_clock_low,
+    .can_go_dormant = can_go_dormant,
+    .arm_wake = arm_wake,
+    .wait_for_wake = wait_for_wake,
+    .disarm_wake = disarm_wake,
+};
+
+static Power pm;
+
+static void setup(void) {
+    calls[0] = '\0';
+    memset(&sim, 0, sizeof(sim));
+    sim.dormant_allowed = true;
+    sim.key = true;
+    Power_Initialise(&pm, &hooks, NULL, 0);
+    Power_SetTimeouts(&pm, 10000, 60000, 300000);
+}
+
+static bool calls_are(const char *expected) {
+    bool same = strcmp(calls, expected) == 0;
+    if (!same) {
+        fprintf(stderr, "  hook calls \"%s\", expected \"%s\"\n", calls, expected);
+    }
+    calls[0] = '\0';
+    return same;
+}
+
+static void test_idle_steps(void) {
+    setup();
+    TEST_EQUAL(Power_Update(&pm, 9999 * MS), POWER_ACTIVE);
+    TEST_CHECK(calls_are(""));
+    TEST_EQUAL(Power_Update(&pm, 10000 * MS), POWER_IDLE);
+    TEST_CHECK(calls_are("D1"));
+    // Nothing more until the next threshold, and nothing repeated
+    TEST_EQUAL(Power_Update(&pm, 20000 * MS), POWER_IDLE);
+    TEST_CHECK(calls_are(""));
+    // LEDs go off crossing into SLEEP
+    TEST_EQUAL(Power_Update(&pm, 60000 * MS), POWER_SLEEP);
+    TEST_CHECK(calls_are("D2 L0"));
+    // Input brings everything straight back
+    Power_Activity(&pm, 61000 * MS);
+    TEST_EQUAL(pm.state, POWER_ACTIVE);
+    TEST_CHECK(calls_are("D0 L1"));
+    TEST_EQUAL(Power_Update(&pm, 70999 * MS), POWER_ACTIVE);
+    // Activity while active only moves the timer
+    Power_Activity(&pm, 70000 * MS);
+    TEST_CHECK(calls_are(""));
+    TEST_EQUAL(Power_Update(&pm, 79999 * MS), POWER_ACTIVE);
+    TEST_EQUAL(Power_Update(&pm, 80000 * MS), POWER_IDLE);
+}
+
+static void test_disabled_states(void) {
+    setup();
+    // No IDLE: straight to SLEEP, the display told once
+    Power_SetTimeouts(&pm, 0, 60000, 0);
+    TEST_EQUAL(Power_Update(&pm, 59999 * MS), POWER_ACTIVE);
+    TEST_EQUAL(Power_Update(&pm, 60000 * MS), POWER_SLEEP);
+    TEST_CHECK(calls_are("D2 L0"));
+    // No DORMANT: SLEEP forever
+    TEST_EQUAL(Power_Update(&pm, 100000000 * MS), POWER_SLEEP);
+    TEST_EQUAL(sim.waits, 0);
+    // All disabled
+    Power_SetTimeouts(&pm, 0, 0, 0);
+    Power_Activity(&pm, 0);
+    TEST_EQUAL(Power_Update(&pm, 100000000 * MS), POWER_ACTIVE);
+}
+
+static void test_dormant_wake(void) {
+    setup();
+    Power_Update(&pm, 10000 * MS);
+    Power_Update(&pm, 60000 * MS);
+    calls[0] = '\0';
+    sim.wake_us = 400000 * MS;
+    sim.captured_io = 0x0204;
+    // Dark first, wake armed before the clock drops, restored in reverse
+    TEST_EQUAL(Power_Update(&pm, 300000 * MS), POWER_ACTIVE);
+    TEST_CHECK(calls_are("D3 A C1 W C0 X D0 L1"));
+    TEST_EQUAL(pm.wake_count, 1);
+    TEST_EQUAL(pm.last_activity_us, 400000 * MS);
+
+    // The waking key is handed over until it's reported
+    uint16_t io = 0;
+    TEST_CHECK(Power_TakeWakeKeys(&pm, &io));
+    TEST_EQUAL(io, 0x0204);
+    TEST_CHECK(Power_TakeWakeKeys(&pm, &io));
+    Power_KeyReported(&pm, 400000 * MS + 1800);
+    TEST_CHECK(!Power_TakeWakeKeys(&pm, &io));
+    TEST_EQUAL(pm.last_wake_latency_us, 1800);
+    TEST_EQUAL(pm.max_wake_latency_us, 1800);
+    TEST_EQUAL(pm.wake_latency_overruns, 0);
+    // Reported again, nothing changes
+    Power_KeyReported(&pm, 500000 * MS);
+    TEST_EQUAL(pm.last_wake_latency_us, 1800);
+
+    // From ACTIVE with enough idle time it goes all the way in one update
+    sim.wake_us = 800000 * MS;
+    TEST_EQUAL(Power_Update(&pm, 700000 * MS), POWER_ACTIVE);
+    TEST_CHECK(calls_are("D3 L0 A C1 W C0 X D0 L1"));
+    // Over the 5ms budget
+    Power_KeyReported(&pm, 800000 * MS + 7000);
+    TEST_EQUAL(pm.max_wake_latency_us, 7000);
+    TEST_EQUAL(pm.wake_latency_overruns, 1);
+}
+
+// What Power_PrintStats prints, from stdout
+static char printed[512];
+
+static void capture_stats(void) {
+    fflush(stdout);
+    FILE *file = tmpfile();
+    int saved = dup(1);
+    dup2(fileno(file), 1);
+    Power_PrintStats(&pm);
+    fflush(stdout);
+    dup2(saved, 1);
+    close(saved);
+    rewind(file);
+    size_t length = fread(printed, 1, sizeof(printed) - 1, file);
+    printed[length] = '\0';
+    fclose(file);
+}
+
+// The console's view of the latency the device measured
+static void test_print_stats(void) {
+    setup();
+    capture_stats();
+    TEST_CHECK(strstr(printed, "Power active, 0 key wakes") != NULL);
+    TEST_CHECK(strstr(printed, "last 0us, max 0us, budget 5000us, 0 over budget") != NULL);
+
+    Power_Update(&pm, 10000 * MS);
+    Power_Update(&pm, 60000 * MS);
+    capture_stats();
+    TEST_CHECK(strstr(printed, "Power sleep") != NULL);
+
+    sim.wake_us = 400000 * MS;
+    Power_Update(&pm, 300000 * MS);
+    Power_KeyReported(&pm, 400000 * MS + 7000);
+    sim.wake_us = 800000 * MS;
+    Power_Update(&pm, 700000 * MS);
+    Power_KeyReported(&pm, 800000 * MS + 1200);
+    capture_stats();
+    TEST_CHECK(strstr(printed, "Power active, 2 key wakes") != NULL);
+    TEST_CHECK(strstr(printed, "last 1200us, max 7000us, budget 5000us, 1 over budget") != NULL);
+}
+
+static void test_dormant_held_off(void) {
+    setup();
+    // USB host hasn't suspended: SLEEP is as deep as it goes
+    sim.dormant_allowed = false;
+    TEST_EQUAL(Power_Update(&pm, 300000 * MS), POWER_SLEEP);
+    TEST_EQUAL(Power_Update(&pm, 900000 * MS), POWER_SLEEP);
+    TEST_EQUAL(sim.waits, 0);
+    TEST_CHECK(calls_are("D2 L0"));
+    // Suspended later on, dormant on the next update
+    sim.dormant_allowed = true;
+    sim.wake_us = 950000 * MS;
+    TEST_EQUAL(Power_Update(&pm, 901000 * MS), POWER_ACTIVE);
+    TEST_EQUAL(sim.waits, 1);
+    TEST_CHECK(calls_are("D3 A C1 W C0 X D0 L1"));
+}
+
+static void test_wake_without_key(void) {
+    setup();
+    sim.key = false;
+    sim.wake_us = 350000 * MS;
+    sim.captured_io = 0xFFFF;
+    TEST_EQUAL(Power_Update(&pm, 300000 * MS), POWER_ACTIVE);
+    // Resumed by the host: awake, but no key to report and no latency to time
+    uint16_t io = 0x1234;
+    TEST_EQUAL(pm.wake_count, 0);
+    TEST_CHECK(!Power_TakeWakeKeys(&pm, &io));
+    TEST_EQUAL(io, 0x1234);
+    Power_KeyReported(&pm, 360000 * MS);
+    TEST_EQUAL(pm.last_wake_latency_us, 0);
+    // Idle time counts from the resume, not from before the dormant entry
+    TEST_EQUAL(Power_Update(&pm, 359999 * MS), POWER_ACTIVE);
+    TEST_EQUAL(Power_Update(&pm, 360000 * MS), POWER_IDLE);
+}
+
+static void test_no_hooks(void) {
+    // Every hook is optional
+    Power_Initialise(&pm, NULL, NULL, 0);
+    Power_SetTimeouts(&pm, 1, 2, 3);
+    TEST_EQUAL(Power_Update(&pm, 1 * MS), POWER_IDLE);
+    TEST_EQUAL(Power_Update(&pm, 2 * MS), POWER_SLEEP);
+    TEST_EQUAL(Power_Update(&pm, 3 * MS), POWER_ACTIVE);
+    TEST_EQUAL(pm.wake_count, 1);
+}
+
+int main(void) {
+    TEST_RUN(test_idle_steps);
+    TEST_RUN(test_disabled_states);
+    TEST_RUN(test_dormant_wake);
+    TEST_RUN(test_dormant_held_off);
+    TEST_RUN(test_wake_without_key);
+    TEST_RUN(test_no_hooks);
+    TEST_RUN(test_print_stats);
+    return TEST_RESULT();
+}
@@ -0,0 +1,232 @@
+/*
+ *
+ *  SSD1306 Command Encoder Tests
+ *
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *
+*/
+
+// Encoders byte for byte against the datasheet, then what the driver puts on the wire
+// for each command, read back through the panel model
+
+#include <string.h>
+#include "Test.h"
+#include "FakeSdk.h"
+#include "FakeSsd1306.h"
+#include "SSD1306.h"
+
+static I2CBus bus;
+static FakeSsd1306 panel;
+static SSD1306 dev;
+
+#define SENTINEL 0x5A
+
+// Encodes into a buffer with a sentinel past SSD1306_CMD_MAX_LENGTH, so an encoder that
+// writes more than it returns or more than the maximum is caught
+#define CHECK_ENCODE(call, ...) do { \
+        uint8_t out[SSD1306_CMD_MAX_LENGTH + 4]; \
+        const uint8_t expected[] = {__VA_ARGS__}; \
+        memset(out, SENTINEL, sizeof(out)); \
+        uint8_t length = call; \
+        TEST_EQUAL(length, sizeof(expected)); \
+        TEST_CHECK(memcmp(out, expected, sizeof(expected)) == 0); \
+        for (uint8_t i = length; i < sizeof(out); i++) { \
+            TEST_EQUAL(out[i], SENTINEL); \
+        } \
+    } while (0)
+
+static void test_encoders(void) {
+    CHECK_ENCODE(SSD1306_EncodeSingle(out, SSD1306_CMD_DISPLAY_ON), 0xAF);
+    CHECK_ENCODE(SSD1306_EncodeContrast(out, 0x42), 0x81, 0x42);
+    CHECK_ENCODE(SSD1306_EncodeHorizontalScroll(out, SSD1306_SCROLL_RIGHT, 0, 7, SSD1306_SCROLL_2_FRAMES),
+            0x26, 0x00, 0x00, 0x07, 0x07, 0x00, 0xFF);
+    CHECK_ENCODE(SSD1306_EncodeHorizontalScroll(out, SSD1306_SCROLL_LEFT, 2, 5, SSD1306_SCROLL_256_FRAMES),
+            0x27, 0x00, 0x02, 0x03, 0x05, 0x00, 0xFF);
+    CHECK_ENCODE(SSD1306_EncodeDiagonalScroll(out, SSD1306_SCROLL_RIGHT, 0, 3, SSD1306_SCROLL_64_FRAMES, 1),
+            0x29, 0x00, 0x00, 0x01, 0x03, 0x01);
+    CHECK_ENCODE(SSD1306_EncodeDiagonalScroll(out, SSD1306_SCROLL_LEFT, 1, 1, SSD1306_SCROLL_5_FRAMES, 63),
+            0x2A, 0x00, 0x01, 0x00, 0x01, 0x3F);
+    CHECK_ENCODE(SSD1306_EncodeVerticalScrollArea(out, 8, 56), 0xA3, 0x08, 0x38);
+    CHECK_ENCODE(SSD1306_EncodeAddressWindow(out, 4, 127, 2, 3), 0x21, 0x04, 0x7F, 0x22, 0x02, 0x03);
+}
+
+static void test_encoders_mask_fields(void) {
+    // Out of range values are cut to the field width, never spill into other bits
+    CHECK_ENCODE(SSD1306_EncodeHorizontalScroll(out, SSD1306_SCROLL_RIGHT, 9, 0xFF, 0x0F),
+            0x26, 0x00, 0x01, 0x07, 0x07, 0x00, 0xFF);
+    CHECK_ENCODE(SSD1306_EncodeDiagonalScroll(out, SSD1306_SCROLL_RIGHT, 0, 0, 0, 0x41),
+            0x29, 0x00, 0x00, 0x00, 0x00, 0x01);
+    CHECK_ENCODE(SSD1306_EncodeVerticalScrollArea(out, 0x7F, 0xFF), 0xA3, 0x3F, 0x7F);
+    CHECK_ENCODE(SSD1306_EncodeAddressWindow(out, 0x80, 0xFF, 8, 0xFF), 0x21, 0x00, 0x7F, 0x22, 0x00, 0x07);
+}
+
+static void test_init_sequence(void) {
+    const uint8_t expected_64[] = {
+        0xAE, 0xD5, 0x80, 0xA8, 0x3F, 0xD3, 0x00, 0x40, 0x8D, 0x14, 0x20, 0x00, 0xA1,
+        0xC8, 0xDA, 0x12, 0x81, 0xCF, 0xD9, 0xF1, 0xDB, 0x40, 0x2E, 0xA4, 0xA6, 0xAF,
+    };
+    uint8_t out[32];
+    uint8_t length = SSD1306_EncodeInitSequence(out, 64, 0xCF);
+    TEST_EQUAL(length, sizeof(expected_64));
+    TEST_CHECK(memcmp(out, expected_64, sizeof(expected_64)) == 0);
+
+    // 128x32: 32 rows multiplexed, sequential COM pins
+    length = SSD1306_EncodeInitSequence(out, 32, 0x10);
+    TEST_EQUAL(length, sizeof(expected_64));
+    TEST_EQUAL(out[4], 0x1F);
+    TEST_EQUAL(out[15], 0x02);
+    TEST_EQUAL(out[17], 0x10);
+}
+
+static void setup(void) {
+    FakeSdk_Reset();
+    FakeSsd1306_Initialise(&panel, SSD1306_I2C_ADDRESS);
+    FakeSsd1306_AttachI2C(&panel);
+    I2CBus_Initialise(&bus, i2c0);
+    TEST_EQUAL(I2CBus_Discover(&bus), 1);
+    memset(&dev, 0, sizeof(dev));
+    TEST_EQUAL(SSD1306_Initialise(&dev, I2CBus_Find(&bus, I2CBUS_DEVICE_SSD1306, 0), 64, 128), 0);
+    Fake_ClearLog();
+}
+
+// The last transfer on the bus, as sent after the address
+static void check_last_transfer(const uint8_t *expected, uint32_t length) {
+    uint32_t count = Fake_TransferCount();
+    TEST_CHECK(count > 0);
+    if (count == 0) {
+        return;
+    }
+    const Fake_Transfer *transfer = Fake_GetTransfer(count - 1);
+    TEST_EQUAL(transfer->kind, FAKE_I2C_WRITE);
+    TEST_EQUAL(transfer->address, SSD1306_I2C_ADDRESS);
+    TEST_EQUAL(transfer->length, length);
+    TEST_CHECK(transfer->length == length && memcmp(Fake_TransferData(transfer), expected, length) == 0);
+}
+
+static void test_display_init_on_wire(void) {
+    setup();
+    TEST_EQUAL(SSD1306_DisplayInit(&dev), 0);
+    // The whole sequence is one command transaction
+    TEST_EQUAL(Fake_TransferCount(), 1);
+    TEST_EQUAL(Fake_TransferData(Fake_GetTransfer(0))[0], SSD1306_CONTROL_COMMAND);
+    TEST_EQUAL(panel.malformed, 0);
+    TEST_CHECK(panel.display_on);
+    TEST_CHECK(panel.charge_pump);
+    TEST_EQUAL(panel.multiplex, 63);
+    TEST_EQUAL(panel.contrast, SSD1306_DEFAULT_CONTRAST);
+    TEST_EQUAL(panel.memory_mode, SSD1306_MEMORY_MODE_HORIZONTAL);
+    TEST_EQUAL(dev.power_state, SSD1306_POWER_ON);
+
+    // A NAK leaves the driver thinking the panel is still off
+    setup();
+    FakeI2C_FailNext(1, PICO_ERROR_GENERIC);
+    TEST_CHECK(SSD1306_DisplayInit(&dev) < 0);
+    TEST_EQUAL(dev.power_state, SSD1306_POWER_SLEEP);
+}
+
+static void test_scroll_on_wire(void) {
+    setup();
+    SSD1306_DisplayInit(&dev);
+    SSD1306_StartScroll(&dev, SSD1306_SCROLL_LEFT, 0, 1, SSD1306_SCROLL_5_FRAMES);
+    const uint8_t scroll[] = {0x00, 0x2E, 0x27, 0x00, 0x00, 0x00, 0x01, 0x00, 0xFF, 0x2F};
+    check_last_transfer(scroll, sizeof(scroll));
+    TEST_CHECK(panel.scrolling);
+    TEST_CHECK(dev.scrolling);
+
+    // Restarting while scrolling must still deactivate first, the model counts it otherwise
+    SSD1306_StartDiagonalScroll(&dev, SSD1306_SCROLL_RIGHT, 0, 7, SSD1306_SCROLL_2_FRAMES, 1);
+    const uint8_t diagonal[] = {0x00, 0x2E, 0x29, 0x00, 0x00, 0x07, 0x07, 0x01, 0x2F};
+    check_last_transfer(diagonal, sizeof(diagonal));
+    TEST_EQUAL(panel.malformed, 0);
+
+    SSD1306_SetVerticalScrollArea(&dev, 0, 64);
+    const uint8_t area[] = {0x00, 0xA3, 0x00, 0x40};
+    check_last_transfer(area, sizeof(area));
+
+    // Stopping redraws the whole panel, the scroll moved GDDRAM
+    Fake_ClearLog();
+    dev.buffer[5] = 0x81;
+    SSD1306_StopScroll(&dev);
+    TEST_CHECK(!panel.scrolling);
+    TEST_EQUAL(panel.gddram[5], 0x81);
+    TEST_EQUAL(memcmp(panel.gddram, dev.buffer, sizeof(panel.gddram)), 0);
+    const uint8_t stop[] = {0x00, 0x2E};
+    TEST_CHECK(Fake_TransferCount() > 1 && memcmp(Fake_TransferData(Fake_GetTransfer(0)), stop, 2) == 0);
+
+    // Not scrolling, nothing to send
+    Fake_ClearLog();
+    SSD1306_StopScroll(&dev);
+    TEST_EQUAL(Fake_TransferCount(), 0);
+}
+
+static void test_power_states_on_wire(void) {
+    setup();
+    SSD1306_DisplayInit(&dev);
+    Fake_ClearLog();
+    SSD1306_SetPowerState(&dev, SSD1306_POWER_ON);
+    TEST_EQUAL(Fake_TransferCount(), 0);
+
+    SSD1306_SetPowerState(&dev, SSD1306_POWER_DIM);
+    const uint8_t dim[] = {0x00, 0x81, SSD1306_DIM_CONTRAST, 0xAF};
+    check_last_transfer(dim, sizeof(dim));
+
+    SSD1306_SetPowerState(&dev, SSD1306_POWER_SLEEP);
+    const uint8_t sleep[] = {0x00, 0xAE};
+    check_last_transfer(sleep, sizeof(sleep));
+    TEST_CHECK(!panel.display_on);
+
+    // Contrast set while asleep waits for the wake
+    Fake_ClearLog();
+    SSD1306_SetContrast(&dev, 0x30);
+    TEST_EQUAL(Fake_TransferCount(), 0);
+    SSD1306_SetPowerState(&dev, SSD1306_POWER_ON);
+    const uint8_t wake[] = {0x00, 0x81, 0x30, 0xAF};
+    check_last_transfer(wake, sizeof(wake));
+    TEST_EQUAL(panel.contrast, 0x30);
+    TEST_CHECK(panel.display_on);
+
+    SSD1306_SetContrast(&dev, 0x31);
+    const uint8_t contrast[] = {0x00, 0x81, 0x31};
+    check_last_transfer(contrast, sizeof(contrast));
+
+    SSD1306_SetInverted(&dev, true);
+    const uint8_t invert[] = {0x00, 0xA7};
+    check_last_transfer(invert, sizeof(invert));
+    TEST_CHECK(panel.inverted);
+
+    // Idle timeouts step down through dim to sleep
+    SSD1306_SetIdleTimeouts(&dev, 1000, 5000);
+    TEST_EQUAL(SSD1306_UpdateIdle(&dev, 999), SSD1306_POWER_ON);
+    TEST_EQUAL(SSD1306_UpdateIdle(&dev, 1000), SSD1306_POWER_DIM);
+    TEST_EQUAL(panel.contrast, SSD1306_DIM_CONTRAST);
+    TEST_EQUAL(SSD1306_UpdateIdle(&dev, 5000), SSD1306_POWER_SLEEP);
+    TEST_CHECK(!panel.display_on);
+    TEST_EQUAL(SSD1306_UpdateIdle(&dev, 0), SSD1306_POWER_ON);
+    TEST_EQUAL(panel.contrast, 0x31);
+    TEST_EQUAL(panel.malformed, 0);
+}
+
+static void test_command_limits(void) {
+    setup();
+    uint8_t commands[SSD1306_MAX_WIDTH + 1];
+    memset(commands, SSD1306_CMD_NOP, sizeof(commands));
+    TEST_EQUAL(SSD1306_WriteCommands(&dev, commands, sizeof(commands)), PICO_ERROR_INVALID_ARG);
+    TEST_EQUAL(Fake_TransferCount(), 0);
+    TEST_EQUAL(SSD1306_WriteCommands(&dev, commands, SSD1306_MAX_WIDTH), 0);
+    TEST_EQUAL(Fake_GetTransfer(0)->length, SSD1306_MAX_WIDTH + 1);
+    TEST_EQUAL(panel.malformed, 0);
+}
+
+int main(void) {
+    TEST_RUN(test_encoders);
+    TEST_RUN(test_encoders_mask_fields);
+    TEST_RUN(test_init_sequence);
+    TEST_RUN(test_display_init_on_wire);
+    TEST_RUN(test_scroll_on_wire);
+    TEST_RUN(test_power_states_on_wire);
+    TEST_RUN(test_command_limits);
+    return TEST_RESULT();
+}
@@ -0,0 +1,281 @@
+/*
+ *
+ *  SSD1306 Diff Flush Tests
+ *
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *
+*/
+
+// The word at a time diff against a byte at a time reference over random edits, then
+// flushes read back through the panel model, and what the merge saves on the bus
+
+#include <stdlib.h>
+#include <string.h>
+#include "Test.h"
+#include "FakeSdk.h"
+#include "FakeSsd1306.h"
+#include "SSD1306.h"
+
+static I2CBus bus;
+static FakeSsd1306 panel;
+static SSD1306 dev;
+
+// Differing columns joined while the unchanged gap is <= merge_gap, any runs past max_runs
+// folded into the last. Matches the word diff for merge gaps of 6 or more, as two changed
+// bytes in neighbouring words are never further apart than that
+static uint8_t reference_diff(const uint8_t *front, const uint8_t *back, uint8_t width, uint8_t page, uint8_t merge_gap, SSD1306_Run *runs, uint8_t max_runs) {
+    uint8_t count = 0;
+    for (uint16_t column = 0; column < width; column++) {
+        if (front[column] == back[column]) {
+            continue;
+        }
+        if (count > 0 && (column - runs[count - 1].end - 1 <= merge_gap || count == max_runs)) {
+            runs[count - 1].end = column;
+        }
+        else if (max_runs > 0) {
+            runs[count].page = page;
+            runs[count].start = runs[count].end = column;
+            count++;
+        }
+    }
+    return count;
+}
+
+// <edits> random bytes changed, some in clusters
+static void scatter(uint8_t *row, uint8_t width, uint8_t edits) {
+    for (uint8_t i = 0; i < edits; i++) {
+        uint8_t column = rand() % width;
+        uint8_t span = rand() % 4 == 0 ? 1 + rand() % 12 : 1;
+        for (uint8_t j = 0; j < span && column + j < width; j++) {
+            row[column + j] ^= 1 + rand() % 255;
+        }
+    }
+}
+
+static void test_diff_matches_reference(void) {
+    static uint8_t front[128] __attribute__((aligned(4)));
+    static uint8_t back[128] __attribute__((aligned(4)));
+    const uint8_t widths[] = {128, 64, 4};
+    const uint8_t gaps[] = {SSD1306_RUN_OVERHEAD_BYTES, 6, 40};
+    const uint8_t limits[] = {SSD1306_MAX_RUNS_PER_PAGE, 2, 1};
+    srand(29);
+    for (uint16_t round = 0; round < 2000; round++) {
+        uint8_t width = widths[round % 3];
+        uint8_t gap = gaps[(round / 3) % 3];
+        uint8_t limit = limits[(round / 9) % 3];
+        for (uint8_t i = 0; i < width; i++) {
+            front[i] = back[i] = rand();
+        }
+        scatter(back, width, rand() % 16);
+
+        SSD1306_Run runs[SSD1306_MAX_RUNS_PER_PAGE];
+        SSD1306_Run expected[SSD1306_MAX_RUNS_PER_PAGE];
+        uint8_t count = SSD1306_DiffPage(front, back, width, 3, gap, runs, limit);
+        uint8_t expected_count = reference_diff(front, back, width, 3, gap, expected, limit);
+        TEST_EQUAL(count, expected_count);
+        if (count != expected_count) {
+            return;
+        }
+        for (uint8_t i = 0; i < count; i++) {
+            TEST_EQUAL(runs[i].page, 3);
+            TEST_EQUAL(runs[i].start, expected[i].start);
+            TEST_EQUAL(runs[i].end, expected[i].end);
+        }
+    }
+}
+
+static void test_diff_edges(void) {
+    static uint8_t front[128] __attribute__((aligned(4)));
+    static uint8_t back[128] __attribute__((aligned(4)));
+    SSD1306_Run runs[SSD1306_MAX_RUNS_PER_PAGE];
+    memset(front, 0, sizeof(front));
+    memset(back, 0, sizeof(back));
+    TEST_EQUAL(SSD1306_DiffPage(front, back, 128, 0, 10, runs, 8), 0);
+
+    // First and last column, too far apart to merge
+    back[0] = 1;
+    back[127] = 1;
+    TEST_EQUAL(SSD1306_DiffPage(front, back, 128, 0, 10, runs, 8), 2);
+    TEST_EQUAL(runs[0].start, 0);
+    TEST_EQUAL(runs[0].end, 0);
+    TEST_EQUAL(runs[1].start, 127);
+    TEST_EQUAL(runs[1].end, 127);
+    // No slots, nothing written
+    TEST_EQUAL(SSD1306_DiffPage(front, back, 128, 0, 10, runs, 0), 0);
+    // One slot covers both
+    TEST_EQUAL(SSD1306_DiffPage(front, back, 128, 0, 10, runs, 1), 1);
+    TEST_EQUAL(runs[0].end, 127);
+}
+
+static void setup(void) {
+    FakeSdk_Reset();
+    FakeSsd1306_Initialise(&panel, SSD1306_I2C_ADDRESS);
+    FakeSsd1306_AttachI2C(&panel);
+    I2CBus_Initialise(&bus, i2c0);
+    I2CBus_Discover(&bus);
+    memset(&dev, 0, sizeof(dev));
+    SSD1306_Initialise(&dev, I2CBus_Find(&bus, I2CBUS_DEVICE_SSD1306, 0), 64, 128);
+    SSD1306_DisplayInit(&dev);
+    SSD1306_Show(&dev);
+    Fake_ClearLog();
+}
+
+// Bytes on the bus since the last clear, each transfer's address byte included
+static uint32_t bus_bytes(void) {
+    uint32_t bytes = 0;
+    for (uint32_t i = 0; i < Fake_TransferCount(); i++) {
+        bytes += Fake_GetTransfer(i)->length + 1;
+    }
+    return bytes;
+}
+
+static void test_flush_reaches_panel(void) {
+    setup();
+    srand(1029);
+    for (uint16_t round = 0; round < 500; round++) {
+        for (uint8_t page = 0; page < dev.pages; page++) {
+            if (rand() % 3 == 0) {
+                scatter(&dev.buffer[page * dev.width], dev.width, 1 + rand() % 6);
+            }
+        }
+        Fake_ClearLog();
+        uint16_t bytes = SSD1306_Flush(&dev);
+        TEST_EQUAL(bytes, bus_bytes());
+        TEST_EQUAL(dev.last_flush_bytes, bytes);
+        if (memcmp(panel.gddram, dev.buffer, sizeof(panel.gddram)) != 0) {
+            TEST_CHECK(!"panel differs from the back buffer");
+            return;
+        }
+        TEST_EQUAL(memcmp(dev.front, dev.buffer, sizeof(dev.buffer)), 0);
+        // A second flush has nothing to send
+        TEST_EQUAL(SSD1306_Flush(&dev), 0);
+    }
+    TEST_EQUAL(panel.malformed, 0);
+}
+
+static void test_failed_run_is_resent(void) {
+    setup();
+    dev.buffer[10] = 0xFF;
+    dev.buffer[3 * 128 + 100] = 0x0F;
+    // The first run's address window is NAKed
+    FakeI2C_FailNext(1, PICO_ERROR_GENERIC);
+    SSD1306_Flush(&dev);
+    TEST_EQUAL(panel.gddram[10], 0);
+    TEST_EQUAL(panel.gddram[3 * 128 + 100], 0x0F);
+    TEST_EQUAL(dev.front[10], 0);
+    // Only the failed run goes out again
+    Fake_ClearLog();
+    TEST_EQUAL(SSD1306_Flush(&dev), SSD1306_RUN_OVERHEAD_BYTES + 1);
+    TEST_EQUAL(panel.gddram[10], 0xFF);
+    TEST_EQUAL(Fake_CountTransfers(FAKE_I2C_WRITE, SSD1306_I2C_ADDRESS), 2);
+
+    // A failed full frame leaves the panel unknown, the next flush resends all of it
+    FakeI2C_FailNext(1, PICO_ERROR_GENERIC);
+    SSD1306_Show(&dev);
+    TEST_EQUAL(dev.last_flush_bytes, 0);
+    TEST_EQUAL(SSD1306_Flush(&dev), 8 * (SSD1306_RUN_OVERHEAD_BYTES + 128));
+}
+
+// After an init or a failed frame nothing is known of the panel. Whatever is drawn before
+// the next flush, including exactly the inverse of what was there, goes out in full
+static void test_unknown_panel(void) {
+    setup();
+    SSD1306_DisplayInit(&dev);
+    memset(dev.buffer, 0xFF, 128);
+    dev.buffer[5 * 128 + 7] = 0xFF;
+    Fake_ClearLog();
+    TEST_EQUAL(SSD1306_Flush(&dev), 8 * (SSD1306_RUN_OVERHEAD_BYTES + 128));
+    TEST_EQUAL(memcmp(panel.gddram, dev.buffer, sizeof(panel.gddram)), 0);
+    TEST_EQUAL(SSD1306_Flush(&dev), 0);
+
+    FakeI2C_FailNext(1, PICO_ERROR_GENERIC);
+    SSD1306_Show(&dev);
+    for (uint16_t i = 0; i < 128; i++) {
+        dev.buffer[2 * 128 + i] = ~dev.buffer[2 * 128 + i];
+    }
+    // A region on an unknown page sends the whole page, the other pages wait for their flush
+    TEST_EQUAL(SSD1306_FlushRegion(&dev, 40, 8, 2, 1), SSD1306_RUN_OVERHEAD_BYTES + 128);
+    TEST_EQUAL(memcmp(&panel.gddram[2 * 128], &dev.buffer[2 * 128], 128), 0);
+    TEST_EQUAL(SSD1306_Flush(&dev), 7 * (SSD1306_RUN_OVERHEAD_BYTES + 128));
+    TEST_EQUAL(memcmp(panel.gddram, dev.buffer, sizeof(panel.gddram)), 0);
+
+    // A failed run on an unknown page leaves it unknown
+    SSD1306_Invalidate(&dev);
+    FakeI2C_FailNext(1, PICO_ERROR_GENERIC);
+    SSD1306_FlushRegion(&dev, 0, 128, 0, 1);
+    TEST_EQUAL(SSD1306_FlushRegion(&dev, 0, 128, 0, 1), SSD1306_RUN_OVERHEAD_BYTES + 128);
+}
+
+static void test_flush_region(void) {
+    setup();
+    // Inside the region, and outside it on the same page
+    dev.buffer[2 * 128 + 40] = 0x11;
+    dev.buffer[2 * 128 + 100] = 0x22;
+    dev.buffer[6 * 128 + 41] = 0x33;
+    SSD1306_FlushRegion(&dev, 38, 10, 2, 1);
+    TEST_EQUAL(panel.gddram[2 * 128 + 40], 0x11);
+    TEST_EQUAL(panel.gddram[2 * 128 + 100], 0);
+    TEST_EQUAL(panel.gddram[6 * 128 + 41], 0);
+    // The rest goes with the next full flush
+    SSD1306_Flush(&dev);
+    TEST_EQUAL(memcmp(panel.gddram, dev.buffer, sizeof(panel.gddram)), 0);
+    // Empty and off panel regions send nothing
+    Fake_ClearLog();
+    dev.buffer[0] = 0x44;
+    TEST_EQUAL(SSD1306_FlushRegion(&dev, 0, 0, 0, 8), 0);
+    TEST_EQUAL(SSD1306_FlushRegion(&dev, 0, 128, 8, 1), 0);
+    TEST_EQUAL(Fake_TransferCount(), 0);
+}
+
+static void bench_diff(void) {
+    static uint8_t front[128] __attribute__((aligned(4)));
+    static uint8_t back[128] __attribute__((aligned(4)));
+    static volatile uint8_t sink;
+    SSD1306_Run runs[SSD1306_MAX_RUNS_PER_PAGE];
+    memset(front, 0x55, sizeof(front));
+    memcpy(back, front, sizeof(back));
+    back[17] = 0; // A counter digit
+    TEST_BENCH("SSD1306_DiffPage 128 columns", 1000000, sink = SSD1306_DiffPage(front, back, 128, 0, 10, runs, 8));
+    TEST_BENCH("byte at a time reference", 1000000, sink = reference_diff(front, back, 128, 0, 10, runs, 8));
+    (void)sink;
+
+    // Bus bytes for a widget update: two counter digits redrawn on two pages, and a
+    // scattered change where merging wins
+    setup();
+    for (uint8_t page = 0; page < 2; page++) {
+        memset(&dev.buffer[page * 128 + 90], 0xFF, 12);
+    }
+    uint16_t diff = SSD1306_Flush(&dev);
+    SSD1306_Show(&dev);
+    printf("bench %-32s %5u of %u bus bytes\n", "counter update, diff vs full", diff, dev.last_flush_bytes);
+
+    uint16_t unmerged = 0;
+    for (uint8_t i = 0; i < 128; i += 8) {
+        back[i] ^= 0xFF;
+    }
+    uint8_t count = SSD1306_DiffPage(front, back, 128, 0, 0, runs, 8);
+    for (uint8_t i = 0; i < count; i++) {
+        unmerged += SSD1306_RunCost(&runs[i]);
+    }
+    uint16_t merged = 0;
+    count = SSD1306_DiffPage(front, back, 128, 0, SSD1306_RUN_OVERHEAD_BYTES, runs, 8);
+    for (uint8_t i = 0; i < count; i++) {
+        merged += SSD1306_RunCost(&runs[i]);
+    }
+    printf("bench %-32s %5u vs %u bus bytes\n", "every 8th column, merged vs not", merged, unmerged);
+    TEST_CHECK(merged < unmerged);
+}
+
+int main(void) {
+    TEST_RUN(test_diff_matches_reference);
+    TEST_RUN(test_diff_edges);
+    TEST_RUN(test_flush_reaches_panel);
+    TEST_RUN(test_failed_run_is_resent);
+    TEST_RUN(test_unknown_panel);
+    TEST_RUN(test_flush_region);
+    bench_diff();
+    return TEST_RESULT();
+}
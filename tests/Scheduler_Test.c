@@ -0,0 +1,287 @@
+/*
+ *
+ *  Scheduler Tests
+ *
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *
+*/
+
+// The scheduler on a virtual clock: tasks "run" by moving the clock on by their cost,
+// the idle hook jumps straight to the next wake. Release times, selection order and the
+// statistics are exact, so they're checked to the microsecond
+
+#include <setjmp.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Test.h"
+#include "Scheduler.h"
+
+#define JOB_STARTS 64
+
+static uint64_t now_us;
+static uint64_t stop_at_us;
+static jmp_buf stop;
+static Scheduler sched;
+
+static uint64_t virtual_clock(void) {
+    return now_us;
+}
+
+// Sleeps to the wake time, or ends Scheduler_Run at the end of the test
+static void virtual_idle(Scheduler *s, uint64_t wake_at_us) {
+    (void)s;
+    if (wake_at_us >= stop_at_us) {
+        if (now_us < stop_at_us) {
+            now_us = stop_at_us;
+        }
+        longjmp(stop, 1);
+    }
+    now_us = wake_at_us;
+}
+
+static void run_until(uint64_t end_us) {
+    stop_at_us = end_us;
+    if (setjmp(stop) == 0) {
+        Scheduler_Run(&sched);
+    }
+}
+
+typedef struct {
+    char letter;       // Recorded in order[] each run
+    uint32_t cost_us;
+    int8_t trigger;    // Task to trigger from inside this one, -1 for none
+    uint32_t runs;
+    uint64_t started_us[JOB_STARTS];
+} Job;
+
+static char order[JOB_STARTS + 1];
+static uint8_t order_length;
+
+static void job(void *context) {
+    Job *j = (Job *)context;
+    if (j->runs < JOB_STARTS) {
+        j->started_us[j->runs] = now_us;
+    }
+    j->runs++;
+    if (order_length < JOB_STARTS) {
+        order[order_length++] = j->letter;
+        order[order_length] = '\0';
+    }
+    if (j->trigger >= 0) {
+        Scheduler_Trigger(&sched, j->trigger);
+    }
+    now_us += j->cost_us;
+}
+
+static void setup(uint64_t start_us) {
+    now_us = start_us;
+    order_length = 0;
+    order[0] = '\0';
+    Scheduler_Initialise(&sched, virtual_clock, virtual_idle);
+}
+
+static void test_periodic_release(void) {
+    setup(500);
+    Job scan = {'S', 150, -1};
+    int id = Scheduler_AddTask(&sched, "scan", job, &scan, 1000, 0, SCHEDULER_PRIORITY_SCAN);
+    TEST_EQUAL(id, 0);
+    TEST_EQUAL(Scheduler_NextWake(&sched), 1500);
+    TEST_CHECK(!Scheduler_RunOnce(&sched));
+    TEST_CHECK(!Scheduler_HasWork(&sched, 1499));
+    TEST_CHECK(Scheduler_HasWork(&sched, 1500));
+
+    // Released on the period grid whatever the run time, no drift
+    run_until(11000);
+    TEST_EQUAL(scan.runs, 10);
+    for (uint8_t i = 0; i < 10; i++) {
+        TEST_EQUAL(scan.started_us[i], 1500 + i * 1000);
+    }
+    Scheduler_Task *task = &sched.tasks[id];
+    TEST_EQUAL(task->max_runtime_us, 150);
+    TEST_EQUAL(task->total_runtime_us, 1500);
+    TEST_EQUAL(task->max_latency_us, 0);
+    TEST_EQUAL(task->missed_deadlines, 0);
+    TEST_EQUAL(task->skipped_periods, 0);
+    // Idle between runs, up to the last start (the final sleep ends the test before it's counted)
+    TEST_EQUAL(sched.idle_us, 10500 - 500 - 9 * 150);
+}
+
+static void test_skips_missed_periods(void) {
+    setup(0);
+    Job scan = {'S', 10, -1};
+    Scheduler_AddTask(&sched, "scan", job, &scan, 1000, 0, SCHEDULER_PRIORITY_SCAN);
+    // Stalled through five and a half periods: one late run, not a burst of six
+    now_us = 6500;
+    TEST_CHECK(Scheduler_RunOnce(&sched));
+    TEST_CHECK(!Scheduler_RunOnce(&sched));
+    TEST_EQUAL(scan.runs, 1);
+    TEST_EQUAL(sched.tasks[0].skipped_periods, 5);
+    TEST_EQUAL(sched.tasks[0].max_latency_us, 5500);
+    TEST_EQUAL(sched.tasks[0].missed_deadlines, 1);
+    // Back on the original grid
+    TEST_EQUAL(Scheduler_NextWake(&sched), 7000);
+}
+
+static void test_selection_order(void) {
+    setup(0);
+    Job low = {'L', 10, -1};
+    Job normal_late = {'N', 10, -1};
+    Job normal_early = {'E', 10, -1};
+    Job scan = {'S', 10, -1};
+    // Added in the opposite order to how they should run
+    Scheduler_AddTask(&sched, "low", job, &low, 1000, 0, SCHEDULER_PRIORITY_LOW);
+    Scheduler_AddTask(&sched, "late", job, &normal_late, 1000, 900, SCHEDULER_PRIORITY_NORMAL);
+    Scheduler_AddTask(&sched, "early", job, &normal_early, 1000, 300, SCHEDULER_PRIORITY_NORMAL);
+    Scheduler_AddTask(&sched, "scan", job, &scan, 1000, 0, SCHEDULER_PRIORITY_SCAN);
+    now_us = 1000;
+    while (Scheduler_RunOnce(&sched)) {
+    }
+    TEST_CHECK(strcmp(order, "SENL") == 0);
+    // Each waited for the ones before it
+    TEST_EQUAL(sched.tasks[0].max_latency_us, 30);
+    TEST_EQUAL(sched.tasks[1].max_latency_us, 20);
+    TEST_EQUAL(sched.tasks[2].max_latency_us, 10);
+}
+
+static void test_triggers(void) {
+    setup(0);
+    Job event = {'T', 20, -1};
+    Job chain = {'C', 20, 0};
+    int event_id = Scheduler_AddTask(&sched, "event", job, &event, 0, 0, SCHEDULER_PRIORITY_HIGH);
+    int chain_id = Scheduler_AddTask(&sched, "chain", job, &chain, 0, 0, SCHEDULER_PRIORITY_NORMAL);
+    // Event only tasks have no deadline and never wake the idle hook
+    TEST_EQUAL(sched.tasks[event_id].deadline_us, UINT32_MAX);
+    TEST_EQUAL(Scheduler_NextWake(&sched), UINT64_MAX);
+    TEST_CHECK(!Scheduler_HasWork(&sched, 1000000));
+
+    // Triggered twice before it runs is one run
+    now_us = 100;
+    Scheduler_Trigger(&sched, event_id);
+    Scheduler_Trigger(&sched, event_id);
+    TEST_CHECK(Scheduler_HasWork(&sched, now_us));
+    while (Scheduler_RunOnce(&sched)) {
+    }
+    TEST_EQUAL(event.runs, 1);
+
+    // Triggered from a running task, released after it
+    Scheduler_Trigger(&sched, chain_id);
+    while (Scheduler_RunOnce(&sched)) {
+    }
+    TEST_CHECK(strcmp(order, "TCT") == 0);
+
+    // A trigger that lands while the task itself runs isn't lost
+    Job self = {'R', 5, -1};
+    int self_id = Scheduler_AddTask(&sched, "self", job, &self, 0, 0, SCHEDULER_PRIORITY_LOW);
+    self.trigger = self_id;
+    Scheduler_Trigger(&sched, self_id);
+    TEST_CHECK(Scheduler_RunOnce(&sched));
+    TEST_CHECK(Scheduler_HasWork(&sched, now_us));
+    self.trigger = -1;
+    TEST_CHECK(Scheduler_RunOnce(&sched));
+    TEST_CHECK(!Scheduler_RunOnce(&sched));
+    TEST_EQUAL(self.runs, 2);
+
+    // Out of range ids are ignored
+    Scheduler_Trigger(&sched, SCHEDULER_MAX_TASKS);
+    TEST_CHECK(!Scheduler_HasWork(&sched, now_us));
+}
+
+static void test_task_table(void) {
+    setup(0);
+    Job idle_job = {'I', 0, -1};
+    TEST_EQUAL(Scheduler_AddTask(&sched, "null", NULL, NULL, 1000, 0, 0), -1);
+    for (uint8_t i = 0; i < SCHEDULER_MAX_TASKS; i++) {
+        TEST_EQUAL(Scheduler_AddTask(&sched, "t", job, &idle_job, 0, 0, 0), i);
+    }
+    TEST_EQUAL(Scheduler_AddTask(&sched, "full", job, &idle_job, 0, 0, 0), -1);
+
+    // A new period starts from now, the deadline follows it
+    setup(0);
+    Job scan = {'S', 0, -1};
+    Scheduler_AddTask(&sched, "scan", job, &scan, 1000, 0, SCHEDULER_PRIORITY_SCAN);
+    now_us = 400;
+    Scheduler_SetPeriod(&sched, 0, 250);
+    TEST_EQUAL(Scheduler_NextWake(&sched), 650);
+    TEST_EQUAL(sched.tasks[0].deadline_us, 250);
+    Scheduler_SetPeriod(&sched, 0, 0);
+    TEST_EQUAL(Scheduler_NextWake(&sched), UINT64_MAX);
+    Scheduler_SetPeriod(&sched, 7, 100); // Not a task
+}
+
+static uint8_t dispatched[8];
+static uint8_t dispatch_count;
+
+static void record_dispatch(Scheduler *s, uint8_t task_id) {
+    (void)s;
+    if (dispatch_count < sizeof(dispatched)) {
+        dispatched[dispatch_count++] = task_id;
+    }
+}
+
+static void test_dispatch_hook(void) {
+    setup(0);
+    Job a = {'A', 1, -1};
+    Job b = {'B', 1, -1};
+    Scheduler_AddTask(&sched, "a", job, &a, 0, 0, SCHEDULER_PRIORITY_LOW);
+    Scheduler_AddTask(&sched, "b", job, &b, 0, 0, SCHEDULER_PRIORITY_HIGH);
+    Scheduler_SetDispatchHook(&sched, record_dispatch);
+    dispatch_count = 0;
+    Scheduler_Trigger(&sched, 0);
+    Scheduler_Trigger(&sched, 1);
+    while (Scheduler_RunOnce(&sched)) {
+    }
+    TEST_EQUAL(dispatch_count, 2);
+    TEST_EQUAL(dispatched[0], 1);
+    TEST_EQUAL(dispatched[1], 0);
+}
+
+// The firmware's task set with interrupts landing at random: the scan is never held up for
+// longer than the longest other task, so with every task shorter than the scan period
+// minus the scan itself, no scan deadline is missed
+static void test_firmware_task_set(void) {
+    setup(0);
+    Job scan = {'S', 120, -1};
+    Job usb = {'U', 60, -1};
+    Job encoder = {'E', 15, -1};
+    Job display = {'D', 700, -1};  // One flush chunk
+    Job console = {'C', 200, -1};
+    int scan_id = Scheduler_AddTask(&sched, "scan", job, &scan, 1000, 0, SCHEDULER_PRIORITY_SCAN);
+    Scheduler_AddTask(&sched, "usb", job, &usb, 1000, 0, SCHEDULER_PRIORITY_HIGH);
+    int encoder_id = Scheduler_AddTask(&sched, "encoder", job, &encoder, 0, 500, SCHEDULER_PRIORITY_HIGH);
+    Scheduler_AddTask(&sched, "display", job, &display, 20000, 0, SCHEDULER_PRIORITY_NORMAL);
+    Scheduler_AddTask(&sched, "console", job, &console, 10000, 0, SCHEDULER_PRIORITY_LOW);
+
+    srand(30);
+    uint64_t end = 2000000;
+    while (now_us < end) {
+        // An encoder interrupt somewhere in the next few periods
+        uint64_t next = now_us + 1 + rand() % 3000;
+        run_until(next < end ? next : end);
+        Scheduler_Trigger(&sched, encoder_id);
+    }
+    Scheduler_Task *task = &sched.tasks[scan_id];
+    // Releases at or past the end didn't run
+    TEST_EQUAL(task->runs, (end - 1) / 1000);
+    TEST_EQUAL(task->missed_deadlines, 0);
+    TEST_EQUAL(task->skipped_periods, 0);
+    TEST_CHECK(task->max_latency_us <= display.cost_us);
+    for (uint8_t i = 0; i < sched.task_count; i++) {
+        TEST_EQUAL(sched.tasks[i].missed_deadlines, 0);
+    }
+    printf("      scan latency max %u us, encoder %u us, idle %u%%\n", (unsigned)task->max_latency_us,
+           (unsigned)sched.tasks[encoder_id].max_latency_us, (unsigned)(sched.idle_us * 100 / now_us));
+}
+
+int main(void) {
+    TEST_RUN(test_periodic_release);
+    TEST_RUN(test_skips_missed_periods);
+    TEST_RUN(test_selection_order);
+    TEST_RUN(test_triggers);
+    TEST_RUN(test_task_table);
+    TEST_RUN(test_dispatch_hook);
+    TEST_RUN(test_firmware_task_set);
+    return TEST_RESULT();
+}
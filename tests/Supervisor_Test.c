@@ -0,0 +1,334 @@
+/*
+ *
+ *  Supervisor Tests
+ *
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *
+*/
+
+// Simulated hangs on a virtual clock: the firmware's watched tasks and 100ms supervisor task
+// feeding a 3s watchdog. A task that stops beating, or a main loop that stops altogether,
+// must stop the feed in time, and the breadcrumbs found after the reset must say which.
+// Then the crumb record itself: checksum upkeep, corruption and cold boots
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "Test.h"
+#include "Supervisor.h"
+
+#define MS              1000u
+#define PERIOD_US       (100 * MS)  // As Macropad.c
+#define WATCHDOG_US     (3000 * MS)
+#define SCAN_TIMEOUT_US (250 * MS)
+#define CONSOLE_TIMEOUT_US (1000 * MS)
+
+enum {
+    TASK_SCAN,
+    TASK_CONSOLE,
+    TASK_SUPERVISOR,
+};
+
+static const char *task_name(uint32_t task) {
+    static const char *names[] = {"scan", "console", "supervisor"};
+    return task < 3 ? names[task] : "?";
+}
+
+static Supervisor_Crumbs crumbs; // Survives the simulated resets
+static Supervisor sup;
+static int scan_id;
+static int console_id;
+
+typedef enum {
+    HANG_NONE,
+    HANG_SCAN_STARVED,  // Loop runs, the scan task never gets to beat
+    HANG_LOOP,          // Scan task stuck in an I2C transfer, nothing else runs
+} Hang;
+
+typedef struct {
+    uint32_t start_us;
+    uint32_t last_feed_us;
+    uint32_t tripped_at_us; // First failed check
+    uint32_t reset_at_us;   // Watchdog fired, 0 if it never did
+} Run;
+
+static void boot(bool watchdog_reset, uint32_t now_us) {
+    Supervisor_Initialise(&sup, &crumbs, watchdog_reset);
+    scan_id = Supervisor_Watch(&sup, "scan", SCAN_TIMEOUT_US, now_us);
+    console_id = Supervisor_Watch(&sup, "console", CONSOLE_TIMEOUT_US, now_us);
+}
+
+// The main loop a millisecond at a time for <duration_ms> or until the watchdog fires. The
+// scan runs every 10ms, the console every 50ms, the supervisor every 100ms; <hang> starts
+// at <hang_us>
+static Run simulate(uint32_t start_us, uint32_t duration_ms, Hang hang, uint32_t hang_us, uint32_t layers) {
+    Run run = {start_us, start_us, 0, 0};
+    bool stuck = false;
+    for (uint32_t step = 0; step < duration_ms; step++) {
+        uint32_t now = start_us + step * MS;
+        if (now - run.last_feed_us > WATCHDOG_US) {
+            run.reset_at_us = now;
+            return run;
+        }
+        if (stuck) {
+            continue; // Nothing runs, not even the supervisor task
+        }
+        bool hung = hang != HANG_NONE && now - start_us >= hang_us - start_us;
+        if ((now / MS) % 10 == 0) {
+            Supervisor_TaskStarted(&sup, TASK_SCAN, now / MS);
+            if (hang == HANG_LOOP && hung) {
+                // The transfer that never finishes
+                Supervisor_Detail(&sup, 0x20);
+                stuck = true;
+                continue;
+            }
+            Supervisor_Detail(&sup, 0x21);
+            Supervisor_Detail(&sup, SUPERVISOR_NONE);
+            Supervisor_Keep(&sup, 0, layers);
+            if (!hung) {
+                Supervisor_Heartbeat(&sup, scan_id, now);
+            }
+        }
+        if ((now / MS) % 50 == 5) {
+            Supervisor_TaskStarted(&sup, TASK_CONSOLE, now / MS);
+            Supervisor_Heartbeat(&sup, console_id, now);
+        }
+        if ((now / MS) % 100 == 7) {
+            Supervisor_TaskStarted(&sup, TASK_SUPERVISOR, now / MS);
+            if (Supervisor_Check(&sup, now)) {
+                run.last_feed_us = now;
+            }
+            else if (!run.tripped_at_us) {
+                run.tripped_at_us = now;
+            }
+        }
+    }
+    return run;
+}
+
+// What Supervisor_PrintReport prints, from stdout
+static char report[512];
+
+static void capture_report(void) {
+    fflush(stdout);
+    FILE *file = tmpfile();
+    int saved = dup(1);
+    dup2(fileno(file), 1);
+    Supervisor_PrintReport(&sup, task_name);
+    fflush(stdout);
+    dup2(saved, 1);
+    close(saved);
+    rewind(file);
+    size_t length = fread(report, 1, sizeof(report) - 1, file);
+    report[length] = '\0';
+    fclose(file);
+}
+
+static void test_healthy(void) {
+    memset(&crumbs, 0, sizeof(crumbs));
+    boot(false, 0);
+    TEST_CHECK(!Supervisor_IsWarm(&sup));
+    capture_report();
+    TEST_CHECK(strcmp(report, "Cold boot\n") == 0);
+    // A minute of normal running never trips, across the 32 bit clock wrap too
+    Run run = simulate(0, 60000, HANG_NONE, 0, 0);
+    TEST_EQUAL(run.reset_at_us, 0);
+    TEST_EQUAL(run.tripped_at_us, 0);
+    boot(false, 0u - 30000 * MS);
+    run = simulate(0u - 30000 * MS, 60000, HANG_NONE, 0, 0);
+    TEST_EQUAL(run.reset_at_us, 0);
+    TEST_EQUAL(sup.watched[scan_id].misses, 0);
+}
+
+static void test_task_stops_beating(void) {
+    memset(&crumbs, 0, sizeof(crumbs));
+    boot(false, 0);
+    uint32_t hang_us = 5003 * MS;
+    Run run = simulate(0, 20000, HANG_SCAN_STARVED, hang_us, 0x5);
+    // Caught by the first check past the timeout, no feed from then on
+    TEST_CHECK(run.tripped_at_us > hang_us + SCAN_TIMEOUT_US - 10 * MS);
+    TEST_CHECK(run.tripped_at_us <= hang_us + SCAN_TIMEOUT_US + PERIOD_US);
+    TEST_EQUAL(run.reset_at_us, run.last_feed_us + WATCHDOG_US + MS);
+    TEST_CHECK(run.last_feed_us < run.tripped_at_us);
+    TEST_EQUAL(sup.tripped, scan_id);
+    TEST_EQUAL(sup.watched[scan_id].misses, 1);
+    TEST_EQUAL(sup.watched[console_id].misses, 0);
+
+    // After the reset: warm, the stale task named, the kept layers back
+    boot(true, 0);
+    TEST_CHECK(Supervisor_IsWarm(&sup));
+    TEST_EQUAL(sup.previous.stale, scan_id);
+    TEST_EQUAL(sup.previous.resets, 0);
+    TEST_EQUAL(Supervisor_Kept(&sup, 0), 0x5);
+    TEST_EQUAL(Supervisor_Kept(&sup, SUPERVISOR_KEEP_WORDS), 0);
+    capture_report();
+    TEST_CHECK(strstr(report, "Watchdog reset 1 at ") != NULL);
+    TEST_CHECK(strstr(report, "stale heartbeat: scan\n") != NULL);
+    TEST_CHECK(strstr(report, "detail") == NULL);
+    // The new record starts clean apart from the count and the kept words
+    TEST_EQUAL(crumbs.resets, 1);
+    TEST_EQUAL(crumbs.stale, SUPERVISOR_NONE);
+    TEST_EQUAL(crumbs.keep[0], 0x5);
+}
+
+static void test_loop_hangs(void) {
+    memset(&crumbs, 0, sizeof(crumbs));
+    boot(false, 0);
+    uint32_t hang_us = 7000 * MS;
+    Run run = simulate(0, 20000, HANG_LOOP, hang_us, 0x2);
+    // Nobody checks, so nothing trips, the feed just stops
+    TEST_EQUAL(run.tripped_at_us, 0);
+    TEST_CHECK(run.last_feed_us < hang_us && run.last_feed_us > hang_us - PERIOD_US);
+    TEST_EQUAL(run.reset_at_us, run.last_feed_us + WATCHDOG_US + MS);
+
+    boot(true, 0);
+    TEST_CHECK(Supervisor_IsWarm(&sup));
+    TEST_EQUAL(sup.previous.task, TASK_SCAN);
+    TEST_EQUAL(sup.previous.detail, 0x20);
+    TEST_EQUAL(sup.previous.stale, SUPERVISOR_NONE);
+    TEST_EQUAL(sup.previous.uptime_ms, 7000);
+    capture_report();
+    TEST_CHECK(strstr(report, "last task started: scan\n") != NULL);
+    TEST_CHECK(strstr(report, "the main loop hung\n") != NULL);
+    TEST_CHECK(strstr(report, "detail: 00000020\n") != NULL);
+
+    // Reset again the same way, the count carries on
+    simulate(0, 20000, HANG_LOOP, hang_us, 0x2);
+    boot(true, 0);
+    TEST_EQUAL(sup.previous.resets, 1);
+    TEST_EQUAL(crumbs.resets, 2);
+    TEST_EQUAL(Supervisor_Kept(&sup, 0), 0x2);
+}
+
+static void test_trip_is_final(void) {
+    memset(&crumbs, 0, sizeof(crumbs));
+    boot(false, 0);
+    TEST_CHECK(Supervisor_Check(&sup, SCAN_TIMEOUT_US));
+    TEST_CHECK(!Supervisor_Check(&sup, SCAN_TIMEOUT_US + 1));
+    // Beating again doesn't help, the watchdog has to reset us
+    Supervisor_Heartbeat(&sup, scan_id, SCAN_TIMEOUT_US + 2);
+    Supervisor_Heartbeat(&sup, console_id, SCAN_TIMEOUT_US + 2);
+    TEST_CHECK(!Supervisor_Check(&sup, SCAN_TIMEOUT_US + 3));
+    TEST_EQUAL(sup.watched[scan_id].misses, 1);
+
+    // A pause on purpose (dormant) isn't a hang once resumed
+    boot(false, 0);
+    Supervisor_Resume(&sup, 3600000u * MS);
+    TEST_CHECK(Supervisor_Check(&sup, 3600000u * MS + SCAN_TIMEOUT_US));
+    // Unknown ids are ignored, the table has a limit
+    Supervisor_Heartbeat(&sup, SUPERVISOR_MAX_WATCHED, 0);
+    for (uint8_t i = 2; i < SUPERVISOR_MAX_WATCHED; i++) {
+        TEST_EQUAL(Supervisor_Watch(&sup, "extra", 1000, 0), i);
+    }
+    TEST_EQUAL(Supervisor_Watch(&sup, "extra", 1000, 0), -1);
+}
+
+static void test_record_integrity(void) {
+    // Power on: RAM is whatever it is, never a warm boot
+    srand(44);
+    for (uint8_t i = 0; i < 100; i++) {
+        for (uint32_t w = 0; w < sizeof(crumbs) / sizeof(uint32_t); w++) {
+            ((uint32_t *)&crumbs)[w] = rand();
+        }
+        if (i & 1) {
+            crumbs.magic = SUPERVISOR_MAGIC;
+        }
+        boot(true, 0);
+        TEST_CHECK(!Supervisor_IsWarm(&sup));
+        TEST_EQUAL(Supervisor_Kept(&sup, 0), 0);
+        TEST_EQUAL(crumbs.resets, 0);
+    }
+
+    // Thousands of breadcrumb stores keep the check word right
+    boot(false, 0);
+    for (uint32_t i = 0; i < 10000; i++) {
+        switch (rand() % 3) {
+            case 0: Supervisor_TaskStarted(&sup, rand() % 3, rand()); break;
+            case 1: Supervisor_Detail(&sup, rand()); break;
+            default: Supervisor_Keep(&sup, rand() % (SUPERVISOR_KEEP_WORDS + 1), rand() % 4); break;
+        }
+    }
+    Supervisor_Crumbs saved = crumbs;
+    boot(true, 0);
+    TEST_CHECK(Supervisor_IsWarm(&sup));
+    TEST_EQUAL(memcmp(&sup.previous, &saved, sizeof(saved)), 0);
+
+    // A single flipped bit anywhere and the record isn't trusted
+    for (uint32_t bit = 0; bit < sizeof(crumbs) * 8; bit++) {
+        crumbs = saved;
+        ((uint8_t *)&crumbs)[bit / 8] ^= 1 << (bit % 8);
+        boot(true, 0);
+        if (Supervisor_IsWarm(&sup)) {
+            TEST_CHECK(!"corrupt record taken as warm");
+            break;
+        }
+    }
+    // A good record after a power on reset is still a cold boot
+    crumbs = saved;
+    boot(false, 0);
+    TEST_CHECK(!Supervisor_IsWarm(&sup));
+    TEST_EQUAL(Supervisor_Kept(&sup, 0), 0);
+}
+
+// Lock hooks that check every store is bracketed and leaves the check word right
+static uint32_t lock_depth;
+static uint32_t lock_taken;
+static uint32_t lock_bad;
+
+static uint32_t check_of(const Supervisor_Crumbs *record) {
+    uint32_t check = 0;
+    for (uint32_t w = 0; w < offsetof(Supervisor_Crumbs, check) / sizeof(uint32_t); w++) {
+        check ^= ((const uint32_t *)record)[w];
+    }
+    return check;
+}
+
+static uint32_t test_lock(void *context) {
+    lock_bad += lock_depth != 0 || crumbs.check != check_of(&crumbs);
+    lock_depth++;
+    lock_taken++;
+    return 0x1234;
+}
+
+static void test_unlock(void *context, uint32_t saved) {
+    lock_bad += lock_depth != 1 || saved != 0x1234 || context != &crumbs || crumbs.check != check_of(&crumbs);
+    lock_depth--;
+}
+
+static void test_lock_held(void) {
+    boot(false, 0);
+    lock_depth = lock_taken = lock_bad = 0;
+    Supervisor_SetLock(&sup, test_lock, test_unlock, &crumbs);
+    Supervisor_TaskStarted(&sup, TASK_SCAN, 1);
+    TEST_EQUAL(lock_taken, 2);
+    Supervisor_Detail(&sup, 0x20);
+    Supervisor_Keep(&sup, 0, 0x3);
+    TEST_EQUAL(lock_taken, 4);
+    // Unchanged keep word, no store
+    Supervisor_Keep(&sup, 0, 0x3);
+    TEST_EQUAL(lock_taken, 4);
+    // A stale task records itself under the lock too
+    TEST_CHECK(!Supervisor_Check(&sup, SCAN_TIMEOUT_US + 1));
+    TEST_EQUAL(lock_taken, 5);
+    TEST_EQUAL(lock_depth, 0);
+    TEST_EQUAL(lock_bad, 0);
+    // Boot again leaves the lock off until it's set
+    boot(true, 0);
+    TEST_CHECK(Supervisor_IsWarm(&sup));
+    Supervisor_Detail(&sup, 0x21);
+    TEST_EQUAL(lock_taken, 5);
+}
+
+int main(void) {
+    TEST_RUN(test_healthy);
+    TEST_RUN(test_task_stops_beating);
+    TEST_RUN(test_loop_hangs);
+    TEST_RUN(test_trip_is_final);
+    TEST_RUN(test_record_integrity);
+    TEST_RUN(test_lock_held);
+    return TEST_RESULT();
+}
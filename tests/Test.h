@@ -0,0 +1,69 @@
+/*
+ *
+ *  Host Test Assertions
+ *
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *
+*/
+
+#ifndef _TEST_H
+#define _TEST_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+// Each test file is one executable (one ctest test). A failed check prints where and
+// carries on with the next, main returns TEST_RESULT() so ctest sees any failure
+
+static int test_failures;
+static int test_checks;
+
+#define TEST_CHECK(condition) do { \
+        test_checks++; \
+        if (!(condition)) { \
+            test_failures++; \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+        } \
+    } while (0)
+
+// Integers, both values are printed on failure
+#define TEST_EQUAL(actual, expected) do { \
+        long long test_actual = (long long)(actual); \
+        long long test_expected = (long long)(expected); \
+        test_checks++; \
+        if (test_actual != test_expected) { \
+            test_failures++; \
+            fprintf(stderr, "%s:%d: %s is %lld (0x%llx), expected %lld (0x%llx)\n", __FILE__, __LINE__, #actual, \
+                    test_actual, (unsigned long long)test_actual, test_expected, (unsigned long long)test_expected); \
+        } \
+    } while (0)
+
+#define TEST_RUN(function) do { \
+        int test_before = test_failures; \
+        function(); \
+        printf("%s %s\n", test_failures == test_before ? "ok  " : "FAIL", #function); \
+    } while (0)
+
+// Benchmarks print host time per operation and never fail, the numbers are for comparing
+// two ways of doing the same thing on the same machine, not for the RP2040
+static inline uint64_t test_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+#define TEST_BENCH(label, iterations, statement) do { \
+        uint64_t test_start = test_now_ns(); \
+        for (uint32_t test_i = 0; test_i < (iterations); test_i++) { \
+            statement; \
+        } \
+        uint64_t test_elapsed = test_now_ns() - test_start; \
+        printf("bench %-32s %8.1f ns\n", label, (double)test_elapsed / (iterations)); \
+    } while (0)
+
+#define TEST_RESULT() (printf("%d checks, %d failed\n", test_checks, test_failures), test_failures ? 1 : 0)
+#endif
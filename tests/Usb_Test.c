@@ -0,0 +1,583 @@
+/*
+ *
+ *  USB Descriptor And Transport Tests
+ *
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *
+*/
+
+// The firmware's function list built and walked the way a host would: lengths, interface
+// and endpoint numbering, report descriptors against what the transport sends. Then the
+// transport policy against recording hooks: order per poll, busy endpoints, no host,
+// suspend, raw HID replies and CDC batching
+
+#include <string.h>
+#include "Test.h"
+#include "UsbDescriptors.h"
+#include "UsbTransport.h"
+#include "Keymap.h"
+
+#define DESC_INTERFACE  0x04
+#define DESC_ENDPOINT   0x05
+#define DESC_IAD        0x0B
+#define DESC_HID        0x21
+
+// As Usb.c
+static const UsbDescriptors_Function firmware_functions[] = {
+    {USBDESC_FUNCTION_KEYBOARD, 1, USBDESC_STRING_KEYBOARD},
+    {USBDESC_FUNCTION_CONSUMER, 1, USBDESC_STRING_CONSUMER},
+    {USBDESC_FUNCTION_RAW_HID, 1, USBDESC_STRING_RAW},
+    {USBDESC_FUNCTION_CDC, 0, USBDESC_STRING_CDC},
+};
+
+// Bits in and out of a report descriptor, from its global report size and count items
+typedef struct {
+    uint32_t input_bits;
+    uint32_t output_bits;
+    int depth;
+    bool balanced;
+} ReportShape;
+
+static ReportShape report_shape(const uint8_t *report, uint16_t length) {
+    ReportShape shape = {0, 0, 0, true};
+    uint32_t size = 0;
+    uint32_t count = 0;
+    uint16_t i = 0;
+    while (i < length) {
+        uint8_t prefix = report[i];
+        uint8_t bytes = (prefix & 3) == 3 ? 4 : prefix & 3;
+        uint32_t value = 0;
+        for (uint8_t b = 0; b < bytes; b++) {
+            value |= (uint32_t)report[i + 1 + b] << (8 * b);
+        }
+        switch (prefix & 0xFC) {
+        case 0x74: size = value; break;
+        case 0x94: count = value; break;
+        case 0x80: shape.input_bits += size * count; break;
+        case 0x90: shape.output_bits += size * count; break;
+        case 0xA0: shape.depth++; break;
+        case 0xC0: shape.balanced &= --shape.depth >= 0; break;
+        }
+        i += 1 + bytes;
+    }
+    shape.balanced &= shape.depth == 0 && i == length;
+    return shape;
+}
+
+static void test_report_descriptors(void) {
+    uint16_t length;
+    const uint8_t *report = UsbDescriptors_HidReport(USBDESC_FUNCTION_KEYBOARD, &length);
+    TEST_CHECK(report == UsbDescriptors_KeyboardReport);
+    ReportShape shape = report_shape(report, length);
+    TEST_CHECK(shape.balanced);
+    // The transport sends HidKeyboardReport as is, the host reads it as the boot layout
+    TEST_EQUAL(shape.input_bits, 8 * sizeof(HidKeyboardReport));
+    TEST_EQUAL(shape.input_bits / 8, USBDESC_KEYBOARD_EP_SIZE);
+    TEST_EQUAL(shape.output_bits, 8); // LEDs
+
+    // Consumer control, the 2 byte usage the transport sends
+    report = UsbDescriptors_HidReport(USBDESC_FUNCTION_CONSUMER, &length);
+    TEST_CHECK(report == UsbDescriptors_ConsumerReport);
+    shape = report_shape(report, length);
+    TEST_CHECK(shape.balanced);
+    TEST_EQUAL(shape.input_bits, 16);
+    TEST_EQUAL(shape.output_bits, 0);
+    TEST_EQUAL(report[1], 0x0C); // Consumer page
+    TEST_CHECK(KC_CONSUMER_USAGE(KC_VOLU) <= (report[9] | report[10] << 8));
+
+    report = UsbDescriptors_HidReport(USBDESC_FUNCTION_RAW_HID, &length);
+    shape = report_shape(report, length);
+    TEST_CHECK(shape.balanced);
+    TEST_EQUAL(shape.input_bits, 8 * USBTRANSPORT_RAW_REPORT_SIZE);
+    TEST_EQUAL(shape.output_bits, 8 * USBTRANSPORT_RAW_REPORT_SIZE);
+    TEST_EQUAL(report[1] | report[2] << 8, 0xFF60);
+
+    TEST_CHECK(UsbDescriptors_HidReport(USBDESC_FUNCTION_CDC, &length) == NULL);
+}
+
+// Walks the configuration descriptor as a host parses it
+static void test_configuration(void) {
+    UsbDescriptors_Configuration config;
+    int total = UsbDescriptors_BuildConfiguration(&config, firmware_functions, 4, 500, true);
+    TEST_CHECK(total > 0);
+    TEST_EQUAL(total, config.length);
+    const uint8_t *data = config.data;
+    TEST_EQUAL(data[1], 0x02);
+    TEST_EQUAL(data[2] | data[3] << 8, total);
+    TEST_EQUAL(data[4], 5); // CDC takes two
+    TEST_EQUAL(config.interface_count, 5);
+    TEST_EQUAL(data[7], 0x80 | 0x20);
+    TEST_EQUAL(data[8], 250);
+
+    uint8_t interfaces = 0;
+    uint8_t endpoints_declared = 0;
+    uint8_t endpoints_found = 0;
+    uint32_t addresses_used = 0;
+    uint8_t iads = 0;
+    uint8_t hid_interfaces = 0;
+    uint16_t i = 0;
+    while (i < total) {
+        uint8_t length = data[i];
+        if (length < 2 || i + length > total) {
+            TEST_CHECK(!"bad descriptor length");
+            return;
+        }
+        switch (data[i + 1]) {
+        case DESC_INTERFACE:
+            // Numbered in order with no gaps
+            TEST_EQUAL(data[i + 2], interfaces);
+            interfaces++;
+            endpoints_declared += data[i + 4];
+            hid_interfaces += data[i + 5] == 0x03;
+            break;
+        case DESC_ENDPOINT: {
+            // Each address once only, IN and OUT are separate
+            uint32_t bit = 1u << ((data[i + 2] & 0x0F) + (data[i + 2] & 0x80 ? 16 : 0));
+            TEST_CHECK(!(addresses_used & bit));
+            TEST_CHECK((data[i + 2] & 0x0F) != 0 && (data[i + 2] & 0x0F) <= USBDESC_MAX_ENDPOINT);
+            addresses_used |= bit;
+            endpoints_found++;
+            break;
+        }
+        case DESC_IAD:
+            // CDC control and data under one function
+            TEST_EQUAL(data[i + 2], config.assigned[3].interface);
+            TEST_EQUAL(data[i + 3], 2);
+            iads++;
+            break;
+        case DESC_HID: {
+            // Follows its interface, names the report descriptor's length
+            uint16_t expected;
+            const UsbDescriptors_Function *function = &firmware_functions[hid_interfaces - 1];
+            UsbDescriptors_HidReport(function->type, &expected);
+            TEST_EQUAL(data[i + 7] | data[i + 8] << 8, expected);
+            break;
+        }
+        }
+        i += length;
+    }
+    TEST_EQUAL(i, total);
+    TEST_EQUAL(interfaces, 5);
+    TEST_EQUAL(endpoints_found, endpoints_declared);
+    TEST_EQUAL(endpoints_found, 1 + 1 + 2 + 3);
+    TEST_EQUAL(iads, 1);
+    TEST_EQUAL(hid_interfaces, 3);
+
+    // What Usb.c takes from the assignment
+    TEST_EQUAL(config.assigned[0].ep_in, 0x81);
+    TEST_EQUAL(config.assigned[0].instance, 0);
+    TEST_EQUAL(config.assigned[1].ep_in, 0x82);
+    TEST_EQUAL(config.assigned[1].instance, 1);
+    TEST_EQUAL(config.assigned[2].ep_in, 0x83);
+    TEST_EQUAL(config.assigned[2].ep_out, 0x03);
+    TEST_EQUAL(config.assigned[2].instance, 2);
+    TEST_EQUAL(config.assigned[3].interface, 3);
+    TEST_EQUAL(config.assigned[3].ep_notify, 0x84);
+    TEST_EQUAL(config.assigned[3].ep_out, 0x05);
+    TEST_EQUAL(config.assigned[3].ep_in, 0x85);
+    TEST_EQUAL(config.assigned[3].instance, 0);
+
+    // Keyboard interface is the boot keyboard, polled every 1ms
+    TEST_EQUAL(data[9 + 5], 0x03);
+    TEST_EQUAL(data[9 + 6], 0x01);
+    TEST_EQUAL(data[9 + 7], 0x01);
+    TEST_EQUAL(data[9 + 9 + 9 + 6], 1);
+
+    // No wakeup, bus powered 100mA
+    UsbDescriptors_BuildConfiguration(&config, firmware_functions, 1, 100, false);
+    TEST_EQUAL(config.data[7], 0x80);
+    TEST_EQUAL(config.data[8], 50);
+    TEST_EQUAL(config.length, 9 + 9 + 9 + 7);
+}
+
+static void test_configuration_limits(void) {
+    UsbDescriptors_Configuration config;
+    UsbDescriptors_Function functions[USBDESC_MAX_FUNCTIONS + 1];
+    for (uint8_t i = 0; i <= USBDESC_MAX_FUNCTIONS; i++) {
+        functions[i] = (UsbDescriptors_Function){USBDESC_FUNCTION_KEYBOARD, 1, 0};
+    }
+    TEST_CHECK(UsbDescriptors_BuildConfiguration(&config, functions, USBDESC_MAX_FUNCTIONS, 100, false) > 0);
+    TEST_EQUAL(UsbDescriptors_BuildConfiguration(&config, functions, USBDESC_MAX_FUNCTIONS + 1, 100, false), -1);
+    // Four CDC functions are more than the buffer holds
+    for (uint8_t i = 0; i < USBDESC_MAX_FUNCTIONS; i++) {
+        functions[i] = (UsbDescriptors_Function){USBDESC_FUNCTION_CDC, 0, 0};
+    }
+    TEST_EQUAL(UsbDescriptors_BuildConfiguration(&config, functions, USBDESC_MAX_FUNCTIONS, 100, false), -1);
+    TEST_CHECK(UsbDescriptors_BuildConfiguration(&config, functions, 3, 100, false) > 0);
+    TEST_EQUAL(config.assigned[2].ep_notify, 0x85);
+    TEST_EQUAL(config.assigned[2].ep_in, 0x86);
+    TEST_EQUAL(config.assigned[2].instance, 2);
+}
+
+static void test_device_and_strings(void) {
+    uint8_t device[18];
+    UsbDescriptors_BuildDevice(device, 0x1209, 0x0001, 0x0102);
+    const uint8_t expected[18] = {18, 0x01, 0x00, 0x02, 0xEF, 0x02, 0x01, 64, 0x09, 0x12, 0x01, 0x00, 0x02, 0x01,
+                                  USBDESC_STRING_MANUFACTURER, USBDESC_STRING_PRODUCT, USBDESC_STRING_SERIAL, 1};
+    TEST_CHECK(memcmp(device, expected, sizeof(expected)) == 0);
+
+    uint16_t string[8];
+    TEST_EQUAL(UsbDescriptors_BuildString(string, 8, "Pad"), 8);
+    TEST_EQUAL(string[0], 0x0300 | 8);
+    TEST_EQUAL(string[1], 'P');
+    TEST_EQUAL(string[3], 'd');
+    // Cut to what fits after the header
+    TEST_EQUAL(UsbDescriptors_BuildString(string, 8, "Jennifer Chan"), 2 + 2 * 7);
+    TEST_EQUAL(string[0], 0x0300 | 16);
+    TEST_EQUAL(string[7], 'e');
+}
+
+// Recording hooks: a host that can be missing, suspended, or slow on any endpoint
+typedef struct {
+    bool mounted;
+    bool suspended;
+    bool ready[USBTRANSPORT_CHANNEL_COUNT];
+    uint32_t refuse[USBTRANSPORT_CHANNEL_COUNT]; // Sends to refuse while saying ready
+    uint32_t cdc_space;
+    uint32_t wakeups;
+    // Every send in order
+    uint8_t channels[64];
+    uint8_t data[64][USBTRANSPORT_RAW_REPORT_SIZE];
+    uint32_t lengths[64];
+    uint32_t sends;
+} Host;
+
+static Host host;
+
+static bool host_mounted(void *context) {
+    return ((Host *)context)->mounted;
+}
+
+static bool host_suspended(void *context) {
+    return ((Host *)context)->suspended;
+}
+
+static void host_remote_wakeup(void *context) {
+    ((Host *)context)->wakeups++;
+}
+
+static bool host_ready(void *context, UsbTransport_Channel channel) {
+    return ((Host *)context)->ready[channel];
+}
+
+static bool host_send(void *context, UsbTransport_Channel channel, const uint8_t *data, uint32_t length) {
+    Host *h = (Host *)context;
+    if (h->refuse[channel] > 0) {
+        h->refuse[channel]--;
+        return false;
+    }
+    if (h->sends < 64) {
+        h->channels[h->sends] = channel;
+        memcpy(h->data[h->sends], data, length);
+        h->lengths[h->sends] = length;
+    }
+    h->sends++;
+    if (channel == USBTRANSPORT_CDC) {
+        h->cdc_space -= length;
+    }
+    return true;
+}
+
+static uint32_t host_cdc_space(void *context) {
+    return ((Host *)context)->cdc_space;
+}
+
+static const UsbTransport_Hooks host_hooks = {
+    host_mounted, host_suspended, host_remote_wakeup, host_ready, host_send, host_cdc_space,
+};
+
+static HidReport hid;
+static UsbTransport usb;
+
+static void setup(void) {
+    memset(&host, 0, sizeof(host));
+    host.mounted = true;
+    for (uint8_t i = 0; i < USBTRANSPORT_CHANNEL_COUNT; i++) {
+        host.ready[i] = true;
+    }
+    host.cdc_space = 256;
+    HidReport_Initialise(&hid);
+    UsbTransport_Initialise(&usb, &host_hooks, &host, &hid);
+}
+
+static void key(uint16_t keycode, uint8_t edge) {
+    KeyEvent event = {0};
+    event.edge = edge;
+    event.keycode = keycode;
+    TEST_CHECK(HidReport_Stage(&hid, &event));
+}
+
+// Raw handler echoing the command with a marker
+static void raw_echo(void *context, const uint8_t *request, uint8_t *reply) {
+    (*(uint32_t *)context)++;
+    reply[0] = request[0];
+    reply[1] = 0xAA;
+    reply[63] = request[63];
+}
+
+static void test_poll_order(void) {
+    setup();
+    uint32_t requests = 0;
+    UsbTransport_SetRawHandler(&usb, raw_echo, &requests);
+    // A bit of everything waiting at once
+    UsbTransport_Write(&usb, "0123456789012345678901234567890123456789012345678901234567890123"
+                             "0123456789012345678901234567890123456789012345678901234567890123"
+                             "0123456789012345678901234567890123456789012345678901234567890123", 192, 0);
+    uint8_t request[3] = {0x01, 0, 0};
+    UsbTransport_RawReceived(&usb, request, sizeof(request));
+    key(KC_VOLU, KEYEVENT_PRESS);
+    key(0x04, KEYEVENT_PRESS);
+    key(0x04, KEYEVENT_RELEASE);
+    key(KC_VOLU, KEYEVENT_RELEASE);
+
+    UsbTransport_Poll(&usb, 0);
+    // One keyboard report, one consumer report, the raw reply, then the CDC budget
+    TEST_EQUAL(host.sends, 3 + USBTRANSPORT_CDC_PACKETS_PER_POLL);
+    TEST_EQUAL(host.channels[0], USBTRANSPORT_KEYBOARD);
+    TEST_EQUAL(host.lengths[0], sizeof(HidKeyboardReport));
+    TEST_EQUAL(host.data[0][2], 0x04);
+    TEST_EQUAL(host.channels[1], USBTRANSPORT_CONSUMER);
+    TEST_EQUAL(host.lengths[1], 2);
+    TEST_EQUAL(host.data[1][0], 0xE9);
+    TEST_EQUAL(host.data[1][1], 0x00);
+    TEST_EQUAL(host.channels[2], USBTRANSPORT_RAW);
+    TEST_EQUAL(host.lengths[2], USBTRANSPORT_RAW_REPORT_SIZE);
+    TEST_EQUAL(host.data[2][0], 0x01);
+    TEST_EQUAL(host.data[2][1], 0xAA);
+    TEST_EQUAL(host.channels[3], USBTRANSPORT_CDC);
+    TEST_EQUAL(host.lengths[3], TELEMETRY_PACKET_SIZE);
+    TEST_EQUAL(host.channels[4], USBTRANSPORT_CDC);
+
+    // The releases, and the last CDC packet
+    UsbTransport_Poll(&usb, 1000);
+    TEST_EQUAL(host.sends, 5 + 3);
+    TEST_EQUAL(host.channels[5], USBTRANSPORT_KEYBOARD);
+    TEST_EQUAL(host.data[5][2], 0x00);
+    TEST_EQUAL(host.channels[6], USBTRANSPORT_CONSUMER);
+    TEST_EQUAL(host.data[6][0], 0x00);
+    TEST_EQUAL(host.channels[7], USBTRANSPORT_CDC);
+    TEST_CHECK(!HidReport_Pending(&hid));
+    TEST_EQUAL(usb.sent[USBTRANSPORT_KEYBOARD], 2);
+    TEST_EQUAL(usb.sent[USBTRANSPORT_CONSUMER], 2);
+    TEST_EQUAL(usb.sent[USBTRANSPORT_RAW], 1);
+    TEST_EQUAL(usb.sent[USBTRANSPORT_CDC], 3);
+    TEST_EQUAL(requests, 1);
+}
+
+static void test_busy_endpoints(void) {
+    setup();
+    key(0x04, KEYEVENT_PRESS);
+    key(KC_MUTE, KEYEVENT_PRESS);
+    // Neither endpoint free: both stay queued, nothing dropped
+    host.ready[USBTRANSPORT_KEYBOARD] = false;
+    host.ready[USBTRANSPORT_CONSUMER] = false;
+    UsbTransport_Poll(&usb, 0);
+    TEST_EQUAL(host.sends, 0);
+    TEST_CHECK(HidReport_Pending(&hid));
+    // A busy keyboard endpoint doesn't hold the consumer one up
+    host.ready[USBTRANSPORT_CONSUMER] = true;
+    UsbTransport_Poll(&usb, 1000);
+    TEST_EQUAL(host.sends, 1);
+    TEST_EQUAL(host.channels[0], USBTRANSPORT_CONSUMER);
+    TEST_EQUAL(host.data[0][0], 0xE2);
+    host.ready[USBTRANSPORT_KEYBOARD] = true;
+    UsbTransport_Poll(&usb, 2000);
+    TEST_EQUAL(host.sends, 2);
+    TEST_EQUAL(host.channels[1], USBTRANSPORT_KEYBOARD);
+    TEST_EQUAL(host.data[1][2], 0x04);
+    TEST_EQUAL(usb.keyboard_dropped, 0);
+
+    // A raw reply waits for its endpoint, a second request before it goes replaces it
+    uint32_t requests = 0;
+    UsbTransport_SetRawHandler(&usb, raw_echo, &requests);
+    host.ready[USBTRANSPORT_RAW] = false;
+    uint8_t request[USBTRANSPORT_RAW_REPORT_SIZE + 8];
+    memset(request, 0x11, sizeof(request));
+    UsbTransport_RawReceived(&usb, request, sizeof(request));
+    UsbTransport_Poll(&usb, 3000);
+    TEST_EQUAL(host.sends, 2);
+    request[0] = 0x02;
+    UsbTransport_RawReceived(&usb, request, 1);
+    TEST_EQUAL(usb.raw_overrun, 1);
+    host.ready[USBTRANSPORT_RAW] = true;
+    UsbTransport_Poll(&usb, 4000);
+    UsbTransport_Poll(&usb, 5000);
+    TEST_EQUAL(host.sends, 3);
+    TEST_EQUAL(host.data[2][0], 0x02);
+    // Short requests are padded with zeros, long ones cut to a report
+    TEST_EQUAL(host.data[2][63], 0x00);
+    TEST_EQUAL(requests, 2);
+}
+
+// Ready, then the send is refused anyway (busy again, or suspended in between). The report
+// stays queued and goes on a later poll, a release is never lost
+static void test_refused_send(void) {
+    setup();
+    key(0x04, KEYEVENT_PRESS);
+    key(0x04, KEYEVENT_RELEASE);
+    key(KC_MUTE, KEYEVENT_PRESS);
+    key(KC_MUTE, KEYEVENT_RELEASE);
+    host.refuse[USBTRANSPORT_KEYBOARD] = 1;
+    host.refuse[USBTRANSPORT_CONSUMER] = 2;
+    UsbTransport_Poll(&usb, 0);
+    TEST_EQUAL(host.sends, 0);
+    TEST_EQUAL(usb.send_failed, 2);
+    TEST_CHECK(HidReport_Pending(&hid));
+
+    // Keyboard goes, the consumer endpoint refuses once more
+    UsbTransport_Poll(&usb, 1000);
+    TEST_EQUAL(host.sends, 1);
+    TEST_EQUAL(host.channels[0], USBTRANSPORT_KEYBOARD);
+    TEST_EQUAL(host.data[0][2], 0x04);
+    TEST_EQUAL(usb.send_failed, 3);
+
+    // Then everything in order, the releases last
+    for (uint32_t t = 2000; t < 10000; t += 1000) {
+        UsbTransport_Poll(&usb, t);
+    }
+    TEST_EQUAL(host.sends, 4);
+    TEST_EQUAL(host.channels[1], USBTRANSPORT_KEYBOARD);
+    TEST_EQUAL(host.data[1][2], 0x00);
+    TEST_EQUAL(host.channels[2], USBTRANSPORT_CONSUMER);
+    TEST_EQUAL(host.data[2][0], 0xE2);
+    TEST_EQUAL(host.channels[3], USBTRANSPORT_CONSUMER);
+    TEST_EQUAL(host.data[3][0], 0x00);
+    TEST_CHECK(!HidReport_Pending(&hid));
+    TEST_EQUAL(usb.sent[USBTRANSPORT_KEYBOARD], 2);
+    TEST_EQUAL(usb.sent[USBTRANSPORT_CONSUMER], 2);
+    TEST_EQUAL(usb.send_failed, 3);
+
+    // A refused raw reply is kept too
+    uint32_t requests = 0;
+    UsbTransport_SetRawHandler(&usb, raw_echo, &requests);
+    uint8_t request[USBTRANSPORT_RAW_REPORT_SIZE] = {0x01};
+    UsbTransport_RawReceived(&usb, request, sizeof(request));
+    host.refuse[USBTRANSPORT_RAW] = 1;
+    UsbTransport_Poll(&usb, 10000);
+    TEST_EQUAL(host.sends, 4);
+    TEST_EQUAL(usb.send_failed, 4);
+    UsbTransport_Poll(&usb, 11000);
+    TEST_EQUAL(host.sends, 5);
+    TEST_EQUAL(host.channels[4], USBTRANSPORT_RAW);
+    TEST_EQUAL(usb.sent[USBTRANSPORT_RAW], 1);
+}
+
+static void test_no_host_and_suspend(void) {
+    setup();
+    host.mounted = false;
+    key(0x04, KEYEVENT_PRESS);
+    key(0x04, KEYEVENT_RELEASE);
+    key(KC_VOLD, KEYEVENT_PRESS);
+    UsbTransport_Write(&usb, "boot", 4, 0);
+    UsbTransport_Poll(&usb, 0);
+    // Reports dropped so the pipeline keeps moving, console output kept for later
+    TEST_EQUAL(host.sends, 0);
+    TEST_EQUAL(usb.keyboard_dropped, 3);
+    TEST_CHECK(!HidReport_Pending(&hid));
+    TEST_EQUAL(Telemetry_Pending(&usb.telemetry), 4);
+
+    // Suspended: a key press asks for a wakeup once, nothing is sent
+    host.mounted = true;
+    host.suspended = true;
+    UsbTransport_Poll(&usb, 1000);
+    TEST_EQUAL(host.wakeups, 0);
+    key(0x05, KEYEVENT_PRESS);
+    key(0x05, KEYEVENT_RELEASE);
+    for (uint32_t t = 2000; t < 100000; t += 1000) {
+        UsbTransport_Poll(&usb, t);
+    }
+    TEST_EQUAL(host.wakeups, 1);
+    TEST_EQUAL(host.sends, 0);
+    // Resumed: the reports that woke it follow, with the console output
+    host.suspended = false;
+    UsbTransport_Poll(&usb, 100000);
+    UsbTransport_Poll(&usb, 101000);
+    TEST_EQUAL(host.sends, 3);
+    TEST_EQUAL(host.channels[0], USBTRANSPORT_KEYBOARD);
+    TEST_EQUAL(host.data[0][2], 0x05);
+    TEST_EQUAL(host.channels[1], USBTRANSPORT_CDC);
+    TEST_EQUAL(host.lengths[1], 4);
+    TEST_EQUAL(host.channels[2], USBTRANSPORT_KEYBOARD);
+    // The next suspend may wake the host again
+    host.suspended = true;
+    key(0x06, KEYEVENT_PRESS);
+    UsbTransport_Poll(&usb, 102000);
+    TEST_EQUAL(host.wakeups, 2);
+    TEST_EQUAL(usb.wakeups, 2);
+}
+
+static void test_cdc_batching(void) {
+    setup();
+    // A short line waits for more until it has aged out
+    UsbTransport_Write(&usb, "line\n", 5, 0);
+    UsbTransport_Poll(&usb, 0);
+    UsbTransport_Poll(&usb, TELEMETRY_MAX_AGE_US - 1);
+    TEST_EQUAL(host.sends, 0);
+    UsbTransport_Write(&usb, "more\n", 5, 10000);
+    UsbTransport_Poll(&usb, TELEMETRY_MAX_AGE_US);
+    TEST_EQUAL(host.sends, 1);
+    TEST_EQUAL(host.lengths[0], 10);
+    TEST_CHECK(memcmp(host.data[0], "line\nmore\n", 10) == 0);
+
+    // With less room than a packet nothing goes, rather than a packet cut short
+    uint8_t burst[TELEMETRY_PACKET_SIZE * 4];
+    memset(burst, 'x', sizeof(burst));
+    UsbTransport_Write(&usb, burst, sizeof(burst), 30000);
+    host.cdc_space = TELEMETRY_PACKET_SIZE - 1;
+    UsbTransport_Poll(&usb, 30000);
+    TEST_EQUAL(host.sends, 1);
+    // Room for three packets, two per poll
+    host.cdc_space = 3 * TELEMETRY_PACKET_SIZE;
+    UsbTransport_Poll(&usb, 31000);
+    TEST_EQUAL(host.sends, 3);
+    UsbTransport_Poll(&usb, 32000);
+    TEST_EQUAL(host.sends, 4);
+    TEST_EQUAL(host.lengths[3], TELEMETRY_PACKET_SIZE);
+    UsbTransport_Poll(&usb, 33000);
+    TEST_EQUAL(host.sends, 4);
+    host.cdc_space = TELEMETRY_PACKET_SIZE;
+    UsbTransport_Poll(&usb, 34000);
+    TEST_EQUAL(host.sends, 5);
+    TEST_EQUAL(Telemetry_Pending(&usb.telemetry), 0);
+
+    // A full ring drops rather than blocks
+    setup();
+    uint8_t big[TELEMETRY_SIZE + 100];
+    memset(big, 'y', sizeof(big));
+    TEST_EQUAL(UsbTransport_Write(&usb, big, sizeof(big), 0), TELEMETRY_SIZE);
+}
+
+static void bench_console_burst(void) {
+    // 200 log lines of 30 bytes each, written 500us apart, polled every 1ms
+    setup();
+    host.cdc_space = 1 << 30;
+    uint32_t bytes = 0;
+    for (uint32_t t = 0; t < 200 * 500 + 2 * TELEMETRY_MAX_AGE_US; t += 500) {
+        if (t < 200 * 500) {
+            bytes += UsbTransport_Write(&usb, "[    1.234] key 12 pressed L0\n", 30, t);
+        }
+        if (t % 1000 == 0) {
+            UsbTransport_Poll(&usb, t);
+        }
+    }
+    printf("bench %-32s %5u transfers for %u bytes\n", "CDC, 200 console lines", host.sends, bytes);
+    TEST_EQUAL(bytes, 200 * 30);
+    TEST_EQUAL(host.sends, (200 * 30 + TELEMETRY_PACKET_SIZE - 1) / TELEMETRY_PACKET_SIZE);
+}
+
+int main(void) {
+    TEST_RUN(test_report_descriptors);
+    TEST_RUN(test_configuration);
+    TEST_RUN(test_configuration_limits);
+    TEST_RUN(test_device_and_strings);
+    TEST_RUN(test_poll_order);
+    TEST_RUN(test_busy_endpoints);
+    TEST_RUN(test_refused_send);
+    TEST_RUN(test_no_host_and_suspend);
+    TEST_RUN(test_cdc_batching);
+    bench_console_burst();
+    return TEST_RESULT();
+}
@@ -0,0 +1,380 @@
+/*
+ *
+ *  Host Stand-in for the Pico SDK
+ *
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *
+*/
+
+#include <string.h>
+#include "FakeSdk.h"
+#include "hardware/sync.h"
+
+struct i2c_inst {
+    int unused;
+};
+
+struct spi_inst {
+    unsigned int baudrate;
+};
+
+static struct i2c_inst fake_i2c0;
+static struct spi_inst fake_spi0;
+i2c_inst_t *const i2c0 = &fake_i2c0;
+spi_inst_t *const spi0 = &fake_spi0;
+
+static uint64_t fake_time_us;
+static uint fake_core;
+static bool fake_gpio_input[FAKE_GPIO_COUNT];
+static bool fake_gpio_output[FAKE_GPIO_COUNT];
+static spin_lock_t fake_spin_locks[32];
+static uint8_t fake_spin_next;
+
+static struct {
+    uint8_t address;
+    FakeI2C_Device device;
+} fake_i2c_devices[FAKE_I2C_MAX_DEVICES];
+static uint8_t fake_i2c_count;
+static uint32_t fake_i2c_fail;
+static int fake_i2c_error;
+static uint32_t fake_i2c_baudrate;
+
+static FakeSPI_Device fake_spi_devices[FAKE_SPI_MAX_DEVICES];
+static uint8_t fake_spi_count;
+static uint32_t fake_spi_short;
+static int32_t fake_spi_frame = -1; // Log entry of the open frame
+
+static Fake_Transfer fake_log[FAKE_LOG_TRANSFERS];
+static uint32_t fake_log_count;
+static uint8_t fake_log_bytes[FAKE_LOG_BYTES];
+static uint32_t fake_log_used;
+
+void FakeSdk_Reset(void) {
+    fake_time_us = 0;
+    fake_core = 0;
+    for (uint i = 0; i < FAKE_GPIO_COUNT; i++) {
+        fake_gpio_input[i] = true;
+        fake_gpio_output[i] = true;
+    }
+    memset((void *)fake_spin_locks, 0, sizeof(fake_spin_locks));
+    fake_spin_next = 0;
+    fake_i2c_count = 0;
+    fake_i2c_fail = 0;
+    fake_i2c_baudrate = 0;
+    fake_spi_count = 0;
+    fake_spi_short = 0;
+    fake_spi_frame = -1;
+    fake_spi0.baudrate = 1000000;
+    Fake_ClearLog();
+}
+
+void FakeSdk_SetTime(uint64_t time_us) {
+    fake_time_us = time_us;
+}
+
+void FakeSdk_Advance(uint64_t us) {
+    fake_time_us += us;
+}
+
+void FakeSdk_SetCore(uint core) {
+    fake_core = core;
+}
+
+// Time
+uint32_t time_us_32(void) {
+    return (uint32_t)fake_time_us;
+}
+
+uint64_t time_us_64(void) {
+    return fake_time_us;
+}
+
+void busy_wait_us_32(uint32_t delay_us) {
+    fake_time_us += delay_us;
+}
+
+void sleep_us(uint64_t us) {
+    fake_time_us += us;
+}
+
+void sleep_ms(uint32_t ms) {
+    fake_time_us += (uint64_t)ms * 1000;
+}
+
+uint get_core_num(void) {
+    return fake_core;
+}
+
+void tight_loop_contents(void) {
+    fake_time_us++;
+}
+
+// Spinlocks, one thread so they never spin
+int spin_lock_claim_unused(bool required) {
+    return fake_spin_next++;
+}
+
+spin_lock_t *spin_lock_instance(unsigned int lock_num) {
+    return &fake_spin_locks[lock_num % 32];
+}
+
+uint32_t spin_lock_blocking(spin_lock_t *lock) {
+    *lock = 1;
+    return 0;
+}
+
+void spin_unlock(spin_lock_t *lock, uint32_t saved_irq) {
+    *lock = 0;
+}
+
+// Transfer log
+static Fake_Transfer *Fake_Log(Fake_TransferKind kind, uint8_t address, bool nostop) {
+    if (fake_log_count >= FAKE_LOG_TRANSFERS) {
+        return NULL;
+    }
+    Fake_Transfer *transfer = &fake_log[fake_log_count++];
+    memset(transfer, 0, sizeof(Fake_Transfer));
+    transfer->kind = kind;
+    transfer->address = address;
+    transfer->nostop = nostop;
+    transfer->offset = fake_log_used;
+    transfer->time_us = fake_time_us;
+    return transfer;
+}
+
+static void Fake_LogBytes(Fake_Transfer *transfer, const uint8_t *data, size_t length) {
+    if (transfer == NULL || fake_log_used + length > FAKE_LOG_BYTES) {
+        return;
+    }
+    memcpy(&fake_log_bytes[fake_log_used], data, length);
+    fake_log_used += length;
+    transfer->length += length;
+}
+
+uint32_t Fake_TransferCount(void) {
+    return fake_log_count;
+}
+
+const Fake_Transfer *Fake_GetTransfer(uint32_t index) {
+    return index < fake_log_count ? &fake_log[index] : NULL;
+}
+
+const uint8_t *Fake_TransferData(const Fake_Transfer *transfer) {
+    return &fake_log_bytes[transfer->offset];
+}
+
+uint32_t Fake_CountTransfers(Fake_TransferKind kind, uint8_t address) {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < fake_log_count; i++) {
+        if (fake_log[i].kind == kind && (address == 0xFF || fake_log[i].address == address)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void Fake_ClearLog(void) {
+    fake_log_count = 0;
+    fake_log_used = 0;
+}
+
+// GPIO, outputs that are chip selects frame SPI transfers
+void gpio_init(unsigned int gpio) {
+}
+
+void gpio_set_dir(unsigned int gpio, bool out) {
+}
+
+void gpio_pull_up(unsigned int gpio) {
+}
+
+void FakeGpio_SetInput(uint gpio, bool level) {
+    fake_gpio_input[gpio] = level;
+}
+
+bool FakeGpio_Output(uint gpio) {
+    return fake_gpio_output[gpio];
+}
+
+bool gpio_get(unsigned int gpio) {
+    return gpio < FAKE_GPIO_COUNT ? fake_gpio_input[gpio] : false;
+}
+
+void gpio_put(unsigned int gpio, bool value) {
+    if (gpio >= FAKE_GPIO_COUNT || fake_gpio_output[gpio] == value) {
+        return;
+    }
+    fake_gpio_output[gpio] = value;
+    bool selects = false;
+    for (uint8_t i = 0; i < fake_spi_count; i++) {
+        FakeSPI_Device *device = &fake_spi_devices[i];
+        if (device->cs_pin == gpio) {
+            selects = true;
+            if (device->select) {
+                device->select(device->context, !value);
+            }
+        }
+    }
+    if (!selects) {
+        return;
+    }
+    if (!value) {
+        Fake_Transfer *transfer = Fake_Log(FAKE_SPI_FRAME, (uint8_t)gpio, false);
+        fake_spi_frame = transfer ? (int32_t)(transfer - fake_log) : -1;
+    }
+    else {
+        fake_spi_frame = -1;
+    }
+}
+
+// I2C
+void FakeI2C_Attach(uint8_t address, const FakeI2C_Device *device) {
+    if (fake_i2c_count < FAKE_I2C_MAX_DEVICES) {
+        fake_i2c_devices[fake_i2c_count].address = address;
+        fake_i2c_devices[fake_i2c_count].device = *device;
+        fake_i2c_count++;
+    }
+}
+
+void FakeI2C_FailNext(uint32_t count, int error) {
+    fake_i2c_fail = count;
+    fake_i2c_error = error;
+}
+
+void FakeI2C_SetBaudrate(uint32_t baudrate) {
+    fake_i2c_baudrate = baudrate;
+}
+
+static FakeI2C_Device *FakeI2C_Find(uint8_t address) {
+    for (uint8_t i = 0; i < fake_i2c_count; i++) {
+        if (fake_i2c_devices[i].address == address) {
+            return &fake_i2c_devices[i].device;
+        }
+    }
+    return NULL;
+}
+
+static void FakeI2C_Clock(size_t length) {
+    if (fake_i2c_baudrate) {
+        fake_time_us += (uint64_t)(length + 1) * 9 * 1000000 / fake_i2c_baudrate;
+    }
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    Fake_Transfer *transfer = Fake_Log(FAKE_I2C_WRITE, addr, nostop);
+    Fake_LogBytes(transfer, src, len);
+    FakeI2C_Clock(len);
+    FakeI2C_Device *device = FakeI2C_Find(addr);
+    if (fake_i2c_fail) {
+        fake_i2c_fail--;
+        if (transfer) {
+            transfer->failed = true;
+        }
+        return fake_i2c_error;
+    }
+    if (device == NULL || (device->write && !device->write(device->context, src, len))) {
+        if (transfer) {
+            transfer->failed = true;
+        }
+        return PICO_ERROR_GENERIC;
+    }
+    return (int)len;
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    Fake_Transfer *transfer = Fake_Log(FAKE_I2C_READ, addr, nostop);
+    FakeI2C_Clock(len);
+    FakeI2C_Device *device = FakeI2C_Find(addr);
+    if (fake_i2c_fail) {
+        fake_i2c_fail--;
+        if (transfer) {
+            transfer->failed = true;
+        }
+        return fake_i2c_error;
+    }
+    if (device == NULL || (device->read && !device->read(device->context, dst, len))) {
+        if (transfer) {
+            transfer->failed = true;
+        }
+        return PICO_ERROR_GENERIC;
+    }
+    if (device->read == NULL) {
+        memset(dst, 0, len);
+    }
+    Fake_LogBytes(transfer, dst, len);
+    return (int)len;
+}
+
+int i2c_read_timeout_us(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop, unsigned int timeout_us) {
+    return i2c_read_blocking(i2c, addr, dst, len, nostop);
+}
+
+// SPI, MOSI bytes go to every part on the selected chip select, MISO is the OR of theirs
+// (parts that aren't addressed drive nothing, 0)
+void FakeSPI_Attach(const FakeSPI_Device *device) {
+    if (fake_spi_count < FAKE_SPI_MAX_DEVICES) {
+        fake_spi_devices[fake_spi_count++] = *device;
+    }
+}
+
+void FakeSPI_ShortNext(uint32_t count) {
+    fake_spi_short = count;
+}
+
+static uint8_t FakeSPI_Byte(uint8_t out) {
+    uint8_t in = 0;
+    for (uint8_t i = 0; i < fake_spi_count; i++) {
+        FakeSPI_Device *device = &fake_spi_devices[i];
+        if (!fake_gpio_output[device->cs_pin] && device->transfer) {
+            in |= device->transfer(device->context, out);
+        }
+    }
+    if (fake_spi_frame >= 0) {
+        Fake_LogBytes(&fake_log[fake_spi_frame], &out, 1);
+    }
+    return in;
+}
+
+static size_t FakeSPI_Length(size_t len) {
+    if (fake_spi_short && len > 0) {
+        fake_spi_short--;
+        return len - 1;
+    }
+    return len;
+}
+
+int spi_write_blocking(spi_inst_t *spi, const uint8_t *src, size_t len) {
+    len = FakeSPI_Length(len);
+    for (size_t i = 0; i < len; i++) {
+        FakeSPI_Byte(src[i]);
+    }
+    return (int)len;
+}
+
+int spi_read_blocking(spi_inst_t *spi, uint8_t repeated_tx_data, uint8_t *dst, size_t len) {
+    len = FakeSPI_Length(len);
+    for (size_t i = 0; i < len; i++) {
+        dst[i] = FakeSPI_Byte(repeated_tx_data);
+    }
+    return (int)len;
+}
+
+int spi_write_read_blocking(spi_inst_t *spi, const uint8_t *src, uint8_t *dst, size_t len) {
+    len = FakeSPI_Length(len);
+    for (size_t i = 0; i < len; i++) {
+        dst[i] = FakeSPI_Byte(src[i]);
+    }
+    return (int)len;
+}
+
+unsigned int spi_set_baudrate(spi_inst_t *spi, unsigned int baudrate) {
+    spi->baudrate = baudrate;
+    return baudrate;
+}
+
+unsigned int spi_get_baudrate(const spi_inst_t *spi) {
+    return spi->baudrate;
+}
@@ -0,0 +1,93 @@
+/*
+ *
+ *  Host Stand-in for the Pico SDK
+ *
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ *
+*/
+
+#ifndef _FAKESDK_H
+#define _FAKESDK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "hardware/spi.h"
+
+// Just enough of the SDK for the drivers to run on a host against simulated parts.
+// Time only moves when told to, or by 1us per spin loop pass (tight_loop_contents,
+// busy waits and sleeps advance it by their length), so timeouts are exact.
+// Every I2C transfer and SPI frame is logged byte for byte so tests can check what went
+// on the wire and count transactions
+
+#define FAKE_GPIO_COUNT         30
+#define FAKE_I2C_MAX_DEVICES    8
+#define FAKE_SPI_MAX_DEVICES    8
+#define FAKE_LOG_TRANSFERS      8192
+#define FAKE_LOG_BYTES          (1 << 20)
+
+// A simulated I2C part. write gets the bytes after the address, read fills <data>.
+// Return false to NAK
+typedef struct {
+    bool (*write)(void *context, const uint8_t *data, size_t length);
+    bool (*read)(void *context, uint8_t *data, size_t length);
+    void *context;
+} FakeI2C_Device;
+
+// A simulated SPI part on a chip select, full duplex one byte at a time.
+// select is called on each edge of its chip select
+typedef struct {
+    void (*select)(void *context, bool selected);
+    uint8_t (*transfer)(void *context, uint8_t out);
+    void *context;
+    uint8_t cs_pin;
+} FakeSPI_Device;
+
+typedef enum {
+    FAKE_I2C_WRITE = 0,
+    FAKE_I2C_READ,
+    FAKE_SPI_FRAME, // Chip select low to high, MOSI bytes
+} Fake_TransferKind;
+
+typedef struct {
+    Fake_TransferKind kind;
+    uint8_t address;  // I2C address or chip select pin
+    bool nostop;      // I2C, a repeated start follows
+    bool failed;
+    uint32_t length;
+    uint32_t offset;  // Into the byte log
+    uint64_t time_us;
+} Fake_Transfer;
+
+// Back to power on: time 0, core 0, no devices, empty log, all inputs high
+void FakeSdk_Reset(void);
+
+void FakeSdk_SetTime(uint64_t time_us);
+void FakeSdk_Advance(uint64_t us);
+void FakeSdk_SetCore(uint core);
+void FakeGpio_SetInput(uint gpio, bool level);
+bool FakeGpio_Output(uint gpio);
+
+void FakeI2C_Attach(uint8_t address, const FakeI2C_Device *device);
+// The next <count> transfers to anything fail with <error>, as if the part NAKed
+void FakeI2C_FailNext(uint32_t count, int error);
+// Transfer times at <baudrate>, 9 clocks per byte plus the address. 0 for instant
+void FakeI2C_SetBaudrate(uint32_t baudrate);
+
+void FakeSPI_Attach(const FakeSPI_Device *device);
+// The next <count> SPI calls move one byte less than asked
+void FakeSPI_ShortNext(uint32_t count);
+
+// Transfer log
+uint32_t Fake_TransferCount(void);
+const Fake_Transfer *Fake_GetTransfer(uint32_t index);
+const uint8_t *Fake_TransferData(const Fake_Transfer *transfer);
+// Transfers of <kind> to <address> since the last clear, 0xFF for any address
+uint32_t Fake_CountTransfers(Fake_TransferKind kind, uint8_t address);
+void Fake_ClearLog(void);
+#endif
@@ -0,0 +1,16 @@
+#ifndef _FAKE_HARDWARE_GPIO_H
+#define _FAKE_HARDWARE_GPIO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico.h"
+
+#define GPIO_IN     false
+#define GPIO_OUT    true
+
+void gpio_init(unsigned int gpio);
+void gpio_set_dir(unsigned int gpio, bool out);
+void gpio_put(unsigned int gpio, bool value);
+bool gpio_get(unsigned int gpio);
+void gpio_pull_up(unsigned int gpio);
+#endif
@@ -0,0 +1,15 @@
+#ifndef _FAKE_HARDWARE_I2C_H
+#define _FAKE_HARDWARE_I2C_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico.h"
+#include <stddef.h>
+
+typedef struct i2c_inst i2c_inst_t;
+extern i2c_inst_t *const i2c0;
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop);
+int i2c_read_timeout_us(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop, unsigned int timeout_us);
+#endif
@@ -0,0 +1,16 @@
+#ifndef _FAKE_HARDWARE_SPI_H
+#define _FAKE_HARDWARE_SPI_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "pico.h"
+
+typedef struct spi_inst spi_inst_t;
+extern spi_inst_t *const spi0;
+
+int spi_write_blocking(spi_inst_t *spi, const uint8_t *src, size_t len);
+int spi_read_blocking(spi_inst_t *spi, uint8_t repeated_tx_data, uint8_t *dst, size_t len);
+int spi_write_read_blocking(spi_inst_t *spi, const uint8_t *src, uint8_t *dst, size_t len);
+unsigned int spi_set_baudrate(spi_inst_t *spi, unsigned int baudrate);
+unsigned int spi_get_baudrate(const spi_inst_t *spi);
+#endif
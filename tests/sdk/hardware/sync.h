@@ -0,0 +1,14 @@
+#ifndef _FAKE_HARDWARE_SYNC_H
+#define _FAKE_HARDWARE_SYNC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico.h"
+
+typedef volatile uint32_t spin_lock_t;
+
+int spin_lock_claim_unused(bool required);
+spin_lock_t *spin_lock_instance(unsigned int lock_num);
+uint32_t spin_lock_blocking(spin_lock_t *lock);
+void spin_unlock(spin_lock_t *lock, uint32_t saved_irq);
+#endif
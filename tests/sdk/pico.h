@@ -0,0 +1,23 @@
+// Host stand-in for the Pico SDK base header, the types every SDK header gets from it
+#ifndef _FAKE_PICO_H
+#define _FAKE_PICO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef unsigned int uint;
+
+enum pico_error_codes {
+    PICO_OK = 0,
+    PICO_ERROR_NONE = 0,
+    PICO_ERROR_TIMEOUT = -1,
+    PICO_ERROR_GENERIC = -2,
+    PICO_ERROR_NO_DATA = -3,
+    PICO_ERROR_NOT_PERMITTED = -4,
+    PICO_ERROR_INVALID_ARG = -5,
+    PICO_ERROR_IO = -6,
+};
+
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+#endif
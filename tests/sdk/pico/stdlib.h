@@ -0,0 +1,18 @@
+// Host stand-in for the Pico SDK, only what the tested modules use. See FakeSdk.h
+#ifndef _FAKE_PICO_STDLIB_H
+#define _FAKE_PICO_STDLIB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "pico.h"
+#include "hardware/gpio.h"
+
+uint32_t time_us_32(void);
+uint64_t time_us_64(void);
+void busy_wait_us_32(uint32_t delay_us);
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+uint get_core_num(void);
+void tight_loop_contents(void);
+#endif
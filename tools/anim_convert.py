@@ -0,0 +1,268 @@
+#!/usr/bin/env python3
+"""
+Bitmap/animation converter for the SSD1306 player (Animation.c).
+
+Reads one or more PBM images (P1 or P4, one per frame, all the same size) and
+writes the MPA1 format: page-major column bytes (bit 0 = top pixel of the
+page, same as SSD1306 GDDRAM), run-length coded per page. After the first
+frame each frame is XOR coded against the previous one, with unchanged pages
+left out, unless a key frame comes out smaller or is due.
+
+With --stats, prints per frame the encoded size, pages touched and the bus
+bytes an SSD1306_Flush would spend on it (same diff and merge rules as
+SSD1306_Diff.c), plus a decode round trip check.
+
+Usage: anim_convert.py [options] <output> <frame.pbm> [<frame.pbm> ...]
+  --period MS        frame period in milliseconds (default 100)
+  --keyframe N       force a key frame every N frames (default 0, first only)
+  --invert           lit pixel = white (0) in the PBM instead of black (1)
+  --c-array NAME     write a C source with const NAME[] / NAME_Length instead
+  --stats            print per frame statistics
+"""
+
+import struct
+import sys
+
+MAGIC = b"MPA1"
+FRAME_KEY = 0
+FRAME_DELTA = 1
+MAX_PAGES = 8
+MAX_WIDTH = 255
+# Matches SSD1306_RUN_OVERHEAD_BYTES / SSD1306_MAX_RUNS_PER_PAGE
+RUN_OVERHEAD_BYTES = 10
+MAX_RUNS_PER_PAGE = 8
+
+
+def read_pbm(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    # Header tokens, skipping comments
+    tokens = []
+    i = 0
+    while len(tokens) < 3:
+        while data[i:i + 1].isspace():
+            i += 1
+        if data[i:i + 1] == b"#":
+            while data[i:i + 1] not in (b"\n", b""):
+                i += 1
+            continue
+        start = i
+        while not data[i:i + 1].isspace():
+            i += 1
+        tokens.append(data[start:i])
+    kind, width, height = tokens[0], int(tokens[1]), int(tokens[2])
+    pixels = []
+    if kind == b"P1":
+        bits = [c - 0x30 for c in data[i:] if c in (0x30, 0x31)]
+        for y in range(height):
+            pixels.append(bits[y * width:(y + 1) * width])
+    elif kind == b"P4":
+        i += 1  # Single whitespace before the raster
+        row_bytes = (width + 7) // 8
+        for y in range(height):
+            row = data[i + y * row_bytes:i + (y + 1) * row_bytes]
+            pixels.append([(row[x // 8] >> (7 - x % 8)) & 1 for x in range(width)])
+    else:
+        raise ValueError(f"{path}: not a PBM (P1/P4) file")
+    return width, height, pixels
+
+
+def to_pages(width, height, pixels, invert):
+    """Page major column bytes, the last page padded with unlit rows"""
+    pages = []
+    for page in range((height + 7) // 8):
+        row = []
+        for x in range(width):
+            byte = 0
+            for bit in range(8):
+                y = page * 8 + bit
+                if y < height and (pixels[y][x] ^ invert):
+                    byte |= 1 << bit
+            row.append(byte)
+        pages.append(row)
+    return pages
+
+
+def rle(data):
+    """Packets: 0x00-0x7F literal of n + 1 bytes, 0x80-0xFF run of (n & 0x7F) + 1"""
+    out = bytearray()
+    literal = bytearray()
+    i = 0
+    while i < len(data):
+        run = 1
+        while i + run < len(data) and data[i + run] == data[i] and run < 128:
+            run += 1
+        # A run of 2 only pays off if it isn't splitting a literal
+        if run >= 3 or (run == 2 and not literal):
+            while literal:
+                out.append(len(literal[:128]) - 1)
+                out += literal[:128]
+                literal = literal[128:]
+            out += bytes([0x80 | (run - 1), data[i]])
+            i += run
+        else:
+            literal.append(data[i])
+            i += 1
+    while literal:
+        out.append(len(literal[:128]) - 1)
+        out += literal[:128]
+        literal = literal[128:]
+    return bytes(out)
+
+
+def encode_frame(previous, current, force_key):
+    key = bytes([FRAME_KEY, (1 << len(current)) - 1]) + b"".join(rle(page) for page in current)
+    if previous is None or force_key:
+        return key
+    mask = 0
+    body = b""
+    for p, (old, new) in enumerate(zip(previous, current)):
+        if old != new:
+            mask |= 1 << p
+            body += rle([a ^ b for a, b in zip(old, new)])
+    delta = bytes([FRAME_DELTA, mask]) + body
+    return delta if len(delta) < len(key) else key
+
+
+def decode(data):
+    """Reference decoder, mirrors Animation.c"""
+    assert data[:4] == MAGIC
+    width, pages, count, _period = struct.unpack_from("<BBHH", data, 4)
+    i = 12
+    frame = [[0] * width for _ in range(pages)]
+    frames = []
+    for _ in range(count):
+        kind, mask = data[i], data[i + 1]
+        i += 2
+        for p in range(pages):
+            if not mask & (1 << p):
+                continue
+            out = []
+            while len(out) < width:
+                packet = data[i]
+                i += 1
+                n = (packet & 0x7F) + 1
+                if packet & 0x80:
+                    out += [data[i]] * n
+                    i += 1
+                else:
+                    out += list(data[i:i + n])
+                    i += n
+            assert len(out) == width
+            frame[p] = out if kind == FRAME_KEY else [a ^ b for a, b in zip(frame[p], out)]
+        frames.append([list(page) for page in frame])
+    return frames
+
+
+def flush_cost(front, back):
+    """Bus bytes SSD1306_Flush spends going from <front> to <back>, word diff as in SSD1306_Diff.c"""
+    total = 0
+    for old, new in zip(front, back):
+        width = len(old) - len(old) % 4
+        runs = []
+        i = 0
+        words = width // 4
+        while i < words:
+            if old[i * 4:i * 4 + 4] == new[i * 4:i * 4 + 4]:
+                i += 1
+                continue
+            changed = [c for c in range(i * 4, i * 4 + 4) if old[c] != new[c]]
+            start = changed[0]
+            end = changed[-1]
+            i += 1
+            while i < words and old[i * 4:i * 4 + 4] != new[i * 4:i * 4 + 4]:
+                end = [c for c in range(i * 4, i * 4 + 4) if old[c] != new[c]][-1]
+                i += 1
+            if runs and (start - runs[-1][1] - 1 <= RUN_OVERHEAD_BYTES or len(runs) == MAX_RUNS_PER_PAGE):
+                runs[-1][1] = end
+            else:
+                runs.append([start, end])
+        total += sum(RUN_OVERHEAD_BYTES + end - start + 1 for start, end in runs)
+    return total
+
+
+def write_c(out, name, data):
+    out.write("// Generated by tools/anim_convert.py - do not edit\n\n")
+    out.write("#include <stdint.h>\n\n")
+    out.write(f"const uint8_t {name}[{len(data)}] = {{\n")
+    for i in range(0, len(data), 16):
+        out.write("    " + ", ".join(f"0x{b:02X}" for b in data[i:i + 16]) + ",\n")
+    out.write("};\n\n")
+    out.write(f"const uint32_t {name}_Length = {len(data)};\n")
+
+
+def main(argv):
+    period = 100
+    keyframe = 0
+    invert = 0
+    c_array = None
+    stats = False
+    args = []
+    i = 0
+    while i < len(argv):
+        arg = argv[i]
+        if arg == "--period":
+            period = int(argv[i + 1])
+            i += 1
+        elif arg == "--keyframe":
+            keyframe = int(argv[i + 1])
+            i += 1
+        elif arg == "--invert":
+            invert = 1
+        elif arg == "--c-array":
+            c_array = argv[i + 1]
+            i += 1
+        elif arg == "--stats":
+            stats = True
+        else:
+            args.append(arg)
+        i += 1
+    if len(args) < 2:
+        sys.stderr.write(__doc__)
+        return 1
+
+    output, inputs = args[0], args[1:]
+    frames = []
+    width = height = None
+    for path in inputs:
+        w, h, pixels = read_pbm(path)
+        if width is None:
+            width, height = w, h
+        elif (w, h) != (width, height):
+            raise ValueError(f"{path}: {w}x{h}, expected {width}x{height}")
+        frames.append(to_pages(w, h, pixels, invert))
+    pages = len(frames[0])
+    if width > MAX_WIDTH or pages > MAX_PAGES:
+        raise ValueError(f"{width}x{height} is larger than the player supports")
+
+    data = bytearray(MAGIC + struct.pack("<BBHHH", width, pages, len(frames), period, 0))
+    previous = None
+    encoded = []
+    for n, frame in enumerate(frames):
+        chunk = encode_frame(previous, frame, keyframe and n % keyframe == 0)
+        encoded.append(chunk)
+        data += chunk
+        previous = frame
+
+    if stats:
+        assert decode(bytes(data)) == frames, "round trip mismatch"
+        raw = width * pages
+        shown = [[0] * width for _ in range(pages)]
+        print(f"{len(frames)} frames, {width}x{height}, {raw} bytes raw per frame, {len(data)} bytes total")
+        print("Frame  Type   Encoded  Pages  Flush bytes")
+        for n, (frame, chunk) in enumerate(zip(frames, encoded)):
+            touched = bin(chunk[1]).count("1")
+            print(f"{n:5}  {'key' if chunk[0] == FRAME_KEY else 'delta':5}  {len(chunk):7}  {touched:5}  {flush_cost(shown, frame):11}")
+            shown = frame
+
+    if c_array:
+        with open(output, "w", newline="\n") as out:
+            write_c(out, c_array, data)
+    else:
+        with open(output, "wb") as out:
+            out.write(data)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,200 @@
+#!/usr/bin/env python3
+"""
+Font atlas generator for the SSD1306 text renderer.
+
+Rasterises the 5x7 base font at each requested scale into page-aligned
+column bytes (bit 0 = top pixel of the page, same as SSD1306 GDDRAM), trims
+blank columns for proportional widths and writes the result as const C tables
+so they stay in XIP flash.
+
+Usage: fontgen.py <output.c>
+"""
+
+import sys
+
+FIRST_CHAR = 0x20
+LAST_CHAR = 0x7E
+
+# Classic 5x7 font, one byte per column, bit 0 is the top row
+BASE_FONT = [
+    [0x00, 0x00, 0x00, 0x00, 0x00],  # ' '
+    [0x00, 0x00, 0x5F, 0x00, 0x00],  # !
+    [0x00, 0x07, 0x00, 0x07, 0x00],  # "
+    [0x14, 0x7F, 0x14, 0x7F, 0x14],  # #
+    [0x24, 0x2A, 0x7F, 0x2A, 0x12],  # $
+    [0x23, 0x13, 0x08, 0x64, 0x62],  # %
+    [0x36, 0x49, 0x56, 0x20, 0x50],  # &
+    [0x00, 0x05, 0x03, 0x00, 0x00],  # '
+    [0x00, 0x1C, 0x22, 0x41, 0x00],  # (
+    [0x00, 0x41, 0x22, 0x1C, 0x00],  # )
+    [0x14, 0x08, 0x3E, 0x08, 0x14],  # *
+    [0x08, 0x08, 0x3E, 0x08, 0x08],  # +
+    [0x00, 0x50, 0x30, 0x00, 0x00],  # ,
+    [0x08, 0x08, 0x08, 0x08, 0x08],  # -
+    [0x00, 0x60, 0x60, 0x00, 0x00],  # .
+    [0x20, 0x10, 0x08, 0x04, 0x02],  # /
+    [0x3E, 0x51, 0x49, 0x45, 0x3E],  # 0
+    [0x00, 0x42, 0x7F, 0x40, 0x00],  # 1
+    [0x42, 0x61, 0x51, 0x49, 0x46],  # 2
+    [0x21, 0x41, 0x45, 0x4B, 0x31],  # 3
+    [0x18, 0x14, 0x12, 0x7F, 0x10],  # 4
+    [0x27, 0x45, 0x45, 0x45, 0x39],  # 5
+    [0x3C, 0x4A, 0x49, 0x49, 0x30],  # 6
+    [0x01, 0x71, 0x09, 0x05, 0x03],  # 7
+    [0x36, 0x49, 0x49, 0x49, 0x36],  # 8
+    [0x06, 0x49, 0x49, 0x29, 0x1E],  # 9
+    [0x00, 0x36, 0x36, 0x00, 0x00],  # :
+    [0x00, 0x56, 0x36, 0x00, 0x00],  # ;
+    [0x08, 0x14, 0x22, 0x41, 0x00],  # <
+    [0x14, 0x14, 0x14, 0x14, 0x14],  # =
+    [0x00, 0x41, 0x22, 0x14, 0x08],  # >
+    [0x02, 0x01, 0x51, 0x09, 0x06],  # ?
+    [0x32, 0x49, 0x79, 0x41, 0x3E],  # @
+    [0x7E, 0x11, 0x11, 0x11, 0x7E],  # A
+    [0x7F, 0x49, 0x49, 0x49, 0x36],  # B
+    [0x3E, 0x41, 0x41, 0x41, 0x22],  # C
+    [0x7F, 0x41, 0x41, 0x22, 0x1C],  # D
+    [0x7F, 0x49, 0x49, 0x49, 0x41],  # E
+    [0x7F, 0x09, 0x09, 0x09, 0x01],  # F
+    [0x3E, 0x41, 0x49, 0x49, 0x7A],  # G
+    [0x7F, 0x08, 0x08, 0x08, 0x7F],  # H
+    [0x00, 0x41, 0x7F, 0x41, 0x00],  # I
+    [0x20, 0x40, 0x41, 0x3F, 0x01],  # J
+    [0x7F, 0x08, 0x14, 0x22, 0x41],  # K
+    [0x7F, 0x40, 0x40, 0x40, 0x40],  # L
+    [0x7F, 0x02, 0x0C, 0x02, 0x7F],  # M
+    [0x7F, 0x04, 0x08, 0x10, 0x7F],  # N
+    [0x3E, 0x41, 0x41, 0x41, 0x3E],  # O
+    [0x7F, 0x09, 0x09, 0x09, 0x06],  # P
+    [0x3E, 0x41, 0x51, 0x21, 0x5E],  # Q
+    [0x7F, 0x09, 0x19, 0x29, 0x46],  # R
+    [0x46, 0x49, 0x49, 0x49, 0x31],  # S
+    [0x01, 0x01, 0x7F, 0x01, 0x01],  # T
+    [0x3F, 0x40, 0x40, 0x40, 0x3F],  # U
+    [0x1F, 0x20, 0x40, 0x20, 0x1F],  # V
+    [0x3F, 0x40, 0x38, 0x40, 0x3F],  # W
+    [0x63, 0x14, 0x08, 0x14, 0x63],  # X
+    [0x07, 0x08, 0x70, 0x08, 0x07],  # Y
+    [0x61, 0x51, 0x49, 0x45, 0x43],  # Z
+    [0x00, 0x7F, 0x41, 0x41, 0x00],  # [
+    [0x02, 0x04, 0x08, 0x10, 0x20],  # backslash
+    [0x00, 0x41, 0x41, 0x7F, 0x00],  # ]
+    [0x04, 0x02, 0x01, 0x02, 0x04],  # ^
+    [0x40, 0x40, 0x40, 0x40, 0x40],  # _
+    [0x00, 0x01, 0x02, 0x04, 0x00],  # `
+    [0x20, 0x54, 0x54, 0x54, 0x78],  # a
+    [0x7F, 0x48, 0x44, 0x44, 0x38],  # b
+    [0x38, 0x44, 0x44, 0x44, 0x20],  # c
+    [0x38, 0x44, 0x44, 0x48, 0x7F],  # d
+    [0x38, 0x54, 0x54, 0x54, 0x18],  # e
+    [0x08, 0x7E, 0x09, 0x01, 0x02],  # f
+    [0x0C, 0x52, 0x52, 0x52, 0x3E],  # g
+    [0x7F, 0x08, 0x04, 0x04, 0x78],  # h
+    [0x00, 0x44, 0x7D, 0x40, 0x00],  # i
+    [0x20, 0x40, 0x44, 0x3D, 0x00],  # j
+    [0x7F, 0x10, 0x28, 0x44, 0x00],  # k
+    [0x00, 0x41, 0x7F, 0x40, 0x00],  # l
+    [0x7C, 0x04, 0x18, 0x04, 0x78],  # m
+    [0x7C, 0x08, 0x04, 0x04, 0x78],  # n
+    [0x38, 0x44, 0x44, 0x44, 0x38],  # o
+    [0x7C, 0x14, 0x14, 0x14, 0x08],  # p
+    [0x08, 0x14, 0x14, 0x18, 0x7C],  # q
+    [0x7C, 0x08, 0x04, 0x04, 0x08],  # r
+    [0x48, 0x54, 0x54, 0x54, 0x20],  # s
+    [0x04, 0x3F, 0x44, 0x40, 0x20],  # t
+    [0x3C, 0x40, 0x40, 0x20, 0x7C],  # u
+    [0x1C, 0x20, 0x40, 0x20, 0x1C],  # v
+    [0x3C, 0x40, 0x30, 0x40, 0x3C],  # w
+    [0x44, 0x28, 0x10, 0x28, 0x44],  # x
+    [0x0C, 0x50, 0x50, 0x50, 0x3C],  # y
+    [0x44, 0x64, 0x54, 0x4C, 0x44],  # z
+    [0x00, 0x08, 0x36, 0x41, 0x00],  # {
+    [0x00, 0x00, 0x7F, 0x00, 0x00],  # |
+    [0x00, 0x41, 0x36, 0x08, 0x00],  # }
+    [0x10, 0x08, 0x08, 0x10, 0x08],  # ~
+]
+
+# (C name, scale, blank columns between glyphs, width of ' ')
+SIZES = [
+    ("Font_Small", 1, 1, 3),
+    ("Font_Medium", 2, 2, 6),
+    ("Font_Large", 3, 3, 9),
+]
+
+
+def trim(columns):
+    """Drop blank leading/trailing columns for proportional spacing"""
+    start = 0
+    while start < len(columns) and columns[start] == 0:
+        start += 1
+    end = len(columns)
+    while end > start and columns[end - 1] == 0:
+        end -= 1
+    return columns[start:end]
+
+
+def scale_glyph(columns, scale):
+    """Returns glyph as a list of pages, each page a list of column bytes"""
+    pages = [[] for _ in range(scale)]
+    for column in columns:
+        # Stretch each source row to <scale> rows, 8 source rows -> 8 * scale rows
+        tall = 0
+        for row in range(8):
+            if column & (1 << row):
+                tall |= ((1 << scale) - 1) << (row * scale)
+        for _ in range(scale):
+            for page in range(scale):
+                pages[page].append((tall >> (page * 8)) & 0xFF)
+    return pages
+
+
+def emit(out):
+    out.write("// Generated by tools/fontgen.py - do not edit\n\n")
+    out.write('#include "Font.h"\n\n')
+    for name, scale, spacing, space_width in SIZES:
+        bitmap = []
+        glyphs = []
+        for code in range(FIRST_CHAR, LAST_CHAR + 1):
+            columns = trim(BASE_FONT[code - FIRST_CHAR])
+            if code == 0x20:
+                glyphs.append((len(bitmap), space_width))
+                bitmap.extend([0] * (space_width * scale))
+                continue
+            pages = scale_glyph(columns, scale)
+            glyphs.append((len(bitmap), len(columns) * scale))
+            # Page-major so each page row of a glyph is one contiguous memcpy
+            for page in pages:
+                bitmap.extend(page)
+
+        out.write(f"static const uint8_t {name}_Bitmap[{len(bitmap)}] = {{\n")
+        for i in range(0, len(bitmap), 16):
+            out.write("    " + ", ".join(f"0x{b:02X}" for b in bitmap[i:i + 16]) + ",\n")
+        out.write("};\n\n")
+
+        out.write(f"static const FontGlyph {name}_Glyphs[{len(glyphs)}] = {{\n")
+        for code, (offset, width) in zip(range(FIRST_CHAR, LAST_CHAR + 1), glyphs):
+            out.write(f"    {{{offset}, {width}}}, // 0x{code:02X}\n")
+        out.write("};\n\n")
+
+        out.write(f"const Font {name} = {{\n")
+        out.write(f"    .bitmap = {name}_Bitmap,\n")
+        out.write(f"    .glyphs = {name}_Glyphs,\n")
+        out.write(f"    .first_char = 0x{FIRST_CHAR:02X},\n")
+        out.write(f"    .last_char = 0x{LAST_CHAR:02X},\n")
+        out.write(f"    .pages = {scale},\n")
+        out.write(f"    .spacing = {spacing},\n")
+        out.write("};\n\n")
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.stderr.write(__doc__)
+        return 1
+    assert len(BASE_FONT) == LAST_CHAR - FIRST_CHAR + 1
+    with open(sys.argv[1], "w", newline="\n") as out:
+        emit(out)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,249 @@
+#!/usr/bin/env python3
+"""
+Flash and RAM use per module from a GNU ld map file (Macropad.elf.map).
+
+Every input section in the memory map is charged to the module its object came
+from. Firmware sources are grouped by the name before the first underscore
+(MCP23017_I2C.c is MCP23017), Pico SDK objects by library and archive members
+by archive. Stack and heap reservations are listed on their own. Sections in a
+writable memory region count as RAM, and those with a load address in flash
+(.data, code placed in RAM) count towards flash as well.
+
+With --budget, each module and the total is compared against the budget file
+and the exit code is 1 if anything is over. Budget file lines are
+"<module> <flash bytes> <ram bytes>", "-" for no limit, "#" starts a comment.
+The "total" line is a limit for the whole image.
+
+Usage: mapsize.py [options] <Macropad.elf.map>
+  --budget FILE    compare against FILE, exit 1 if over
+  --update         rewrite the module lines of the budget file from this map,
+                   the total line is left as it is
+  --all            list SDK libraries one by one instead of as pico-sdk
+  --output FILE    also write the report to FILE, only if within budget (a
+                   stamp so a failed check runs again on the next build)
+"""
+
+import os
+import re
+import sys
+
+# Generated sources that belong to a module with a different name
+GROUPS = {
+    "Boot_Logo": "Animation",
+}
+
+REGION = re.compile(r"^(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+(\S+))?\s*$")
+OUTPUT_SECTION = re.compile(r"^(\.\S+)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+load address 0x([0-9a-fA-F]+))?)?\s*$")
+OUTPUT_CONTINUED = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+load address 0x([0-9a-fA-F]+))?\s*$")
+INPUT_SECTION = re.compile(r"^ (\.\S+|COMMON)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(.+))?\s*$")
+INPUT_CONTINUED = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(.+?)\s*$")
+SDK_LIBRARY = re.compile(r"^(hardware|pico|boot)_\w+$")
+
+
+def module_of(section, source, all_libraries):
+    if section.startswith(".stack"):
+        return "stacks"
+    if section.startswith(".heap"):
+        return "heap"
+    archive = re.match(r"^(.*?)\((.*)\)$", source)
+    if archive:
+        name = os.path.basename(archive.group(1))
+        return name[:-2] if name.endswith(".a") else name
+    parts = source.replace("\\", "/").split("/")
+    if "CMakeFiles" in parts:
+        # Object of a source in the firmware tree or the build directory
+        rest = parts[parts.index("CMakeFiles") + 2:]
+        if len(rest) == 1:
+            name = re.sub(r"\.(c|S|s|cpp)\.obj$", "", rest[0])
+            if name in GROUPS:
+                return GROUPS[name]
+            return name.split("_")[0]
+        if "tinyusb" in rest:
+            return "tinyusb"
+        for part in reversed(rest[:-1]):
+            if SDK_LIBRARY.match(part):
+                return part if all_libraries else "pico-sdk"
+        return "pico-sdk"
+    return "pico-sdk" if "pico-sdk" in parts else "toolchain"
+
+
+def parse_map(path, all_libraries):
+    regions = []
+    usage = {}
+    with open(path) as file:
+        lines = file.read().splitlines()
+
+    i = 0
+    while i < len(lines) and not lines[i].startswith("Memory Configuration"):
+        i += 1
+    while i < len(lines) and not lines[i].startswith("Linker script and memory map"):
+        match = REGION.match(lines[i])
+        if match and match.group(1) not in ("Name", "*default*"):
+            regions.append((int(match.group(2), 16), int(match.group(3), 16), "w" in (match.group(4) or "")))
+        i += 1
+    if not regions:
+        raise ValueError(f"{path}: no memory configuration, not a GNU ld map file?")
+
+    def writable(address):
+        for origin, length, rw in regions:
+            if origin <= address < origin + length:
+                return rw
+        return None
+
+    loaded = False  # Current output section has a load image in flash
+    discard = False
+    while i < len(lines):
+        line = lines[i]
+        i += 1
+        if line.startswith("/DISCARD/"):
+            discard = True
+            continue
+        match = OUTPUT_SECTION.match(line)
+        if match:
+            discard = False
+            address, load = match.group(2), match.group(4)
+            if address is None:
+                continued = OUTPUT_CONTINUED.match(lines[i]) if i < len(lines) else None
+                if continued:
+                    address, load = continued.group(1), continued.group(3)
+                    i += 1
+            loaded = load is not None and writable(int(load, 16)) is False
+            continue
+        match = INPUT_SECTION.match(line)
+        if not match or discard:
+            continue
+        section, address, size, source = match.groups()
+        if address is None:
+            continued = INPUT_CONTINUED.match(lines[i]) if i < len(lines) else None
+            if not continued:
+                continue
+            address, size, source = continued.groups()
+            i += 1
+        address, size = int(address, 16), int(size, 16)
+        rw = writable(address)
+        if size == 0 or rw is None:
+            continue
+        module = module_of(section, source, all_libraries)
+        flash, ram = usage.get(module, (0, 0))
+        if rw:
+            ram += size
+            if loaded:
+                flash += size
+        else:
+            flash += size
+        usage[module] = (flash, ram)
+    return usage
+
+
+def read_budget(path):
+    budget = {}
+    if not os.path.exists(path):
+        return budget
+    with open(path) as file:
+        for line in file:
+            fields = line.split("#")[0].split()
+            if not fields:
+                continue
+            if len(fields) != 3:
+                raise ValueError(f"{path}: bad budget line: {line.strip()}")
+            budget[fields[0]] = tuple(None if f == "-" else int(f, 0) for f in fields[1:])
+    return budget
+
+
+def update_budget(path, usage):
+    header = []
+    total = None
+    if os.path.exists(path):
+        with open(path) as file:
+            for line in file:
+                fields = line.split("#")[0].split()
+                if not fields:
+                    if not total:
+                        header.append(line)
+                elif fields[0] == "total":
+                    total = line
+    if total is None:
+        flash = sum(f for f, _ in usage.values())
+        ram = sum(r for _, r in usage.values())
+        total = f"total {flash} {ram}\n"
+    with open(path, "w", newline="\n") as out:
+        out.writelines(header)
+        out.write(total)
+        for module in sorted(usage):
+            flash, ram = usage[module]
+            out.write(f"{module} {flash} {ram}\n")
+
+
+def difference(value, limit):
+    if limit is None:
+        return ""
+    return f"{value - limit:+d}"
+
+
+def report(usage, budget):
+    lines = []
+    over = []
+    rows = sorted(usage.items(), key=lambda item: (-(item[1][0] + item[1][1]), item[0]))
+    rows.append(("total", (sum(f for _, (f, _) in rows), sum(r for _, (_, r) in rows))))
+    if budget:
+        lines.append(f"{'Module':16} {'Flash':>8} {'Budget':>8} {'Diff':>9} {'RAM':>8} {'Budget':>8} {'Diff':>9}")
+    else:
+        lines.append(f"{'Module':16} {'Flash':>8} {'RAM':>8}")
+    for module, (flash, ram) in rows:
+        if not budget:
+            lines.append(f"{module:16} {flash:8} {ram:8}")
+            continue
+        flash_limit, ram_limit = budget.get(module, (None, None))
+        mark = ""
+        if (flash_limit is not None and flash > flash_limit) or (ram_limit is not None and ram > ram_limit):
+            mark = "  OVER"
+            over.append(module)
+        lines.append(f"{module:16} {flash:8} {'' if flash_limit is None else flash_limit:>8} {difference(flash, flash_limit):>9} "
+                     f"{ram:8} {'' if ram_limit is None else ram_limit:>8} {difference(ram, ram_limit):>9}{mark}")
+    return lines, over
+
+
+def main(argv):
+    budget_path = None
+    update = False
+    all_libraries = False
+    output = None
+    args = []
+    i = 0
+    while i < len(argv):
+        arg = argv[i]
+        if arg == "--budget":
+            budget_path = argv[i + 1]
+            i += 1
+        elif arg == "--update":
+            update = True
+        elif arg == "--all":
+            all_libraries = True
+        elif arg == "--output":
+            output = argv[i + 1]
+            i += 1
+        else:
+            args.append(arg)
+        i += 1
+    if len(args) != 1 or (update and budget_path is None):
+        sys.stderr.write(__doc__)
+        return 2
+
+    usage = parse_map(args[0], all_libraries)
+    if update:
+        update_budget(budget_path, usage)
+    budget = read_budget(budget_path) if budget_path else {}
+    lines, over = report(usage, budget)
+    print("\n".join(lines))
+    if over:
+        sys.stderr.write(f"Over the size budget ({budget_path}): {', '.join(over)}\n"
+                         "Trim it, or raise the budget on purpose with tools/mapsize.py --update\n")
+        return 1
+    if output:
+        with open(output, "w", newline="\n") as out:
+            out.write("\n".join(lines) + "\n")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,25 @@
+#!/bin/sh
+# Builds every board profile (profiles/*.cmake) in its own directory and prints
+# flash and RAM use side by side. Needs the Pico SDK and arm-none-eabi toolchain.
+#
+# Usage: tools/profile_sizes.sh [build root, default build-profiles]
+
+set -e
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+OUT=${1:-$ROOT/build-profiles}
+SIZE=${SIZE:-arm-none-eabi-size}
+JOBS=$(nproc 2>/dev/null || echo 4)
+mkdir -p "$OUT"
+
+printf "%-12s %8s %8s %8s %8s %8s\n" profile text data bss flash ram
+for file in "$ROOT"/profiles/*.cmake; do
+    profile=$(basename "$file" .cmake)
+    build="$OUT/$profile"
+    cmake -S "$ROOT" -B "$build" -DMACROPAD_PROFILE="$profile" > "$build.log" 2>&1 &&
+        cmake --build "$build" -j"$JOBS" >> "$build.log" 2>&1 || {
+        echo "$profile: build failed, see $build.log" >&2
+        continue
+    }
+    "$SIZE" "$build/Macropad.elf" | awk -v p="$profile" 'NR == 2 {
+        printf "%-12s %8d %8d %8d %8d %8d\n", p, $1, $2, $3, $1 + $2, $2 + $3 }'
+done
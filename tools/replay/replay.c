@@ -0,0 +1,510 @@
+/*
+ *
+ *  Scan Trace Replay
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+// Feeds a trace dumped by the firmware `trace dump` console command through the same
+// debounce -> combo -> keymap -> HID pipeline, with the trace timestamps as the clock.
+// Output is one line per key event and HID report, so two runs over the same trace are
+// byte identical and can be diffed against an expected output.
+//
+// Usage: replay [options] <trace.txt>
+//   --expect FILE   compare the output against FILE, exit 1 on the first difference
+//   --repeat N      replay N times for steadier timings (output is from the first run)
+//   --quiet         don't print the output, only the summary
+//   --keystats      attach key statistics as a second consumer, as the firmware does, and
+//                   time it apart from the scan. The table is printed after the output
+//
+// Usage: replay --simulate-taps N
+//   No trace. N short taps (1-8ms, faster than the scan period) spread over all 16 keys
+//   of one expander are played against a model of its INTF/INTCAP latch, once scanning
+//   GPIO every 10ms and once with edge capture (a burst read triggered by INT plus the
+//   same periodic read). Prints the presses each one missed, exit 1 if edge capture
+//   missed any
+//   --int-latency US   INT edge to the burst read, 150us by default. Taps shorter than
+//                      this are only seen through INTCAP
+//   --tap-gap US       least time from one tap starting to the next, 0 by default. INTCAP
+//                      holds one change per port, so a second tap on the same port that
+//                      starts and ends before the read is lost. With the latency longer
+//                      than the longest tap and the gap longer than both together, a tap
+//                      no periodic read lands in is only seen through INTCAP, and none
+//                      may be missed (the ctest run in tests/)
+//
+// The encoder isn't traced, so its taps don't appear in a replay
+
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include "KeyPipeline.h"
+#include "Debounce.h"
+#include "Combo.h"
+#include "Keymap.h"
+#include "HidReport.h"
+#include "Layout.h"
+#include "Trace.h"
+#include "KeyStats.h"
+#include "EdgeCapture.h"
+
+#define REPLAY_LINE_LENGTH  128
+
+// Tap simulation
+#define REPLAY_SIM_SCAN_US          10000 // MACROPAD_SCAN_PERIOD_US
+#define REPLAY_SIM_INT_LATENCY_US   150   // INT edge to the burst read finishing, --int-latency
+#define REPLAY_SIM_TAP_MIN_US       1000
+#define REPLAY_SIM_TAP_MAX_US       8000
+#define REPLAY_SIM_SPACING_US       20000 // Release to the next press of the same key
+#define REPLAY_SIM_GAP_MAX_US       1000  // Between taps of any keys
+#define REPLAY_SIM_KEYS             16
+#define REPLAY_SIM_NO_READ          UINT32_MAX
+
+typedef struct {
+    KeyPipeline pipeline;
+    Debounce debounce;
+    Combo combo;
+    Keymap keymap;
+    HidReport hid;
+    int consumer;
+    KeyStats keystats;
+    int keystats_consumer;   // -1 without --keystats
+} Replay_Firmware;
+
+typedef struct {
+    char (*lines)[REPLAY_LINE_LENGTH];
+    size_t count;
+    size_t capacity;
+} Replay_Output;
+
+typedef struct {
+    uint64_t samples;
+    uint64_t events;
+    uint64_t reports;
+    uint64_t total_ns;
+    uint64_t max_sample_ns;
+    uint32_t max_latency_us; // Key edge to HID report, in trace time
+    uint64_t keystats_ns;
+    uint64_t keystats_events;
+} Replay_Stats;
+
+typedef struct {
+    uint32_t time_us;
+    uint8_t key;
+    bool pressed;
+} Replay_SimEdge;
+
+// One MCP23017 with interrupt on change from the previous value (INTCON = 0) on every key.
+// Each port latches INTF and INTCAP on its first change, a read clears both
+typedef struct {
+    uint16_t gpio;
+    uint16_t intf;
+    uint16_t intcap;
+} Replay_SimExpander;
+
+typedef struct {
+    uint32_t pressed;
+    uint32_t out_of_order; // A press while down or a release while up
+    uint32_t reads;
+    uint32_t recovered;    // Key changes only seen in INTCAP
+} Replay_SimResult;
+
+static Trace_Sample *samples;
+static size_t sample_count;
+static bool with_keystats;
+
+static uint64_t replay_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// Same stages, same order and same settings as main()
+static void replay_firmware_initialise(Replay_Firmware *fw) {
+    KeyPipeline_Initialise(&fw->pipeline);
+    Debounce_Initialise(&fw->debounce, DEBOUNCE_DEFAULT_WINDOW_US);
+    Combo_Initialise(&fw->combo, Layout_DefaultCombos, Layout_DefaultComboCount, COMBO_DEFAULT_WINDOW_US);
+    Keymap_Initialise(&fw->keymap, Layout_DefaultLayers, LAYOUT_LAYER_COUNT);
+    HidReport_Initialise(&fw->hid);
+    Combo_Attach(&fw->combo, &fw->pipeline, KeyPipeline_AddStage(&fw->pipeline, Combo_Stage, &fw->combo));
+    KeyPipeline_AddStage(&fw->pipeline, Keymap_Stage, &fw->keymap);
+    KeyPipeline_AddStage(&fw->pipeline, HidReport_Stage, &fw->hid);
+    fw->consumer = KeyPipeline_AddConsumer(&fw->pipeline);
+    fw->keystats_consumer = -1;
+    if (with_keystats) {
+        KeyStats_Initialise(&fw->keystats, NULL);
+        fw->keystats_consumer = KeyPipeline_AddConsumer(&fw->pipeline);
+    }
+}
+
+static void replay_output_add(Replay_Output *output, const char *line) {
+    if (output == NULL) {
+        return;
+    }
+    if (output->count == output->capacity) {
+        output->capacity = output->capacity ? output->capacity * 2 : 256;
+        output->lines = realloc(output->lines, output->capacity * REPLAY_LINE_LENGTH);
+        if (output->lines == NULL) {
+            fprintf(stderr, "Out of memory\n");
+            exit(2);
+        }
+    }
+    snprintf(output->lines[output->count++], REPLAY_LINE_LENGTH, "%s", line);
+}
+
+// Mirrors scan_task. Output is collected after the clock is stopped so printing isn't timed
+// Key statistics are drained per sample here rather than every 100ms, which only makes
+// their share look larger
+static void replay_run(Replay_Output *output, Replay_Stats *stats, KeyStats *keystats) {
+    static Replay_Firmware fw;
+    char line[REPLAY_LINE_LENGTH];
+    replay_firmware_initialise(&fw);
+
+    for (size_t i = 0; i < sample_count; i++) {
+        const Trace_Sample *sample = &samples[i];
+        uint64_t start = replay_now_ns();
+        Debounce_Update(&fw.debounce, &fw.pipeline, sample->source, sample->io, sample->time_us);
+        if (sample->kind == TRACE_SAMPLE_SCAN) {
+            Combo_SetTime(&fw.combo, sample->time_us);
+            KeyPipeline_Run(&fw.pipeline);
+        }
+        uint64_t elapsed = replay_now_ns() - start;
+        stats->samples++;
+        stats->total_ns += elapsed;
+        if (elapsed > stats->max_sample_ns) {
+            stats->max_sample_ns = elapsed;
+        }
+
+        if (fw.keystats_consumer >= 0) {
+            start = replay_now_ns();
+            stats->keystats_events += KeyStats_Consume(&fw.keystats, &fw.pipeline, fw.keystats_consumer);
+            KeyStats_SyncChatter(&fw.keystats, &fw.debounce);
+            stats->keystats_ns += replay_now_ns() - start;
+        }
+
+        KeyEvent *event;
+        while ((event = KeyPipeline_Peek(&fw.pipeline, fw.consumer)) != NULL) {
+            snprintf(line, sizeof(line), "%lu key %u %s layer %u keycode %04x", (unsigned long)event->timestamp_us, event->key,
+                     event->edge == KEYEVENT_PRESS ? "down" : "up", event->layer, event->keycode);
+            replay_output_add(output, line);
+            KeyPipeline_Release(&fw.pipeline, fw.consumer);
+            stats->events++;
+        }
+        HidKeyboardReport report;
+        uint32_t event_us;
+        while (HidReport_Take(&fw.hid, &report, &event_us)) {
+            snprintf(line, sizeof(line), "%lu hid %02x [%02x %02x %02x %02x %02x %02x]", (unsigned long)sample->time_us, report.modifiers,
+                     report.keys[0], report.keys[1], report.keys[2], report.keys[3], report.keys[4], report.keys[5]);
+            replay_output_add(output, line);
+            stats->reports++;
+            if (sample->time_us - event_us > stats->max_latency_us) {
+                stats->max_latency_us = sample->time_us - event_us;
+            }
+        }
+        uint16_t usage;
+        while (HidReport_TakeConsumer(&fw.hid, &usage)) {
+            snprintf(line, sizeof(line), "%lu consumer %03x", (unsigned long)sample->time_us, usage);
+            replay_output_add(output, line);
+            stats->reports++;
+        }
+    }
+    if (keystats != NULL && fw.keystats_consumer >= 0) {
+        *keystats = fw.keystats;
+    }
+}
+
+static uint32_t sim_random_state = 0x2545F491;
+static uint32_t sim_latency_us = REPLAY_SIM_INT_LATENCY_US;
+static uint32_t sim_gap_us;
+
+static uint32_t replay_sim_random(uint32_t range) {
+    sim_random_state ^= sim_random_state << 13;
+    sim_random_state ^= sim_random_state >> 17;
+    sim_random_state ^= sim_random_state << 5;
+    return sim_random_state % range;
+}
+
+static int replay_sim_compare(const void *a, const void *b) {
+    const Replay_SimEdge *x = a;
+    const Replay_SimEdge *y = b;
+    if (x->time_us != y->time_us) {
+        return x->time_us < y->time_us ? -1 : 1;
+    }
+    return (int)x->key - (int)y->key;
+}
+
+// Returns 2 * <taps> edges sorted by time, the start of each tap only waits for its own key
+static Replay_SimEdge *replay_sim_generate(uint32_t taps) {
+    Replay_SimEdge *edges = malloc(2 * (size_t)taps * sizeof(Replay_SimEdge));
+    if (edges == NULL) {
+        return NULL;
+    }
+    uint32_t free_at_us[REPLAY_SIM_KEYS] = {0};
+    uint32_t now_us = REPLAY_SIM_SCAN_US;
+    for (uint32_t i = 0; i < taps; i++) {
+        now_us += (i > 0 ? sim_gap_us : 0) + replay_sim_random(REPLAY_SIM_GAP_MAX_US);
+        uint8_t key = replay_sim_random(REPLAY_SIM_KEYS);
+        while (free_at_us[key] > now_us) {
+            key = (key + 1) % REPLAY_SIM_KEYS;
+            now_us += 1;
+        }
+        uint32_t length_us = REPLAY_SIM_TAP_MIN_US + replay_sim_random(REPLAY_SIM_TAP_MAX_US - REPLAY_SIM_TAP_MIN_US + 1);
+        edges[2 * i] = (Replay_SimEdge){now_us, key, true};
+        edges[2 * i + 1] = (Replay_SimEdge){now_us + length_us, key, false};
+        free_at_us[key] = now_us + length_us + REPLAY_SIM_SPACING_US;
+    }
+    qsort(edges, 2 * (size_t)taps, sizeof(Replay_SimEdge), replay_sim_compare);
+    return edges;
+}
+
+static void replay_sim_change(Replay_SimExpander *expander, uint16_t gpio) {
+    uint16_t changed = expander->gpio ^ gpio;
+    expander->gpio = gpio;
+    static const uint16_t ports[] = {0xFF00, 0x00FF};
+    for (uint8_t i = 0; i < 2; i++) {
+        if ((changed & ports[i]) && !(expander->intf & ports[i])) {
+            expander->intf |= changed & ports[i];
+            expander->intcap = (expander->intcap & ~ports[i]) | (gpio & ports[i]);
+        }
+    }
+}
+
+// Mirrors the expander half of scan_task, the rest of the pipeline isn't needed to count presses
+static void replay_sim_run(const Replay_SimEdge *edges, size_t edge_count, bool capture, Replay_SimResult *result) {
+    static KeyPipeline pipeline;
+    static Debounce debounce;
+    static EdgeCapture edge_capture;
+    KeyPipeline_Initialise(&pipeline);
+    Debounce_Initialise(&debounce, DEBOUNCE_DEFAULT_WINDOW_US);
+    EdgeCapture_Initialise(&edge_capture);
+    int consumer = KeyPipeline_AddConsumer(&pipeline);
+    Replay_SimExpander expander = {0};
+    uint16_t down = 0;
+
+    uint32_t end_us = edges[edge_count - 1].time_us + 2 * REPLAY_SIM_SCAN_US;
+    uint32_t next_scan_us = REPLAY_SIM_SCAN_US;
+    uint32_t read_at_us = REPLAY_SIM_NO_READ; // INT triggered read
+    uint32_t interrupt_us = 0;
+    size_t e = 0;
+    while (next_scan_us < end_us) {
+        uint32_t now_us = next_scan_us < read_at_us ? next_scan_us : read_at_us;
+        // Key changes up to and including the read
+        if (e < edge_count && edges[e].time_us <= now_us) {
+            uint16_t bit = 1u << edges[e].key;
+            uint16_t gpio = edges[e].pressed ? expander.gpio | bit : expander.gpio & ~bit;
+            bool asserted = expander.intf != 0;
+            replay_sim_change(&expander, gpio);
+            if (capture && !asserted && expander.intf != 0) {
+                interrupt_us = edges[e].time_us;
+                read_at_us = interrupt_us + sim_latency_us;
+            }
+            e++;
+            continue;
+        }
+        if (now_us == next_scan_us) {
+            next_scan_us += REPLAY_SIM_SCAN_US;
+        }
+        read_at_us = REPLAY_SIM_NO_READ;
+        result->reads++;
+        if (capture) {
+            uint16_t samples[2];
+            bool latched = expander.intf != 0;
+            uint8_t count = EdgeCapture_Decode(&edge_capture, 0, expander.intf, expander.intcap, expander.gpio, samples);
+            expander.intf = 0;
+            if (count == 2) {
+                Debounce_Update(&debounce, &pipeline, 0, samples[0], latched ? interrupt_us : now_us);
+            }
+        }
+        Debounce_Update(&debounce, &pipeline, 0, expander.gpio, now_us);
+
+        KeyEvent *event;
+        while ((event = KeyPipeline_Peek(&pipeline, consumer)) != NULL) {
+            uint16_t bit = 1u << event->key;
+            if ((event->edge == KEYEVENT_PRESS) == ((down & bit) != 0)) {
+                result->out_of_order++;
+            }
+            if (event->edge == KEYEVENT_PRESS) {
+                result->pressed++;
+                down |= bit;
+            }
+            else {
+                down &= ~bit;
+            }
+            KeyPipeline_Release(&pipeline, consumer);
+        }
+    }
+    result->recovered = edge_capture.recovered;
+}
+
+static int replay_simulate_taps(uint32_t taps) {
+    Replay_SimEdge *edges = replay_sim_generate(taps);
+    if (edges == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 2;
+    }
+    Replay_SimResult polling = {0};
+    Replay_SimResult capture = {0};
+    replay_sim_run(edges, 2 * (size_t)taps, false, &polling);
+    replay_sim_run(edges, 2 * (size_t)taps, true, &capture);
+    printf("%lu taps over %lums\n", (unsigned long)taps, (unsigned long)(edges[2 * taps - 1].time_us / 1000));
+    printf("gpio polling: %lu reads, %lu pressed, %lu missed, %lu out of order\n", (unsigned long)polling.reads,
+           (unsigned long)polling.pressed, (unsigned long)(taps - polling.pressed), (unsigned long)polling.out_of_order);
+    printf("edge capture: %lu reads, %lu pressed, %lu missed, %lu out of order, %lu changes only in INTCAP\n",
+           (unsigned long)capture.reads, (unsigned long)capture.pressed, (unsigned long)(taps - capture.pressed),
+           (unsigned long)capture.out_of_order, (unsigned long)capture.recovered);
+    free(edges);
+    return capture.pressed == taps && capture.out_of_order == 0 ? 0 : 1;
+}
+
+static bool replay_load(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        perror(path);
+        return false;
+    }
+    char line[256];
+    size_t capacity = 0;
+    while (fgets(line, sizeof(line), file)) {
+        Trace_Sample sample;
+        if (!Trace_ParseLine(line, &sample)) {
+            continue; // Header, footer and any other serial output
+        }
+        if (sample_count == capacity) {
+            capacity = capacity ? capacity * 2 : 1024;
+            samples = realloc(samples, capacity * sizeof(Trace_Sample));
+            if (samples == NULL) {
+                fclose(file);
+                return false;
+            }
+        }
+        samples[sample_count++] = sample;
+    }
+    fclose(file);
+    return true;
+}
+
+// Returns the number of the first differing line, 0 if identical
+static size_t replay_compare(const Replay_Output *output, const char *path) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        perror(path);
+        return 1;
+    }
+    char line[256];
+    size_t n = 0;
+    size_t mismatch = 0;
+    while (fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (n >= output->count || strcmp(line, output->lines[n]) != 0) {
+            fprintf(stderr, "Line %zu differs\n  expected: %s\n  replayed: %s\n", n + 1, line, n < output->count ? output->lines[n] : "<end>");
+            mismatch = n + 1;
+            break;
+        }
+        n++;
+    }
+    if (mismatch == 0 && n != output->count) {
+        fprintf(stderr, "Line %zu differs\n  expected: <end>\n  replayed: %s\n", n + 1, output->lines[n]);
+        mismatch = n + 1;
+    }
+    fclose(file);
+    return mismatch;
+}
+
+int main(int argc, char **argv) {
+    const char *trace_path = NULL;
+    const char *expect_path = NULL;
+    unsigned long repeat = 1;
+    bool quiet = false;
+    unsigned long simulate_taps = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--expect") == 0 && i + 1 < argc) {
+            expect_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "--quiet") == 0) {
+            quiet = true;
+        }
+        else if (strcmp(argv[i], "--keystats") == 0) {
+            with_keystats = true;
+        }
+        else if (strcmp(argv[i], "--simulate-taps") == 0 && i + 1 < argc) {
+            simulate_taps = strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "--int-latency") == 0 && i + 1 < argc) {
+            sim_latency_us = strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "--tap-gap") == 0 && i + 1 < argc) {
+            sim_gap_us = strtoul(argv[++i], NULL, 0);
+        }
+        else if (argv[i][0] != '-' && trace_path == NULL) {
+            trace_path = argv[i];
+        }
+        else {
+            trace_path = NULL;
+            break;
+        }
+    }
+    if (simulate_taps > 0 && trace_path == NULL) {
+        return replay_simulate_taps(simulate_taps);
+    }
+    if (trace_path == NULL || repeat == 0) {
+        fprintf(stderr, "Usage: %s [--expect FILE] [--repeat N] [--quiet] [--keystats] <trace.txt>\n"
+                        "       %s --simulate-taps N [--int-latency US] [--tap-gap US]\n", argv[0], argv[0]);
+        return 2;
+    }
+    if (!replay_load(trace_path)) {
+        return 2;
+    }
+
+    Replay_Output output = {0};
+    Replay_Stats stats = {0};
+    static KeyStats keystats;
+    replay_run(&output, &stats, &keystats);
+    for (unsigned long i = 1; i < repeat; i++) {
+        Replay_Stats run = {0};
+        replay_run(NULL, &run, NULL);
+        stats.total_ns += run.total_ns;
+        stats.samples += run.samples;
+        stats.keystats_ns += run.keystats_ns;
+        stats.keystats_events += run.keystats_events;
+        if (run.max_sample_ns > stats.max_sample_ns) {
+            stats.max_sample_ns = run.max_sample_ns;
+        }
+    }
+
+    if (!quiet) {
+        for (size_t i = 0; i < output.count; i++) {
+            printf("%s\n", output.lines[i]);
+        }
+        if (with_keystats) {
+            KeyStats_Print(&keystats);
+        }
+    }
+    uint64_t events = stats.events ? stats.events : 1;
+    fprintf(stderr, "%zu samples, %llu key events, %llu reports, max edge to report %luus\n", sample_count,
+            (unsigned long long)stats.events, (unsigned long long)stats.reports, (unsigned long)stats.max_latency_us);
+    fprintf(stderr, "Cost: %llu ns/sample mean, %llu ns/sample max, %llu ns/event\n",
+            (unsigned long long)(stats.total_ns / (stats.samples ? stats.samples : 1)), (unsigned long long)stats.max_sample_ns,
+            (unsigned long long)(stats.total_ns / repeat / events));
+    if (with_keystats) {
+        fprintf(stderr, "Key statistics: %llu ns/event, not counted in the scan cost above\n",
+                (unsigned long long)(stats.keystats_ns / (stats.keystats_events ? stats.keystats_events : 1)));
+    }
+
+    int result = 0;
+    if (expect_path && replay_compare(&output, expect_path) != 0) {
+        result = 1;
+    }
+    free(output.lines);
+    free(samples);
+    return result;
+}
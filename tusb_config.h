@@ -0,0 +1,41 @@
+/*
+ *
+ *  TinyUSB Configuration
+ *  
+ *  Author: Jennifer Chan
+ *  Created: 19/10/2026
+ *  Updated: 19/10/2026
+ *  Revision: 0.0.1
+ * 
+*/
+
+// Picked up by TinyUSB by name. Device only: boot keyboard, consumer control and raw HID (three HID
+// instances) plus one CDC ACM. Descriptors are built by UsbDescriptors.c
+
+#ifndef _TUSB_CONFIG_H
+#define _TUSB_CONFIG_H
+
+#ifndef CFG_TUSB_MCU
+#error CFG_TUSB_MCU must be defined by the build
+#endif
+
+#define CFG_TUSB_RHPORT0_MODE       OPT_MODE_DEVICE
+#define CFG_TUSB_OS                 OPT_OS_PICO
+#define CFG_TUD_ENABLED             1
+#define CFG_TUD_ENDPOINT0_SIZE      64
+
+#define CFG_TUD_HID                 3
+#define CFG_TUD_CDC                 1
+#define CFG_TUD_MSC                 0
+#define CFG_TUD_MIDI                0
+#define CFG_TUD_VENDOR              0
+
+// Large enough for a 64 byte raw HID report
+#define CFG_TUD_HID_EP_BUFSIZE      64
+
+// Room for a few batched telemetry packets, the OUT side only carries console commands
+#define CFG_TUD_CDC_RX_BUFSIZE      64
+#define CFG_TUD_CDC_TX_BUFSIZE      256
+#define CFG_TUD_CDC_EP_BUFSIZE      64
+
+#endif